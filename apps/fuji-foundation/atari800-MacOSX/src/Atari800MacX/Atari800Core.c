@@ -25,6 +25,7 @@
 #include "akey.h"
 #include "mac_diskled.h"
 #include "mac_colours.h"
+#include "perf.h"
 #include "pokeysnd.h"
 #include "preferences_c.h"
 
@@ -75,6 +76,7 @@ static void convert_screen_to_argb(void)
     uint8_t *dst = s_argb_buffer;
     int n = CORE_FRAME_W * CORE_FRAME_H;
 
+    PERF_BEGIN(PERF_PALETTE);
     for (int i = 0; i < n; i++) {
         unsigned int rgb = (unsigned int)colortable[src[i]];
         dst[0] = (uint8_t)((rgb >> 16) & 0xFF); /* R */
@@ -83,6 +85,7 @@ static void convert_screen_to_argb(void)
         dst[3] = 0xFF;                           /* A */
         dst += 4;
     }
+    PERF_END(PERF_PALETTE);
 }
 
 /* -------------------------------------------------------------------------
@@ -380,3 +383,40 @@ int Atari800Core_GetDiskLEDSector(void)
 {
     return led_sector;
 }
+
+/* -------------------------------------------------------------------------
+   Performance counters
+   ------------------------------------------------------------------------- */
+
+void Atari800Core_GetPerfCounters(Atari800Core_PerfCounters *out)
+{
+    PERF_Counters c;
+
+    if (!out) return;
+    PERF_GetCounters(&c);
+#ifdef PERF_COUNTERS
+    out->enabled = 1;
+#else
+    out->enabled = 0;
+#endif
+    out->frames               = c.frames;
+    out->wallSeconds          = c.wall_time;
+    out->cpuSeconds           = c.time[PERF_CPU];
+    out->anticDrawSeconds     = c.time[PERF_ANTIC_DRAW];
+    out->gtiaCollisionSeconds = c.time[PERF_GTIA_COLLISIONS];
+    out->pokeySoundSeconds    = c.time[PERF_POKEYSND];
+    out->sioSeconds           = c.time[PERF_SIO];
+    out->netsioWaitSeconds    = c.time[PERF_NETSIO_WAIT];
+    out->paletteSeconds       = c.time[PERF_PALETTE];
+    out->syncSleepSeconds     = c.time[PERF_SYNC_SLEEP];
+}
+
+void Atari800Core_ResetPerfCounters(void)
+{
+    PERF_Reset();
+}
+
+void Atari800Core_SetPerfDumpInterval(int frames)
+{
+    PERF_dump_interval = frames > 0 ? frames : 0;
+}
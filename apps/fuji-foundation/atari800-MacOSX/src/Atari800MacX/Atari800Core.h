@@ -235,6 +235,37 @@ int Atari800Core_GetDiskLEDStatus(void);
 /* Returns the current sector number being accessed (>0 when active). */
 int Atari800Core_GetDiskLEDSector(void);
 
+/* -------------------------------------------------------------------------
+   Performance counters
+
+   Time spent in each emulation hot path since the last reset, in seconds.
+   Only collected when the core is built with PERF_COUNTERS (see config.h);
+   otherwise enabled is 0 and only frames/wallSeconds are filled in.
+   Must be called from the emulation thread, or while it is stopped.
+   ------------------------------------------------------------------------- */
+
+typedef struct {
+    int           enabled;
+    unsigned long frames;
+    double        wallSeconds;
+    double        cpuSeconds;            /* 6502 emulation (CPU_GO)           */
+    double        anticDrawSeconds;      /* ANTIC scanline drawing            */
+    double        gtiaCollisionSeconds;  /* GTIA PMG scanlines and collisions */
+    double        pokeySoundSeconds;     /* POKEY sample generation           */
+    double        sioSeconds;            /* SIO patch handler                 */
+    double        netsioWaitSeconds;     /* waiting for FujiNet sync replies  */
+    double        paletteSeconds;        /* indexed colour to RGB conversion  */
+    double        syncSleepSeconds;      /* sleeping until the frame deadline */
+} Atari800Core_PerfCounters;
+
+void Atari800Core_GetPerfCounters(Atari800Core_PerfCounters *out);
+
+/* Clear the performance counters. */
+void Atari800Core_ResetPerfCounters(void);
+
+/* Log the per-frame averages every `frames` frames; 0 turns the dump off. */
+void Atari800Core_SetPerfDumpInterval(int frames);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1717,7 +1717,7 @@ static int monitorRunFirstTime = 1;
 	p = find_user_label(label);
 	if (p != NULL) {
 		if (p->addr != addr) {
-			p->addr = addr;
+			move_user_label(p, addr);
 		}
 	}
 	else
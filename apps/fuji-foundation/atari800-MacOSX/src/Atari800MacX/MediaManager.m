@@ -1058,7 +1058,8 @@ NSImage *disketteImage;
                     
     [filename getCString:cfilename maxLength:FILENAME_MAX encoding:NSUTF8StringEncoding];
 
-    CARTRIDGE_WriteImage(cfilename, cart->type, cart->image, cart->size << 10, cart->raw, 0);
+    CARTRIDGE_WriteImage(cfilename, cart->type, cart->image, cart->size << 10, cart->raw, 0,
+                         strcmp(cfilename, cart->filename) == 0 ? cart->dirty_blocks : NULL);
 
     cart->blank = FALSE;
     cart->dirty = FALSE;
@@ -2127,7 +2128,8 @@ NSImage *disketteImage;
         return;
 
     [filename getCString:cfilename maxLength:FILENAME_MAX encoding:NSUTF8StringEncoding];
-    CARTRIDGE_WriteImage(cfilename, dirtyCartridgeToSave->type, dirtyCartridgeToSave->image, dirtyCartridgeToSave->size << 10, dirtyCartridgeToSave->raw, 0);
+    CARTRIDGE_WriteImage(cfilename, dirtyCartridgeToSave->type, dirtyCartridgeToSave->image, dirtyCartridgeToSave->size << 10, dirtyCartridgeToSave->raw, 0,
+                         strcmp(cfilename, dirtyCartridgeToSave->filename) == 0 ? dirtyCartridgeToSave->dirty_blocks : NULL);
     dirtyCartridgeToSave->blank = FALSE;
     dirtyCartridgeToSave->dirty = FALSE;
 }
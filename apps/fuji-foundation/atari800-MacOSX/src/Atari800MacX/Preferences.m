@@ -182,6 +182,7 @@ enum {
     SYSROM_AUTO = SYSROM_SIZE /* Use to indicate that OS revision should be chosen automatically */
 };
 extern int SYSROM_FindType(int defaultType, char const *filename, char *romTypeName);
+extern void ROMCACHE_Save(void);
 
 void RunPreferences() {
 
@@ -3384,6 +3385,7 @@ static Preferences *sharedInstance = nil;
         [romFilename getCString:romCFilename maxLength:FILENAME_MAX encoding:NSUTF8StringEncoding];
         
         osType = SYSROM_FindType(romDefault, romCFilename, romTypeName);
+        ROMCACHE_Save();
 
         if (osType == -1)
             [label setStringValue:@"Error Identifying ROM - Altirra Will Be Used"];
@@ -133,6 +133,7 @@
 - (void)writeSector:(int)sector
 {
 	AtrWriteSector([owner getDiskInfo], sector, sectorBuffer);
+	AtrFlush([owner getDiskInfo]);
 	[owner clearDirty];
 }
 
@@ -49,6 +49,7 @@
 #include "akey.h"
 #include "atari.h"
 #include "bit3.h"
+#include "col80.h"
 #include "esc.h"
 #include "input.h"
 #include "mac_colours.h"
@@ -82,6 +83,8 @@
 #include "side2.h"
 #include "util.h"
 #include "capslock.h"
+#include "pacer.h"
+#include "perf.h"
 #ifdef NETSIO
 #include "netsio.h"
 #endif
@@ -562,6 +565,8 @@ static int sndspread = 14; /* proportional to snddelay increase */
 static int gap_est = 0;
 /* cumulative audio difference */
 static double avg_gap;
+/* integral term of the dynamic rate controller */
+static double drc_integral;
 /* dsp_write_pos, dsp_read_pos and callbacktick are accessed in two different threads: */
 static int dsp_write_pos;
 static int dsp_read_pos;
@@ -680,16 +685,28 @@ int lookup(struct table *t,int key){
 struct table *SDL_IsJoyKeyTable = NULL;
 
 #ifdef SYNCHRONIZED_SOUND
-/* returns a factor (1.0 by default) to adjust the speed of the emulation
- * so that if the sound buffer is too full or too empty, the emulation
- * slows down or speeds up to match the actual speed of sound output */
+/* Dynamic rate control: a PI controller resamples the POKEY output by a
+ * tiny ratio so the sound buffer settles at snddelay ms. The deviation is
+ * kept within 0.5%, which is not audible as a pitch change. */
+#define DRC_MAX_DEVIATION 0.005
+#define DRC_KP 0.5
+#define DRC_KI 0.01
+/* beyond this many spreads off target, also change emulation speed */
+#define DRC_PANIC_ERROR 4.0
+
+/* returns a factor (1.0 by default) to adjust the speed of the emulation.
+ * Normally the buffer is steered by resampling and this returns 1.0; only
+ * if the buffer is far off target (after a stall) does the emulation slow
+ * down or speed up to catch up quickly. */
 double PLATFORM_AdjustSpeed(void)
 {
 	int bytes_per_sample = (POKEYSND_stereo_enabled ? 2 : 1)*((sound_bits == 16) ? 2:1);
 	
 	double alpha = 2.0/(1.0+40.0);
-	double gap_too_small;
-	double gap_too_large;
+	double target;
+	double spread;
+	double error;
+	double ratio;
 	static int inited = FALSE;
 	
 	if (!inited) {
@@ -700,18 +717,28 @@ double PLATFORM_AdjustSpeed(void)
 		avg_gap = avg_gap + alpha * (gap_est - avg_gap);
 	}
 	
-	gap_too_small = (snddelay*dsprate*bytes_per_sample)/1000;
-	gap_too_large = ((snddelay+sndspread)*dsprate*bytes_per_sample)/1000;
-	if (avg_gap < gap_too_small) {
-		double speed = 0.95;
-//		printf("small %f %f %d %d %d %d\n",avg_gap,gap_too_small,snddelay,dsprate,bytes_per_sample,sound_bits);
-		return speed;
-	}
-	if (avg_gap > gap_too_large) {
-		double speed = 1.05;
-//		printf("large %f %f %d %d %d %d\n",avg_gap,gap_too_large,snddelay,dsprate,bytes_per_sample,sound_bits);
-		return speed;
-	}
+	target = (snddelay*dsprate*bytes_per_sample)/1000.0;
+	spread = (sndspread*dsprate*bytes_per_sample)/1000.0;
+	/* positive when the buffer is too empty */
+	error = (target - avg_gap) / spread;
+
+	drc_integral += DRC_KI * DRC_MAX_DEVIATION * error;
+	if (drc_integral > DRC_MAX_DEVIATION)
+		drc_integral = DRC_MAX_DEVIATION;
+	else if (drc_integral < -DRC_MAX_DEVIATION)
+		drc_integral = -DRC_MAX_DEVIATION;
+
+	ratio = 1.0 + DRC_KP * DRC_MAX_DEVIATION * error + drc_integral;
+	if (ratio > 1.0 + DRC_MAX_DEVIATION)
+		ratio = 1.0 + DRC_MAX_DEVIATION;
+	else if (ratio < 1.0 - DRC_MAX_DEVIATION)
+		ratio = 1.0 - DRC_MAX_DEVIATION;
+	MZPOKEYSND_SetRateRatio(ratio);
+
+	if (error > DRC_PANIC_ERROR)
+		return 0.95;
+	if (error < -DRC_PANIC_ERROR)
+		return 1.05;
 	return 1.0;
 }
 #endif /* SYNCHRONIZED_SOUND */
@@ -1250,6 +1277,7 @@ void SoundSetup()
 		dsp_read_pos = 0;
 		dsp_write_pos = (specified_delay_samps+frag_samps)*bytes_per_sample;
 		avg_gap = 0.0;
+		drc_integral = 0.0;
 	}
 #else
 	dsp_buffer_bytes = desired.channels*frag_samps*(sound_bits == 8 ? 1 : 2);
@@ -2931,51 +2959,64 @@ void DisplayWithoutScaling16bpp(Uint8 * screen, int jumped, int width,
     }
 }
 
-void DisplayAF80WithoutScaling16bpp(int first_row, int last_row, int blink)
+/*------------------------------------------------------------------------------
+*  DisplayCol80Cells - Displays the text cells of the AF80 or Bit3 screen that
+*    changed since they were last drawn, from the COL80 glyph cache.
+*-----------------------------------------------------------------------------*/
+void DisplayCol80Cells(int rows, int cell_height, ULONG (*get_cell)(int, int),
+                       const int *palette, int blink)
 {
-    register Uint32 *toPtr;
-    unsigned int column;
-    UBYTE pixels;
-
-    toPtr = MetalFrameBuffer + (first_row * AF80_SCRN_WIDTH);
-    for (; first_row < last_row; first_row++) {
-        for (column = 0; column < 80; column++) {
-            int i;
-            int colour;
+    int row, column;
+
+    for (row = 0; row < rows; row++) {
+        for (column = 0; column < COL80_COLUMNS; column++) {
+            ULONG key = get_cell(row, column);
+            const UBYTE *glyph;
+            register Uint32 *toPtr;
             Uint32 fgColor;
-            pixels = AF80_GetPixels(first_row, column, &colour, blink);
-            fgColor = 0xFF000000u | (Uint32)AF80_palette[colour]; /* 0x00RRGGBB → BGRA8 */
-            for (i = 0; i < 4; i++) {
-                *toPtr++ = (pixels & 0x01) ? fgColor : 0xFF000000u;
-                *toPtr++ = (pixels & 0x02) ? fgColor : 0xFF000000u;
-                pixels >>= 2;
+            int line, i;
+
+            if (!COL80_UpdateCell(row, column, key, blink))
+                continue;
+            glyph = COL80_GetGlyph(key, blink);
+            fgColor = 0xFF000000u | (Uint32)palette[COL80_KEY_COLOUR(key)]; /* 0x00RRGGBB → BGRA8 */
+            toPtr = MetalFrameBuffer + (row * cell_height * COL80_COLUMNS + column) * 8;
+            for (line = 0; line < cell_height; line++) {
+                UBYTE pixels = glyph[line];
+                for (i = 0; i < 8; i++) {
+                    toPtr[i] = (pixels & 0x01) ? fgColor : 0xFF000000u;
+                    pixels >>= 1;
+                }
+                toPtr += COL80_COLUMNS * 8;
             }
         }
-        /* toPtr has advanced AF80_SCRN_WIDTH (640) pixels; ready for next row */
     }
 }
 
-void DisplayBit3WithoutScaling16bpp(int first_line, int last_line, int blink)
+/*------------------------------------------------------------------------------
+*  DisplayXEP80Cells - Displays the cells of the XEP80 screen that were
+*    redrawn, or that blink, since they were last drawn.
+*-----------------------------------------------------------------------------*/
+void DisplayXEP80Cells(Uint8 *screen, int blink)
 {
-    register Uint32 *toPtr;
-    unsigned int column;
-    UBYTE pixels;
-
-    toPtr = MetalFrameBuffer + (first_line * BIT3_SCRN_WIDTH);
-    for (; first_line < last_line; first_line++) {
-        for (column = 0; column < 80; column++) {
-            int i;
-            int colour;
-            Uint32 fgColor;
-            pixels = BIT3_GetPixels(first_line, column, &colour, blink);
-            fgColor = 0xFF000000u | (Uint32)BIT3_palette[colour]; /* 0x00RRGGBB → BGRA8 */
-            for (i = 0; i < 4; i++) {
-                *toPtr++ = (pixels & 0x01) ? fgColor : 0xFF000000u;
-                *toPtr++ = (pixels & 0x02) ? fgColor : 0xFF000000u;
-                pixels >>= 2;
+    int row, column;
+
+    for (row = 0; row < XEP80_HEIGHT; row++) {
+        for (column = 0; column < XEP80_LINE_LEN; column++) {
+            int offset = row * XEP80_CHAR_HEIGHT * XEP80_SCRN_WIDTH + column * XEP80_CHAR_WIDTH;
+            register Uint8 *fromPtr = screen + offset;
+            register Uint32 *toPtr = MetalFrameBuffer + offset;
+            int line, i;
+
+            if (!COL80_CellChanged(row, column, blink))
+                continue;
+            for (line = 0; line < XEP80_CHAR_HEIGHT; line++) {
+                for (i = 0; i < XEP80_CHAR_WIDTH; i++)
+                    toPtr[i] = MetalPalette32[fromPtr[i]];
+                fromPtr += XEP80_SCRN_WIDTH;
+                toPtr += XEP80_SCRN_WIDTH;
             }
         }
-        /* toPtr has advanced BIT3_SCRN_WIDTH (640) pixels; ready for next row */
     }
 }
 
@@ -3016,6 +3057,7 @@ void Atari_DisplayScreen(UBYTE * screen)
     int last_row = Screen_HEIGHT - 1;
     ULONG *line_start1, *line_start2;
     static int xep80Frame = 0;
+    int xep80Blink = FALSE;
     static int af80Frame = 0;
     static int bit3Frame = 0;
 	
@@ -3047,25 +3089,20 @@ void Atari_DisplayScreen(UBYTE * screen)
             }
 		else {
             screen = (UBYTE *) XEP80_screen_2;
+            xep80Blink = TRUE;
             }
         xep80Frame++;
         if (xep80Frame >= 60) {
             xep80Frame = 0;
 			}
-		if (xep80Frame == 1 || xep80Frame == 31 || full_display) {
-			XEP80_first_row = 0;
-			XEP80_last_row = XEP80_SCRN_HEIGHT - 1;
-		}
-		if (XEP80_last_row == 0) {
-			first_row = 0;
-			last_row = 0;
-		}
-		else {
-			first_row = XEP80_first_row;
-			last_row = XEP80_last_row;
+		/* Only the changed and blinking cells are redrawn */
+		COL80_SetDevice(XEP80_HEIGHT, XEP80_CHAR_HEIGHT, NULL);
+		if (full_display) {
+			COL80_InvalidateCells();
+			full_display--;
 		}
-		XEP80_last_row = 0;
-		XEP80_first_row = XEP80_SCRN_HEIGHT - 1;
+		first_row = 0;
+		last_row = XEP80_SCRN_HEIGHT - 1;
 		}
     else if (PLATFORM_80col && AF80_enabled) {
         width = AF80_SCRN_WIDTH;
@@ -3075,6 +3112,11 @@ void Atari_DisplayScreen(UBYTE * screen)
         if (af80Frame >= 60) {
             af80Frame = 0;
             }
+        COL80_SetDevice(AF80_SCRN_HEIGHT / AF80_CHAR_HEIGHT, AF80_CHAR_HEIGHT, AF80_RenderGlyph);
+        if (full_display) {
+            COL80_InvalidateCells();
+            full_display--;
+            }
         }
     else if (PLATFORM_80col && BIT3_enabled) {
         width = BIT3_SCRN_WIDTH;
@@ -3084,6 +3126,11 @@ void Atari_DisplayScreen(UBYTE * screen)
         if (bit3Frame >= 60) {
             bit3Frame = 0;
             }
+        COL80_SetDevice(BIT3_SCRN_HEIGHT / BIT3_CHAR_HEIGHT, BIT3_CHAR_HEIGHT, BIT3_RenderGlyph);
+        if (full_display) {
+            COL80_InvalidateCells();
+            full_display--;
+            }
         }
 	else if (!full_display) {
 		line_start1 = Screen_atari + (Screen_WIDTH/4 * (Screen_HEIGHT-1));
@@ -3106,13 +3153,19 @@ void Atari_DisplayScreen(UBYTE * screen)
 	else
 		full_display--;
 		
-    if (PLATFORM_80col && AF80_enabled) {
-        DisplayAF80WithoutScaling16bpp(first_row, last_row, af80Frame >= 30);
+    PERF_BEGIN(PERF_PALETTE);
+    if (PLATFORM_80col && XEP80_enabled) {
+        DisplayXEP80Cells(screen, xep80Blink);
+    } else if (PLATFORM_80col && AF80_enabled) {
+        DisplayCol80Cells(AF80_SCRN_HEIGHT / AF80_CHAR_HEIGHT, AF80_CHAR_HEIGHT,
+                          AF80_GetCell, AF80_palette, af80Frame >= 30);
     } else if (PLATFORM_80col && BIT3_enabled) {
-            DisplayBit3WithoutScaling16bpp(first_row, last_row, bit3Frame / 30);
+        DisplayCol80Cells(BIT3_SCRN_HEIGHT / BIT3_CHAR_HEIGHT, BIT3_CHAR_HEIGHT,
+                          BIT3_GetCell, BIT3_palette, bit3Frame / 30);
     } else {
         DisplayWithoutScaling16bpp(screen, jumped, width, first_row, last_row);
     }
+    PERF_END(PERF_PALETTE);
     
     // If not in mouse emulation or Fullscreen, check for copy selection
 	if (INPUT_mouse_mode == INPUT_MOUSE_OFF)
@@ -4806,6 +4859,7 @@ void ProcessMacPrefsChange()
                 }
             CalcPalette();
             SetPalette();
+            COL80_InvalidateCells();
             /* Clear the alternate page, so the first redraw is entire screen */
             if (Screen_atari)
                 memset(Screen_atari, 0, (Screen_HEIGHT * Screen_WIDTH));
@@ -4919,9 +4973,9 @@ void ProcessMacPrefsChange()
             SIDE2_Add_Block_Device(side2_nvram_filename);
         }
     if (Atari800_tv_mode == Atari800_TV_PAL)
-            deltatime = (1.0 / 50.0) / emulationSpeed;
+            deltatime = (1.0 / Atari800_FPS_PAL) / emulationSpeed;
     else
-            deltatime = (1.0 / 60.0) / emulationSpeed;
+            deltatime = (1.0 / Atari800_FPS_NTSC) / emulationSpeed;
 #ifdef SYNCHRONIZED_SOUND			 
 	init_mzpokeysnd_sync();
 #endif			 
@@ -5116,10 +5170,7 @@ void Casette_Frame(void)
 
 static double Atari800Time(void)
 {
-  struct timeval tp;
-
-  gettimeofday(&tp, NULL);
-  return tp.tv_sec + 1e-6 * tp.tv_usec;
+  return PACER_Time();
 }
 
 static void SDL_Atari_CX85(void)
@@ -70,7 +70,6 @@ static Dos2DirEntry *AtrDos2FindDirEntryByName(AtrDiskInfo *info, char *name);
 static UWORD AtrDos2GetFreeSector(AtrDiskInfo *info);
 static int AtrDos2ReadVtoc(AtrDiskInfo *info, UWORD *freeSectors);
 static int AtrDos2WriteVtoc(AtrDiskInfo *info);
-static int AtrDos2IsSectorUsed(AtrDiskInfo *info,  UWORD sector);
 static void AtrDos2MarkSectorUsed(AtrDiskInfo *info, UWORD sector, int used);
 static Dos2DirEntry *AtrDos2FindFreeDirEntry(AtrDiskInfo *info);
 static void AtrDos2DeleteDirList(AtrDiskInfo *info);
@@ -482,16 +481,19 @@ int AtrDos2ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 	{
 		if ( sector < 1 || (sector > AtrSectorCount(info)))
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 
 		if ( ( secBuff[ sectorSize - 1 ] & 0x80 ) && ( sectorSize == 0x80 ) )
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 
 		if ( AtrReadSector(info,sector, secBuff))
 		{
+			fclose(output);
 			return ADOS_FILE_READ_ERR;
 		}
 
@@ -502,6 +504,7 @@ int AtrDos2ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 
 		    if ( ( secBuff[ sectorSize-3 ] >> 2 ) != fileNumber )
 		    {
+			    fclose(output);
 			    return ADOS_FILE_CORRUPTED;
 		    }
         }
@@ -534,6 +537,7 @@ int AtrDos2ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 		if ( ! ( secBuff[ sectorSize - 1 ] & 128 ) && 
               ( sectorSize == 128 ) && sector)
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 	}
@@ -623,15 +627,12 @@ static Dos2DirEntry *AtrDos2FindDirEntryByName(AtrDiskInfo *info, char *name)
 
 static UWORD AtrDos2GetFreeSector(AtrDiskInfo *info)
 {
-    UWORD i;
+    int sector;
+	AtrDos2DiskInfo *dinfo = (AtrDos2DiskInfo *)info->atr_dosinfo;
 
-    for (i=1;i<=AtrSectorCount(info)+1;i++)
-        {
-        if (!AtrDos2IsSectorUsed(info,i) )
-            {
-            return i;
-            }
-        }
+    sector = AtrBitmapFindFree(dinfo->vtocMap, 1, AtrSectorCount(info)+2);
+    if (sector >= 0)
+        return sector;
     return  0;
 }
 
@@ -692,12 +693,7 @@ static int AtrDos2WriteVtoc(AtrDiskInfo *info)
             return stat;
         for( j=6,i=0; i<122; i++ )
             secBuf[i] = dinfo->vtocMap[j++] ;
-        freeSectors = 0;
-        for (i=720;i<1024;i++) 
-            {
-            if (!AtrDos2IsSectorUsed(info,i)) 
-                freeSectors++;
-            }
+        freeSectors = AtrBitmapCountFree(dinfo->vtocMap, 720, 1024);
         secBuf[122] = freeSectors & 0xFF;
         secBuf[123] = freeSectors >> 8;
         stat = AtrWriteSector(info, VTOC_2, secBuf);
@@ -708,12 +704,7 @@ static int AtrDos2WriteVtoc(AtrDiskInfo *info)
             return stat;
         for( j=0,i=10; i<100; i++ )
             secBuf[i] = dinfo->vtocMap[j++];
-        freeSectors = 0;
-        for (i=0;i<720;i++) 
-            {
-            if (!AtrDos2IsSectorUsed(info,i)) 
-                freeSectors++;
-            }
+        freeSectors = AtrBitmapCountFree(dinfo->vtocMap, 0, 720);
         secBuf[3] = freeSectors & 0xFF;
         secBuf[4] = freeSectors >> 8;
         stat = AtrWriteSector(info, VTOC_1, secBuf);
@@ -727,12 +718,7 @@ static int AtrDos2WriteVtoc(AtrDiskInfo *info)
             return stat;
         for( i=10; i<sectorSize; i++ )
             secBuf[i] = dinfo->vtocMap[j++];
-        freeSectors = 0;
-        for (i=0;i<sectorCount;i++) 
-            {
-            if (!AtrDos2IsSectorUsed(info,i)) 
-                freeSectors++;
-            }
+        freeSectors = AtrBitmapCountFree(dinfo->vtocMap, 0, sectorCount);
         secBuf[3] = (UBYTE)(freeSectors&255);
         secBuf[4] = (UBYTE)(freeSectors>>8);
         stat = AtrWriteSector(info, VTOC_1, secBuf);
@@ -743,18 +729,6 @@ static int AtrDos2WriteVtoc(AtrDiskInfo *info)
 
 }
 
-static int AtrDos2IsSectorUsed(AtrDiskInfo *info, UWORD sector)
-{
-    UWORD entry;
-    UBYTE mask;
-    UBYTE maskTable[] = {128, 64, 32, 16, 8, 4, 2, 1};
-	AtrDos2DiskInfo *dinfo = (AtrDos2DiskInfo *)info->atr_dosinfo;
-
-    entry = sector / 8;
-    mask = maskTable[ sector & 7];
-    return ( !(dinfo->vtocMap[entry] & mask) );
-}
-
 static void AtrDos2MarkSectorUsed(AtrDiskInfo *info, UWORD sector, int used)
 {
     UWORD entry;
@@ -470,6 +470,7 @@ int AtrDos3ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
         for (i=0;i<8;i++) {
             if ( AtrReadSector(info,sector+i, secBuff+(i*128)))
                 {
+			    fclose(output);
 			    return ADOS_FILE_READ_ERR;
 		        }
             }
@@ -489,12 +490,18 @@ int AtrDos3ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 		if ( bytesToWrite == DOS_3_BLOCK_SIZE )
 		{
 			if ( block >= FAT_END_OF_FILE )
+			{
+				fclose(output);
 				return ADOS_FILE_CORRUPTED;
+			}
 		}
 		else
 		{
 			if ( block != FAT_END_OF_FILE )
+			{
+				fclose(output);
 				return ADOS_FILE_CORRUPTED;
+			}
 		}
 
 
@@ -529,6 +529,7 @@ int AtrDos4ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
         for (i=0;i<(DOS4_BLOCK_SIZE / sectorSize);i++) {
             if ( AtrReadSector(info,sector+i, secBuff+(i*sectorSize)))
                 {
+			    fclose(output);
 			    return ADOS_FILE_READ_ERR;
 		        }
             }
@@ -551,12 +552,18 @@ int AtrDos4ExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 		if ( count > 1 )
 		{
 			if ( block < DOS4_FIRST_BLK_NUM )
+			{
+				fclose(output);
 				return ADOS_FILE_CORRUPTED;
+			}
 		}
 		else
 		{
 			if ( block >= DOS4_FIRST_BLK_NUM )
+			{
+				fclose(output);
 				return ADOS_FILE_CORRUPTED;
+			}
 		}
 
 		count--;
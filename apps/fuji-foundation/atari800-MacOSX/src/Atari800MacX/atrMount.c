@@ -76,12 +76,33 @@
 
 static void SizeOfSector(AtrDiskInfo *info, int sector, int *sz, ULONG * ofs);
 static int AtrSeekSector(AtrDiskInfo *info, int sector);
+static int AtrLoadImage(AtrDiskInfo *info, ULONG file_length);
+static int AtrWriteBack(AtrDiskInfo *info, int stat);
 static int AtrDiskType(AtrDiskInfo *info);
+static int AtrMountFile(const char *filename, int readOnly, int *dosType,
+                        int *readWrite, int *writeProtect, AtrDiskInfo **info);
 
+/* On error, *info must still be released with AtrUnmount */
 int AtrMount(const char *filename, int *dosType, 
              int *readWrite, int *writeProtect, AtrDiskInfo **info)
+{
+    return AtrMountFile(filename, FALSE, dosType, readWrite, writeProtect, info);
+}
+
+/* Mounts without opening the image for writing, for tools that only read */
+int AtrMountReadOnly(const char *filename, int *dosType, 
+                     int *writeProtect, AtrDiskInfo **info)
+{
+    int readWrite;
+
+    return AtrMountFile(filename, TRUE, dosType, &readWrite, writeProtect, info);
+}
+
+static int AtrMountFile(const char *filename, int readOnly, int *dosType,
+                        int *readWrite, int *writeProtect, AtrDiskInfo **info)
 {
 	struct AFILE_ATR_Header header;
+	ULONG file_length = 0;
 	int i;
     int stat;
     
@@ -92,7 +113,8 @@ int AtrMount(const char *filename, int *dosType,
     *dosType = DOS_UNKNOWN;
     (*info)->atr_dostype = DOS_UNKNOWN;
 
-    (*info)->atr_file = fopen(filename, "rb+");
+    if (!readOnly)
+        (*info)->atr_file = fopen(filename, "rb+");
     if (!(*info)->atr_file) {
         *readWrite = FALSE;
         (*info)->atr_file = fopen(filename, "rb");
@@ -101,8 +123,6 @@ int AtrMount(const char *filename, int *dosType,
         *readWrite = TRUE;    
     
 	if ((*info)->atr_file) {
-		ULONG file_length;
-
 		fseek((*info)->atr_file, 0L, SEEK_END);
 		file_length = ftell((*info)->atr_file);
 		fseek((*info)->atr_file, 0L, SEEK_SET);
@@ -110,9 +130,12 @@ int AtrMount(const char *filename, int *dosType,
 		if (fread(&header, 1, sizeof(struct AFILE_ATR_Header), (*info)->atr_file) < 
               sizeof(struct AFILE_ATR_Header)) {
 			fclose((*info)->atr_file);
+			(*info)->atr_file = NULL;
 			return ADOS_DISK_READ_ERR;
             }
 		}
+	else
+		return ADOS_DISK_READ_ERR;
 
 	(*info)->atr_boot_sectors_type = BOOT_SECTORS_LOGICAL;
 
@@ -161,6 +184,10 @@ int AtrMount(const char *filename, int *dosType,
             (*info)->atr_sectorcount >>= 6;
             }
 
+        stat = AtrLoadImage(*info, file_length);
+        if (stat)
+            return stat;
+
         *dosType = AtrDiskType(*info);
         if (*dosType == -1)
             return ADOS_DISK_READ_ERR;
@@ -172,41 +199,20 @@ int AtrMount(const char *filename, int *dosType,
                 return(ADOS_UNKNOWN_FORMAT);
             case DOS_ATARI:
             case DOS_ATARI1:
-                stat = AtrDos2Mount(*info, TRUE);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrDos2Mount(*info, TRUE));
             case DOS_TOP:
             case DOS_BIBO:
-                stat = AtrDos2Mount(*info, FALSE);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrDos2Mount(*info, FALSE));
             case DOS_ATARI3:
-                stat = AtrDos3Mount(*info);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrDos3Mount(*info));
             case DOS_ATARI4:
-                stat = AtrDos4Mount(*info);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrDos4Mount(*info));
             case DOS_ATARIXE:
-                stat = AtrXEMount(*info);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrXEMount(*info));
             case DOS_MYDOS:
-                stat = AtrMyDosMount(*info);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrMyDosMount(*info));
             case DOS_SPARTA2:
-                stat = AtrSpartaMount(*info);
-                if (stat) 
-                    AtrUnmount(*info);
-                return(stat);
+                return(AtrSpartaMount(*info));
             }
 
 	    return ADOS_UNKNOWN_FORMAT;
@@ -368,29 +374,39 @@ static int AtrDiskType(AtrDiskInfo *info)
 
 void AtrUnmount(AtrDiskInfo *info)
 {
-    switch(info->atr_dostype) {
-        case DOS_ATARI:
-            AtrDos2Unmount(info);
-			break;
-        case DOS_ATARI3:
-            AtrDos3Unmount(info);
-			break;
-        case DOS_ATARI4:
-            AtrDos4Unmount(info);
-			break;
-        case DOS_ATARIXE:
-            AtrXEUnmount(info);
-			break;
-        case DOS_MYDOS:
-            AtrMyDosUnmount(info);
-			break;
-        case DOS_SPARTA2:
-            AtrSpartaUnmount(info);
-			break;
+    /* NULL if the DOS was not recognised, or its mount ran out of memory */
+    if (info->atr_dosinfo) {
+        switch(info->atr_dostype) {
+            case DOS_ATARI:
+            case DOS_ATARI1:
+            case DOS_TOP:
+            case DOS_BIBO:
+                AtrDos2Unmount(info);
+				break;
+            case DOS_ATARI3:
+                AtrDos3Unmount(info);
+				break;
+            case DOS_ATARI4:
+                AtrDos4Unmount(info);
+				break;
+            case DOS_ATARIXE:
+                AtrXEUnmount(info);
+				break;
+            case DOS_MYDOS:
+                AtrMyDosUnmount(info);
+				break;
+            case DOS_SPARTA2:
+                AtrSpartaUnmount(info);
+				break;
+            }
         }
 
-    if (info->atr_file) 
+    if (info->atr_file) {
+        AtrFlush(info);
         fclose(info->atr_file);
+        }
+    free(info->atr_image);
+    free(info->atr_dirty);
 	free(info);
 }
 
@@ -423,10 +439,16 @@ int AtrSectorCount(AtrDiskInfo *info)
 /* Unit counts from zero up */
 int AtrReadSector(AtrDiskInfo *info, int sector, UBYTE * buffer)
 {
+	ULONG offset;
 	int size;
 
     if (info->atr_file) {
     	if (sector > 0 && sector <= info->atr_sectorcount) {
+            if (info->atr_image) {
+                SizeOfSector(info, sector, &size, &offset);
+                memcpy(buffer, info->atr_image + offset, size);
+                return FALSE;
+                }
     		size = AtrSeekSector(info, sector);
             fread(buffer, 1, size, info->atr_file);
             return FALSE;
@@ -436,12 +458,20 @@ int AtrReadSector(AtrDiskInfo *info, int sector, UBYTE * buffer)
 	return ADOS_DISK_READ_ERR;
 }
 
+/* Writes to a loaded image only reach the file at the next AtrFlush */
 int AtrWriteSector(AtrDiskInfo *info, int sector, UBYTE * buffer)
 {
+	ULONG offset;
 	int size;
 
 	if (info->atr_file) {
 		if (sector > 0 && sector <= info->atr_sectorcount) {
+            if (info->atr_image) {
+                SizeOfSector(info, sector, &size, &offset);
+                memcpy(info->atr_image + offset, buffer, size);
+                info->atr_dirty[sector] = TRUE;
+                return FALSE;
+                }
 			size = AtrSeekSector(info, sector);
 			fwrite(buffer, 1, size, info->atr_file);
 			return FALSE;
@@ -451,6 +481,40 @@ int AtrWriteSector(AtrDiskInfo *info, int sector, UBYTE * buffer)
     return ADOS_DISK_WRITE_ERR;
 }
 
+/* Writes the sectors changed since the last call back to the image file,
+   each run of neighbouring sectors with one fwrite */
+int AtrFlush(AtrDiskInfo *info)
+{
+    ULONG offset, next, end;
+    int sector, last, size;
+    int stat = FALSE;
+
+    if (info->atr_image == NULL)
+        return FALSE;
+
+    for (sector = 1; sector <= info->atr_sectorcount; sector++) {
+        if (!info->atr_dirty[sector])
+            continue;
+        SizeOfSector(info, sector, &size, &offset);
+        end = offset + size;
+        for (last = sector; last < info->atr_sectorcount && info->atr_dirty[last + 1]; last++) {
+            SizeOfSector(info, last + 1, &size, &next);
+            if (next != end)
+                break;
+            end = next + size;
+            }
+        memset(info->atr_dirty + sector, FALSE, last - sector + 1);
+        if (fseek(info->atr_file, offset, SEEK_SET) != 0 ||
+            fwrite(info->atr_image + offset, 1, end - offset, info->atr_file) < end - offset)
+            stat = ADOS_DISK_WRITE_ERR;
+        sector = last;
+        }
+
+    if (fflush(info->atr_file) != 0)
+        stat = ADOS_DISK_WRITE_ERR;
+    return stat;
+}
+
 int AtrSetWriteProtect(AtrDiskInfo *info, int writeProtect)
 {
 	struct AFILE_ATR_Header header;
@@ -471,6 +535,10 @@ int AtrSetWriteProtect(AtrDiskInfo *info, int writeProtect)
 	if (fwrite(&header, 1, sizeof(struct AFILE_ATR_Header), info->atr_file) < 
              sizeof(struct AFILE_ATR_Header)) 
 		return ADOS_DISK_WRITE_ERR;
+	fflush(info->atr_file);
+
+    if (info->atr_image)
+        memcpy(info->atr_image, &header, sizeof(struct AFILE_ATR_Header));
 
 	return(FALSE);
 }
@@ -525,11 +593,11 @@ int AtrDeleteDir(AtrDiskInfo *info, char *name)
         case DOS_BIBO:
             return(ADOS_FUNC_NOT_SUPPORTED);
         case DOS_ATARIXE:
-            return(AtrXEDeleteDir(info, name));
+            return(AtrWriteBack(info, AtrXEDeleteDir(info, name)));
         case DOS_MYDOS:
-            return(AtrMyDosDeleteDir(info, name));
+            return(AtrWriteBack(info, AtrMyDosDeleteDir(info, name)));
         case DOS_SPARTA2:
-            return(AtrSpartaDeleteDir(info, name));
+            return(AtrWriteBack(info, AtrSpartaDeleteDir(info, name)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -543,11 +611,11 @@ int AtrMakeDir(AtrDiskInfo *info, char *name)
         case DOS_BIBO:
             return(ADOS_FUNC_NOT_SUPPORTED);
         case DOS_ATARIXE:
-            return(AtrXEMakeDir(info,name));
+            return(AtrWriteBack(info, AtrXEMakeDir(info,name)));
         case DOS_MYDOS:
-            return(AtrMyDosMakeDir(info,name));
+            return(AtrWriteBack(info, AtrMyDosMakeDir(info,name)));
         case DOS_SPARTA2:
-            return(AtrSpartaMakeDir(info,name));
+            return(AtrWriteBack(info, AtrSpartaMakeDir(info,name)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -559,17 +627,17 @@ int AtrLockFile(AtrDiskInfo *info, char *name, int lock)
         case DOS_ATARI1:
         case DOS_TOP:
         case DOS_BIBO:
-            return(AtrDos2LockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrDos2LockFile(info,name,lock)));
         case DOS_ATARI3:
-            return(AtrDos3LockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrDos3LockFile(info,name,lock)));
         case DOS_ATARI4:
-            return(AtrDos4LockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrDos4LockFile(info,name,lock)));
         case DOS_ATARIXE:
-            return(AtrXELockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrXELockFile(info,name,lock)));
         case DOS_MYDOS:
-            return(AtrMyDosLockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrMyDosLockFile(info,name,lock)));
         case DOS_SPARTA2:
-            return(AtrSpartaLockFile(info,name,lock));
+            return(AtrWriteBack(info, AtrSpartaLockFile(info,name,lock)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -581,17 +649,17 @@ int AtrRenameFile(AtrDiskInfo *info, char *name, char *newname)
         case DOS_ATARI1:
         case DOS_TOP:
         case DOS_BIBO:
-            return(AtrDos2RenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrDos2RenameFile(info, name,newname)));
         case DOS_ATARI3:
-            return(AtrDos3RenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrDos3RenameFile(info, name,newname)));
         case DOS_ATARI4:
-            return(AtrDos4RenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrDos4RenameFile(info, name,newname)));
         case DOS_ATARIXE:
-            return(AtrXERenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrXERenameFile(info, name,newname)));
         case DOS_MYDOS:
-            return(AtrMyDosRenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrMyDosRenameFile(info, name,newname)));
         case DOS_SPARTA2:
-            return(AtrSpartaRenameFile(info, name,newname));
+            return(AtrWriteBack(info, AtrSpartaRenameFile(info, name,newname)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -603,17 +671,17 @@ int AtrDeleteFile(AtrDiskInfo *info, char *name)
         case DOS_ATARI1:
         case DOS_TOP:
         case DOS_BIBO:
-            return(AtrDos2DeleteFile(info,name));
+            return(AtrWriteBack(info, AtrDos2DeleteFile(info,name)));
         case DOS_ATARI3:
-            return(AtrDos3DeleteFile(info,name));
+            return(AtrWriteBack(info, AtrDos3DeleteFile(info,name)));
         case DOS_ATARI4:
-            return(AtrDos4DeleteFile(info,name));
+            return(AtrWriteBack(info, AtrDos4DeleteFile(info,name)));
         case DOS_ATARIXE:
-            return(AtrXEDeleteFile(info,name));
+            return(AtrWriteBack(info, AtrXEDeleteFile(info,name)));
         case DOS_MYDOS:
-            return(AtrMyDosDeleteFile(info,name));
+            return(AtrWriteBack(info, AtrMyDosDeleteFile(info,name)));
         case DOS_SPARTA2:
-            return(AtrSpartaDeleteFile(info,name));
+            return(AtrWriteBack(info, AtrSpartaDeleteFile(info,name)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -625,17 +693,17 @@ int AtrImportFile(AtrDiskInfo *info, char *filename, int lfConvert, int tabConve
         case DOS_ATARI1:
         case DOS_TOP:
         case DOS_BIBO:
-            return(AtrDos2ImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrDos2ImportFile(info, filename, lfConvert, tabConvert)));
         case DOS_ATARI3:
-            return(AtrDos3ImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrDos3ImportFile(info, filename, lfConvert, tabConvert)));
         case DOS_ATARI4:
-            return(AtrDos4ImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrDos4ImportFile(info, filename, lfConvert, tabConvert)));
         case DOS_ATARIXE:
-            return(AtrXEImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrXEImportFile(info, filename, lfConvert, tabConvert)));
         case DOS_MYDOS:
-            return(AtrMyDosImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrMyDosImportFile(info, filename, lfConvert, tabConvert)));
         case DOS_SPARTA2:
-            return(AtrSpartaImportFile(info, filename, lfConvert, tabConvert));
+            return(AtrWriteBack(info, AtrSpartaImportFile(info, filename, lfConvert, tabConvert)));
         }
     return(ADOS_UNKNOWN_FORMAT);
 }
@@ -696,6 +764,43 @@ static void SizeOfSector(AtrDiskInfo *info, int sector, int *sz, ULONG * ofs)
 		*ofs = offset;
 }
 
+/* Reads the whole image into memory, so that sector access doesn't go
+   through the file. Falls back to file access if there is no memory for it. */
+static int AtrLoadImage(AtrDiskInfo *info, ULONG file_length)
+{
+	ULONG offset;
+	int size;
+
+	SizeOfSector(info, info->atr_sectorcount, &size, &offset);
+	if (info->atr_sectorcount < 1 || offset + size < file_length)
+		info->atr_image_size = file_length;
+	else
+		info->atr_image_size = offset + size;
+
+	info->atr_image = (UBYTE *) calloc(1, info->atr_image_size);
+	info->atr_dirty = (UBYTE *) calloc(1, info->atr_sectorcount + 1);
+	if (info->atr_image == NULL || info->atr_dirty == NULL) {
+		free(info->atr_image);
+		free(info->atr_dirty);
+		info->atr_image = NULL;
+		info->atr_dirty = NULL;
+		return FALSE;
+	}
+
+	fseek(info->atr_file, 0L, SEEK_SET);
+	if (fread(info->atr_image, 1, file_length, info->atr_file) < file_length)
+		return ADOS_DISK_READ_ERR;
+	return FALSE;
+}
+
+/* Completes a call that changed the image by writing it back */
+static int AtrWriteBack(AtrDiskInfo *info, int stat)
+{
+    int flushStat = AtrFlush(info);
+
+    return stat ? stat : flushStat;
+}
+
 static int AtrSeekSector(AtrDiskInfo *info, int sector)
 {
 	ULONG offset;
@@ -7,10 +7,14 @@ typedef struct atrDiskInfo {
 	int atr_boot_sectors_type;
 	int atr_dostype;
 	void *atr_dosinfo;
+	UBYTE *atr_image;		/* whole image file, header included */
+	ULONG atr_image_size;
+	UBYTE *atr_dirty;		/* per sector, written since the last AtrFlush */
 	} AtrDiskInfo;
 
 
 int AtrMount(const char *filename, int *dosType, int *readWrite, int *writeProtect, AtrDiskInfo **info);
+int AtrMountReadOnly(const char *filename, int *dosType, int *writeProtect, AtrDiskInfo **info);
 void AtrUnmount(AtrDiskInfo *info);
 int AtrSetWriteProtect(AtrDiskInfo *info, int writeProtect);
 int AtrSectorSize(AtrDiskInfo *info);
@@ -18,6 +22,7 @@ int AtrSectorNumberSize(AtrDiskInfo *info, int sector);
 int AtrSectorCount(AtrDiskInfo *info);
 int AtrReadSector(AtrDiskInfo *info, int sector, UBYTE * buffer);
 int AtrWriteSector(AtrDiskInfo *info, int sector, UBYTE * buffer);
+int AtrFlush(AtrDiskInfo *info);
 
 int AtrGetDir(AtrDiskInfo *info, UWORD *fileCount, ADosFileEntry *files, ULONG *freeBytes);
 int AtrChangeDir(AtrDiskInfo *info, int cdFlag, char *name);
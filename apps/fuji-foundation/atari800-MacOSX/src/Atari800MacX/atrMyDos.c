@@ -81,7 +81,6 @@ static UWORD AtrMyDosGetFreeSector(AtrDiskInfo *info);
 static UWORD AtrMyDosGetFreeSectorBlock(AtrDiskInfo *info, int count);
 static int AtrMyDosReadVtoc(AtrDiskInfo *info, UWORD *freeSectors);
 static int AtrMyDosWriteVtoc(AtrDiskInfo *info);
-static int AtrMyDosIsSectorUsed(AtrDiskInfo *info, UWORD sector);
 static void AtrMyDosMarkSectorUsed(AtrDiskInfo *info, UWORD sector, int used);
 static MyDosDirEntry *AtrMyDosFindFreeDirEntry(AtrDiskInfo *info);
 static void AtrMyDosDeleteDirList(AtrDiskInfo *info);
@@ -703,16 +702,19 @@ int AtrMyDosExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 	{
 		if ( sector < 1 || (sector > AtrSectorCount(info)))
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 
 		if ( ( secBuff[ sectorSize - 1 ] & 0x80 ) && ( sectorSize == 0x80 ) )
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 
 		if ( AtrReadSector(info,sector, secBuff))
 		{
+			fclose(output);
 			return ADOS_FILE_READ_ERR;
 		}
 		
@@ -744,6 +746,7 @@ int AtrMyDosExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, int
 		if ( ! ( secBuff[ sectorSize - 1 ] & 128 ) && 
                ( sectorSize == 128 ) && sector)
 		{
+			fclose(output);
 			return ADOS_FILE_CORRUPTED;
 		}
 	}
@@ -854,37 +857,23 @@ static MyDosDirEntry *AtrMyDosFindDirEntryByName(AtrDiskInfo *info, char *name)
 
 static UWORD AtrMyDosGetFreeSector(AtrDiskInfo *info)
 {
-    UWORD i;
+    int sector;
+	AtrMyDosDiskInfo *dinfo = (AtrMyDosDiskInfo *)info->atr_dosinfo;
 
-    for (i=1;i<=AtrSectorCount(info)+1;i++)
-        {
-        if (!AtrMyDosIsSectorUsed(info,i) )
-            {
-            return i;
-            }
-        }
+    sector = AtrBitmapFindFree(dinfo->vtocMap, 1, AtrSectorCount(info)+2);
+    if (sector >= 0)
+        return sector;
     return  0;
 }
 
 static UWORD AtrMyDosGetFreeSectorBlock(AtrDiskInfo *info, int count)
 {
-    UWORD i,j;
-    int blockFree;
+    int sector;
+	AtrMyDosDiskInfo *dinfo = (AtrMyDosDiskInfo *)info->atr_dosinfo;
 
-    for (i=1;i<=AtrSectorCount(info)+1-count;i++)
-        {
-        if (!AtrMyDosIsSectorUsed(info,i) )
-            {
-            blockFree = TRUE;
-            for (j=i;j<i+count;j++) {
-                if (AtrMyDosIsSectorUsed(info,j)) {
-                    blockFree=FALSE;
-                    }
-                }
-            if (blockFree)
-                return i;
-            }
-        }
+    sector = AtrBitmapFindFreeRun(dinfo->vtocMap, 1, AtrSectorCount(info)+1, count);
+    if (sector >= 0)
+        return sector;
     return  0;
 }
 
@@ -963,12 +952,7 @@ static int AtrMyDosWriteVtoc(AtrDiskInfo *info)
             secBuf[i] = dinfo->vtocMap[j++];
         if ( sector == VTOC )
             {
-        	freeSectors = 0;
-        	for (i=0;i<(AtrSectorCount(info)+1);i++) 
-            	{
-            	if (!AtrMyDosIsSectorUsed(info,i)) 
-                	freeSectors++;
-            	}
+        	freeSectors = AtrBitmapCountFree(dinfo->vtocMap, 0, AtrSectorCount(info)+1);
             secBuf[3] = (UWORD)(freeSectors&255);
             secBuf[4] = (UWORD)(freeSectors>>8);
             }
@@ -981,18 +965,6 @@ static int AtrMyDosWriteVtoc(AtrDiskInfo *info)
 
 }
 
-static int AtrMyDosIsSectorUsed(AtrDiskInfo *info, UWORD sector)
-{
-    UWORD entry;
-    UBYTE mask;
-    UBYTE maskTable[] = {128, 64, 32, 16, 8, 4, 2, 1};
-	AtrMyDosDiskInfo *dinfo = (AtrMyDosDiskInfo *)info->atr_dosinfo;
-
-    entry = sector / 8;
-    mask = maskTable[ sector & 7];
-    return ( !(dinfo->vtocMap[entry] & mask) );
-}
-
 static void AtrMyDosMarkSectorUsed(AtrDiskInfo *info, UWORD sector, int used)
 {
     UWORD entry;
@@ -133,7 +133,6 @@ static UWORD AtrSpartaGetFreeSectorFile(AtrDiskInfo *info);
 static UWORD AtrSpartaGetFreeSectorDir(AtrDiskInfo *info);
 static int AtrSpartaReadVtoc(AtrDiskInfo *info);
 static int AtrSpartaWriteVtoc(AtrDiskInfo *info);
-static int AtrSpartaIsSectorUsed(AtrDiskInfo *info, UWORD sector);
 static void AtrSpartaMarkSectorUsed(AtrDiskInfo *info, UWORD sector,
                                     int used, ULONG dir);
 static void AtrSpartaDeleteDirList(AtrDiskInfo *info);
@@ -922,6 +921,7 @@ int AtrSpartaExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile, in
         
         if ( AtrReadSector(info,sector, secBuff))
 		    {
+			fclose(output);
 			return ADOS_FILE_READ_ERR;
 		    }
 			
@@ -1120,6 +1120,7 @@ static int AtrReadSectorMap(AtrDiskInfo *info, UWORD startSector)
     UWORD nextSector;
     UWORD sector;
     int i;
+    int mapSectors = 1;
 	AtrSpartaDiskInfo *dinfo = (AtrSpartaDiskInfo *)info->atr_dosinfo;
     UWORD secPtrsPerSec = (dinfo->sectorSize - 4)/2;
     
@@ -1136,6 +1137,9 @@ static int AtrReadSectorMap(AtrDiskInfo *info, UWORD startSector)
             sector =  *mapPtr + ((*(mapPtr+1)) << 8);
             
             if (sector) {
+                /* Don't overrun the map on a corrupted disk */
+                if (dinfo->sectorMapCount >= sizeof(dinfo->sectorMap)/sizeof(UWORD))
+                    return(ADOS_FILE_CORRUPTED);
                 dinfo->sectorMap[dinfo->sectorMapCurr++] = *mapPtr + ((*(mapPtr+1)) << 8);
                 dinfo->sectorMapCount++;
                 mapPtr += 2;
@@ -1146,6 +1150,9 @@ static int AtrReadSectorMap(AtrDiskInfo *info, UWORD startSector)
 
         nextSector = secBuff[0] + (secBuff[1] << 8);
         
+        /* Stop at a map chain that loops back */
+        if (nextSector && ++mapSectors > AtrSectorCount(info))
+            return(ADOS_FILE_CORRUPTED);
         if (nextSector) 
             if (AtrReadSector(info,nextSector, secBuff)) 
                 return(ADOS_FILE_READ_ERR);
@@ -1359,32 +1366,27 @@ static SpartaDirEntry *AtrSpartaFindDirEntryByName(AtrDiskInfo *info, char *name
 
 static UWORD AtrSpartaGetFreeSectorFile(AtrDiskInfo *info)
 {
-    UWORD i;
+    int sector;
 	AtrSpartaDiskInfo *dinfo = (AtrSpartaDiskInfo *)info->atr_dosinfo;
 
-    for (i=dinfo->dataSectorSearchStart;i<=AtrSectorCount(info)+1;i++)
-        {
-        if (!AtrSpartaIsSectorUsed(info,i) )
-            return i;
-        }
+    sector = AtrBitmapFindFree(dinfo->vtocMap, dinfo->dataSectorSearchStart,
+                               AtrSectorCount(info)+2);
+    if (sector >= 0)
+        return sector;
     return  AtrSpartaGetFreeSectorDir(info);
 }
 
 static UWORD AtrSpartaGetFreeSectorDir(AtrDiskInfo *info)
 {
-    UWORD i;
+    int sector;
 	AtrSpartaDiskInfo *dinfo = (AtrSpartaDiskInfo *)info->atr_dosinfo;
 
-    for (i=dinfo->dirSectorSearchStart;i<=AtrSectorCount(info)+1;i++)
-        {
-        if (!AtrSpartaIsSectorUsed(info,i) )
-            return i;
-         }
-    for (i=0;i<dinfo->dirSectorSearchStart;i++)
-        {
-        if (!AtrSpartaIsSectorUsed(info,i) )
-             return i;
-        }
+    sector = AtrBitmapFindFree(dinfo->vtocMap, dinfo->dirSectorSearchStart,
+                               AtrSectorCount(info)+2);
+    if (sector < 0)
+        sector = AtrBitmapFindFree(dinfo->vtocMap, 0, dinfo->dirSectorSearchStart);
+    if (sector >= 0)
+        return sector;
     return  0;
 }
 
@@ -1433,12 +1435,7 @@ static int AtrSpartaWriteVtoc(AtrDiskInfo *info)
             return stat;
         }
     
-    freeSectors = 0;
-    for (i=0;i<(dinfo->totalSectors+1);i++) 
-       {
-       if (!AtrSpartaIsSectorUsed(info,i)) 
-          freeSectors++;
-       }
+    freeSectors = AtrBitmapCountFree(dinfo->vtocMap, 0, dinfo->totalSectors+1);
 
     stat = AtrReadSector(info, 1, secBuf);
     if ( stat )
@@ -1462,18 +1459,6 @@ static int AtrSpartaWriteVtoc(AtrDiskInfo *info)
 
 }
 
-static int AtrSpartaIsSectorUsed(AtrDiskInfo *info, UWORD sector)
-{
-    UWORD entry;
-    UBYTE mask;
-    UBYTE maskTable[] = {128, 64, 32, 16, 8, 4, 2, 1};
-	AtrSpartaDiskInfo *dinfo = (AtrSpartaDiskInfo *)info->atr_dosinfo;
-
-    entry = sector / 8;
-    mask = maskTable[ sector & 7];
-    return ( !(dinfo->vtocMap[entry] & mask) );
-}
-
 static void AtrSpartaMarkSectorUsed(AtrDiskInfo *info, UWORD sector, 
                                      int used, ULONG dir)
 {
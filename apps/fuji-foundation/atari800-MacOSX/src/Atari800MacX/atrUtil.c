@@ -185,3 +185,71 @@ void HostTabToAtari(unsigned char *buffer, int len)
         }
 }
 
+
+/* VTOC bitmaps hold one bit per sector, most significant bit first, set
+ * when the sector is free.  The searches below skip a word of used sectors
+ * at a time, so allocating on a nearly full disk doesn't test every bit.
+ */
+#define BIT_FREE(map, bit) ((map)[(bit) >> 3] & (0x80 >> ((bit) & 7)))
+
+/* Returns the first free bit in first..end-1, or -1 */
+int AtrBitmapFindFree(const UBYTE *map, int first, int end)
+{
+    int bit = first;
+    ULONG word;
+
+    while (bit < end) {
+        if ((bit & 31) == 0 && bit + 32 <= end) {
+            memcpy(&word, map + (bit >> 3), sizeof(word));
+            if (word == 0) {
+                bit += 32;
+                continue;
+                }
+            }
+        if ((bit & 7) == 0 && map[bit >> 3] == 0) {
+            bit += 8;
+            continue;
+            }
+        if (BIT_FREE(map, bit))
+            return bit;
+        bit++;
+        }
+    return -1;
+}
+
+/* Returns the first of count free bits in a row in first..end-1, or -1 */
+int AtrBitmapFindFreeRun(const UBYTE *map, int first, int end, int count)
+{
+    int start, bit;
+
+    start = AtrBitmapFindFree(map, first, end);
+    while (start >= 0 && start + count <= end) {
+        for (bit = start + 1; bit < start + count; bit++)
+            if (!BIT_FREE(map, bit))
+                break;
+        if (bit == start + count)
+            return start;
+        start = AtrBitmapFindFree(map, bit + 1, end);
+        }
+    return -1;
+}
+
+/* Returns the number of free bits in first..end-1 */
+int AtrBitmapCountFree(const UBYTE *map, int first, int end)
+{
+    static const UBYTE nibbleBits[16] = {0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4};
+    int bit = first;
+    int count = 0;
+
+    while (bit < end && (bit & 7) != 0) {
+        if (BIT_FREE(map, bit))
+            count++;
+        bit++;
+        }
+    for (; bit + 8 <= end; bit += 8)
+        count += nibbleBits[map[bit >> 3] >> 4] + nibbleBits[map[bit >> 3] & 15];
+    for (; bit < end; bit++)
+        if (BIT_FREE(map, bit))
+            count++;
+    return count;
+}
@@ -6,6 +6,9 @@ void AtariLFToHost(unsigned char *buffer, int len);
 void HostLFToAtari(unsigned char *buffer, int len);
 void AtariTabToHost(unsigned char *buffer, int len);
 void HostTabToAtari(unsigned char *buffer, int len);
+int AtrBitmapFindFree(const UBYTE *map, int first, int end);
+int AtrBitmapFindFreeRun(const UBYTE *map, int first, int end, int count);
+int AtrBitmapCountFree(const UBYTE *map, int first, int end);
 
 
 typedef struct ADosFileEntry {
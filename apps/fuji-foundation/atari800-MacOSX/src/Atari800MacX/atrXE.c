@@ -122,7 +122,6 @@ static XEDirEntry *AtrXEFindDirEntryByName(AtrDiskInfo *info, char *name);
 static UWORD AtrXEGetFreeBlock(AtrDiskInfo *info);
 static int AtrXEReadVtoc(AtrDiskInfo *info, UWORD *freeBlocks);
 static int AtrXEWriteVtoc(AtrDiskInfo *info);
-static int AtrXEIsBlockUsed(AtrDiskInfo *info, UWORD block);
 static void AtrXEMarkBlockUsed(AtrDiskInfo *info, UWORD block, int used);
 static void AtrXEDeleteDirList(AtrDiskInfo *info);
 static void AtrXEDeleteDirEntryList(AtrDiskInfo *info);
@@ -865,6 +864,7 @@ int AtrXEExportFile(AtrDiskInfo *info, char *nameToExport, char* outFile,
 
         if ( AtrXEReadBlock(info,block, blockBuff))
 		    {
+			fclose(output);
 			return ADOS_FILE_READ_ERR;
 		    }
 			
@@ -1087,6 +1087,7 @@ static int AtrXEReadBlockMap(AtrDiskInfo *info, UWORD *blockMapList)
     UWORD nextBlock;
     UWORD block;
     int i;
+    int mapBlocks = 1;
 	AtrXEDiskInfo *dinfo = (AtrXEDiskInfo *)info->atr_dosinfo;
 
     if (AtrXEReadBlock(info,*blockMapList++, blockBuff)) 
@@ -1102,6 +1103,9 @@ static int AtrXEReadBlockMap(AtrDiskInfo *info, UWORD *blockMapList)
             block =  *mapPtr + ((*(mapPtr+1)) << 8);
             
             if (block) {
+                /* Don't overrun the map on a corrupted disk */
+                if (dinfo->blockMapCount >= sizeof(dinfo->blockMap)/sizeof(UWORD))
+                    return(ADOS_FILE_CORRUPTED);
                 dinfo->blockMap[dinfo->blockMapCurr++] = 
                     *mapPtr + ((*(mapPtr+1)) << 8);
                 dinfo->blockMapCount++;
@@ -1111,7 +1115,8 @@ static int AtrXEReadBlockMap(AtrDiskInfo *info, UWORD *blockMapList)
                 break;
             }
             
-        nextBlock = *blockMapList;
+        /* A directory entry holds at most 12 map blocks */
+        nextBlock = mapBlocks++ < 12 ? *blockMapList : 0;
 
         if (nextBlock) 
             if (AtrXEReadBlock(info,*blockMapList++, blockBuff)) 
@@ -1208,20 +1213,18 @@ static XEDirEntry *AtrXEFindDirEntryByName(AtrDiskInfo *info, char *name)
 
 static UWORD AtrXEGetFreeBlock(AtrDiskInfo *info)
 {
-    UWORD i;
+	AtrXEDiskInfo *dinfo = (AtrXEDiskInfo *)info->atr_dosinfo;
 	UWORD blockCount;
+	int bit;
 
 	blockCount = AtrSectorCount(info);
 	if (AtrSectorSize(info) == 128)
         blockCount /= 2;
 
-    for (i=1;blockCount+1;i++)
-        {
-        if (!AtrXEIsBlockUsed(info,i) )
-            {
-            return i;
-            }
-        }
+    /* Block numbers start at 1, bits in the map at 0 */
+    bit = AtrBitmapFindFree(dinfo->vtocMap + 10, 0, blockCount);
+    if (bit >= 0)
+        return bit + 1;
 
     return  0;
 }
@@ -1246,16 +1249,12 @@ static int AtrXEWriteVtoc(AtrDiskInfo *info)
 	AtrXEDiskInfo *dinfo = (AtrXEDiskInfo *)info->atr_dosinfo;
 	UWORD blockCount;
 	UWORD freeBlocks;
-	int i;
 
 	blockCount = AtrSectorCount(info);
 	if (AtrSectorSize(info) == 128)
         blockCount /= 2;
 
-    freeBlocks = 0;
-    for (i=1;i<blockCount+1;i++)
-        if (!AtrXEIsBlockUsed(info,i))
-            freeBlocks++;
+    freeBlocks = AtrBitmapCountFree(dinfo->vtocMap + 10, 0, blockCount);
     dinfo->vtocMap[4] = freeBlocks & 0xFF;
     dinfo->vtocMap[5] = freeBlocks >> 8;
     
@@ -1269,18 +1268,6 @@ static int AtrXEWriteVtoc(AtrDiskInfo *info)
 
 }
 
-static int AtrXEIsBlockUsed(AtrDiskInfo *info, UWORD block)
-{
-    UWORD entry;
-    UBYTE mask;
-    UBYTE maskTable[] = {128, 64, 32, 16, 8, 4, 2, 1};
-	AtrXEDiskInfo *dinfo = (AtrXEDiskInfo *)info->atr_dosinfo;
-
-    entry = (block-1) / 8;
-    mask = maskTable[ (block-1) & 7];
-    return ( !(dinfo->vtocMap[entry + 10] & mask) );
-}
-
 static void AtrXEMarkBlockUsed(AtrDiskInfo *info, UWORD block, int used)
 {
     UWORD entry;
@@ -102,6 +102,19 @@
 /* Define if you have the function fstat  */
 #define HAVE_FSTAT 1
 
+/* Define if you have the function mmap  */
+#define HAVE_MMAP 1
+
+/* Define if you have the function funopen  */
+#ifdef __APPLE__
+#define HAVE_FUNOPEN 1
+#endif
+
+/* Define if you have the function fopencookie (for the Linux tools in util) */
+#ifdef __linux__
+#define HAVE_FOPENCOOKIE 1
+#endif
+
 /* Define if you have the function stat  */
 #define HAVE_STAT 1
 
@@ -310,6 +323,9 @@
 /* Display LED on screen */
 #define SHOW_DISK_LED */
 
+/* Define to time the emulation hot paths (perf.h, Atari800Core_GetPerfCounters) */
+/* #undef PERF_COUNTERS */
+
 /* color change inside a scanline */
 #define CYCLE_EXACT
 #define NEW_CYCLE_EXACT
@@ -31,13 +31,16 @@
 #include "antic.h"
 #include "atari.h"
 #include "cpu.h"
+#include "cputrace.h"
 #include "gtia.h"
 #include "memory.h"
 #include "monitor.h"
 #include "pia.h"
 #include "pokey.h"
+#include "profiler.h"
 #include "prompts.h"
 #include "sio.h"
+#include "symtable.h"
 #include "util.h"
 #include <stdarg.h>
 #ifdef STEREO_SOUND
@@ -53,7 +56,6 @@ extern int instruction_count[256];
 #endif
 extern int cycles[256];
 
-extern UBYTE *atarixe_memory;
 extern ULONG atarixe_memory_size;
 extern int ControlManagerMonitorPrintf(const char *format, ...);
 extern int ControlManagerMonitorPuts(const char *string);
@@ -368,38 +370,72 @@ static symtable_rec *symtable_user = NULL;
 static int symtable_user_size = 0;
 #endif
 
-static const char *find_label_name(UWORD addr, int write)
+/* Indexes of symtable_user and of the built-in table for the current
+   machine. */
+static SYMTABLE_Index symindex_user;
+static SYMTABLE_Index symindex_builtin;
+static const symtable_rec *symindex_builtin_table = NULL;
+
+/* Returns the built-in table for the current machine, indexed. */
+static const symtable_rec *builtin_labels(void)
 {
-	int i;
-	for (i = 0; i < symtable_user_size; i++) {
-		if (symtable_user[i].addr == addr)
-			return symtable_user[i].name;
+	const symtable_rec *table = Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin;
+	if (table != symindex_builtin_table) {
+		SYMTABLE_IndexBuiltin(&symindex_builtin, table);
+		symindex_builtin_table = table;
 	}
+	return table;
+}
+
+static const char *find_label_name(UWORD addr, int write)
+{
+	int i = SYMTABLE_FindAddr(&symindex_user, addr, FALSE);
+	if (i >= 0)
+		return symtable_user[i].name;
 	if (symtable_builtin_enable) {
-		const symtable_rec *p;
-		for (p = (Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin); p->name != NULL; p++) {
-			if (p->addr == addr) {
-				if (write && p[1].addr == addr)
-					p++;
-				return p->name;
-			}
-		}
+		const symtable_rec *table = builtin_labels();
+		i = SYMTABLE_FindAddr(&symindex_builtin, addr, write);
+		if (i >= 0)
+			return table[i].name;
 	}
 	return NULL;
 }
 
+static const char *profiler_label(UWORD addr)
+{
+	return find_label_name(addr, FALSE);
+}
+
+static void show_profile_hot(int count)
+{
+	PROFILER_Hot hot[100];
+	unsigned long long insns, cycles;
+	int n, i;
+
+	PROFILER_GetTotals(&insns, &cycles);
+	if (cycles == 0) {
+		mon_printf("No profile data\n");
+		return;
+	}
+	if (count > 100)
+		count = 100;
+	n = PROFILER_GetHot(hot, count);
+	mon_printf("Addr Label           Count       Cycles     %%\n");
+	for (i = 0; i < n; i++) {
+		const char *name = find_label_name(hot[i].addr, FALSE);
+		mon_printf("%04X %-12.12s %10lu %12llu %5.1f\n", hot[i].addr, name != NULL ? name : "",
+		           hot[i].count, hot[i].cycles, hot[i].cycles * 100.0 / cycles);
+	}
+}
+
 #ifdef MACOSX_MON_ENHANCEMENTS
 symtable_rec *find_user_label(const char *name)
 #else
 static symtable_rec *find_user_label(const char *name)
 #endif
 {
-	int i;
-	for (i = 0; i < symtable_user_size; i++) {
-		if (Util_stricmp(symtable_user[i].name, name) == 0)
-			return &symtable_user[i];
-	}
-	return NULL;
+	int i = SYMTABLE_FindName(&symindex_user, symtable_user, name);
+	return i >= 0 ? &symtable_user[i] : NULL;
 }
 
 #ifdef MACOSX_MON_ENHANCEMENTS
@@ -412,10 +448,10 @@ static int find_label_value(const char *name)
 	if (p != NULL)
 		return p->addr;
 	if (symtable_builtin_enable) {
-		for (p = (Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin); p->name != NULL; p++) {
-			if (Util_stricmp(p->name, name) == 0)
-				return p->addr;
-		}
+		const symtable_rec *table = builtin_labels();
+		int i = SYMTABLE_FindName(&symindex_builtin, table, name);
+		if (i >= 0)
+			return table[i].addr;
 	}
 	return -1;
 }
@@ -432,6 +468,7 @@ static void free_user_labels(void)
 		free(symtable_user);
 		symtable_user = NULL;
 	}
+	SYMTABLE_Free(&symindex_user);
 }
 
 #ifdef MACOSX_MON_ENHANCEMENTS
@@ -451,9 +488,19 @@ static void add_user_label(const char *name, UWORD addr)
 	}
 	symtable_user[symtable_user_size].name = Util_strdup(name);
 	symtable_user[symtable_user_size].addr = addr;
+	SYMTABLE_Add(&symindex_user, symtable_user, symtable_user_size);
 	symtable_user_size++;
 }
 
+#ifdef MACOSX_MON_ENHANCEMENTS
+void move_user_label(symtable_rec *p, UWORD addr)
+#else
+static void move_user_label(symtable_rec *p, UWORD addr)
+#endif
+{
+	SYMTABLE_Move(&symindex_user, symtable_user, (int) (p - symtable_user), addr);
+}
+
 #ifdef MACOSX_MON_ENHANCEMENTS
 void load_user_labels(const char *filename)
 #else
@@ -741,11 +788,6 @@ static UBYTE get_dlist_byte(UWORD *addr)
 	return result;
 }
 
-#ifdef MONITOR_TRACE
-int MONITOR_tron;
-FILE *MONITOR_trace_file;
-#endif
-
 /*
  * The following array is used for 6502 instruction profiling
  */
@@ -849,40 +891,40 @@ void MONITOR_monitorEnter(void)
 
 
 	show_instruction(CPU_regPC,22);
-	optype=MONITOR_optype6502[MEMORY_mem[CPU_regPC]]>>4;
+	optype=MONITOR_optype6502[MEMORY_dGetByte(CPU_regPC)]>>4;
 	switch (optype)
 	{
 	case 0x1:
-	    value=MEMORY_mem[CPU_regPC+1]+(MEMORY_mem[CPU_regPC+2]<<8);
-	    value=MEMORY_mem[value];
+	    value=MEMORY_dGetByte(CPU_regPC+1)+(MEMORY_dGetByte(CPU_regPC+2)<<8);
+	    value=MEMORY_dGetByte(value);
 	    break;
 	case 0x2:
-	    value=MEMORY_mem[MEMORY_mem[CPU_regPC+1]];
+	    value=MEMORY_dGetByte(MEMORY_dGetByte(CPU_regPC+1));
 	    break;
 	case 0x3:
-	    value=MEMORY_mem[(MEMORY_mem[CPU_regPC+2]<<8)+MEMORY_mem[CPU_regPC+1]+CPU_regX];
+	    value=MEMORY_dGetByte((UWORD)((MEMORY_dGetByte(CPU_regPC+2)<<8)+MEMORY_dGetByte(CPU_regPC+1)+CPU_regX));
 	    break;
 	case 0x4:
-	    value=MEMORY_mem[(MEMORY_mem[CPU_regPC+2]<<8)+MEMORY_mem[CPU_regPC+1]+CPU_regY];
+	    value=MEMORY_dGetByte((UWORD)((MEMORY_dGetByte(CPU_regPC+2)<<8)+MEMORY_dGetByte(CPU_regPC+1)+CPU_regY));
 	    break;
 	case 0x5:
-	    value=(UBYTE)(MEMORY_mem[CPU_regPC+1]+CPU_regX);
-	    value=(MEMORY_mem[(UBYTE)(value+1)]<<8)+MEMORY_mem[value];
-	    value=MEMORY_mem[value];
+	    value=(UBYTE)(MEMORY_dGetByte(CPU_regPC+1)+CPU_regX);
+	    value=(MEMORY_dGetByte((UBYTE)(value+1))<<8)+MEMORY_dGetByte(value);
+	    value=MEMORY_dGetByte(value);
 	    break;
 	case 0x6:
-	    value=MEMORY_mem[CPU_regPC+1];
-	    value=(MEMORY_mem[(UBYTE)(value+1)]<<8)+MEMORY_mem[value]+CPU_regY;
-	    value=MEMORY_mem[value];
+	    value=MEMORY_dGetByte(CPU_regPC+1);
+	    value=(MEMORY_dGetByte((UBYTE)(value+1))<<8)+MEMORY_dGetByte(value)+CPU_regY;
+	    value=MEMORY_dGetByte(value);
 	    break;
 	case 0x7:
-	    value=MEMORY_mem[(UBYTE)(MEMORY_mem[CPU_regPC+1]+CPU_regX)];
+	    value=MEMORY_dGetByte((UBYTE)(MEMORY_dGetByte(CPU_regPC+1)+CPU_regX));
 	    break;
 	case 0x8:
-	    value=MEMORY_mem[(UBYTE)(MEMORY_mem[CPU_regPC+1]+CPU_regX)];
+	    value=MEMORY_dGetByte((UBYTE)(MEMORY_dGetByte(CPU_regPC+1)+CPU_regX));
 	    break;
 	case 0x9:
-	    switch(MEMORY_mem[CPU_regPC])
+	    switch(MEMORY_dGetByte(CPU_regPC))
 	    {
 	        case 0x10:  /*BPL*/
 	        if (!(CPU_regP & CPU_N_FLAG)) value=1;
@@ -912,26 +954,26 @@ void MONITOR_monitorEnter(void)
 	    if (value==1) mon_printf("(Y) "); else mon_printf("(N) ");
 	    break;
 	case 0xb:
-	    value=MEMORY_mem[0x100+(UBYTE)(CPU_regS+1)]+(MEMORY_mem[0x100+(UBYTE)(CPU_regS+2)]<<8)+1;
+	    value=MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+1))+(MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+2))<<8)+1;
 	    break;
 	case 0xc:
-	    value=MEMORY_mem[0x100+(UBYTE)(CPU_regS+2)]+(MEMORY_mem[0x100+(UBYTE)(CPU_regS+3)]<<8);
+	    value=MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+2))+(MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+3))<<8);
 	    break;
 	case 0xd:
-	    value=MEMORY_mem[CPU_regPC+1]+(MEMORY_mem[CPU_regPC+2]<<8);
-	    value=MEMORY_mem[value]+(MEMORY_mem[value+1]<<8);
+	    value=MEMORY_dGetByte(CPU_regPC+1)+(MEMORY_dGetByte(CPU_regPC+2)<<8);
+	    value=MEMORY_dGetByte(value)+(MEMORY_dGetByte(value+1)<<8);
 	    break;
 	case 0xe:
-	    mon_printf("(ESC %02X) ",MEMORY_mem[CPU_regPC+1]);
-	    value=MEMORY_mem[0x100+(UBYTE)(CPU_regS+1)]+(MEMORY_mem[0x100+(UBYTE)(CPU_regS+2)]<<8)+1;
+	    mon_printf("(ESC %02X) ",MEMORY_dGetByte(CPU_regPC+1));
+	    value=MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+1))+(MEMORY_dGetByte(0x100+(UBYTE)(CPU_regS+2))<<8)+1;
 	    break;
 	case 0xf:
-	    mon_printf("(ESC %02X) ",MEMORY_mem[CPU_regPC+1]);
+	    mon_printf("(ESC %02X) ",MEMORY_dGetByte(CPU_regPC+1));
 	    break;
 
 	}
 	if (optype!=0x0 && optype!=0x9 && optype!=0xa && optype!=0xf &&
-	    MEMORY_mem[CPU_regPC]!=0x4c && MEMORY_mem[CPU_regPC]!=0x20)
+	    MEMORY_dGetByte(CPU_regPC)!=0x4c && MEMORY_dGetByte(CPU_regPC)!=0x20)
 	{
 		mon_printf("(%04X) ",value);
 	}
@@ -1245,7 +1287,7 @@ int MONITOR_monitorCmd(char *input)
 		else if (strcmp(t, "TRON") == 0) {
 			char *file;
 			
-			if (MONITOR_tron)
+			if (CPUTRACE_enabled)
 			{
 			    mon_printf("Trace is already on, use TROFF to turn off\n");
 			}
@@ -1253,21 +1295,16 @@ int MONITOR_monitorCmd(char *input)
 			{
 				file = get_token(NULL);
 				if (file) {
-					if ((MONITOR_trace_file = fopen(file,"w")))
-						MONITOR_tron = TRUE;
-					else {
+					if (!CPUTRACE_Start(file))
 						mon_printf("Error opening trace file %s\n", file);
-						}
 					}
 				else mon_printf("Usage: TRON file\n");
 			}
 		}
 
 		else if (strcmp(t, "TROFF") == 0) {
-			if (MONITOR_tron) {
-				fclose(MONITOR_trace_file);
-				MONITOR_tron = FALSE;
-			}
+			if (CPUTRACE_enabled && !CPUTRACE_Stop())
+				mon_printf("Error writing trace file\n");
 		}
 #endif
 
@@ -1283,6 +1320,39 @@ int MONITOR_monitorCmd(char *input)
 		}
 #endif
 
+		else if (strcmp(t, "PROF") == 0) {
+			char *arg = get_token(NULL);
+			if (arg == NULL) {
+				unsigned long long insns, cycles;
+				PROFILER_GetTotals(&insns, &cycles);
+				mon_printf("Profiler is %s, %llu instructions, %llu cycles\n",
+				           PROFILER_enabled ? "on" : "off", insns, cycles);
+			}
+			else if (Util_stricmp(arg, "ON") == 0)
+				PROFILER_Start();
+			else if (Util_stricmp(arg, "OFF") == 0)
+				PROFILER_Stop();
+			else if (Util_stricmp(arg, "CLEAR") == 0)
+				PROFILER_Reset();
+			else if (Util_stricmp(arg, "HOT") == 0) {
+				char *count = get_token(NULL);
+				int n = count != NULL ? Util_sscandec(count) : 20;
+				if (n > 0)
+					show_profile_hot(n);
+				else
+					mon_printf("Usage: PROF HOT [count]\n");
+			}
+			else if (Util_stricmp(arg, "SAVE") == 0) {
+				char *file = get_token(NULL);
+				if (file == NULL)
+					mon_printf("Usage: PROF SAVE file\n");
+				else if (!PROFILER_WriteFolded(file, profiler_label))
+					mon_printf("Error writing profile %s\n", file);
+			}
+			else
+				mon_printf("Usage: PROF [ON|OFF|CLEAR|HOT [count]|SAVE file]\n");
+		}
+
 		else if (strcmp(t, "SHOW") == 0) {
 			int i;
 #ifdef NEW_CYCLE_EXACT
@@ -1382,9 +1452,7 @@ int MONITOR_monitorCmd(char *input)
 
 			if (status) {
 				if (bank < (atarixe_memory_size/16384)) {
-					memcpy(atarixe_memory + (((long) MEMORY_xe_bank) << 14), MEMORY_mem + 0x4000, 16384);
-					memcpy(MEMORY_mem + 0x4000, atarixe_memory + (((long) bank) << 14), 16384);
-					MEMORY_xe_bank = bank;
+					MEMORY_SelectXEBank(bank);
 				}
 				else {
 					mon_printf("Error - Bank number larger than available memory\n");
@@ -1422,9 +1490,13 @@ int MONITOR_monitorCmd(char *input)
                 			mon_printf("Error reading file %s\n",filename);
 							}
 						else {
-							if (fread(&MEMORY_mem[addr], 1, nbytes, f) == 0) {
+							UBYTE *buffer = (UBYTE *) Util_malloc(nbytes);
+							size_t len = fread(buffer, 1, nbytes, f);
+							if (len == 0) {
                 				mon_printf("Error reading file %s\n",filename);
                 				}
+							MEMORY_dCopyToMem(buffer, addr, (int) len);
+							free(buffer);
 							fclose(f);
 						}
 					}
@@ -1440,6 +1512,7 @@ int MONITOR_monitorCmd(char *input)
 			int status1, status2, status3, status4;
 			int size;
 			ULONG offset;
+			UBYTE buffer[8192];
 
 			status1 = get_dec(NULL, &driveNo);
 			status2 = get_dec(NULL, &sector);
@@ -1456,11 +1529,12 @@ int MONITOR_monitorCmd(char *input)
 						}
 					else {
 						for (i=0;i<secCount;i++) {
-							if ((result = SIO_ReadSector(driveNo-1, sector+i, &MEMORY_mem[addr])) != 'C') {
+							if ((result = SIO_ReadSector(driveNo-1, sector+i, buffer)) != 'C') {
 								mon_printf("Error reading drive %d sector %d\n",driveNo, sector+i);
 								break;
 								}
 							SIO_SizeOfSector(driveNo-1,sector+i,&size,&offset);
+							MEMORY_dCopyToMem(buffer, addr, size);
 							addr += size;
 							}
 						}
@@ -1479,6 +1553,7 @@ int MONITOR_monitorCmd(char *input)
 			int status1, status2, status3, status4;
 			int size;
 			ULONG offset;
+			UBYTE buffer[8192];
 
 			status1 = get_dec(NULL, &driveNo);
 			status2 = get_dec(NULL, &sector);
@@ -1495,11 +1570,12 @@ int MONITOR_monitorCmd(char *input)
 						}
 					else {
 						for (i=0;i<secCount;i++) {
-							if ((result = SIO_WriteSector(driveNo-1, sector+i, &MEMORY_mem[addr])) != 'C') {
+							SIO_SizeOfSector(driveNo-1,sector+i,&size,&offset);
+							MEMORY_dCopyFromMem(addr, buffer, size);
+							if ((result = SIO_WriteSector(driveNo-1, sector+i, buffer)) != 'C') {
 								mon_printf("Error writing drive %d sector %d\n",driveNo, sector+i);
 								break;
 								}
-							SIO_SizeOfSector(driveNo-1,sector+i,&size,&offset);
 							addr += size;
 							}
 						}
@@ -1548,7 +1624,12 @@ int MONITOR_monitorCmd(char *input)
 						write_result &= (fwrite(&header[0], 1, 6, f) != -1);
 					}
 
-					write_result &= (fwrite(&MEMORY_mem[addr1], 1, addr2 - addr1 + 1, f) != -1);
+					{
+						UBYTE *buffer = (UBYTE *) Util_malloc(addr2 - addr1 + 1);
+						MEMORY_dCopyFromMem(addr1, buffer, addr2 - addr1 + 1);
+						write_result &= (fwrite(buffer, 1, addr2 - addr1 + 1, f) != -1);
+						free(buffer);
+					}
 
 					if ((status_init) && (init != 0x0000))
 					{
@@ -1644,7 +1725,7 @@ int MONITOR_monitorCmd(char *input)
 			addr2 = xaddr2;
 
 			for (addr = addr1; addr <= addr2; addr++)
-				MEMORY_mem[addr] = (UBYTE) (hexval & 0x00ff);
+				MEMORY_dPutByte(addr, (UBYTE) (hexval & 0x00ff));
 		}
 		else if (strcmp(t, "MM") == 0) {
 			int addr1;
@@ -1663,11 +1744,11 @@ int MONITOR_monitorCmd(char *input)
 
 			if (addr1 < addr2) {
 				for (i=count-1;i>=0;i--)
-					MEMORY_mem[addr2+i] = MEMORY_mem[addr1+i];
+					MEMORY_dPutByte((UWORD) (addr2+i), MEMORY_dGetByte((UWORD) (addr1+i)));
 				}
 			else {
 				for (i=0;i<count;i++)
-					MEMORY_mem[addr2+i] = MEMORY_mem[addr1+i];
+					MEMORY_dPutByte((UWORD) (addr2+i), MEMORY_dGetByte((UWORD) (addr1+i)));
 				}
 		}
 #endif
@@ -1747,18 +1828,18 @@ int MONITOR_monitorCmd(char *input)
 			return -2;
 #else			
 		/* with RTS, RTI, JMP, SKW, ESCRTS we simply do step */
-		        if (MEMORY_mem[CPU_regPC]==0x60 || MEMORY_mem[CPU_regPC]==0x40 || MEMORY_mem[CPU_regPC]==0x0c ||
-		            MEMORY_mem[CPU_regPC]==0x4c || MEMORY_mem[CPU_regPC]==0x6c || MEMORY_mem[CPU_regPC]==0xd2 ||
-		            MEMORY_mem[CPU_regPC]==0x1c || MEMORY_mem[CPU_regPC]==0x3c || MEMORY_mem[CPU_regPC]==0x5c ||
-		            MEMORY_mem[CPU_regPC]==0x7c || MEMORY_mem[CPU_regPC]==0xdc || MEMORY_mem[CPU_regPC]==0xfc ||
-		            MEMORY_mem[CPU_regPC]==0x9c )
+		        if (MEMORY_dGetByte(CPU_regPC)==0x60 || MEMORY_dGetByte(CPU_regPC)==0x40 || MEMORY_dGetByte(CPU_regPC)==0x0c ||
+		            MEMORY_dGetByte(CPU_regPC)==0x4c || MEMORY_dGetByte(CPU_regPC)==0x6c || MEMORY_dGetByte(CPU_regPC)==0xd2 ||
+		            MEMORY_dGetByte(CPU_regPC)==0x1c || MEMORY_dGetByte(CPU_regPC)==0x3c || MEMORY_dGetByte(CPU_regPC)==0x5c ||
+		            MEMORY_dGetByte(CPU_regPC)==0x7c || MEMORY_dGetByte(CPU_regPC)==0xdc || MEMORY_dGetByte(CPU_regPC)==0xfc ||
+		            MEMORY_dGetByte(CPU_regPC)==0x9c )
 		        {
 		          MONITOR_break_step=1;
 		          return -1;
 		        }
 		        else
 		        {
-		          MONITOR_break_addr=CPU_regPC+(UWORD)(MONITOR_optype6502[MEMORY_mem[CPU_regPC]]&0x3);
+		          MONITOR_break_addr=CPU_regPC+(UWORD)(MONITOR_optype6502[MEMORY_dGetByte(CPU_regPC)]&0x3);
 				  MONITOR_break_active=TRUE;
 				  break_over = TRUE;
 		          return -1;
@@ -2160,7 +2241,7 @@ int MONITOR_monitorCmd(char *input)
 						if (p != NULL) {
 							if (p->addr != addr) {
 								mon_printf("%s redefined (previous value: %04X)\n", name, p->addr);
-								p->addr = addr;
+								move_user_label(p, addr);
 							}
 						}
 						else
@@ -2309,7 +2390,7 @@ int MONITOR_monitorCmd(char *input)
 			mon_printf("WRITESEC drive# sector count addr  - Write disk sectors from memory\n");
 			mon_printf("SUM startaddr endaddr          - SUM of specified memory range\n");
 #ifdef MONITOR_TRACE
-			mon_printf("TRON file                      - Trace on\n");
+			mon_printf("TRON file                      - Trace on (read with util/tracedump)\n");
 			mon_printf("TROFF                          - Trace off\n");
 #endif
 #ifdef MONITOR_BREAK
@@ -2339,6 +2420,9 @@ int MONITOR_monitorCmd(char *input)
 #ifdef MONITOR_PROFILE
 			mon_printf("PROFILE                        - Display profiling statistics\n");
 #endif
+			mon_printf("PROF [ON|OFF|CLEAR]            - Control the code profiler\n");
+			mon_printf("PROF HOT [count]               - Show the addresses using most cycles\n");
+			mon_printf("PROF SAVE file                 - Write call stacks for flame graphs\n");
 #ifdef MONITOR_HINTS
 			mon_printf("LABELS file                    - Load labels from file (xasm format)\n");
 #endif
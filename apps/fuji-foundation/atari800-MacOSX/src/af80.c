@@ -24,6 +24,7 @@
 
 #include "af80.h"
 #include "atari.h"
+#include "col80.h"
 #include "util.h"
 #include "log.h"
 #include "memory.h"
@@ -153,6 +154,7 @@ static void init_af80(void)
     else {
         Log_print("loaded Austin Franklin charset image");
     }
+    COL80_InvalidateGlyphs();
 
     AF80_Reset();
 
@@ -344,14 +346,26 @@ void AF80_D5PutByte(UWORD addr, UBYTE byte)
 	D(if (addr!=0xd5f7 && addr!=0xd5f6) printf("AF80 Write addr:%4x byte:%2x, cpu:%4x\n", addr, byte,CPU_remember_PC[(CPU_remember_PC_curpos-1)%CPU_REMEMBER_PC_STEPS]));
 }
 
-UBYTE AF80_GetPixels(int scanline, int column, int *colour, int blink)
-{
 #define AF80_ROWS 25
 #define AF80_CELL_HEIGHT 10
+
+static int cell_screen_pos(int row, int column)
+{
+	int screen_pos;
+	if (row >= crtreg[0x10]) {
+		screen_pos = (row-crtreg[0x10])*80 + column + crtreg[0x0e] + ((crtreg[0x0f]&0x3f)<<8);
+	}
+	else {
+		screen_pos = row*80+column + crtreg[0x0c] + ((crtreg[0x0d]&0x3f)<<8);
+	}
+	return screen_pos & 0x7ff;
+}
+
+UBYTE AF80_GetPixels(int scanline, int column, int *colour, int blink)
+{
 	UBYTE character;
 	int attrib;
 	UBYTE font_data;
-	int table_start = crtreg[0x0c] + ((crtreg[0x0d]&0x3f)<<8);
 	int row = scanline / AF80_CELL_HEIGHT;
 	int line = scanline % AF80_CELL_HEIGHT;
 	int screen_pos;
@@ -359,13 +373,7 @@ UBYTE AF80_GetPixels(int scanline, int column, int *colour, int blink)
 		return 0;
 	}
 
-	if (row >= crtreg[0x10]) {
-		screen_pos = (row-crtreg[0x10])*80 + column + crtreg[0x0e] + ((crtreg[0x0f]&0x3f)<<8);
-	}
-	else {
-		screen_pos = row*80+column + table_start;
-	}
-	screen_pos &= 0x7ff;
+	screen_pos = cell_screen_pos(row, column);
 	character = af80_screen[screen_pos];
 	attrib = af80_attrib[screen_pos];
 	font_data = af80_charset[character*16 + line];
@@ -385,6 +393,40 @@ UBYTE AF80_GetPixels(int scanline, int column, int *colour, int blink)
 	return font_data;
 }
 
+ULONG AF80_GetCell(int row, int column)
+{
+	int screen_pos = cell_screen_pos(row, column);
+	int attrib = af80_attrib[screen_pos];
+	ULONG key = af80_screen[screen_pos] | COL80_KEY_SET_COLOUR(attrib>>4);
+	if (attrib & 0x01)
+		key |= COL80_KEY_INVERT;
+	if (attrib & 0x02)
+		key |= COL80_KEY_BLINK;
+	if (attrib & 0x04)
+		key |= COL80_KEY_UNDERLINE;
+	if (row == crtreg[0x18] && column == crtreg[0x19])
+		key |= COL80_KEY_CURSOR;
+	return key;
+}
+
+/* Renders a cell the way AF80_GetPixels() does, for the COL80 glyph cache. */
+void AF80_RenderGlyph(ULONG key, int blink, UBYTE *rows)
+{
+	int line;
+	for (line = 0; line < AF80_CELL_HEIGHT; line++) {
+		UBYTE font_data = af80_charset[(key & COL80_KEY_CHAR)*16 + line];
+		if (key & COL80_KEY_INVERT)
+			font_data ^= 0xff;
+		if ((key & COL80_KEY_BLINK) && blink)
+			font_data = 0x00;
+		if (line+1 == AF80_CELL_HEIGHT && (key & COL80_KEY_UNDERLINE))
+			font_data = 0xff;
+		if ((key & COL80_KEY_CURSOR) && !blink)
+			font_data = 0xff;
+		rows[line] = font_data;
+	}
+}
+
 void AF80_Reset(void)
 {
 	memset(af80_screen, 0, 0x800);
@@ -23,6 +23,9 @@ void AF80_D5PutByte(UWORD addr, UBYTE byte);
 int AF80_D6GetByte(UWORD addr, int no_side_effects);
 void AF80_D6PutByte(UWORD addr, UBYTE byte);
 UBYTE AF80_GetPixels(int scanline, int column, int *colour, int blink);
+/* Returns the COL80 key of the text cell at ROW, COLUMN. */
+ULONG AF80_GetCell(int row, int column);
+void AF80_RenderGlyph(ULONG key, int blink, UBYTE *rows);
 extern int AF80_enabled;
 void AF80_Reset(void);
 #ifdef ATARI800MACX
@@ -34,6 +34,7 @@
 #include "gtia.h"
 #include "log.h"
 #include "memory.h"
+#include "perf.h"
 #include "platform.h"
 #include "pokey.h"
 #include "util.h"
@@ -48,6 +49,19 @@
 #include "cycle_map.h"
 #endif
 
+/* Lines without any player/missile graphics in modes 2, E and F are
+   expanded 16 bytes at a time with NEON or SSSE3. DIRTYRECT needs every
+   store to go through WRITE_VIDEO, so it keeps the plain loops. */
+#if !defined(DIRTYRECT) && !defined(BASIC) && !defined(CURSES_BASIC)
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ANTIC_VECTOR_2BPP
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define ANTIC_VECTOR_2BPP
+#endif
+#endif
+
 #define LCHOP 3			/* do not build leftmost 0..3 characters in wide mode */
 #define RCHOP 3			/* do not build rightmost 0..3 characters in wide mode */
 
@@ -259,8 +273,9 @@ static UWORD *scrn_ptr;
    - if both conditions are true, then access memory instead of ANTIC_xe_ptr */
 
 /* Pointer to 16 KB seen by ANTIC in 0x4000-0x7fff.
-   If it's the same what the CPU sees (and what's in MEMORY_mem[0x4000..0x7fff],
-   then NULL. */
+   If it's base RAM (what's in MEMORY_mem[0x4000..0x7fff]), then NULL.
+   The CPU may see another bank there through MEMORY_cpu_map, so ANTIC
+   reads MEMORY_mem rather than MEMORY_dGetByte(). */
 const UBYTE *ANTIC_xe_ptr = NULL;
 
 /* ANTIC Timing --------------------------------------------------------------
@@ -869,7 +884,7 @@ static void pmg_dma(void)
 			if (ANTIC_xe_ptr != NULL && pmbase_s < 0x8000 && pmbase_s >= 0x4000)
 				data = ANTIC_xe_ptr[singleline ? pmbase_s + ANTIC_ypos + 0x300 - 0x4000 : pmbase_d + (ANTIC_ypos >> 1) + 0x180 - 0x4000];
 			else
-				data = MEMORY_dGetByte(singleline ? pmbase_s + ANTIC_ypos + 0x300 : pmbase_d + (ANTIC_ypos >> 1) + 0x180);
+				data = MEMORY_mem[singleline ? pmbase_s + ANTIC_ypos + 0x300 : pmbase_d + (ANTIC_ypos >> 1) + 0x180];
 			/* in odd lines load all missiles, in even only those, for which VDELAY bit is zero */
 			GTIA_GRAFM = ANTIC_ypos & 1 ? data : ((GTIA_GRAFM ^ data) & hold_missiles_tab[GTIA_VDELAY & 0xf]) ^ data;
 		}
@@ -1491,12 +1506,127 @@ static void draw_an_gtia_bug(const ULONG *t_pm_scanline_ptr)
 
 #endif /* PAGED_MEM */
 
+#ifdef ANTIC_VECTOR_2BPP
+#ifdef __aarch64__
+/* Expands 16 bytes of DATA to 64 words at PTR. TABLE holds the four
+   colour words as bytes 0..7. */
+static void expand_2bpp_16(const UBYTE *data, UWORD *ptr, const UBYTE table[16])
+{
+	const uint8x16_t tbl = vld1q_u8(table);
+	const uint8x16_t three = vdupq_n_u8(3);
+	const uint8x16_t one = vdupq_n_u8(1);
+	uint8x16_t b = vld1q_u8(data);
+	/* pixel values in display order, as byte offsets into TABLE */
+	uint8x16_t p0 = vshlq_n_u8(vshrq_n_u8(b, 6), 1);
+	uint8x16_t p1 = vshlq_n_u8(vandq_u8(vshrq_n_u8(b, 4), three), 1);
+	uint8x16_t p2 = vshlq_n_u8(vandq_u8(vshrq_n_u8(b, 2), three), 1);
+	uint8x16_t p3 = vshlq_n_u8(vandq_u8(b, three), 1);
+	uint8x16x2_t p01 = vzipq_u8(p0, p1);
+	uint8x16x2_t p23 = vzipq_u8(p2, p3);
+	uint16x8x2_t lo = vzipq_u16(vreinterpretq_u16_u8(p01.val[0]), vreinterpretq_u16_u8(p23.val[0]));
+	uint16x8x2_t hi = vzipq_u16(vreinterpretq_u16_u8(p01.val[1]), vreinterpretq_u16_u8(p23.val[1]));
+	uint8x16_t px[4];
+	int i;
+	px[0] = vreinterpretq_u8_u16(lo.val[0]);
+	px[1] = vreinterpretq_u8_u16(lo.val[1]);
+	px[2] = vreinterpretq_u8_u16(hi.val[0]);
+	px[3] = vreinterpretq_u8_u16(hi.val[1]);
+	for (i = 0; i < 4; i++) {
+		/* each pixel is a word: fetch both bytes of its colour */
+		uint8x16x2_t w = vzipq_u8(px[i], vaddq_u8(px[i], one));
+		vst1q_u8((uint8_t *) (ptr + i * 16), vqtbl1q_u8(tbl, w.val[0]));
+		vst1q_u8((uint8_t *) (ptr + i * 16 + 8), vqtbl1q_u8(tbl, w.val[1]));
+	}
+}
+#else
+static void expand_2bpp_16(const UBYTE *data, UWORD *ptr, const UBYTE table[16])
+{
+	const __m128i tbl = _mm_loadu_si128((const __m128i *) table);
+	const __m128i three = _mm_set1_epi8(3);
+	const __m128i one = _mm_set1_epi8(1);
+	__m128i b = _mm_loadu_si128((const __m128i *) data);
+	/* pixel values in display order, as byte offsets into TABLE;
+	   SSE has no byte shifts, so mask after the word shifts */
+	__m128i p0 = _mm_and_si128(_mm_srli_epi16(b, 6), three);
+	__m128i p1 = _mm_and_si128(_mm_srli_epi16(b, 4), three);
+	__m128i p2 = _mm_and_si128(_mm_srli_epi16(b, 2), three);
+	__m128i p3 = _mm_and_si128(b, three);
+	__m128i p01lo, p01hi, p23lo, p23hi;
+	__m128i px[4];
+	int i;
+	p0 = _mm_add_epi8(p0, p0);
+	p1 = _mm_add_epi8(p1, p1);
+	p2 = _mm_add_epi8(p2, p2);
+	p3 = _mm_add_epi8(p3, p3);
+	p01lo = _mm_unpacklo_epi8(p0, p1);
+	p01hi = _mm_unpackhi_epi8(p0, p1);
+	p23lo = _mm_unpacklo_epi8(p2, p3);
+	p23hi = _mm_unpackhi_epi8(p2, p3);
+	px[0] = _mm_unpacklo_epi16(p01lo, p23lo);
+	px[1] = _mm_unpackhi_epi16(p01lo, p23lo);
+	px[2] = _mm_unpacklo_epi16(p01hi, p23hi);
+	px[3] = _mm_unpackhi_epi16(p01hi, p23hi);
+	for (i = 0; i < 4; i++) {
+		/* each pixel is a word: fetch both bytes of its colour */
+		__m128i odd = _mm_add_epi8(px[i], one);
+		_mm_storeu_si128((__m128i *) (ptr + i * 16), _mm_shuffle_epi8(tbl, _mm_unpacklo_epi8(px[i], odd)));
+		_mm_storeu_si128((__m128i *) (ptr + i * 16 + 8), _mm_shuffle_epi8(tbl, _mm_unpackhi_epi8(px[i], odd)));
+	}
+}
+#endif /* __aarch64__ */
+
+/* Writes NCHARS bytes of DATA to PTR as four words each, one per bit pair
+   from the most significant, using COLOURS[0..3] for the pair's value. */
+static void expand_2bpp(int nchars, const UBYTE *data, UWORD *ptr, const UWORD colours[4])
+{
+	UBYTE table[16];
+	int i;
+	memcpy(table, colours, 8);
+	memset(table + 8, 0, 8);
+	if (nchars >= 16) {
+		for (i = 0; i + 16 <= nchars; i += 16)
+			expand_2bpp_16(data + i, ptr + i * 4, table);
+		/* finish with a block overlapping the previous one */
+		if (i < nchars)
+			expand_2bpp_16(data + nchars - 16, ptr + (nchars - 16) * 4, table);
+		return;
+	}
+	for (i = 0; i < nchars; i++) {
+		UBYTE screendata = data[i];
+		*ptr++ = colours[screendata >> 6];
+		*ptr++ = colours[(screendata >> 4) & 3];
+		*ptr++ = colours[(screendata >> 2) & 3];
+		*ptr++ = colours[screendata & 3];
+	}
+}
+#endif /* ANTIC_VECTOR_2BPP */
+
 static void draw_antic_2(int nchars, const UBYTE *antic_memptr, UWORD *ptr, const ULONG *t_pm_scanline_ptr)
 {
 	INIT_BACKGROUND_6
 	INIT_ANTIC_2
 	INIT_HIRES
 
+#ifdef ANTIC_VECTOR_2BPP
+	if (!GTIA_pm_dirty) {
+		UBYTE chars[48];
+		UWORD colours[4];
+		int i;
+		for (i = 0; i < nchars; i++) {
+			UBYTE screendata = antic_memptr[i];
+			int chdata;
+			GET_CHDATA_ANTIC_2
+			chars[i] = (UBYTE) chdata;
+		}
+		colours[0] = hires_norm(0x00);
+		colours[1] = hires_norm(0x04);
+		colours[2] = hires_norm(0x08);
+		colours[3] = hires_norm(0x0c);
+		expand_2bpp(nchars, chars, ptr, colours);
+		do_border();
+		return;
+	}
+#endif
 	CHAR_LOOP_BEGIN
 		UBYTE screendata = *antic_memptr++;
 		int chdata;
@@ -2231,6 +2361,13 @@ static void draw_antic_e(int nchars, const UBYTE *antic_memptr, UWORD *ptr, cons
 	lookup2[0x80] = lookup2[0x20] = lookup2[0x08] = lookup2[0x02] = ANTIC_cl[C_PF1];
 	lookup2[0xc0] = lookup2[0x30] = lookup2[0x0c] = lookup2[0x03] = ANTIC_cl[C_PF2];
 
+#ifdef ANTIC_VECTOR_2BPP
+	if (!GTIA_pm_dirty) {
+		expand_2bpp(nchars, antic_memptr, ptr, lookup2);
+		do_border();
+		return;
+	}
+#endif
 	CHAR_LOOP_BEGIN
 		UBYTE screendata = *antic_memptr++;
 		if (IS_ZERO_ULONG(t_pm_scanline_ptr)) {
@@ -2339,6 +2476,18 @@ static void draw_antic_f(int nchars, const UBYTE *antic_memptr, UWORD *ptr, cons
 	INIT_BACKGROUND_6
 	INIT_HIRES
 
+#ifdef ANTIC_VECTOR_2BPP
+	if (!GTIA_pm_dirty) {
+		UWORD colours[4];
+		colours[0] = hires_norm(0x00);
+		colours[1] = hires_norm(0x04);
+		colours[2] = hires_norm(0x08);
+		colours[3] = hires_norm(0x0c);
+		expand_2bpp(nchars, antic_memptr, ptr, colours);
+		do_border();
+		return;
+	}
+#endif
 	CHAR_LOOP_BEGIN
 		int screendata = *antic_memptr++;
 		if (IS_ZERO_ULONG(t_pm_scanline_ptr)) {
@@ -2783,6 +2932,9 @@ UBYTE ANTIC_GetDLByte(UWORD *paddr)
 	UBYTE result;
 	if (ANTIC_xe_ptr != NULL && addr < 0x8000 && addr >= 0x4000)
 		result = ANTIC_xe_ptr[addr - 0x4000];
+	else if (addr < 0x8000 && addr >= 0x4000 && MEMORY_cpu_map[0x40] != MEMORY_mem + 0x4000)
+		/* the CPU sees an XE bank here, ANTIC base RAM */
+		result = MEMORY_mem[addr];
 	else
 		result = MEMORY_GetByte((UWORD) addr);
 	addr++;
@@ -2835,9 +2987,9 @@ static void antic_load(void)
 				MEMORY_CopyFromMem((UWORD) (screenaddr + bytes - 0x1000), antic_memory + ANTIC_margin + bytes, new_screenaddr & 0xfff);
 		}
 		else {
-			MEMORY_dCopyFromMem(screenaddr, antic_memory + ANTIC_margin, bytes);
+			memcpy(antic_memory + ANTIC_margin, MEMORY_mem + screenaddr, bytes);
 			if (new_screenaddr & 0xfff)
-				MEMORY_dCopyFromMem(screenaddr + bytes - 0x1000, antic_memory + ANTIC_margin + bytes, new_screenaddr & 0xfff);
+				memcpy(antic_memory + ANTIC_margin + bytes, MEMORY_mem + screenaddr + bytes - 0x1000, new_screenaddr & 0xfff);
 		}
 		screenaddr = new_screenaddr - 0x1000;
 	}
@@ -2847,7 +2999,7 @@ static void antic_load(void)
 		else if ((screenaddr & 0xf000) == 0xd000)
 			MEMORY_CopyFromMem(screenaddr, antic_memory + ANTIC_margin, chars_read[md]);
 		else
-			MEMORY_dCopyFromMem(screenaddr, antic_memory + ANTIC_margin, chars_read[md]);
+			memcpy(antic_memory + ANTIC_margin, MEMORY_mem + screenaddr, chars_read[md]);
 		screenaddr = new_screenaddr;
 	}
 #endif
@@ -3122,7 +3274,9 @@ void ANTIC_Frame(int draw_display)
 		ANTIC_xpos += ANTIC_DMAR;
 
 		if (anticmode < 2 || (ANTIC_DMACTL & 3) == 0) {
+			PERF_BEGIN(PERF_ANTIC_DRAW);
 			draw_antic_0_ptr();
+			PERF_END(PERF_ANTIC_DRAW);
 			GOEOL;
 			YPOS_BREAK_FLICKER;
 			scrn_ptr += Screen_WIDTH / 2;
@@ -3149,10 +3303,12 @@ void ANTIC_Frame(int draw_display)
 				ANTIC_xpos -= extra_cycles[md];
 		}
 
+		PERF_BEGIN(PERF_ANTIC_DRAW);
 		draw_antic_ptr(chars_displayed[md],
 			antic_memory + ANTIC_margin + ch_offset[md],
 			scrn_ptr + x_min[md],
 			(ULONG *) &GTIA_pm_scanline[x_min[md]]);
+		PERF_END(PERF_ANTIC_DRAW);
 
 		GOEOL;
 #endif /* NEW_CYCLE_EXACT */
@@ -3484,6 +3640,7 @@ void draw_partial_scanline(int l, int r)
 	}
 	memcpy(sv_buf2, scrn_ptr + sv_bufstart2, sv_bufsize2 * sizeof(UWORD)); /* save part of screen */
 
+	PERF_BEGIN(PERF_ANTIC_DRAW);
 	if (dont_display_playfield) {
 /* the idea here is to use draw_antic_0_ptr() to draw just the border only, since */
 /* we can't set nchars=0.  draw_antic_0_ptr will work if left_border_start and */
@@ -3502,6 +3659,7 @@ void draw_partial_scanline(int l, int r)
 			scrn_ptr + x_min[md] + x_min_adj,
 			(ULONG *) &GTIA_pm_scanline[x_min[md] + x_min_adj]);
 	}
+	PERF_END(PERF_ANTIC_DRAW);
 	memcpy(scrn_ptr + sv_bufstart2, sv_buf2, sv_bufsize2 * sizeof(UWORD)); /* restore screen */
 	memcpy(scrn_ptr + sv_bufstart, sv_buf, sv_bufsize * sizeof(UWORD)); /* restore screen */
 
@@ -78,6 +78,7 @@ biteme!
 #include "cassette.h"
 #include "cfg.h"
 #include "cpu.h"
+#include "cputrace.h"
 #include "devices.h"
 #include "esc.h"
 #include "gtia.h"
@@ -89,8 +90,12 @@ biteme!
 #include "pclink.h"
 #include "platform.h"
 #include "pokey.h"
+#include "romcache.h"
 #include "rtime.h"
+#include "pacer.h"
 #include "pbi.h"
+#include "perf.h"
+#include "sched.h"
 #include "sio.h"
 #include "side2.h"
 #include "ui.h"
@@ -214,6 +219,7 @@ void Atari800_Warmstart(void)
 void Atari800_Coldstart(void)
 {
 #ifdef MACOSX
+	SCHED_Rebase(ANTIC_screenline_cpu_clock);	/* keep pending events relative to the new origin */
 	ANTIC_screenline_cpu_clock = 0;
 	MacSoundReset();
 	MacCapsLockStateReset();
@@ -392,6 +398,7 @@ static int load_roms(void)
     
     if (!loadBasic) {
         MEMORY_have_basic = FALSE;
+        ROMCACHE_Save();
         return TRUE;
     }
     
@@ -411,6 +418,7 @@ static int load_roms(void)
     }
     
     MEMORY_have_basic = TRUE;
+    ROMCACHE_Save();
     return TRUE;
 }
 
@@ -814,6 +822,9 @@ int Atari800_Exit(int run_monitor)
 	if (!restart) {
 		SIO_Exit();	/* umount disks, so temporary files are deleted */
 		INPUT_Exit();	/* finish event recording */
+#ifdef MONITOR_TRACE
+		CPUTRACE_Stop();	/* write the rest of the trace */
+#endif
 #ifdef R_IO_DEVICE
 		RDevice_Exit(); /* R: Device cleanup */
 #endif
@@ -836,37 +847,22 @@ int Atari800_Exit(int run_monitor)
 
 static double Atari_time(void)
 {
-	struct timeval tp;
-	gettimeofday(&tp, NULL);
-	return tp.tv_sec + 1e-6 * tp.tv_usec;
+	return PACER_Time();
 }
 
 void Atari_sleep(double s)
 {
 	if (s > 0) {
-		usleep(s * 1e6);
+		PACER_WaitUntil(PACER_Time() + s);
 	}
 }
 
 void Atari800_Sync(void)
 {
-	static double lasttime = 0;
-	double local_deltatime;
-	double curtime;
-	double sleeptime;
-	local_deltatime = deltatime * PLATFORM_AdjustSpeed();
-	lasttime += local_deltatime;
-	sleeptime = lasttime - Atari_time();
-	if (sleeptime > 1.0) {
-		Log_print("Large positive sleeptime (%f), correcting to 1.0",sleeptime);
-		sleeptime = 1.0;
-	}
-	
-	Atari_sleep(sleeptime);
-	curtime = Atari_time();
-	
-	if ((lasttime + local_deltatime) < curtime)
-		lasttime = curtime;
+	PERF_BEGIN(PERF_SYNC_SLEEP);
+	PACER_Sync(deltatime * PLATFORM_AdjustSpeed());
+	PERF_END(PERF_SYNC_SLEEP);
+	PERF_Frame();
 }
 
 void Atari800_Frame(void)
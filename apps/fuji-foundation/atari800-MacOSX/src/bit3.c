@@ -24,6 +24,7 @@
 
 #include "bit3.h"
 #include "atari.h"
+#include "col80.h"
 #include "util.h"
 #include "log.h"
 #include "memory.h"
@@ -93,6 +94,7 @@ void init_bit3(void)
     else {
         Log_print("loaded Bit3 Full View charset image");
     }
+    COL80_InvalidateGlyphs();
     BIT3_Reset(); /* With VIDEOMODE_80_column = 0, VIDEOMODE_Set80Column(0) will not change modes */
 }
 
@@ -205,7 +207,10 @@ void BIT3_D5PutByte(UWORD addr, UBYTE byte)
 	}
 	else if (addr == 0xd581) {
 		/* write selected crtc register */
-		crtreg[crtreg[0]&0x3f] = byte;
+		int reg = crtreg[0]&0x3f;
+		if ((reg == 0x0a || reg == 0x0b) && crtreg[reg] != byte)
+			COL80_InvalidateGlyphs(); /* cursor shape */
+		crtreg[reg] = byte;
 	}
 	else if (addr == 0xd583 || addr == 0xd585) {
 		/* d583 is used for reading screen ram, d585 for writing, in the ROM.
@@ -219,10 +224,11 @@ void BIT3_D5PutByte(UWORD addr, UBYTE byte)
 	}
 }
 
-UBYTE BIT3_GetPixels(int scanline, int column, int *colour, int blink)
-{
 #define BIT3_ROWS 24
 #define BIT3_CELL_HEIGHT 10
+
+UBYTE BIT3_GetPixels(int scanline, int column, int *colour, int blink)
+{
 	UBYTE character;
 	UBYTE font_data;
 	int table_start = crtreg[0x0d] + ((crtreg[0x0c]&0x3f)<<8);
@@ -256,11 +262,40 @@ UBYTE BIT3_GetPixels(int scanline, int column, int *colour, int blink)
 	return font_data;
 }
 
+ULONG BIT3_GetCell(int row, int column)
+{
+	int screen_pos = ((row*80+column + crtreg[0x0d] + ((crtreg[0x0c]&0x3f)<<8))&0x3fff);
+	UBYTE character = bit3_screen[screen_pos&0x7ff];
+	ULONG key = (character&0x7f) | COL80_KEY_SET_COLOUR(1);
+	if (character & 0x80)
+		key |= COL80_KEY_INVERT;
+	if (screen_pos == (((crtreg[0x0e]&0x3f)<<8)|crtreg[0x0f]) && (crtreg[0x0a]&0x60) != 0x20)
+		key |= COL80_KEY_CURSOR;
+	return key;
+}
+
+/* Renders a cell the way BIT3_GetPixels() does, for the COL80 glyph cache.
+   The cursor lines come from the CRTC, so writing them drops the cache. */
+void BIT3_RenderGlyph(ULONG key, int blink, UBYTE *rows)
+{
+	int line;
+	for (line = 0; line < BIT3_CELL_HEIGHT; line++) {
+		UBYTE font_data = bit3_charset[(key & COL80_KEY_CHAR)*16 + line];
+		if (key & COL80_KEY_INVERT)
+			font_data ^= 0xff;
+		if ((key & COL80_KEY_CURSOR) && !blink
+		    && line >= (crtreg[0x0a]&0x1f) && line <= (crtreg[0x0b]&0x1f))
+			font_data ^= 0xff;
+		rows[line] = font_data;
+	}
+}
+
 void BIT3_Reset(void)
 {
 	memset(bit3_screen, 0, 0x800);
 	rom_bank_select = 0;
 	memset(crtreg, 0, sizeof(crtreg));
+	COL80_InvalidateGlyphs(); /* cursor shape */
 	update_d6();
 	video_latch = 0;
 	//VIDEOMODE_Set80Column(video_latch);
@@ -26,6 +26,9 @@ void BIT3_D5PutByte(UWORD addr, UBYTE byte);
 int BIT3_D6GetByte(UWORD addr, int no_side_effects);
 void BIT3_D6PutByte(UWORD addr, UBYTE byte);
 UBYTE BIT3_GetPixels(int scanline, int column, int *colour, int blink);
+/* Returns the COL80 key of the text cell at ROW, COLUMN. */
+ULONG BIT3_GetCell(int row, int column);
+void BIT3_RenderGlyph(ULONG key, int blink, UBYTE *rows);
 extern int BIT3_enabled;
 void BIT3_Reset(void);
 #ifdef ATARI800MACX
@@ -343,8 +343,10 @@ static void SwitchBank(int old_state)
 #ifdef ATARI800MACX
     case CARTRIDGE_WILL_32:
         set_bank_A0BF(8, 3);
+        break;
     case CARTRIDGE_WILL_16:
         set_bank_A0BF(8, 1);
+        break;
 #endif
 	case CARTRIDGE_DB_32:
 	case CARTRIDGE_XEGS_32:
@@ -606,7 +608,7 @@ static void MapActiveCart(void)
 	else { /* Atari800_machine_type != Atari800_MACHINE_5200 */
 #ifdef ATARI800MACX
         if (active_cart->funcs != NULL) {
-            active_cart->funcs->map();
+            active_cart->funcs->map(TRUE);
             return;
         }
 #endif
@@ -1131,7 +1133,7 @@ static UBYTE GetByte(CARTRIDGE_image_t *cart, UWORD addr, int no_side_effects)
         
         value = cart->funcs->read_byte(addr);
         if (cart == active_cart) {
-            cart->funcs->map();
+            cart->funcs->map(FALSE);
         }
         return value;
     }
@@ -1215,7 +1217,7 @@ static void PutByte(CARTRIDGE_image_t *cart, UWORD addr, UBYTE byte)
     if (cart->funcs != NULL) {
         cart->funcs->write_byte(addr, byte);
         if (cart == active_cart) {
-            cart->funcs->map();
+            cart->funcs->map(FALSE);
         }
         return;
     }
@@ -1612,6 +1614,53 @@ static void ResetCartState(CARTRIDGE_image_t *cart)
 	}
 }
 
+/* Images at least this big are mapped rather than read in, so inserting a
+   128 MB The!Cart image costs neither the read nor the memory up front. */
+#define MAP_IMAGE_MIN_SIZE 0x100000
+
+/* Loads LEN bytes at OFFSET of the file FP, opened from FILENAME, into
+   CART->IMAGE. Returns FALSE if the file is too short. */
+static int ReadImageData(CARTRIDGE_image_t *cart, FILE *fp, const char *filename, int offset, int len)
+{
+	if (len >= MAP_IMAGE_MIN_SIZE) {
+		cart->image = (UBYTE *) Util_mapfile(filename, offset, len);
+		if (cart->image != NULL) {
+			cart->mapped = TRUE;
+			return TRUE;
+		}
+	}
+	cart->mapped = FALSE;
+	cart->image = (UBYTE *) Util_malloc(len);
+	if (fread(cart->image, 1, len, fp) < len) {
+		free(cart->image);
+		cart->image = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void FreeImage(CARTRIDGE_image_t *cart)
+{
+	if (cart->mapped)
+		Util_unmapfile(cart->image, cart->raw ? 0 : 16, cart->size << 10);
+	else
+		free(cart->image);
+	cart->image = NULL;
+	cart->mapped = FALSE;
+	free(cart->dirty_blocks);
+	cart->dirty_blocks = NULL;
+}
+
+UBYTE *CARTRIDGE_DirtyBlocks(CARTRIDGE_image_t *cart)
+{
+	if (cart->dirty_blocks == NULL) {
+		size_t len = UTIL_DIRTY_MAP_SIZE((size_t) cart->size << 10);
+		cart->dirty_blocks = (UBYTE *) Util_malloc(len);
+		memset(cart->dirty_blocks, 0, len);
+	}
+	return cart->dirty_blocks;
+}
+
 /* Before first use of the cartridge, preprocess its contents if needed. */
 static void PreprocessCart(CARTRIDGE_image_t *cart)
 {
@@ -1734,7 +1783,7 @@ static void PreprocessCart(CARTRIDGE_image_t *cart)
 				(byte & 0x40 ? map->data[6] : 0) |
 				(byte & 0x80 ? map->data[7] : 0);
 		}
-		free(cart->image);
+		FreeImage(cart);
 		cart->image = new_image;
 	}
 }
@@ -1805,37 +1854,106 @@ void CARTRIDGE_InitSecondCartridge()
 }
 #endif
 
-int CARTRIDGE_WriteImage(char *filename, int type, UBYTE *image, int size, int raw, UBYTE value) {
-	FILE *fp = fopen(filename, "wb");
-	if (fp != NULL) {
-		if (!raw) {
-			UBYTE header[0x10];
-			int checksum = 0;
-			if (image != NULL)
-				checksum = CARTRIDGE_Checksum(image, size);
-
-			header[0x0] = 'C';
-			header[0x1] = 'A';
-			header[0x2] = 'R';
-			header[0x3] = 'T';
-
-			header[0x4] = 0;
-			header[0x5] = 0;
-			header[0x6] = 0;
-			header[0x7] = type;
-			
-			header[0x8] = checksum >> 24;
-			header[0x9] = checksum >> 16;
-			header[0xa] = checksum >> 8;
-			header[0xb] = checksum;
-			
-			header[0xc] = 0;
-			header[0xd] = 0;
-			header[0xe] = 0;
-			header[0xf] = 0;
+/* Writes back the blocks of IMAGE marked in DIRTY over FILENAME, which held
+   IMAGE when DIRTY started recording. The CART header checksum is a plain sum
+   of the data, so it is moved on by the old and new contents of just those
+   blocks rather than summed again over the whole image. Returns FALSE if
+   FILENAME no longer has the expected layout and must be written in full. */
+static int WriteBackImage(const char *filename, int type, const UBYTE *image, int size, int raw, UBYTE *dirty)
+{
+	UBYTE header[0x10];
+	UBYTE block[UTIL_DIRTY_BLOCK];
+	int checksum = 0;
+	int pos;
+	FILE *fp;
 
-			fwrite(&header, 1, sizeof(header), fp);
+	if (!raw) {
+		fp = fopen(filename, "rb");
+		if (fp == NULL)
+			return FALSE;
+		if (fread(header, 1, sizeof(header), fp) != sizeof(header)
+		    || memcmp(header, "CART", 4) != 0
+		    || ((header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7]) != type) {
+			fclose(fp);
+			return FALSE;
+		}
+		checksum = (header[8] << 24) | (header[9] << 16) | (header[10] << 8) | header[11];
+		for (pos = 0; pos < size; pos += UTIL_DIRTY_BLOCK) {
+			int len = size - pos < UTIL_DIRTY_BLOCK ? size - pos : UTIL_DIRTY_BLOCK;
+			if (!UTIL_DIRTY_BLOCK_SET(dirty, pos / UTIL_DIRTY_BLOCK))
+				continue;
+			if (fseek(fp, sizeof(header) + pos, SEEK_SET) != 0 || fread(block, 1, len, fp) != len) {
+				fclose(fp);
+				return FALSE;
+			}
+			checksum += CARTRIDGE_Checksum(image + pos, len) - CARTRIDGE_Checksum(block, len);
+		}
+		fclose(fp);
+	}
+
+	if (Util_writeback(filename, raw ? 0 : sizeof(header), image, size, dirty) < 0)
+		return FALSE;
+
+	if (!raw) {
+		header[0x8] = checksum >> 24;
+		header[0x9] = checksum >> 16;
+		header[0xa] = checksum >> 8;
+		header[0xb] = checksum;
+		fp = fopen(filename, "r+b");
+		if (fp == NULL)
+			return FALSE;
+		if (fwrite(header, 1, sizeof(header), fp) != sizeof(header)) {
+			fclose(fp);
+			return FALSE;
 		}
+		fclose(fp);
+	}
+	return TRUE;
+}
+
+int CARTRIDGE_WriteImage(char *filename, int type, UBYTE *image, int size, int raw, UBYTE value, UBYTE *dirty) {
+	UBYTE header[0x10];
+	char tmpname[FILENAME_MAX];
+	FILE *fp;
+
+	/* Saving back over the image's own file (the usual case for flash carts)
+	   only rewrites the blocks that were programmed or erased. */
+	if (image != NULL && dirty != NULL && WriteBackImage(filename, type, image, size, raw, dirty))
+		return 0;
+
+	if (!raw) {
+		int checksum = 0;
+		if (image != NULL)
+			checksum = CARTRIDGE_Checksum(image, size);
+
+		header[0x0] = 'C';
+		header[0x1] = 'A';
+		header[0x2] = 'R';
+		header[0x3] = 'T';
+
+		header[0x4] = 0;
+		header[0x5] = 0;
+		header[0x6] = 0;
+		header[0x7] = type;
+		
+		header[0x8] = checksum >> 24;
+		header[0x9] = checksum >> 16;
+		header[0xa] = checksum >> 8;
+		header[0xb] = checksum;
+		
+		header[0xc] = 0;
+		header[0xd] = 0;
+		header[0xe] = 0;
+		header[0xf] = 0;
+	}
+
+	/* Otherwise write a new file and rename it over the old one: truncating
+	   a file that a cart image is still mapped from would fault. */
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+	fp = fopen(tmpname, "wb");
+	if (fp != NULL) {
+		if (!raw)
+			fwrite(&header, 1, sizeof(header), fp);
 		if (image != NULL)
 			fwrite(image, 1, size, fp);
 		else
@@ -1843,12 +1961,18 @@ int CARTRIDGE_WriteImage(char *filename, int type, UBYTE *image, int size, int r
 				fwrite(&value, 1, 1, fp);
 
 		fclose(fp);
-		return 0;
-	}
-	else {
-		Log_print("Error writing cartridge \"%s\".\n", filename);
-		return -1;
+		if (rename(tmpname, filename) == 0) {
+			/* FILENAME now matches IMAGE. */
+			if (dirty != NULL)
+				memset(dirty, 0, UTIL_DIRTY_MAP_SIZE(size));
+			return 0;
+		}
+#ifdef HAVE_UTIL_UNLINK
+		Util_unlink(tmpname);
+#endif
 	}
+	Log_print("Error writing cartridge \"%s\".\n", filename);
+	return -1;
 }
 
 static void RemoveCart(CARTRIDGE_image_t *cart)
@@ -1874,11 +1998,10 @@ static void RemoveCart(CARTRIDGE_image_t *cart)
 		case CARTRIDGE_RAMCART_16M:
 		case CARTRIDGE_RAMCART_32M:
 		case CARTRIDGE_SIDICAR_32:
-			CARTRIDGE_WriteImage(cart->filename, cart->type, cart->image, cart->size << 10, cart->raw, -1);
+			CARTRIDGE_WriteImage(cart->filename, cart->type, cart->image, cart->size << 10, cart->raw, -1, cart->dirty_blocks);
 		}
 
-		free(cart->image);
-		cart->image = NULL;
+		FreeImage(cart);
 #ifdef ATARI800MACX
         cart->blank = FALSE;
         cart->dirty = FALSE;
@@ -1986,13 +2109,9 @@ int CARTRIDGE_ReadImage(const char *filename, CARTRIDGE_image_t *cart)
 
 	/* if full kilobytes, assume it is raw image */
 	if ((len & 0x3ff) == 0) {
-		/* alloc memory and read data */
-		cart->image = (UBYTE *) Util_malloc(len);
-		if (fread(cart->image, 1, len, fp) < len) {
+		if (!ReadImageData(cart, fp, filename, 0, len)) {
 			Log_print("Error reading cartridge.\n");
 			fclose(fp);
-			free(cart->image);
-			cart->image = NULL;
 			return CARTRIDGE_TOO_FEW_DATA;
 		}
 		fclose(fp);
@@ -2014,8 +2133,7 @@ int CARTRIDGE_ReadImage(const char *filename, CARTRIDGE_image_t *cart)
 			InitCartridge(cart);
 			return 0;	/* ok */
 		}
-		free(cart->image);
-		cart->image = NULL;
+		FreeImage(cart);
 		return CARTRIDGE_BAD_FORMAT;
 	}
 
@@ -2039,13 +2157,9 @@ int CARTRIDGE_ReadImage(const char *filename, CARTRIDGE_image_t *cart)
 			len = CARTRIDGES[type].kb << 10;
 			cart->raw = FALSE;
 			cart->size = CARTRIDGES[type].kb;
-			/* alloc memory and read data */
-			cart->image = (UBYTE *) Util_malloc(len);
-			if (fread(cart->image, 1, len, fp) < len) {
+			if (!ReadImageData(cart, fp, filename, 16, len)) {
 				Log_print("Error reading cartridge.\n");
 				fclose(fp);
-				free(cart->image);
-				cart->image = NULL;
 				return CARTRIDGE_TOO_FEW_DATA;
 			}
 			fclose(fp);
@@ -2054,7 +2168,12 @@ int CARTRIDGE_ReadImage(const char *filename, CARTRIDGE_image_t *cart)
 				(header[10] << 8) |
 				header[11];
 			cart->type = type;
-			result = checksum == CARTRIDGE_Checksum(cart->image, len) ? 0 : CARTRIDGE_BAD_CHECKSUM;
+			/* Summing a mapped image would read in all of it, which mapping
+			   is there to avoid; saves keep its checksum up to date. */
+			if (cart->mapped)
+				result = 0;
+			else
+				result = checksum == CARTRIDGE_Checksum(cart->image, len) ? 0 : CARTRIDGE_BAD_CHECKSUM;
 			InitCartridge(cart);
 			return result;
 		}
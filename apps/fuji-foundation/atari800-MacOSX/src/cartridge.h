@@ -18,7 +18,11 @@ typedef struct CARTRIDGE_funcs_type {
     void (*cold_reset)(void);
     UBYTE (*read_byte)(UWORD address);
     void (*write_byte)(UWORD address, UBYTE value);
-    void (*map)(void);
+    /* Copies the selected bank into the cartridge window. It runs on every
+       $D5xx access, so each cart remembers what it last mapped, marks the
+       window stale when a flash write changes the image, and skips the copy
+       when neither changed, unless FORCE. */
+    void (*map)(int force);
 } CARTRIDGE_funcs_type;
 #endif
 
@@ -69,6 +73,8 @@ typedef struct CARTRIDGE_image_t {
     int blank; /* Blank cartridge that has never been saved */
     CARTRIDGE_funcs_type *funcs; /* Cart specific functions */
 #endif
+	int mapped; /* IMAGE is mapped from FILENAME with Util_mapfile() rather than malloc'd. */
+	UBYTE *dirty_blocks; /* Blocks of IMAGE changed since it matched FILENAME (see util.h), or NULL if the cart does not track them. */
 } CARTRIDGE_image_t;
 
 extern CARTRIDGE_image_t CARTRIDGE_main;
@@ -173,7 +179,14 @@ void CARTRIDGE_BountyBob2PutByte(UWORD addr, UBYTE value);
 void CARTRIDGE_5200SuperCartPutByte(UWORD addr, UBYTE value);
 
 int CARTRIDGE_ReadImage(const char *filename, CARTRIDGE_image_t *cart);
-int CARTRIDGE_WriteImage(char *filename, int type, UBYTE *image, int size, int raw, UBYTE value);
+/* Writes SIZE bytes of IMAGE, or of VALUE if IMAGE is NULL, to FILENAME as a
+   cartridge of TYPE, without the CART header if RAW. If DIRTY is not NULL it
+   is the dirty block map of IMAGE against FILENAME as it is on disk, and only
+   those blocks are rewritten. */
+int CARTRIDGE_WriteImage(char *filename, int type, UBYTE *image, int size, int raw, UBYTE value, UBYTE *dirty);
+/* Returns the dirty block map of CART's image, allocating it on first use.
+   Flash carts pass it to their flash chips, which fill it in. */
+UBYTE *CARTRIDGE_DirtyBlocks(CARTRIDGE_image_t *cart);
 
 void CARTRIDGE_UpdateState(CARTRIDGE_image_t *cart, int old_state);
 #endif /* CARTRIDGE_H_ */
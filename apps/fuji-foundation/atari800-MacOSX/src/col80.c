@@ -0,0 +1,121 @@
+/*
+ * col80.c - dirty cell tracking and glyph cache for the 80 column devices
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <string.h>
+
+#include "col80.h"
+
+#define CELLS (COL80_MAX_ROWS * COL80_COLUMNS)
+
+/* Key bits that select a glyph: the character and the attribute bits. */
+#define GLYPH_KEYS 0x1000
+/* Added to the key of a cell drawn in the blink phase when that changes
+   its look. */
+#define KEY_PHASE 0x10000
+
+/* COL80_MarkCell() state of a cell. */
+#define MARK_DIRTY  0x01
+#define MARK_BLINKS 0x02
+
+static int grid_rows = 0;
+static int grid_cell_height = 0;
+static COL80_GlyphFunc glyph_func = NULL;
+
+/* Key each cell was last drawn with. */
+static ULONG shown[CELLS];
+static UBYTE marks[CELLS];
+
+/* Glyphs of the normal phase, followed by those of the blink phase. */
+static UBYTE glyphs[2 * GLYPH_KEYS][COL80_MAX_CELL_HEIGHT];
+static UBYTE glyph_valid[2 * GLYPH_KEYS];
+
+static ULONG phase_key(ULONG key, int blink)
+{
+	if (blink && (key & (COL80_KEY_BLINK | COL80_KEY_CURSOR)))
+		return key | KEY_PHASE;
+	return key;
+}
+
+void COL80_SetDevice(int rows, int cell_height, COL80_GlyphFunc glyph)
+{
+	if (rows == grid_rows && cell_height == grid_cell_height && glyph == glyph_func)
+		return;
+	grid_rows = rows;
+	grid_cell_height = cell_height;
+	glyph_func = glyph;
+	COL80_InvalidateGlyphs();
+}
+
+void COL80_InvalidateGlyphs(void)
+{
+	memset(glyph_valid, 0, sizeof(glyph_valid));
+	COL80_InvalidateCells();
+}
+
+void COL80_InvalidateCells(void)
+{
+	int i;
+	for (i = 0; i < CELLS; i++)
+		marks[i] |= MARK_DIRTY;
+}
+
+int COL80_UpdateCell(int row, int column, ULONG key, int blink)
+{
+	int i = row * COL80_COLUMNS + column;
+	key = phase_key(key, blink);
+	if (!(marks[i] & MARK_DIRTY) && shown[i] == key)
+		return FALSE;
+	shown[i] = key;
+	marks[i] &= ~MARK_DIRTY;
+	return TRUE;
+}
+
+const UBYTE *COL80_GetGlyph(ULONG key, int blink)
+{
+	int i = key & (GLYPH_KEYS - 1);
+	if (phase_key(key, blink) & KEY_PHASE)
+		i += GLYPH_KEYS;
+	if (!glyph_valid[i]) {
+		memset(glyphs[i], 0, COL80_MAX_CELL_HEIGHT);
+		if (glyph_func != NULL)
+			glyph_func(key & (GLYPH_KEYS - 1), i >= GLYPH_KEYS, glyphs[i]);
+		glyph_valid[i] = TRUE;
+	}
+	return glyphs[i];
+}
+
+void COL80_MarkCell(int row, int column, int blinks)
+{
+	int i;
+	if (row < 0 || row >= COL80_MAX_ROWS || column < 0 || column >= COL80_COLUMNS)
+		return;
+	i = row * COL80_COLUMNS + column;
+	marks[i] = MARK_DIRTY | (blinks ? MARK_BLINKS : 0);
+}
+
+int COL80_CellChanged(int row, int column, int blink)
+{
+	int i = row * COL80_COLUMNS + column;
+	return COL80_UpdateCell(row, column, (marks[i] & MARK_BLINKS) ? COL80_KEY_BLINK : 0, blink);
+}
@@ -0,0 +1,63 @@
+#ifndef COL80_H_
+#define COL80_H_
+
+#include "atari.h"
+
+/* Display support shared by the 80 column devices (XEP80, Austin Franklin
+   80 and Bit 3 Full-View 80).
+   The screen is handled as a grid of text cells. The front end remembers
+   what each cell was last drawn with and redraws only the cells that
+   changed, so a word processor or terminal updating a few characters, or a
+   blinking cursor, costs a few cells instead of the whole screen.
+   Devices that decode their character set at display time describe each
+   cell by a key (character, attribute bits and colour) and render glyphs
+   on request; the glyphs are cached per key and blink phase until the
+   character set changes. The XEP80 draws into its own buffers and marks
+   the cells it touched with COL80_MarkCell() instead. */
+
+#define COL80_COLUMNS 80
+#define COL80_MAX_ROWS 25
+#define COL80_MAX_CELL_HEIGHT 16
+
+/* Cell key bits. */
+#define COL80_KEY_CHAR       0x000ff
+#define COL80_KEY_INVERT     0x00100
+#define COL80_KEY_BLINK      0x00200	/* blanked in the blink phase */
+#define COL80_KEY_UNDERLINE  0x00400
+#define COL80_KEY_CURSOR     0x00800	/* cursor shown outside the blink phase */
+#define COL80_KEY_COLOUR(key) (((key) >> 12) & 0x0f)
+#define COL80_KEY_SET_COLOUR(colour) ((ULONG) (colour) << 12)
+
+/* Renders the glyph for the character and attribute bits of KEY in blink
+   phase BLINK into ROWS, one byte per scanline with bit 0 the leftmost
+   pixel. */
+typedef void (*COL80_GlyphFunc)(ULONG key, int blink, UBYTE *rows);
+
+/* Selects the geometry and glyph renderer (NULL for the XEP80) of the
+   device being displayed. A change invalidates all cells and glyphs. */
+void COL80_SetDevice(int rows, int cell_height, COL80_GlyphFunc glyph);
+
+/* Discards the cached glyphs, after the character set or the cursor shape
+   changed, and with them all cells. */
+void COL80_InvalidateGlyphs(void);
+
+/* Makes all cells redraw, after the frame buffer was overwritten. */
+void COL80_InvalidateCells(void);
+
+/* Records that the cell at ROW, COLUMN now shows KEY. Returns TRUE if it
+   must be redrawn for blink phase BLINK. */
+int COL80_UpdateCell(int row, int column, ULONG key, int blink);
+
+/* Returns the cached glyph of KEY in blink phase BLINK. */
+const UBYTE *COL80_GetGlyph(ULONG key, int blink);
+
+/* Marks the cell at ROW, COLUMN as redrawn by the device. BLINKS tells
+   whether it looks different in the blink phase. */
+void COL80_MarkCell(int row, int column, int blinks);
+
+/* Returns TRUE if the cell at ROW, COLUMN was marked since it was last
+   drawn, or if it blinks and the blink phase is no longer BLINK, and
+   records it as drawn. */
+int COL80_CellChanged(int row, int column, int blink);
+
+#endif /* COL80_H_ */
@@ -23,6 +23,9 @@
 */
 
 #include "config.h"
+#ifdef HAVE_FOPENCOOKIE
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -70,6 +73,75 @@ int CompFile_ExtractGZ(const char *infilename, FILE *outfp)
 }
 
 
+/* Decompressed images --------------------------------------------------- */
+
+typedef struct {
+	int archive_type;
+	int archive_flags;
+	int pass_flags;
+	int in_group;	/* the next byte is a sector type, not a sector group */
+	int sectorcount;
+	int sectorsize;
+	int current_sector;
+	UBYTE sector_buf[256];
+} DCM_Info;
+
+/* An image decompressed into memory a piece at a time, as far as it has
+   been needed. */
+typedef struct Image {
+	UBYTE *data;
+	size_t size;	/* bytes decompressed so far */
+	size_t alloc;
+	size_t pos;	/* stream position */
+	int done;	/* no more to decompress, or stopped at an error */
+	int failed;
+	/* Decompresses the next piece, setting done after the last one.
+	   Returns FALSE on error. */
+	int (*more)(struct Image *img);
+	FILE *infp;
+#ifdef HAVE_LIBZ
+	gzFile gzf;
+#endif
+	DCM_Info dcm;
+} Image;
+
+static void image_reserve(Image *img, size_t len)
+{
+	if (img->size + len <= img->alloc)
+		return;
+	if (img->alloc == 0)
+		img->alloc = 65536;
+	while (img->size + len > img->alloc)
+		img->alloc *= 2;
+	img->data = (UBYTE *) Util_realloc(img->data, img->alloc);
+}
+
+static void image_append(Image *img, const UBYTE *buf, size_t len)
+{
+	image_reserve(img, len);
+	memcpy(img->data + img->size, buf, len);
+	img->size += len;
+}
+
+/* Decompresses until the first size bytes of the image are available or
+   there is no more. */
+static void image_fill(Image *img, size_t size)
+{
+	while (!img->done && img->size < size)
+		if (!img->more(img))
+			img->done = img->failed = TRUE;
+}
+
+static void image_free(Image *img)
+{
+	free(img->data);
+#ifdef HAVE_LIBZ
+	if (img->gzf != NULL)
+		gzclose(img->gzf);
+#endif
+}
+
+
 /* DCM decompression ----------------------------------------------------- */
 
 static int fgetw(FILE *fp)
@@ -95,217 +167,398 @@ static int fsave(void *buf, int size, FILE *fp)
 	return (int) fwrite(buf, 1, size, fp) == size;
 }
 
-typedef struct {
-	FILE *fp;
-	int sectorcount;
-	int sectorsize;
-	int current_sector;
-} ATR_Info;
-
-static int write_atr_header(const ATR_Info *pai)
+static void make_atr_header(const DCM_Info *pdi, struct AFILE_ATR_Header *header)
 {
 	int sectorcount;
 	int sectorsize;
 	ULONG paras;
-	struct AFILE_ATR_Header header;
-	sectorcount = pai->sectorcount;
-	sectorsize = pai->sectorsize;
+	sectorcount = pdi->sectorcount;
+	sectorsize = pdi->sectorsize;
 	paras = (sectorsize != 256 || sectorcount <= 3)
 		? (sectorcount << 3) /* single density or only boot sectors: sectorcount * 128 / 16 */
 		: (sectorcount << 4) - 0x18; /* double density with 128-byte boot sectors: (sectorcount * 256 - 3 * 128) / 16 */
-	memset(&header, 0, sizeof(header));
-	header.magic1 = AFILE_ATR_MAGIC1;
-	header.magic2 = AFILE_ATR_MAGIC2;
-	header.secsizelo = (UBYTE) sectorsize;
-	header.secsizehi = (UBYTE) (sectorsize >> 8);
-	header.seccountlo = (UBYTE) paras;
-	header.seccounthi = (UBYTE) (paras >> 8);
-	header.hiseccountlo = (UBYTE) (paras >> 16);
-	header.hiseccounthi = (UBYTE) (paras >> 24);
-	return fsave(&header, sizeof(header), pai->fp);
+	memset(header, 0, sizeof(*header));
+	header->magic1 = AFILE_ATR_MAGIC1;
+	header->magic2 = AFILE_ATR_MAGIC2;
+	header->secsizelo = (UBYTE) sectorsize;
+	header->secsizehi = (UBYTE) (sectorsize >> 8);
+	header->seccountlo = (UBYTE) paras;
+	header->seccounthi = (UBYTE) (paras >> 8);
+	header->hiseccountlo = (UBYTE) (paras >> 16);
+	header->hiseccounthi = (UBYTE) (paras >> 24);
 }
 
-static int write_atr_sector(ATR_Info *pai, UBYTE *buf)
+static void write_atr_sector(Image *img, const UBYTE *buf)
 {
-	return fsave(buf, pai->current_sector++ <= 3 ? 128 : pai->sectorsize, pai->fp);
+	DCM_Info *pdi = &img->dcm;
+	image_append(img, buf, pdi->current_sector++ <= 3 ? 128 : pdi->sectorsize);
 }
 
-static int pad_till_sector(ATR_Info *pai, int till_sector)
+static void pad_till_sector(Image *img, int till_sector)
 {
 	UBYTE zero_buf[256];
 	memset(zero_buf, 0, sizeof(zero_buf));
-	while (pai->current_sector < till_sector)
-		if (!write_atr_sector(pai, zero_buf))
-			return FALSE;
-	return TRUE;
+	while (img->dcm.current_sector < till_sector)
+		write_atr_sector(img, zero_buf);
 }
 
-static int dcm_pass(FILE *infp, ATR_Info *pai)
+/* Decodes a sector of the given coding type into sector_buf. */
+static int dcm_sector(DCM_Info *pdi, FILE *infp, int sector_type)
 {
-	UBYTE sector_buf[256];
-	memset(sector_buf, 0, sizeof(sector_buf));
-	for (;;) {
-		/* sector group */
-		int sector_no;
-		int sector_type;
-		sector_no = fgetw(infp);
-		sector_type = fgetc(infp);
-		if (sector_type == 0x45)
-			return TRUE;
-		if (sector_no < pai->current_sector) {
-			Log_print("Error: current sector is %d, next sector group at %d", pai->current_sector, sector_no);
+	UBYTE *sector_buf = pdi->sector_buf;
+	int i;
+	switch (sector_type & 0x7f) {
+	case 0x41:
+		i = fgetc(infp);
+		if (i == EOF)
 			return FALSE;
-		}
-		if (!pad_till_sector(pai, sector_no))
+		do {
+			int b = fgetc(infp);
+			if (b == EOF)
+				return FALSE;
+			sector_buf[i] = (UBYTE) b;
+		} while (i-- != 0);
+		break;
+	case 0x42:
+		if (!fload(sector_buf + 123, 5, infp))
 			return FALSE;
-		for (;;) {
-			/* sector */
-			int i;
-			switch (sector_type & 0x7f) {
-			case 0x41:
-				i = fgetc(infp);
-				if (i == EOF)
-					return FALSE;
-				do {
-					int b = fgetc(infp);
-					if (b == EOF)
-						return FALSE;
-					sector_buf[i] = (UBYTE) b;
-				} while (i-- != 0);
-				break;
-			case 0x42:
-				if (!fload(sector_buf + 123, 5, infp))
-					return FALSE;
-				memset(sector_buf, sector_buf[123], 123);
-				break;
-			case 0x43:
-				i = 0;
-				do {
-					int j;
-					int c;
-					j = fgetc(infp);
-					if (j < i) {
-						if (j != 0)
-							return FALSE;
-						j = 256;
-					}
-					if (i < j && !fload(sector_buf + i, j - i, infp))
-						return FALSE;
-					if (j >= pai->sectorsize)
-						break;
-					i = fgetc(infp);
-					if (i < j) {
-						if (i != 0)
-							return FALSE;
-						i = 256;
-					}
-					c = fgetc(infp);
-					if (c == EOF)
-						return FALSE;
-					memset(sector_buf + j, c, i - j);
-				} while (i < pai->sectorsize);
-				break;
-			case 0x44:
-				i = fgetc(infp);
-				if (i == EOF || i >= pai->sectorsize)
-					return FALSE;
-				if (!fload(sector_buf + i, pai->sectorsize - i, infp))
+		memset(sector_buf, sector_buf[123], 123);
+		break;
+	case 0x43:
+		i = 0;
+		do {
+			int j;
+			int c;
+			j = fgetc(infp);
+			if (j < i) {
+				if (j != 0)
 					return FALSE;
+				j = 256;
+			}
+			if (i < j && !fload(sector_buf + i, j - i, infp))
+				return FALSE;
+			if (j >= pdi->sectorsize)
 				break;
-			case 0x46:
-				break;
-			case 0x47:
-				if (!fload(sector_buf, pai->sectorsize, infp))
+			i = fgetc(infp);
+			if (i < j) {
+				if (i != 0)
 					return FALSE;
-				break;
-			default:
-				Log_print("Unrecognized sector coding type 0x%02X", sector_type);
-				return FALSE;
+				i = 256;
 			}
-			if (!write_atr_sector(pai, sector_buf))
+			c = fgetc(infp);
+			if (c == EOF)
 				return FALSE;
-			if (!(sector_type & 0x80))
-				break; /* goto sector group */
-			sector_type = fgetc(infp);
-			if (sector_type == 0x45)
-				return TRUE;
-		}
+			memset(sector_buf + j, c, i - j);
+		} while (i < pdi->sectorsize);
+		break;
+	case 0x44:
+		i = fgetc(infp);
+		if (i == EOF || i >= pdi->sectorsize)
+			return FALSE;
+		if (!fload(sector_buf + i, pdi->sectorsize - i, infp))
+			return FALSE;
+		break;
+	case 0x46:
+		break;
+	case 0x47:
+		if (!fload(sector_buf, pdi->sectorsize, infp))
+			return FALSE;
+		break;
+	default:
+		Log_print("Unrecognized sector coding type 0x%02X", sector_type);
+		return FALSE;
 	}
+	return TRUE;
 }
 
-int CompFile_DCMtoATR(FILE *infp, FILE *outfp)
+static int dcm_end_pass(Image *img)
 {
-	int archive_type;
-	int archive_flags;
-	ATR_Info ai;
-	int pass_flags;
+	DCM_Info *pdi = &img->dcm;
+	int block_type;
 	int last_sector;
-	archive_type = fgetc(infp);
-	if (archive_type != 0xf9 && archive_type != 0xfa) {
+	if (!(pdi->pass_flags & 0x80)) {
+		block_type = fgetc(img->infp);
+		if (block_type != pdi->archive_type) {
+			if (block_type == EOF && pdi->archive_type == 0xf9) {
+				Log_print("Multi-part archive error.");
+				Log_print("To process these files, you must first combine the files into a single file.");
+#if defined(HAVE_WINDOWS_H) || defined(DJGPP)
+				Log_print("COPY /B file1.dcm+file2.dcm+file3.dcm newfile.dcm from the DOS prompt");
+#elif defined(__linux__) || defined(__unix__)
+				Log_print("cat file1.dcm file2.dcm file3.dcm >newfile.dcm from the shell");
+#endif
+			}
+			return FALSE;
+		}
+		pdi->pass_flags = fgetc(img->infp);
+		if ((pdi->pass_flags ^ pdi->archive_flags) & 0x60) {
+			Log_print("Density changed inside DCM archive?");
+			return FALSE;
+		}
+		/* TODO: check pass number, this is tricky for >31 */
+		memset(pdi->sector_buf, 0, sizeof(pdi->sector_buf));
+		pdi->in_group = FALSE;
+		return TRUE;
+	}
+	/* last pass */
+	last_sector = pdi->current_sector - 1;
+	if (last_sector <= pdi->sectorcount)
+		pad_till_sector(img, pdi->sectorcount + 1);
+	else {
+		/* more sectors written: update ATR header */
+		pdi->sectorcount = last_sector;
+		make_atr_header(pdi, (struct AFILE_ATR_Header *) img->data);
+	}
+	img->done = TRUE;
+	return TRUE;
+}
+
+/* Decodes the next sector, or the end of a pass. */
+static int dcm_more(Image *img)
+{
+	DCM_Info *pdi = &img->dcm;
+	int sector_type;
+	if (!pdi->in_group) {
+		/* sector group */
+		int sector_no;
+		sector_no = fgetw(img->infp);
+		sector_type = fgetc(img->infp);
+		if (sector_type == 0x45)
+			return dcm_end_pass(img);
+		if (sector_no < pdi->current_sector) {
+			Log_print("Error: current sector is %d, next sector group at %d", pdi->current_sector, sector_no);
+			return FALSE;
+		}
+		pad_till_sector(img, sector_no);
+	}
+	else {
+		sector_type = fgetc(img->infp);
+		if (sector_type == 0x45)
+			return dcm_end_pass(img);
+	}
+	if (!dcm_sector(pdi, img->infp, sector_type))
+		return FALSE;
+	write_atr_sector(img, pdi->sector_buf);
+	pdi->in_group = (sector_type & 0x80) != 0;
+	return TRUE;
+}
+
+/* Reads the archive header and starts an ATR image with its header. */
+static int dcm_open(Image *img, FILE *infp)
+{
+	DCM_Info *pdi = &img->dcm;
+	struct AFILE_ATR_Header header;
+	memset(img, 0, sizeof(*img));
+	pdi->archive_type = fgetc(infp);
+	if (pdi->archive_type != 0xf9 && pdi->archive_type != 0xfa) {
 		Log_print("This is not a DCM image");
 		return FALSE;
 	}
-	archive_flags = fgetc(infp);
-	if ((archive_flags & 0x1f) != 1) {
+	pdi->archive_flags = fgetc(infp);
+	if ((pdi->archive_flags & 0x1f) != 1) {
 		Log_print("Expected pass one first");
-		if (archive_type == 0xf9)
+		if (pdi->archive_type == 0xf9)
 			Log_print("It seems that DCMs of a multi-file archive have been combined in wrong order");
 		return FALSE;
 	}
-	ai.fp = outfp;
-	ai.current_sector = 1;
-	switch ((archive_flags >> 5) & 3) {
+	pdi->current_sector = 1;
+	switch ((pdi->archive_flags >> 5) & 3) {
 	case 0:
-		ai.sectorcount = 720;
-		ai.sectorsize = 128;
+		pdi->sectorcount = 720;
+		pdi->sectorsize = 128;
 		break;
 	case 1:
-		ai.sectorcount = 720;
-		ai.sectorsize = 256;
+		pdi->sectorcount = 720;
+		pdi->sectorsize = 256;
 		break;
 	case 2:
-		ai.sectorcount = 1040;
-		ai.sectorsize = 128;
+		pdi->sectorcount = 1040;
+		pdi->sectorsize = 128;
 		break;
 	default:
 		Log_print("Unrecognized density");
 		return FALSE;
 	}
-	if (!write_atr_header(&ai))
+	pdi->pass_flags = pdi->archive_flags;
+	make_atr_header(pdi, &header);
+	image_append(img, (const UBYTE *) &header, sizeof(header));
+	img->infp = infp;
+	img->more = dcm_more;
+	return TRUE;
+}
+
+int CompFile_DCMtoATR(FILE *infp, FILE *outfp)
+{
+	Image img;
+	int result;
+	if (!dcm_open(&img, infp))
 		return FALSE;
-	pass_flags = archive_flags;
-	for (;;) {
-		/* pass */
-		int block_type;
-		if (!dcm_pass(infp, &ai))
-			return FALSE;
-		if (pass_flags & 0x80)
-			break;
-		block_type = fgetc(infp);
-		if (block_type != archive_type) {
-			if (block_type == EOF && archive_type == 0xf9) {
-				Log_print("Multi-part archive error.");
-				Log_print("To process these files, you must first combine the files into a single file.");
-#if defined(HAVE_WINDOWS_H) || defined(DJGPP)
-				Log_print("COPY /B file1.dcm+file2.dcm+file3.dcm newfile.dcm from the DOS prompt");
-#elif defined(__linux__) || defined(__unix__)
-				Log_print("cat file1.dcm file2.dcm file3.dcm >newfile.dcm from the shell");
+	image_fill(&img, (size_t) -1);
+	result = !img.failed && fsave(img.data, (int) img.size, outfp);
+	image_free(&img);
+	return result;
+}
+
+
+#ifdef COMPFILE_STREAMS
+
+/* Streams of decompressed images ---------------------------------------- */
+
+static long image_read(Image *img, char *buf, size_t len)
+{
+	image_fill(img, img->pos + len);
+	if (img->pos >= img->size)
+		return img->failed ? -1 : 0;
+	if (len > img->size - img->pos)
+		len = img->size - img->pos;
+	memcpy(buf, img->data + img->pos, len);
+	img->pos += len;
+	return (long) len;
+}
+
+static long image_seek(Image *img, long offset, int whence)
+{
+	switch (whence) {
+	case SEEK_CUR:
+		offset += (long) img->pos;
+		break;
+	case SEEK_END:
+		image_fill(img, (size_t) -1);
+		offset += (long) img->size;
+		break;
+	default:
+		break;
+	}
+	if (offset < 0)
+		return -1;
+	img->pos = (size_t) offset;
+	return offset;
+}
+
+static void image_close(Image *img)
+{
+	image_free(img);
+	if (img->infp != NULL)
+		fclose(img->infp);
+	free(img);
+}
+
+#ifdef HAVE_FUNOPEN
+
+static int funopen_read(void *cookie, char *buf, int len)
+{
+	return (int) image_read((Image *) cookie, buf, (size_t) len);
+}
+
+static fpos_t funopen_seek(void *cookie, fpos_t offset, int whence)
+{
+	return image_seek((Image *) cookie, (long) offset, whence);
+}
+
+static int funopen_close(void *cookie)
+{
+	image_close((Image *) cookie);
+	return 0;
+}
+
+#else /* HAVE_FOPENCOOKIE */
+
+static ssize_t cookie_read(void *cookie, char *buf, size_t len)
+{
+	return image_read((Image *) cookie, buf, len);
+}
+
+static int cookie_seek(void *cookie, off64_t *offset, int whence)
+{
+	long pos = image_seek((Image *) cookie, (long) *offset, whence);
+	if (pos < 0)
+		return -1;
+	*offset = pos;
+	return 0;
+}
+
+static int cookie_close(void *cookie)
+{
+	image_close((Image *) cookie);
+	return 0;
+}
+
+#endif /* HAVE_FUNOPEN */
+
+/* Returns a stream reading img, or NULL after freeing img except infp. */
+static FILE *image_stream(Image *img)
+{
+	FILE *fp;
+#ifdef HAVE_FUNOPEN
+	fp = funopen(img, funopen_read, NULL, funopen_seek, funopen_close);
+#else
+	cookie_io_functions_t io = { cookie_read, NULL, cookie_seek, cookie_close };
+	fp = fopencookie(img, "rb", io);
 #endif
-			}
-			return FALSE;
-		}
-		pass_flags = fgetc(infp);
-		if ((pass_flags ^ archive_flags) & 0x60) {
-			Log_print("Density changed inside DCM archive?");
-			return FALSE;
-		}
-		/* TODO: check pass number, this is tricky for >31 */
+	if (fp == NULL) {
+		image_free(img);
+		free(img);
+		return NULL;
 	}
-	last_sector = ai.current_sector - 1;
-	if (last_sector <= ai.sectorcount)
-		return pad_till_sector(&ai, ai.sectorcount + 1);
-	/* more sectors written: update ATR header */
-	ai.sectorcount = last_sector;
-	Util_rewind(outfp);
-	return write_atr_header(&ai);
+	/* The image is in memory already: don't copy it to a stdio buffer, and
+	   only decompress as much as each fread asks for. */
+	setvbuf(fp, NULL, _IONBF, 0);
+	return fp;
 }
+
+#ifdef HAVE_LIBZ
+static int gz_more(Image *img)
+{
+	int result;
+	image_reserve(img, UNCOMPRESS_BUFFER_SIZE);
+	result = gzread(img->gzf, img->data + img->size, UNCOMPRESS_BUFFER_SIZE);
+	if (result < 0) {
+		Log_print("ZLIB could not decompress the image");
+		return FALSE;
+	}
+	img->size += result;
+	if (result < UNCOMPRESS_BUFFER_SIZE)
+		img->done = TRUE;
+	return TRUE;
+}
+#endif /* HAVE_LIBZ */
+
+FILE *CompFile_OpenGZ(const char *infilename)
+{
+#ifndef HAVE_LIBZ
+	Log_print("This executable cannot decompress ZLIB files");
+	return NULL;
+#else
+	Image *img;
+	gzFile gzf = gzopen(infilename, "rb");
+	if (gzf == NULL) {
+		Log_print("ZLIB could not open file %s", infilename);
+		return NULL;
+	}
+	img = (Image *) Util_malloc(sizeof(Image));
+	memset(img, 0, sizeof(*img));
+	img->gzf = gzf;
+	img->more = gz_more;
+	return image_stream(img);
+#endif /* HAVE_LIBZ */
+}
+
+FILE *CompFile_OpenDCM(FILE *infp)
+{
+	Image *img = (Image *) Util_malloc(sizeof(Image));
+	if (!dcm_open(img, infp)) {
+		free(img);
+		return NULL;
+	}
+	/* Only the last pass fixes the sector count in the ATR header, and the
+	   caller reads the header first, so decode the whole archive now. */
+	image_fill(img, (size_t) -1);
+	if (img->failed) {
+		image_free(img);
+		free(img);
+		return NULL;
+	}
+	return image_stream(img);
+}
+
+#endif /* COMPFILE_STREAMS */
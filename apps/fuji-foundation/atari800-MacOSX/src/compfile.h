@@ -1,9 +1,23 @@
 #ifndef COMPFILE_H_
 #define COMPFILE_H_
 
+#include "config.h"
 #include <stdio.h>  /* FILE */
 
 int CompFile_ExtractGZ(const char *infilename, FILE *outfp);
 int CompFile_DCMtoATR(FILE *infp, FILE *outfp);
 
+#if defined(HAVE_FUNOPEN) || defined(HAVE_FOPENCOOKIE)
+#define COMPFILE_STREAMS
+/* Open a read-only stream of the image in a GZIP file or a DCM archive
+   without writing it anywhere. A GZIP image is decompressed into memory as
+   far as the stream has been read or sought. A DCM archive is decoded
+   completely before CompFile_OpenDCM() returns, because only its last pass
+   gives the final sector count for the ATR header.
+   CompFile_OpenDCM() reads infp from its current position and closes it
+   with the stream. Both return NULL on error. */
+FILE *CompFile_OpenGZ(const char *infilename);
+FILE *CompFile_OpenDCM(FILE *infp);
+#endif
+
 #endif /* COMPFILE_H_ */
@@ -64,11 +64,14 @@
 #include "asap_internal.h"
 #else
 #include "antic.h"
+#include "cputrace.h"
 #include "atari.h"
 #include "esc.h"
 #include "memory.h"
 #include "monitor.h"
 #include "emuio.h"
+#include "perf.h"
+#include "profiler.h"
 #ifndef BASIC
 #include "statesav.h"
 #ifndef __PLUS
@@ -117,6 +120,8 @@ void CPU_PutStatus(void)
 /* #define NO_V_FLAG_VARIABLE */
 
 /* If PC_PTR is defined, local PC is "const UBYTE *", otherwise it's UWORD. */
+/* PC_PTR reads code straight from MEMORY_mem, so it does not see the XE bank
+   mapped through MEMORY_cpu_map. */
 /* #define PC_PTR */
 
 /* If PREFETCH_CODE is defined, 2 bytes after the opcode are always fetched. */
@@ -375,6 +380,8 @@ void CPU_NMI(void)
 	UBYTE S = CPU_regS;
 	UBYTE data;
 
+	if (PROFILER_enabled)
+		PROFILER_Interrupt(CPU_regPC, S);
 	PHW(CPU_regPC);
 	PHPB0;
 	CPU_SetI;
@@ -387,6 +394,8 @@ void CPU_NMI(void)
 /* Check pending IRQ, helps in (not only) Lucasfilm games */
 #define CPUCHECKIRQ \
 	if (CPU_IRQ && !(CPU_regP & CPU_I_FLAG) && ANTIC_xpos < ANTIC_xpos_limit) { \
+		if (PROFILER_enabled) \
+			PROFILER_Interrupt(GET_PC(), S); \
 		PHPC; \
 		PHPB0; \
 		CPU_SetI; \
@@ -438,6 +447,12 @@ static const int cycles[256] =
 	2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7		/* Fx */
 };
 
+#ifdef PERF_COUNTERS
+/* CPU_GO() is defined below as a timing wrapper around the emulation loop */
+static void cpu_go(int limit);
+#define CPU_GO cpu_go
+#endif
+
 /* 6502 emulation routine */
 #ifndef NO_GOTO
 __extension__ /* suppress -ansi -pedantic warnings */
@@ -631,39 +646,13 @@ void CPU_GO(int limit)
 #endif /* PC_PTR */
 
 #ifdef MONITOR_TRACE
-#ifdef MACOSX
-		if (MONITOR_tron) {
-#ifdef NEW_CYCLE_EXACT
-			fprintf(MONITOR_trace_file, "%3d ", ANTIC_ypos);
-			fprintf(MONITOR_trace_file, "%3d ", ANTIC_xpos);
-#endif
-			fprintf(MONITOR_trace_file, "%04X ", GET_PC());
-			MONITOR_show_instruction_file(MONITOR_trace_file, GET_PC(), 22);
-			fprintf(MONITOR_trace_file, "; %Xcyc ; ", cycles[insn]);
-			fprintf(MONITOR_trace_file, "A=%02x S=%02x X=%02x Y=%02x P=",A,S,X,Y);
-			fputc(N&0x80 ? 'N' : '-', MONITOR_trace_file);
-			fputc(V ? 'V' : '-', MONITOR_trace_file);
-			fputc('*', MONITOR_trace_file);
-			fputc(CPU_regP & CPU_B_FLAG ? 'B' : '-', MONITOR_trace_file);
-			fputc(CPU_regP & CPU_D_FLAG ? 'D' : '-', MONITOR_trace_file);
-			fputc(CPU_regP & CPU_I_FLAG ? 'I' : '-', MONITOR_trace_file);
-			fputc(Z ? '-' : 'Z', MONITOR_trace_file);
-			fputc(C ? 'C' : '-', MONITOR_trace_file);
-			fputc('\n', MONITOR_trace_file);
-		}
-#else		
-		if (MONITOR_trace_file != NULL) {
-			MONITOR_ShowState(MONITOR_trace_file, GET_PC(), A, X, Y, S,
-				(N & 0x80) ? 'N' : '-',
+		if (CPUTRACE_enabled)
+			CPUTRACE_Record(GET_PC(), A, X, Y, S,
 #ifndef NO_V_FLAG_VARIABLE
-				V ? 'V' : '-',
+				(N & 0x80) + (V ? 0x40 : 0) + (CPU_regP & 0x3c) + ((Z == 0) ? 0x02 : 0) + C);
 #else
-				(CPU_regP & CPU_V_FLAG) ? 'V' : '-',
+				(N & 0x80) + (CPU_regP & 0x7c) + ((Z == 0) ? 0x02 : 0) + C);
 #endif
-				(Z == 0) ? 'Z' : '-',
-				(C != 0) ? 'C' : '-');
-		}
-#endif		
 #endif
 
 #ifdef MONITOR_BREAK
@@ -890,6 +879,9 @@ void CPU_GO(int limit)
 #endif /* MACOSX */			
 #endif /* MONITOR_BREAKPOINTS */
 
+		if (PROFILER_enabled)
+			PROFILER_Step((UWORD) (GET_PC() - 1), S, insn);
+
 #ifndef CYCLES_PER_OPCODE
 		ANTIC_xpos += cycles[insn];
 #endif
@@ -2478,6 +2470,16 @@ void CPU_GO(int limit)
 	UPDATE_GLOBAL_REGS;
 }
 
+#ifdef PERF_COUNTERS
+#undef CPU_GO
+void CPU_GO(int limit)
+{
+	PERF_BEGIN(PERF_CPU);
+	cpu_go(limit);
+	PERF_END(PERF_CPU);
+}
+#endif
+
 void CPU_Initialise(void)
 {
 }
@@ -2673,27 +2675,27 @@ void CPU_Initialise(void)
 	}
 	static void handle_mem_less_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]>=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)>=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_mem_equal_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]!=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)!=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_mem_less_equal_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]>MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)>MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_mem_great_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]<=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)<=MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_mem_not_equal_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]==MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)==MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_mem_great_equal_break()
 	{
-		if (MEMORY_mem[MONITOR_breakpoint_table[check_break_i].addr]<MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
+		if (MEMORY_dGetByte(MONITOR_breakpoint_table[check_break_i].addr)<MONITOR_breakpoint_table[check_break_i].val) check_break_condition=0;
 	}
 	static void handle_access_less_break()
 	{
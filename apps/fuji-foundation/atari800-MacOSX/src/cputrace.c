@@ -0,0 +1,243 @@
+/*
+ * cputrace.c - binary 6502 instruction trace
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#if !defined(WIN32) && !defined(DREAMCAST)
+#include <pthread.h>
+#define TRACE_THREAD
+#endif
+
+#include "antic.h"
+#include "cputrace.h"
+#include "log.h"
+#include "memory.h"
+#include "monitor.h"
+
+/* Records per block, and blocks in the ring shared with the writer. The
+   CPU fills one block while the others wait to be compressed; 8 blocks of
+   512 KB hold about a second of emulation. */
+#define BLOCK_RECORDS 32768
+#define BLOCK_SIZE (BLOCK_RECORDS * CPUTRACE_RECORD_SIZE)
+#define BLOCKS 8
+
+int CPUTRACE_enabled = FALSE;
+
+#ifdef HAVE_LIBZ
+static gzFile out = NULL;
+#else
+static FILE *out = NULL;
+#endif
+static int write_failed;
+
+static UBYTE *blocks[BLOCKS];
+static int block_len[BLOCKS];	/* bytes used in a queued block */
+
+/* The block being filled by the CPU, and the next free byte in it. */
+static int fill_block;
+static UBYTE *fill;
+static UBYTE *fill_end;
+
+/* The writer owns the QUEUED blocks starting at HEAD; the CPU fills the
+   one after them. */
+static int head;
+static int queued;
+
+static unsigned int last_clock;
+
+#ifdef TRACE_THREAD
+static pthread_t writer_id;
+static pthread_mutex_t ring_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t space_cond = PTHREAD_COND_INITIALIZER;
+static int writer_running;
+static int writer_quit;
+#endif
+
+static void write_block(const UBYTE *buf, int len)
+{
+	if (write_failed || len == 0)
+		return;
+#ifdef HAVE_LIBZ
+	if (gzwrite(out, buf, len) != len)
+		write_failed = TRUE;
+#else
+	if (fwrite(buf, 1, len, out) != (size_t) len)
+		write_failed = TRUE;
+#endif
+}
+
+#ifdef TRACE_THREAD
+static void *writer(void *arg)
+{
+	pthread_mutex_lock(&ring_mutex);
+	for (;;) {
+		int b;
+		while (queued == 0 && !writer_quit)
+			pthread_cond_wait(&work_cond, &ring_mutex);
+		if (queued == 0)
+			break;
+		b = head;
+		pthread_mutex_unlock(&ring_mutex);
+		write_block(blocks[b], block_len[b]);
+		pthread_mutex_lock(&ring_mutex);
+		head = (head + 1) % BLOCKS;
+		queued--;
+		pthread_cond_signal(&space_cond);
+	}
+	pthread_mutex_unlock(&ring_mutex);
+	return NULL;
+}
+#endif /* TRACE_THREAD */
+
+/* Hands the block being filled to the writer and starts the next one. */
+static void flush_fill(void)
+{
+	block_len[fill_block] = fill - blocks[fill_block];
+#ifdef TRACE_THREAD
+	if (writer_running) {
+		pthread_mutex_lock(&ring_mutex);
+		queued++;
+		pthread_cond_signal(&work_cond);
+		/* Wait rather than drop records when the writer is behind. */
+		while (queued == BLOCKS)
+			pthread_cond_wait(&space_cond, &ring_mutex);
+		pthread_mutex_unlock(&ring_mutex);
+		fill_block = (fill_block + 1) % BLOCKS;
+	}
+	else
+#endif
+		write_block(blocks[fill_block], block_len[fill_block]);
+	fill = blocks[fill_block];
+	fill_end = fill + BLOCK_SIZE;
+}
+
+void CPUTRACE_Record(UWORD pc, UBYTE a, UBYTE x, UBYTE y, UBYTE s, UBYTE p)
+{
+	UBYTE *r = fill;
+	UBYTE insn = MEMORY_dGetByte(pc);
+	int len = MONITOR_optype6502[insn] & 3;
+	unsigned int now = ANTIC_CPU_CLOCK;
+	unsigned int delta = now - last_clock;
+	last_clock = now;
+	if (delta >= CPUTRACE_CYCLES_UNKNOWN)
+		delta = CPUTRACE_CYCLES_UNKNOWN;
+	r[0] = (UBYTE) pc;
+	r[1] = (UBYTE) (pc >> 8);
+	r[2] = insn;
+	r[3] = len > 1 ? MEMORY_dGetByte((UWORD) (pc + 1)) : 0;
+	r[4] = len > 2 ? MEMORY_dGetByte((UWORD) (pc + 2)) : 0;
+	r[5] = a;
+	r[6] = x;
+	r[7] = y;
+	r[8] = s;
+	r[9] = p;
+	r[10] = (UBYTE) ANTIC_ypos;
+	r[11] = (UBYTE) (ANTIC_ypos >> 8);
+	r[12] = ANTIC_xpos > 255 ? 255 : (UBYTE) ANTIC_xpos;
+	r[13] = 0;
+	r[14] = (UBYTE) delta;
+	r[15] = (UBYTE) (delta >> 8);
+	fill = r + CPUTRACE_RECORD_SIZE;
+	if (fill == fill_end)
+		flush_fill();
+}
+
+int CPUTRACE_Start(const char *filename)
+{
+	UBYTE header[CPUTRACE_HEADER_SIZE];
+	int i;
+	CPUTRACE_Stop();
+	for (i = 0; i < BLOCKS; i++) {
+		if (blocks[i] == NULL) {
+			blocks[i] = (UBYTE *) malloc(BLOCK_SIZE);
+			if (blocks[i] == NULL) {
+				Log_print("Not enough memory for the trace");
+				return FALSE;
+			}
+		}
+	}
+#ifdef HAVE_LIBZ
+	/* Speed over size: the trace compresses well even at level 1. */
+	out = gzopen(filename, "wb1");
+#else
+	out = fopen(filename, "wb");
+#endif
+	if (out == NULL) {
+		Log_print("Can't create %s", filename);
+		return FALSE;
+	}
+	memset(header, 0, sizeof(header));
+	memcpy(header, CPUTRACE_MAGIC, sizeof(CPUTRACE_MAGIC));
+	header[8] = CPUTRACE_VERSION;
+	header[9] = CPUTRACE_RECORD_SIZE;
+	write_failed = FALSE;
+	write_block(header, sizeof(header));
+	head = 0;
+	queued = 0;
+	fill_block = 0;
+	fill = blocks[0];
+	fill_end = fill + BLOCK_SIZE;
+	/* The first record has no predecessor. */
+	last_clock = ANTIC_CPU_CLOCK - CPUTRACE_CYCLES_UNKNOWN;
+#ifdef TRACE_THREAD
+	writer_quit = FALSE;
+	/* Without the thread, full blocks are written by the CPU. */
+	writer_running = pthread_create(&writer_id, NULL, writer, NULL) == 0;
+#endif
+	CPUTRACE_enabled = TRUE;
+	return TRUE;
+}
+
+int CPUTRACE_Stop(void)
+{
+	int ok;
+	if (out == NULL)
+		return TRUE;
+	CPUTRACE_enabled = FALSE;
+	flush_fill();
+#ifdef TRACE_THREAD
+	if (writer_running) {
+		pthread_mutex_lock(&ring_mutex);
+		writer_quit = TRUE;
+		pthread_cond_signal(&work_cond);
+		pthread_mutex_unlock(&ring_mutex);
+		pthread_join(writer_id, NULL);
+		writer_running = FALSE;
+	}
+#endif
+#ifdef HAVE_LIBZ
+	ok = gzclose(out) == Z_OK && !write_failed;
+#else
+	ok = fclose(out) == 0 && !write_failed;
+#endif
+	out = NULL;
+	if (!ok)
+		Log_print("Error writing the trace");
+	return ok;
+}
@@ -0,0 +1,50 @@
+#ifndef CPUTRACE_H_
+#define CPUTRACE_H_
+
+#include "atari.h"
+
+/* Binary trace of executed 6502 instructions.
+   While enabled, the CPU core records every instruction before executing
+   it into a fixed-size record in a block of memory. Full blocks are handed
+   to a background thread that compresses them into the trace file, so
+   minutes of execution can be traced at close to full speed. The CPU only
+   waits if the compressor falls a whole ring of blocks behind.
+   util/tracedump.c turns a trace into a disassembly listing.
+
+   The file is gzip compressed (plain when built without zlib). It starts
+   with a CPUTRACE_HEADER_SIZE byte header: CPUTRACE_MAGIC, then the format
+   version and the record size, then zeros. The records follow, with
+   values little-endian:
+     0-1   PC
+     2-4   opcode and operand bytes, zero past the end of the instruction
+     5-9   A, X, Y, S, P
+     10-11 scanline (ANTIC_ypos)
+     12    cycle in the scanline (ANTIC_xpos, at most 255)
+     13    zero
+     14-15 machine cycles since the previous record, including cycles taken
+           by DMA and WSYNC; 0xffff if unknown (the clock was reset, or it
+           is 0xffff or more) */
+
+#define CPUTRACE_MAGIC "A8TRACE"	/* 8 bytes with the terminating zero */
+#define CPUTRACE_VERSION 1
+#define CPUTRACE_HEADER_SIZE 16
+#define CPUTRACE_RECORD_SIZE 16
+#define CPUTRACE_CYCLES_UNKNOWN 0xffff
+
+/* Non-zero while tracing; tested by the CPU core before calling
+   CPUTRACE_Record(). */
+extern int CPUTRACE_enabled;
+
+/* Starts tracing to FILENAME, stopping a trace in progress. Returns FALSE
+   if the file can't be created. */
+int CPUTRACE_Start(const char *filename);
+
+/* Writes the rest of the trace and closes the file. Returns FALSE if
+   writing failed. */
+int CPUTRACE_Stop(void);
+
+/* Called by the CPU core before executing the instruction at PC, with the
+   registers and the processor status P. */
+void CPUTRACE_Record(UWORD pc, UBYTE a, UBYTE x, UBYTE y, UBYTE s, UBYTE p);
+
+#endif /* CPUTRACE_H_ */
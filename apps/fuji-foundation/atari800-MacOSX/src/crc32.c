@@ -22,12 +22,19 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include "config.h"
 #include <stdio.h>
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#include <stdint.h>
+#include <string.h>
+#define HW_CRC32
+#endif
 
 #include "crc32.h"
 #include "atari.h"
 
-#define BUF_SIZE 0x400
+#define BUF_SIZE 0x4000
 
 /* Table contents generated with the following algorithm:
 #define POLYNOMIAL 0xedb88320
@@ -77,8 +84,63 @@ static ULONG table[0x100]= {
 	0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+#ifdef HW_CRC32
+
+/* ARMv8 CRC32X/CRC32B use the same reflected 0xedb88320 polynomial. */
 ULONG CRC32_Update(ULONG crc, UBYTE const *buf, unsigned int len)
 {
+	uint32_t c = (uint32_t) crc;
+	while (len > 0 && ((uintptr_t) buf & 7) != 0) {
+		c = __crc32b(c, *buf++);
+		--len;
+	}
+	while (len >= 8) {
+		uint64_t v;
+		memcpy(&v, buf, 8);
+		c = __crc32d(c, v);
+		buf += 8;
+		len -= 8;
+	}
+	while (len > 0) {
+		c = __crc32b(c, *buf++);
+		--len;
+	}
+	return c;
+}
+
+#else /* HW_CRC32 */
+
+/* Slicing-by-8: slice[k][i] is the CRC of byte I followed by K zero bytes,
+   so eight input bytes are folded with eight independent lookups. Built from
+   TABLE on first use. */
+static ULONG slice[8][0x100];
+static int slice_ready = FALSE;
+
+static void init_slice(void)
+{
+	int i, k;
+	for (i = 0; i < 0x100; ++i)
+		slice[0][i] = table[i];
+	for (k = 1; k < 8; ++k)
+		for (i = 0; i < 0x100; ++i)
+			slice[k][i] = (slice[k - 1][i] >> 8) ^ table[slice[k - 1][i] & 0xff];
+	slice_ready = TRUE;
+}
+
+ULONG CRC32_Update(ULONG crc, UBYTE const *buf, unsigned int len)
+{
+	if (!slice_ready)
+		init_slice();
+
+	while (len >= 8) {
+		ULONG lo = crc ^ ((ULONG) buf[0] | (ULONG) buf[1] << 8 | (ULONG) buf[2] << 16 | (ULONG) buf[3] << 24);
+		crc = slice[7][lo & 0xff] ^ slice[6][(lo >> 8) & 0xff]
+		    ^ slice[5][(lo >> 16) & 0xff] ^ slice[4][(lo >> 24) & 0xff]
+		    ^ slice[3][buf[4]] ^ slice[2][buf[5]]
+		    ^ slice[1][buf[6]] ^ slice[0][buf[7]];
+		buf += 8;
+		len -= 8;
+	}
 	while (len > 0) {
 		crc = (crc >> 8) ^ table[(crc ^ *(buf++)) & 0xff];
 		--len;
@@ -87,6 +149,8 @@ ULONG CRC32_Update(ULONG crc, UBYTE const *buf, unsigned int len)
 	return crc;
 }
 
+#endif /* HW_CRC32 */
+
 int CRC32_FromFile(FILE *f, ULONG *result)
 {
 	UBYTE buf[BUF_SIZE];
@@ -1075,6 +1075,78 @@ static void Devices_H_Close(void)
 	CPU_ClrN;
 }
 
+/* Returns the next character from the stream of IOCB h_iocb, with EOLs
+   translated in text mode, or EOF. Expects h_lastbyte to hold the byte read
+   ahead, and reads ahead the following one. */
+static int Devices_H_GetChar(void)
+{
+	int ch = h_lastbyte[h_iocb];
+	if (ch == EOF)
+		return EOF;
+	if (h_textmode[h_iocb]) {
+		switch (ch) {
+		case 0x0d:
+			h_wascr[h_iocb] = TRUE;
+			ch = 0x9b;
+			break;
+		case 0x0a:
+			if (h_wascr[h_iocb]) {
+				/* ignore LF next to CR */
+				ch = fgetc(h_fp[h_iocb]);
+				if (ch != EOF) {
+					if (ch == 0x0d) {
+						h_wascr[h_iocb] = TRUE;
+						ch = 0x9b;
+					}
+					else
+						h_wascr[h_iocb] = FALSE;
+				}
+				else {
+					h_lastbyte[h_iocb] = EOF;
+					return EOF;
+				}
+			}
+			else
+				ch = 0x9b;
+			break;
+		default:
+			h_wascr[h_iocb] = FALSE;
+			break;
+		}
+	}
+	h_lastbyte[h_iocb] = fgetc(h_fp[h_iocb]);
+	return ch;
+}
+
+/* CIO moves GET/PUT CHARACTERS and GET RECORD data one byte per handler
+   call, advancing the buffer pointer ICBALZ and counting down ICBLLZ in
+   zero page. Returns the number of bytes left in such a transfer on IOCB
+   number IOCB, or 0 if the handler was not called from that loop: the
+   command and the bytes done so far must agree with the IOCB, so a direct
+   call with stale zero page is left alone. */
+int Devices_BlockLeft(int iocb, UBYTE const *cmds)
+{
+	UWORD addr = Devices_IOCB0 + iocb * 16;
+	UBYTE cmd = MEMORY_dGetByte(Devices_ICCOMZ);
+	UWORD bufadr = MEMORY_dGetWordAligned(Devices_ICBALZ);
+	UWORD left = MEMORY_dGetWordAligned(Devices_ICBLLZ);
+
+	if (strchr((char const *) cmds, cmd) == NULL
+	    || MEMORY_dGetByte(addr + Devices_ICCOM) != cmd
+	    || (UWORD) (bufadr - MEMORY_dGetWord(addr + Devices_ICBAL)) != (UWORD) (MEMORY_dGetWord(addr + Devices_ICBLL) - left))
+		return 0;
+	/* The handler calls stop where CIO would wrap the buffer pointer. */
+	if (left > 0x10000 - bufadr)
+		return 0x10000 - bufadr;
+	return left;
+}
+
+void Devices_BlockAdvance(int n)
+{
+	MEMORY_dPutWordAligned(Devices_ICBALZ, (UWORD) (MEMORY_dGetWordAligned(Devices_ICBALZ) + n));
+	MEMORY_dPutWordAligned(Devices_ICBLLZ, (UWORD) (MEMORY_dGetWordAligned(Devices_ICBLLZ) - n));
+}
+
 static void Devices_H_Read(void)
 {
 	if (devbug)
@@ -1082,51 +1154,48 @@ static void Devices_H_Read(void)
 	if (!Devices_GetIOCB())
 		return;
 	if (h_fp[h_iocb] != NULL) {
+		static UBYTE const block_cmds[] = { 0x05, 0x07, 0 }; /* GET RECORD, GET CHARACTERS */
 		int ch;
+		int left;
 		if (h_lastop[h_iocb] != 'r') {
 			if (h_lastop[h_iocb] == 'w')
 				fseek(h_fp[h_iocb], 0, SEEK_CUR);
 			h_lastbyte[h_iocb] = fgetc(h_fp[h_iocb]);
 			h_lastop[h_iocb] = 'r';
 		}
-		ch = h_lastbyte[h_iocb];
-		if (ch != EOF) {
-			if (h_textmode[h_iocb]) {
-				switch (ch) {
-				case 0x0d:
-					h_wascr[h_iocb] = TRUE;
-					ch = 0x9b;
-					break;
-				case 0x0a:
-					if (h_wascr[h_iocb]) {
-						/* ignore LF next to CR */
-						ch = fgetc(h_fp[h_iocb]);
-						if (ch != EOF) {
-							if (ch == 0x0d) {
-								h_wascr[h_iocb] = TRUE;
-								ch = 0x9b;
-							}
-							else
-								h_wascr[h_iocb] = FALSE;
-						}
-						else {
-							CPU_regY = 136; /* end of file */
-							CPU_SetN;
-							break;
-						}
-					}
-					else
-						ch = 0x9b;
-					break;
-				default:
-					h_wascr[h_iocb] = FALSE;
-					break;
+		ch = Devices_H_GetChar();
+		/* Inside a block GET, store all but the last byte of the block
+		   (or of the record) directly and return that one to CIO, which
+		   then finishes the transfer as if it had made every call. */
+		left = ch == EOF ? 0 : Devices_BlockLeft(h_iocb, block_cmds);
+		if (left > 1) {
+			int record = MEMORY_dGetByte(Devices_ICCOMZ) == 0x05;
+			UWORD bufadr = MEMORY_dGetWordAligned(Devices_ICBALZ);
+			UBYTE buf[0x400];
+			int n = 0;
+			int stored = 0;
+			while (stored + n < left - 1 && !(record && ch == 0x9b)
+			       && h_lastbyte[h_iocb] != EOF) {
+				buf[n++] = (UBYTE) ch;
+				ch = Devices_H_GetChar();
+				if (n == (int) sizeof(buf) || ch == EOF) {
+					MEMORY_CopyToMem(buf, (UWORD) (bufadr + stored), n);
+					stored += n;
+					n = 0;
 				}
+				if (ch == EOF)
+					break;
 			}
+			if (n > 0) {
+				MEMORY_CopyToMem(buf, (UWORD) (bufadr + stored), n);
+				stored += n;
+			}
+			Devices_BlockAdvance(stored);
+		}
+		if (ch != EOF) {
 			CPU_regA = (UBYTE) ch;
 			/* [OSMAN] p. 79: Status should be 3 if next read would yield EOF.
 			   But to set the stream's EOF flag, we need to read the next byte. */
-			h_lastbyte[h_iocb] = fgetc(h_fp[h_iocb]);
 			CPU_regY = feof(h_fp[h_iocb]) ? 3 : 1;
 			CPU_ClrN;
 		}
@@ -1148,14 +1217,41 @@ static void Devices_H_Write(void)
 	if (!Devices_GetIOCB())
 		return;
 	if (h_fp[h_iocb] != NULL) {
+		static UBYTE const block_cmds[] = { 0x0b, 0 }; /* PUT CHARACTERS */
+		UBYTE buf[0x400];
 		int ch;
+		int left;
 		if (h_lastop[h_iocb] == 'r')
 			fseek(h_fp[h_iocb], 0, SEEK_CUR);
 		h_lastop[h_iocb] = 'w';
-		ch = CPU_regA;
-		if (ch == 0x9b && h_textmode[h_iocb])
-			ch = '\n';
-		fputc(ch, h_fp[h_iocb]);
+		/* Inside a block PUT, write the rest of the block now; CIO's own
+		   step past this byte then ends the transfer. PUT RECORD is left
+		   byte by byte, as CIO stops it on the EOL it passed in A. */
+		left = Devices_BlockLeft(h_iocb, block_cmds);
+		if (left > 1 && MEMORY_dGetByte(MEMORY_dGetWordAligned(Devices_ICBALZ)) == CPU_regA) {
+			UWORD bufadr = MEMORY_dGetWordAligned(Devices_ICBALZ);
+			int done = 0;
+			while (done < left) {
+				int n = left - done;
+				int i;
+				if (n > (int) sizeof(buf))
+					n = sizeof(buf);
+				MEMORY_CopyFromMem((UWORD) (bufadr + done), buf, n);
+				if (h_textmode[h_iocb])
+					for (i = 0; i < n; i++)
+						if (buf[i] == 0x9b)
+							buf[i] = '\n';
+				fwrite(buf, 1, n, h_fp[h_iocb]);
+				done += n;
+			}
+			Devices_BlockAdvance(left - 1);
+		}
+		else {
+			ch = CPU_regA;
+			if (ch == 0x9b && h_textmode[h_iocb])
+				ch = '\n';
+			fputc(ch, h_fp[h_iocb]);
+		}
 		CPU_regY = 1;
 		CPU_ClrN;
 	}
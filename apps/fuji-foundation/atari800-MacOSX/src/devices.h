@@ -84,6 +84,16 @@ extern struct DEV_B dev_b_status;
 
 UWORD Devices_UpdateHATABSEntry(char device, UWORD entry_address, UWORD table_address);
 void Devices_RemoveHATABSEntry(char device, UWORD entry_address, UWORD table_address);
+
+/* Block transfers: CIO calls a handler's READ/WRIT vector once per byte of
+   GET RECORD, GET CHARACTERS and PUT CHARACTERS. Devices_BlockLeft()
+   returns the bytes left in such a transfer on IOCB number IOCB if the
+   command in ICCOMZ is one of the zero-terminated CMDS, or 0 if the
+   handler wasn't called from CIO's loop. A handler may then move all but
+   the last byte itself and advance CIO's buffer pointer and length with
+   Devices_BlockAdvance(). */
+int Devices_BlockLeft(int iocb, UBYTE const *cmds);
+void Devices_BlockAdvance(int n);
 #ifdef ATARI800MACX
 void Devices_WarmCold_Start(void);
 #endif
@@ -17,6 +17,7 @@
 
 #include "flash.h"
 #include "atari.h"
+#include "util.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -37,6 +38,8 @@ const uint32_t SectorEraseTimeoutCycles50us = 89;
 const uint32_t SectorEraseTimeoutCycles30us = 54;
 
 static void SectorErase(FlashEmu *flash, uint32_t address);
+static void Erase(FlashEmu *flash, uint32_t address, uint32_t size);
+static void Mark_Dirty(FlashEmu *flash, uint32_t address, uint32_t size);
 
 FlashEmu *Flash_Init(void *mem, int type) {
     FlashEmu *flash = (FlashEmu *) malloc(sizeof(FlashEmu));
@@ -45,6 +48,8 @@ FlashEmu *Flash_Init(void *mem, int type) {
     flash->FlashType = type;
 
     flash->Dirty = FALSE;
+    flash->DirtyBlocks = NULL;
+    flash->DirtyOffset = 0;
     flash->WriteActivity = FALSE;
     flash->AtmelSDP = (type == Flash_TypeAT29C010A || type == Flash_TypeAT29C040);
 
@@ -121,6 +126,11 @@ void Flash_Shutdown(FlashEmu *flash) {
     free(flash);
 }
 
+void Flash_Track_Dirty(FlashEmu *flash, uint8_t *blocks, uint32_t offset) {
+    flash->DirtyBlocks = blocks;
+    flash->DirtyOffset = offset;
+}
+
 void Flash_Cold_Reset(FlashEmu *flash) {
 
     flash->ReadMode = ReadMode_Normal;
@@ -702,14 +712,14 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
                     case Flash_TypeM29F010B:
                     case Flash_TypeSST39SF010:
                     case Flash_TypeMX29F001T:
-                        memset(flash->Memory, 0xFF, 0x20000);
+                        Erase(flash, 0, 0x20000);
                         break;
 
                     case Flash_TypeAm29F002BT:
                     case Flash_TypeMX29F002B:
                     case Flash_TypeMX29F002T:
                     case Flash_TypeSST39SF020:
-                        memset(flash->Memory, 0xFF, 0x40000);        // 256K (2Mbit)
+                        Erase(flash, 0, 0x40000);        // 256K (2Mbit)
                         break;
 
                     case Flash_TypeAm29F040:
@@ -719,32 +729,32 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
                     case Flash_TypeBM29F040:
                     case Flash_TypeHY29F040A:
                     case Flash_TypeMX29F040:
-                        memset(flash->Memory, 0xFF, 0x80000);
+                        Erase(flash, 0, 0x80000);
                         break;
 
                     case Flash_TypeM29W800DT:
                     case Flash_TypeMX29LV640DT:
-                        memset(flash->Memory, 0xFF, 0x800000);        // 8M (64Mbit)
+                        Erase(flash, 0, 0x800000);        // 8M (64Mbit)
                         break;
 
                     case Flash_TypeAm29F016D:
-                        memset(flash->Memory, 0xFF, 0x200000);
+                        Erase(flash, 0, 0x200000);
                         break;
 
                     case Flash_TypeAm29F032B:
-                        memset(flash->Memory, 0xFF, 0x400000);
+                        Erase(flash, 0, 0x400000);
                         break;
 
                     case Flash_TypeS29GL01P:
-                        memset(flash->Memory, 0xFF, 0x8000000);
+                        Erase(flash, 0, 0x8000000);
                         break;
 
                     case Flash_TypeS29GL512P:
-                        memset(flash->Memory, 0xFF, 0x4000000);
+                        Erase(flash, 0, 0x4000000);
                         break;
 
                     case Flash_TypeS29GL256P:
-                        memset(flash->Memory, 0xFF, 0x2000000);
+                        Erase(flash, 0, 0x2000000);
                         break;
                 }
 
@@ -778,6 +788,7 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
 
         case 6:     // 5555[AA] 2AAA[55] 5555[A0]
             flash->Memory[address] &= value;
+            Mark_Dirty(flash, address, 1);
             flash->Dirty = TRUE;
             flash->WriteActivity = TRUE;
 
@@ -844,11 +855,11 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
                     case 0x10:      // chip erase
                         switch(flash->FlashType) {
                             case Flash_TypeAT29C010A:
-                                memset(flash->Memory, 0xFF, 0x20000);
+                                Erase(flash, 0, 0x20000);
                                 break;
 
                             case Flash_TypeAT29C040:
-                                memset(flash->Memory, 0xFF, 0x80000);
+                                Erase(flash, 0, 0x80000);
                                 break;
                         }
                         flash->Dirty = TRUE;
@@ -869,12 +880,13 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
         case 12:    // Atmel SDP program mode - initial sector write
             flash->WriteSector = address & 0xFFF00;
             flash->ReadMode = ReadMode_WriteStatusPending;
-            memset(flash->Memory, 0xFF, 256);
+            Erase(flash, 0, 256);
             flash->CommandPhase = 13;
             // fall through
 
         case 13:    // Atmel program mode - sector write
             flash->Memory[address] = value;
+            Mark_Dirty(flash, address, 1);
             flash->Dirty = TRUE;
             flash->WriteActivity = TRUE;
             return TRUE;
@@ -953,6 +965,7 @@ int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value) {
 
                 for(int i=0; i<32; ++i)
                     flash->Memory[flash->PendingWriteAddress + i] &= flash->WriteBufferData[i];
+                Mark_Dirty(flash, flash->PendingWriteAddress, 32);
 
                 flash->WriteActivity = TRUE;
                 flash->Dirty = TRUE;
@@ -971,7 +984,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
         case Flash_TypeAm29F010B:
         case Flash_TypeM29F010B:
             address &= 0x1C000;
-            memset(flash->Memory + address, 0xFF, 0x4000);
+            Erase(flash, address, 0x4000);
             printf("Erasing sector $%05X-%05X\n", address, address + 0x3FFF);
             break;
         case Flash_TypeAm29F040:
@@ -981,47 +994,47 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
         case Flash_TypeHY29F040A:
         case Flash_TypeMX29F040:
             address &= 0x70000;
-            memset(flash->Memory + address, 0xFF, 0x10000);
+            Erase(flash, address, 0x10000);
             printf("Erasing sector $%05X-%05X\n", address, address + 0xFFFF);
             break;
         case Flash_TypeSST39SF010:
             address &= 0x1F000;
-            memset(flash->Memory + address, 0xFF, 0x1000);
+            Erase(flash, address, 0x1000);
             printf("Erasing sector $%05X-%05X\n", address, address + 0xFFF);
             break;
         case Flash_TypeSST39SF020:
             address &= 0x3F000;
-            memset(flash->Memory + address, 0xFF, 0x1000);
+            Erase(flash, address, 0x1000);
             printf("Erasing sector $%05X-%05X\n", address, address + 0xFFF);
             break;
         case Flash_TypeSST39SF040:
             address &= 0x7F000;
-            memset(flash->Memory + address, 0xFF, 0x1000);
+            Erase(flash, address, 0x1000);
             printf("Erasing sector $%05X-%05X\n", address, address + 0xFFF);
             break;
         case Flash_TypeAm29F016D:
             address &= 0x1F0000;
-            memset(flash->Memory + address, 0xFF, 0x10000);
+            Erase(flash, address, 0x10000);
             printf("Erasing sector $%06X-%06X\n", address, address + 0xFFFF);
             break;
         case Flash_TypeAm29F032B:
             address &= 0x3F0000;
-            memset(flash->Memory + address, 0xFF, 0x10000);
+            Erase(flash, address, 0x10000);
             printf("Erasing sector $%06X-%06X\n", address, address + 0xFFFF);
             break;
         case Flash_TypeS29GL01P:
             address &= 0x7FF0000;
-            memset(flash->Memory + address, 0xFF, 0x20000);
+            Erase(flash, address, 0x20000);
             printf("Erasing sector $%07X-%07X\n", address, address + 0x1FFFF);
             break;
         case Flash_TypeS29GL512P:
             address &= 0x3FF0000;
-            memset(flash->Memory + address, 0xFF, 0x20000);
+            Erase(flash, address, 0x20000);
             printf("Erasing sector $%07X-%07X\n", address, address + 0x1FFFF);
             break;
         case Flash_TypeS29GL256P:
             address &= 0x1FF0000;
-            memset(flash->Memory + address, 0xFF, 0x20000);
+            Erase(flash, address, 0x20000);
             printf("Erasing sector $%07X-%07X\n", address, address + 0x1FFFF);
             break;
 
@@ -1051,7 +1064,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
                     blockSize = 0x2000;
                 }
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
@@ -1068,7 +1081,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
                 else
                     blockSize = 0x2000;
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
@@ -1095,7 +1108,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
                     blockSize = 0x2000;
                 }
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
@@ -1118,7 +1131,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
 
                 address &= ~blockSize;
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
@@ -1141,7 +1154,7 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
 
                 address &= ~blockSize;
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
@@ -1165,9 +1178,19 @@ static void SectorErase(FlashEmu *flash, uint32_t address) {
                     blockSize = 0x4000;
                 }
 
-                memset(flash->Memory + address, 0xFF, blockSize);
+                Erase(flash, address, blockSize);
                 printf("Erasing block $%07X-%07X\n", address, address + blockSize - 1);
             }
             break;
     }
 }
+
+static void Erase(FlashEmu *flash, uint32_t address, uint32_t size) {
+    memset(flash->Memory + address, 0xFF, size);
+    Mark_Dirty(flash, address, size);
+}
+
+static void Mark_Dirty(FlashEmu *flash, uint32_t address, uint32_t size) {
+    if (flash->DirtyBlocks != NULL)
+        Util_markdirty(flash->DirtyBlocks, flash->DirtyOffset + address, size);
+}
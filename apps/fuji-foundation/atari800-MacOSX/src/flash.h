@@ -68,6 +68,8 @@ typedef struct flashEmu {
     uint8_t  WriteBufferData[32];
     uint8_t  PendingWriteCount;
     uint32_t PendingWriteAddress;
+    uint8_t *DirtyBlocks;
+    uint32_t DirtyOffset;
 } FlashEmu;
 
 FlashEmu *Flash_Init(void *mem, int type);
@@ -76,4 +78,7 @@ void Flash_Cold_Reset(FlashEmu *Flash);
 int Flash_Read_Byte(FlashEmu *flash, uint32_t address, uint8_t *data);
 int Flash_Debug_Read_Byte(FlashEmu *flash, uint32_t address, uint8_t *data);
 int Flash_Write_Byte(FlashEmu *flash, uint32_t address, uint8_t value);
+// Programs and erases mark the blocks they change in BLOCKS, a dirty block
+// map (see util.h) of an image holding this chip's memory at OFFSET.
+void Flash_Track_Dirty(FlashEmu *flash, uint8_t *blocks, uint32_t offset);
 
@@ -23,6 +23,7 @@
 */
 
 #include "config.h"
+#include <stdint.h>
 #include <string.h>
 
 #include "antic.h"
@@ -34,6 +35,7 @@
 #include "vbxe.h"
 #endif
 #include "input.h"
+#include "perf.h"
 #ifndef BASIC
 #include "statesav.h"
 #endif
@@ -150,6 +152,32 @@ static ULONG grafp_lookup[4][256];
 static ULONG *grafp_ptr[4];
 static int global_sizem[4];
 
+/* GTIA_pm_scanline is updated eight bytes at a time: pm_expand[b] has 0xff
+   in byte i (in memory order) for each bit i set in b. */
+static uint64_t pm_expand[256];
+#define PM_REPEAT(b) ((uint64_t) (b) * 0x0101010101010101ULL)
+
+static uint64_t pm_load(const UBYTE *ptr)
+{
+	uint64_t v;
+	memcpy(&v, ptr, sizeof(v));
+	return v;
+}
+
+static void pm_store(UBYTE *ptr, uint64_t v)
+{
+	memcpy(ptr, &v, sizeof(v));
+}
+
+/* ORs together the eight bytes of V. */
+static UBYTE pm_fold(uint64_t v)
+{
+	v |= v >> 32;
+	v |= v >> 16;
+	v |= v >> 8;
+	return (UBYTE) v;
+}
+
 static const int PM_Width[4] = {1, 2, 1, 4};
 static int patch_ram[0x100];
 
@@ -250,6 +278,13 @@ int GTIA_Initialise(int *argc, char *argv[])
 		grafp_lookup[1][i] = grafp2;
 		grafp_lookup[3][i] = grafp4;
 	}
+	for (i = 0; i < 256; i++) {
+		UBYTE bytes[8];
+		int j;
+		for (j = 0; j < 8; j++)
+			bytes[j] = (i >> j) & 1 ? 0xff : 0;
+		memcpy(&pm_expand[i], bytes, sizeof(bytes));
+	}
 	memset(ANTIC_cl, GTIA_COLOUR_BLACK, sizeof(ANTIC_cl));
 	for (i = 0; i < 32; i++)
 		GTIA_PutByte((UWORD) i, 0);
@@ -266,15 +301,34 @@ int GTIA_Initialise(int *argc, char *argv[])
 static void generate_partial_pmpl_colls(int l, int r)
 {
 	int i;
+	uint64_t acc[7] = {0, 0, 0, 0, 0, 0, 0};
 	if (r < 0 || l >= (int) sizeof(GTIA_pm_scanline) / (int) sizeof(GTIA_pm_scanline[0]))
 		return;
 	if (r >= (int) sizeof(GTIA_pm_scanline) / (int) sizeof(GTIA_pm_scanline[0])) {
-		r = (int) sizeof(GTIA_pm_scanline) / (int) sizeof(GTIA_pm_scanline[0]);
+		r = (int) sizeof(GTIA_pm_scanline) / (int) sizeof(GTIA_pm_scanline[0]) - 1;
 	}
 	if (l < 0)
 		l = 0;
 
-	for (i = l; i <= r; i++) {
+	/* Eight bytes at a time: a byte takes part in object n's collisions
+	   when its bit n is set. */
+	for (i = l; i + 8 <= r + 1; i += 8) {
+		uint64_t w = pm_load(GTIA_pm_scanline + i);
+		int n;
+		if (w == 0)
+			continue;
+		for (n = 0; n < 7; n++)
+			acc[n] |= w & (((w >> (n + 1)) & PM_REPEAT(1)) * 0xff);
+	}
+	GTIA_P1PL |= pm_fold(acc[0]);
+	GTIA_P2PL |= pm_fold(acc[1]);
+	GTIA_P3PL |= pm_fold(acc[2]);
+	GTIA_M0PL |= pm_fold(acc[3]);
+	GTIA_M1PL |= pm_fold(acc[4]);
+	GTIA_M2PL |= pm_fold(acc[5]);
+	GTIA_M3PL |= pm_fold(acc[6]);
+
+	for (; i <= r; i++) {
 		UBYTE p = GTIA_pm_scanline[i];
 /* It is possible that some bits are set in PxPL/MxPL here, which would
  * not otherwise be set ever in GTIA_NewPmScanline.  This is because the
@@ -305,6 +359,7 @@ static void update_partial_pmpl_colls(void)
 /* update pm-> pl collisions at the end of a scanline */
 void GTIA_UpdatePmplColls(void)
 {
+	PERF_BEGIN(PERF_GTIA_COLLISIONS);
 	if (hitclr_pos != 0){
 		generate_partial_pmpl_colls(hitclr_pos,
 				sizeof(GTIA_pm_scanline) / sizeof(GTIA_pm_scanline[0]) - 1);
@@ -326,6 +381,7 @@ void GTIA_UpdatePmplColls(void)
 	}
 	collision_curpos = 0;
 	hitclr_pos = 0;
+	PERF_END(PERF_GTIA_COLLISIONS);
 }
 
 #else
@@ -338,6 +394,7 @@ void GTIA_UpdatePmplColls(void)
 
 void GTIA_NewPmScanline(void)
 {
+	PERF_BEGIN(PERF_GTIA_COLLISIONS);
 #ifdef NEW_CYCLE_EXACT
 /* reset temporary pm->pl collisions */
 	P1PL_T = P2PL_T = P3PL_T = 0;
@@ -351,17 +408,29 @@ void GTIA_NewPmScanline(void)
 
 /* Draw Players */
 
+/* A player is at most 32 bytes wide; the bytes it covers are merged in
+   blocks of eight, and the collisions folded out of each merged block. */
 #define DO_PLAYER(n)	if (GTIA_GRAFP##n) {						\
 	ULONG grafp = grafp_ptr[n][GTIA_GRAFP##n] & hposp_mask[n];	\
 	if (grafp) {											\
 		UBYTE *ptr = hposp_ptr[n];							\
+		uint64_t coll = 0;									\
 		GTIA_pm_dirty = TRUE;									\
+		if (ptr < GTIA_pm_scanline) {						\
+			grafp >>= GTIA_pm_scanline - ptr;					\
+			ptr = GTIA_pm_scanline;							\
+		}													\
 		do {												\
-			if (grafp & 1)									\
-				P##n##PL_T |= *ptr |= 1 << n;					\
-			ptr++;											\
-			grafp >>= 1;									\
+			if (grafp & 0xff) {								\
+				uint64_t m = pm_expand[grafp & 0xff];			\
+				uint64_t v = pm_load(ptr) | (m & PM_REPEAT(1 << n));	\
+				pm_store(ptr, v);								\
+				coll |= v & m;								\
+			}												\
+			ptr += 8;										\
+			grafp >>= 8;									\
 		} while (grafp);									\
+		P##n##PL_T |= pm_fold(coll);						\
 	}														\
 }
 
@@ -371,11 +440,15 @@ void GTIA_NewPmScanline(void)
 		if (grafp) {
 			UBYTE *ptr = hposp_ptr[0];
 			GTIA_pm_dirty = TRUE;
+			if (ptr < GTIA_pm_scanline) {
+				grafp >>= GTIA_pm_scanline - ptr;
+				ptr = GTIA_pm_scanline;
+			}
 			do {
-				if (grafp & 1)
-					*ptr = 1;
-				ptr++;
-				grafp >>= 1;
+				if (grafp & 0xff)
+					pm_store(ptr, pm_load(ptr) | (pm_expand[grafp & 0xff] & PM_REPEAT(1)));
+				ptr += 8;
+				grafp >>= 8;
 			} while (grafp);
 		}
 	}
@@ -401,10 +474,12 @@ void GTIA_NewPmScanline(void)
 	}												\
 	else if (ptr + j > GTIA_pm_scanline + Screen_WIDTH / 2 - 2)	\
 		j = GTIA_pm_scanline + Screen_WIDTH / 2 - 2 - ptr;		\
-	if (j > 0)										\
-		do											\
-			M##n##PL_T |= *ptr++ |= p;				\
-		while (--j);								\
+	if (j > 0) {									\
+		uint64_t bytes = pm_expand[(1 << j) - 1];		\
+		uint64_t v = pm_load(ptr) | (bytes & PM_REPEAT(p));	\
+		pm_store(ptr, v);								\
+		M##n##PL_T |= pm_fold(v & bytes);				\
+	}												\
 }
 
 	if (GTIA_GRAFM) {
@@ -414,6 +489,7 @@ void GTIA_NewPmScanline(void)
 		DO_MISSILE(1, 0x20, 0x0c, 0x08, 0x04)
 		DO_MISSILE(0, 0x10, 0x03, 0x02, 0x01)
 	}
+	PERF_END(PERF_GTIA_COLLISIONS);
 }
 
 #endif /* !defined(BASIC) && !defined(CURSES_BASIC) */
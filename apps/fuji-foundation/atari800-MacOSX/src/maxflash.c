@@ -23,6 +23,9 @@ static FlashEmu *flash;
 static FlashEmu *flash2;
 static int CartBank;
 static int CartMiniBank;
+static int MappedBank;
+static int MappedMiniBank;
+static int MapStale = TRUE;
 static int CartWriteEnable = TRUE;
 
 static void SetCartBank(int bank);
@@ -35,7 +38,7 @@ static int MAXFLASH_Is_Dirty(void);
 static void  MAXFLASH_Cold_Reset(void);
 static UBYTE MAXFLASH_Read_Byte(UWORD address);
 static void  MAXFLASH_Write_Byte(UWORD address, UBYTE value);
-static void MAXFLASH_Map_Cart(void);
+static void MAXFLASH_Map_Cart(int force);
 
 static CARTRIDGE_funcs_type funcs = {
     MAXFLASH_Shutdown,
@@ -86,6 +89,10 @@ void MAXFLASH_Init(CARTRIDGE_image_t *cart)
             flash = Flash_Init(Cart->image, Flash_TypeSST39SF040);
             flash2 = NULL;
     }
+
+    Flash_Track_Dirty(flash, CARTRIDGE_DirtyBlocks(Cart), 0);
+    if (flash2 != NULL)
+        Flash_Track_Dirty(flash2, CARTRIDGE_DirtyBlocks(Cart), 0x80000);
 }
 
 static void  MAXFLASH_Shutdown(void)
@@ -197,11 +204,17 @@ static void SetDCartBank(int bank, int miniBank) {
     CartBank = bank;
 }
 
-static void MAXFLASH_Map_Cart(void)
+static void MAXFLASH_Map_Cart(int force)
 {
     UWORD base = 0xA000;
     UWORD end = base + 0x2000 - 1;
-    
+
+    if (!force && !MapStale && CartBank == MappedBank && CartMiniBank == MappedMiniBank)
+        return;
+    MappedBank = CartBank;
+    MappedMiniBank = CartMiniBank;
+    MapStale = FALSE;
+
     if (CartBank < 0) {
         MEMORY_CartA0bfDisable();
     } else {
@@ -242,6 +255,7 @@ static void MAXFLASH_Flash_Write(UWORD addr, UBYTE value) {
     if (CartWriteEnable) {
         if (Flash_Write_Byte(flashEmu, fullAddr & 0x7FFFF, value)) {
             Cart->dirty = TRUE;
+            MapStale = TRUE;
         }
     }
 }
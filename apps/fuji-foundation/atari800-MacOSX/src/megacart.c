@@ -22,6 +22,8 @@ static int CartSizeMask;
 static FlashEmu *flash;
 static FlashEmu *flash2;
 static int CartBank;
+static int MappedBank;
+static int MapStale = TRUE;
 
 static void SetCartBank(int bank);
 static UBYTE MEGACART_Flash_Read(UWORD addr);
@@ -32,7 +34,7 @@ static int MEGACART_Is_Dirty(void);
 static void  MEGACART_Cold_Reset(void);
 static UBYTE MEGACART_Read_Byte(UWORD address);
 static void  MEGACART_Write_Byte(UWORD address, UBYTE value);
-static void MEGACART_Map_Cart(void);
+static void MEGACART_Map_Cart(int force);
 
 static CARTRIDGE_funcs_type funcs = {
     MEGACART_Shutdown,
@@ -67,6 +69,8 @@ void MEGACART_Init(CARTRIDGE_image_t *cart)
             flash = Flash_Init(Cart->image, Flash_TypeAm29F032B);
             break;
     }
+    if (flash != NULL)
+        Flash_Track_Dirty(flash, CARTRIDGE_DirtyBlocks(Cart), 0);
 }
 
 static void MEGACART_Shutdown(void)
@@ -149,11 +153,16 @@ static void SetCartBank(int bank) {
     CartBank = bank;
 }
 
-static void MEGACART_Map_Cart(void)
+static void MEGACART_Map_Cart(int force)
 {
     UWORD base = 0x8000;
     UWORD end = base + 0x4000 - 1;
-    
+
+    if (!force && !MapStale && CartBank == MappedBank)
+        return;
+    MappedBank = CartBank;
+    MapStale = FALSE;
+
     if (CartBank < 0) {
         MEMORY_Cart809fDisable();
         MEMORY_CartA0bfDisable();
@@ -192,5 +201,6 @@ static void MEGACART_Flash_Write(UWORD addr, UBYTE value) {
 
     if (Flash_Write_Byte(flash, fullAddr, value)) {
         Cart->dirty = TRUE;
+        MapStale = TRUE;
     };
 }
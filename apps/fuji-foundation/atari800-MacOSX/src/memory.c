@@ -50,6 +50,20 @@
 
 UBYTE MEMORY_mem[65536 + 2];
 
+#define MAP_PAGE(p)	(MEMORY_mem + (p) * 0x100)
+#define MAP_16(p)	MAP_PAGE(p), MAP_PAGE(p + 1), MAP_PAGE(p + 2), MAP_PAGE(p + 3), \
+			MAP_PAGE(p + 4), MAP_PAGE(p + 5), MAP_PAGE(p + 6), MAP_PAGE(p + 7), \
+			MAP_PAGE(p + 8), MAP_PAGE(p + 9), MAP_PAGE(p + 10), MAP_PAGE(p + 11), \
+			MAP_PAGE(p + 12), MAP_PAGE(p + 13), MAP_PAGE(p + 14), MAP_PAGE(p + 15)
+
+UBYTE *MEMORY_cpu_map[256 + 1] = {
+	MAP_16(0x00), MAP_16(0x10), MAP_16(0x20), MAP_16(0x30),
+	MAP_16(0x40), MAP_16(0x50), MAP_16(0x60), MAP_16(0x70),
+	MAP_16(0x80), MAP_16(0x90), MAP_16(0xa0), MAP_16(0xb0),
+	MAP_16(0xc0), MAP_16(0xd0), MAP_16(0xe0), MAP_16(0xf0),
+	MAP_PAGE(0x100)
+};
+
 int MEMORY_ram_size = 64;
 
 #ifndef PAGED_ATTRIB
@@ -104,6 +118,50 @@ static ULONG atarixe_memory_size = 0;
    separate XE access is active. */
 static UBYTE antic_bank_under_selftest[0x800];
 
+/* XE banks are switched by repointing pages 0x40-0x7f of MEMORY_cpu_map and
+   ANTIC_xe_ptr; no data moves. Base RAM stays in MEMORY_mem, extended bank N
+   lives at atarixe_memory + N * 16 KB. The first 16 KB of atarixe_memory only
+   hold base RAM in state files, and in the window described at
+   unload_base_window(). Self Test and MapRAM are still copied over the
+   2 KB at 0x5000 of the bank they show in. */
+static UBYTE *xe_bank_memory(int bank)
+{
+	return bank == 0 ? MEMORY_mem + 0x4000 : atarixe_memory + (bank << 14);
+}
+
+static void map_cpu_window(UBYTE *window)
+{
+	int i;
+	for (i = 0; i < 0x40; i++)
+		MEMORY_cpu_map[0x40 + i] = window + (i << 8);
+}
+
+/* ANTIC reads MEMORY_mem unless ANTIC_xe_ptr is set. */
+static void map_antic_window(int bank)
+{
+	ANTIC_xe_ptr = bank == 0 ? NULL : atarixe_memory + (bank << 14);
+}
+
+/* Returns the 16 KB ANTIC sees when it is not the CPU's bank, else NULL. */
+static UBYTE *antic_separate_window(void)
+{
+	UBYTE *window = ANTIC_xe_ptr != NULL ? (UBYTE *) ANTIC_xe_ptr : MEMORY_mem + 0x4000;
+	return window == MEMORY_cpu_map[0x40] ? NULL : window;
+}
+
+/* Copy-based banking kept the CPU's bank in MEMORY_mem. Until the first bank
+   switch, that is still the case after MEMORY_InitialiseMachine() and after
+   reading a state file older than version 7: MEMORY_mem holds CPU_BANK, and
+   base RAM is in the first 16 KB of atarixe_memory. Put both where they
+   belong. */
+static void unload_base_window(int cpu_bank)
+{
+	if (cpu_bank != 0 && MEMORY_cpu_map[0x40] == MEMORY_mem + 0x4000) {
+		memcpy(atarixe_memory + (cpu_bank << 14), MEMORY_mem + 0x4000, 0x4000);
+		memcpy(MEMORY_mem + 0x4000, atarixe_memory, 0x4000);
+	}
+}
+
 int MEMORY_have_basic = FALSE; /* Atari BASIC image has been successfully read (Atari 800 only) */
 
 static int pbi_overlay = FALSE;
@@ -211,6 +269,7 @@ void MEMORY_InitialiseMachine(void)
 	                    : Atari800_machine_type == Atari800_MACHINE_5200 ? 0x800
 	                    : 0x4000;
 	int const os_rom_start = 0x10000 - os_size;
+	map_cpu_window(MEMORY_mem + 0x4000);
 	ANTIC_xe_ptr = NULL;
 	cart809F_enabled = FALSE;
 	MEMORY_cartA0BF_enabled = FALSE;
@@ -373,7 +432,10 @@ void MEMORY_StateSave(UBYTE SaveVerbose)
 	temp = MEMORY_ram_size > 64 ? 64 : MEMORY_ram_size;
 	StateSav_SaveINT(&temp, 1);
 	STATESAV_TAG(base_ram);
-	StateSav_SaveUBYTE(&MEMORY_mem[0], 65536);
+	/* What the CPU sees, as copy-based banking kept it in MEMORY_mem. */
+	StateSav_SaveUBYTE(&MEMORY_mem[0], 0x4000);
+	StateSav_SaveUBYTE(MEMORY_cpu_map[0x40], 0x4000);
+	StateSav_SaveUBYTE(&MEMORY_mem[0x8000], 0x8000);
 	STATESAV_TAG(base_ram_attrib);
 #ifndef PAGED_ATTRIB
 	StateSav_SaveUBYTE(&MEMORY_attrib[0], 65536);
@@ -433,8 +495,10 @@ void MEMORY_StateSave(UBYTE SaveVerbose)
 	StateSav_SaveINT(&MEMORY_cartA0BF_enabled, 1);
 
 	if (MEMORY_ram_size > 64) {
-		StateSav_SaveUBYTE(&atarixe_memory[0], atarixe_memory_size);
-		if (ANTIC_xe_ptr != NULL && MEMORY_selftest_enabled)
+		/* Base RAM goes in the first bank while it is not the CPU's. */
+		StateSav_SaveUBYTE(MEMORY_cpu_map[0x40] == MEMORY_mem + 0x4000 ? atarixe_memory : MEMORY_mem + 0x4000, 0x4000);
+		StateSav_SaveUBYTE(&atarixe_memory[0x4000], atarixe_memory_size - 0x4000);
+		if (antic_separate_window() != NULL && MEMORY_selftest_enabled)
 			StateSav_SaveUBYTE(antic_bank_under_selftest, 0x800);
 	}
 
@@ -490,6 +554,7 @@ void MEMORY_StateRead(UBYTE SaveVerbose, UBYTE StateVersion)
 	if (StateVersion >= 7)
 		/* Read amount of base RAM in kilobytes. */
 		StateSav_ReadINT(&base_ram_kb, 1);
+	map_cpu_window(MEMORY_mem + 0x4000);
 	StateSav_ReadUBYTE(&MEMORY_mem[0], 65536);
 #ifndef PAGED_ATTRIB
 	StateSav_ReadUBYTE(&MEMORY_attrib[0], 65536);
@@ -664,20 +729,17 @@ void MEMORY_StateRead(UBYTE SaveVerbose, UBYTE StateVersion)
 			for (i = 0; i < 192 * 4; i++)
 				StateSav_ReadUBYTE(&buffer[0], 256);
 		}
-		if (StateVersion >= 7 && (MEMORY_ram_size == 128 || MEMORY_ram_size == MEMORY_RAM_320_COMPY_SHOP)) {
-			switch (portb & 0x30) {
-			case 0x20:	/* ANTIC: base, CPU: extended */
-				ANTIC_xe_ptr = atarixe_memory;
-				break;
-			case 0x10:	/* ANTIC: extended, CPU: base */
-				ANTIC_xe_ptr = atarixe_memory + (MEMORY_xe_bank << 14);
-				break;
-			default:	/* ANTIC same as CPU */
-				ANTIC_xe_ptr = NULL;
-				break;
-			}
+		if (StateVersion >= 7) {
+			int cpu_bank = (portb & 0x10) ? 0 : MEMORY_xe_bank;
+			int antic_bank = cpu_bank;
+			if (MEMORY_ram_size == 128 || MEMORY_ram_size == MEMORY_RAM_320_COMPY_SHOP)
+				antic_bank = (portb & 0x20) ? 0 : MEMORY_xe_bank;
+
+			unload_base_window(cpu_bank);
+			map_cpu_window(xe_bank_memory(cpu_bank));
+			map_antic_window(antic_bank);
 
-			if (ANTIC_xe_ptr != NULL && MEMORY_selftest_enabled)
+			if (antic_separate_window() != NULL && MEMORY_selftest_enabled)
 				/* Also read ANTIC-visible memory shadowed by Self Test. */
 				StateSav_ReadUBYTE(antic_bank_under_selftest, 0x800);
 
@@ -713,6 +775,46 @@ void MEMORY_CopyToMem(const UBYTE *from, UWORD to, int size)
 	}
 }
 
+void MEMORY_dCopyFromMem(UWORD from, void *to, int size)
+{
+	UBYTE *dest = (UBYTE *) to;
+	while (size > 0) {
+		int len = 0x100 - (from & 0xff);
+		if (len > size)
+			len = size;
+		memcpy(dest, MEMORY_dPtr(from), len);
+		dest += len;
+		from += len;
+		size -= len;
+	}
+}
+
+void MEMORY_dCopyToMem(const void *from, UWORD to, int size)
+{
+	const UBYTE *src = (const UBYTE *) from;
+	while (size > 0) {
+		int len = 0x100 - (to & 0xff);
+		if (len > size)
+			len = size;
+		memcpy(MEMORY_dPtr(to), src, len);
+		src += len;
+		to += len;
+		size -= len;
+	}
+}
+
+void MEMORY_dFillMem(UWORD addr1, UBYTE value, int length)
+{
+	while (length > 0) {
+		int len = 0x100 - (addr1 & 0xff);
+		if (len > length)
+			len = length;
+		memset(MEMORY_dPtr(addr1), value, len);
+		addr1 += len;
+		length -= len;
+	}
+}
+
 
 /* Returns NULL if both builtin BASIC and XEGS game are disabled.
    Otherwise returns a pointer to an 8KB array containing either
@@ -741,7 +843,6 @@ static UBYTE const * builtin_cart(UBYTE portb)
 /* Note: this function is only for XL/XE! */
 void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 {
-	int antic_bank = 0;
 	int mapram_selected = FALSE;
 	int new_mapram_selected = FALSE;
 
@@ -754,14 +855,14 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 
 	if (mapram_selected && !new_mapram_selected) {
 		/* Restore RAM hidden by MapRAM. */
-		memcpy(mapram_memory, MEMORY_mem + 0x5000, 0x800);
-		memcpy(MEMORY_mem + 0x5000, under_atarixl_os + 0x1000, 0x800);
+		memcpy(mapram_memory, MEMORY_cpu_map[0x50], 0x800);
+		memcpy(MEMORY_cpu_map[0x50], under_atarixl_os + 0x1000, 0x800);
 	}
 
 	/* Switch XE memory bank in 0x4000-0x7fff */
 	if (MEMORY_ram_size > 64) {
 		int bank = 0;
-		int cpu_bank, new_cpu_bank, new_antic_bank;
+		int cpu_bank, new_cpu_bank, antic_bank, new_antic_bank;
 		/* bank = 0 : base RAM */
 		/* bank = 1..64 : extended RAM */
 		if ((byte & 0x30) != 0x30)
@@ -795,24 +896,25 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 		    && (cpu_bank != new_cpu_bank
 		        || antic_bank != new_antic_bank
 		        || (MEMORY_ram_size == MEMORY_RAM_320_COMPY_SHOP && (byte & 0x20) == 0))) {
+			UBYTE *antic_window = antic_separate_window();
 			/* Disable Self Test ROM */
-			memcpy(MEMORY_mem + 0x5000, under_atarixl_os + 0x1000, 0x800);
-			if (ANTIC_xe_ptr != NULL)
+			memcpy(MEMORY_cpu_map[0x50], under_atarixl_os + 0x1000, 0x800);
+			if (antic_window != NULL)
 				/* Also disable Self Test from XE bank accessed by ANTIC. */
-				memcpy(atarixe_memory + (antic_bank << 14) + 0x1000, antic_bank_under_selftest, 0x800);
+				memcpy(antic_window + 0x1000, antic_bank_under_selftest, 0x800);
 			MEMORY_SetRAM(0x5000, 0x57ff);
 			MEMORY_selftest_enabled = FALSE;
 		}
-		if (cpu_bank != new_cpu_bank) {
-			memcpy(atarixe_memory + (cpu_bank << 14), MEMORY_mem + 0x4000, 0x4000);
-			memcpy(MEMORY_mem + 0x4000, atarixe_memory + (new_cpu_bank << 14), 0x4000);
-		}
+		unload_base_window(cpu_bank);
+		if (MEMORY_cpu_map[0x40] != xe_bank_memory(new_cpu_bank))
+			map_cpu_window(xe_bank_memory(new_cpu_bank));
 
-		if (MEMORY_ram_size == 128 || MEMORY_ram_size == MEMORY_RAM_320_COMPY_SHOP)
-			ANTIC_xe_ptr = new_antic_bank == new_cpu_bank ? NULL : atarixe_memory + (new_antic_bank << 14);
+		/* Other expansions have no separate ANTIC access. */
+		if (MEMORY_ram_size != 128 && MEMORY_ram_size != MEMORY_RAM_320_COMPY_SHOP)
+			new_antic_bank = new_cpu_bank;
+		map_antic_window(new_antic_bank);
 
 		MEMORY_xe_bank = bank;
-		antic_bank = new_antic_bank;
 	}
 
 	/* Enable/disable OS ROM in 0xc000-0xcfff and 0xd800-0xffff */
@@ -855,10 +957,11 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 			/* When OS ROM is disabled we also have to disable Self Test - Jindroush */
 			if (MEMORY_selftest_enabled) {
 				if (MEMORY_ram_size > 20) {
-					memcpy(MEMORY_mem + 0x5000, under_atarixl_os + 0x1000, 0x800);
-					if (ANTIC_xe_ptr != NULL)
+					UBYTE *antic_window = antic_separate_window();
+					memcpy(MEMORY_cpu_map[0x50], under_atarixl_os + 0x1000, 0x800);
+					if (antic_window != NULL)
 						/* Also disable Self Test from XE bank accessed by ANTIC. */
-						memcpy(atarixe_memory + (antic_bank << 14) + 0x1000, antic_bank_under_selftest, 0x800);
+						memcpy(antic_window + 0x1000, antic_bank_under_selftest, 0x800);
 					MEMORY_SetRAM(0x5000, 0x57ff);
 				}
 				else
@@ -895,10 +998,11 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 		if (MEMORY_selftest_enabled) {
 			/* Disable Self Test ROM */
 			if (MEMORY_ram_size > 20) {
-				memcpy(MEMORY_mem + 0x5000, under_atarixl_os + 0x1000, 0x800);
-				if (ANTIC_xe_ptr != NULL)
+				UBYTE *antic_window = antic_separate_window();
+				memcpy(MEMORY_cpu_map[0x50], under_atarixl_os + 0x1000, 0x800);
+				if (antic_window != NULL)
 					/* Also disable Self Test from XE bank accessed by ANTIC. */
-					memcpy(atarixe_memory + (antic_bank << 14) + 0x1000, antic_bank_under_selftest, 0x800);
+					memcpy(antic_window + 0x1000, antic_bank_under_selftest, 0x800);
 				MEMORY_SetRAM(0x5000, 0x57ff);
 			}
 			else
@@ -913,28 +1017,38 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 		if (!MEMORY_selftest_enabled && (byte & 0x01)
 		&& !((byte & 0x30) != 0x30 && MEMORY_ram_size == MEMORY_RAM_320_COMPY_SHOP)
 		&& !((byte & 0x10) == 0 && MEMORY_ram_size == 1088)) {
+			UBYTE *antic_window = antic_separate_window();
 			/* Enable Self Test ROM */
 			if (MEMORY_ram_size > 20) {
-				memcpy(under_atarixl_os + 0x1000, MEMORY_mem + 0x5000, 0x800);
-				if (ANTIC_xe_ptr != NULL)
+				memcpy(under_atarixl_os + 0x1000, MEMORY_cpu_map[0x50], 0x800);
+				if (antic_window != NULL)
 					/* Also backup RAM under Self Test from XE bank accessed by ANTIC. */
-					memcpy(antic_bank_under_selftest, atarixe_memory + (antic_bank << 14) + 0x1000, 0x800);
+					memcpy(antic_bank_under_selftest, antic_window + 0x1000, 0x800);
 				MEMORY_SetROM(0x5000, 0x57ff);
 			}
-			memcpy(MEMORY_mem + 0x5000, MEMORY_os + 0x1000, 0x800);
-			if (ANTIC_xe_ptr != NULL)
+			memcpy(MEMORY_cpu_map[0x50], MEMORY_os + 0x1000, 0x800);
+			if (antic_window != NULL)
 				/* Also enable Self Test in the XE bank accessed by ANTIC. */
-				memcpy(atarixe_memory + (antic_bank << 14) + 0x1000, MEMORY_os + 0x1000, 0x800);
+				memcpy(antic_window + 0x1000, MEMORY_os + 0x1000, 0x800);
 			MEMORY_selftest_enabled = TRUE;
 		}
 		else if (!mapram_selected && new_mapram_selected) {
 			/* Enable MapRAM */
-			memcpy(under_atarixl_os + 0x1000, MEMORY_mem + 0x5000, 0x800);
-			memcpy(MEMORY_mem + 0x5000, mapram_memory, 0x800);
+			memcpy(under_atarixl_os + 0x1000, MEMORY_cpu_map[0x50], 0x800);
+			memcpy(MEMORY_cpu_map[0x50], mapram_memory, 0x800);
 		}
 	}
 }
 
+void MEMORY_SelectXEBank(int bank)
+{
+	unload_base_window((PIA_PORTB | PIA_PORTB_mask) & 0x10 ? 0 : MEMORY_xe_bank);
+	map_cpu_window(xe_bank_memory(bank));
+	if (MEMORY_ram_size != 128 && MEMORY_ram_size != MEMORY_RAM_320_COMPY_SHOP)
+		map_antic_window(bank);
+	MEMORY_xe_bank = bank;
+}
+
 void MEMORY_StartPBIOverlay(void)
 {
     if (!((PIA_PORTB | PIA_PORTB_mask) & 0x01)) {
@@ -6,21 +6,34 @@
 
 #include "atari.h"
 
-#define MEMORY_dGetByte(x)				(MEMORY_mem[x])
-#define MEMORY_dPutByte(x, y)			(MEMORY_mem[x] = y)
+/* The CPU sees memory through MEMORY_cpu_map: one pointer per 256-byte page,
+   plus a 257th for the two bytes at 0x10000 that mirror 0x0000-0x0001.
+   Pages 0x40-0x7f point at the XE bank selected by PORTB; all other pages
+   always point into MEMORY_mem, so code that only touches them may use
+   MEMORY_mem directly. Zero page is never remapped. */
+extern UBYTE *MEMORY_cpu_map[256 + 1];
+/* A function rather than a macro, so that callers such as the CPU stack
+   macros may pass ADDR with side effects. */
+static inline UBYTE *MEMORY_dPtr(unsigned int addr)
+{
+	return MEMORY_cpu_map[addr >> 8] + (addr & 0xff);
+}
+#define MEMORY_dGetByte(x)				(*MEMORY_dPtr(x))
+#define MEMORY_dPutByte(x, y)			(*MEMORY_dPtr(x) = (y))
 #ifdef MACOSX
 #define MEMORY_dGetWordZero(x)			(MEMORY_mem[(x) & 0xff] | (MEMORY_mem[((x)+1) & 0xff] << 8))
 #endif
 
 #ifndef WORDS_BIGENDIAN
 #ifdef WORDS_UNALIGNED_OK
-#define MEMORY_dGetWord(x)				UNALIGNED_GET_WORD(MEMORY_mem+(x), memory_read_word_stat)
-#define MEMORY_dPutWord(x, y)			UNALIGNED_PUT_WORD(MEMORY_mem+(x), (y), memory_write_word_stat)
-#define MEMORY_dGetWordAligned(x)		UNALIGNED_GET_WORD(MEMORY_mem+(x), memory_read_aligned_word_stat)
-#define MEMORY_dPutWordAligned(x, y)	UNALIGNED_PUT_WORD(MEMORY_mem+(x), (y), memory_write_aligned_word_stat)
+/* A word at the last byte of a page may span two mappings. */
+#define MEMORY_dGetWord(x)				(((x) & 0xff) != 0xff ? UNALIGNED_GET_WORD(MEMORY_dPtr(x), memory_read_word_stat) : MEMORY_dGetByte(x) + (MEMORY_dGetByte((x) + 1) << 8))
+#define MEMORY_dPutWord(x, y)			(((x) & 0xff) != 0xff ? UNALIGNED_PUT_WORD(MEMORY_dPtr(x), (y), memory_write_word_stat) : (MEMORY_dPutByte(x, (UBYTE) (y)), MEMORY_dPutByte((x) + 1, (UBYTE) ((y) >> 8))))
+#define MEMORY_dGetWordAligned(x)		UNALIGNED_GET_WORD(MEMORY_dPtr(x), memory_read_aligned_word_stat)
+#define MEMORY_dPutWordAligned(x, y)	UNALIGNED_PUT_WORD(MEMORY_dPtr(x), (y), memory_write_aligned_word_stat)
 #else	/* WORDS_UNALIGNED_OK */
-#define MEMORY_dGetWord(x)				(MEMORY_mem[x] + (MEMORY_mem[(x) + 1] << 8))
-#define MEMORY_dPutWord(x, y)			(MEMORY_mem[x] = (UBYTE) (y), MEMORY_mem[(x) + 1] = (UBYTE) ((y) >> 8))
+#define MEMORY_dGetWord(x)				(MEMORY_dGetByte(x) + (MEMORY_dGetByte((x) + 1) << 8))
+#define MEMORY_dPutWord(x, y)			(MEMORY_dPutByte(x, (UBYTE) (y)), MEMORY_dPutByte((x) + 1, (UBYTE) ((y) >> 8)))
 /* faster versions of MEMORY_jdGetWord and MEMORY_dPutWord for even addresses */
 /* TODO: guarantee that memory is UWORD-aligned and use UWORD access */
 #define MEMORY_dGetWordAligned(x)		MEMORY_dGetWord(x)
@@ -28,15 +41,16 @@
 #endif	/* WORDS_UNALIGNED_OK */
 #else	/* WORDS_BIGENDIAN */
 /* can't do any word optimizations for big endian machines */
-#define MEMORY_dGetWord(x)				(MEMORY_mem[x] + (MEMORY_mem[(x) + 1] << 8))
-#define MEMORY_dPutWord(x, y)			(MEMORY_mem[x] = (UBYTE) (y), MEMORY_mem[(x) + 1] = (UBYTE) ((y) >> 8))
+#define MEMORY_dGetWord(x)				(MEMORY_dGetByte(x) + (MEMORY_dGetByte((x) + 1) << 8))
+#define MEMORY_dPutWord(x, y)			(MEMORY_dPutByte(x, (UBYTE) (y)), MEMORY_dPutByte((x) + 1, (UBYTE) ((y) >> 8)))
 #define MEMORY_dGetWordAligned(x)		MEMORY_dGetWord(x)
 #define MEMORY_dPutWordAligned(x, y)	MEMORY_dPutWord(x, y)
 #endif	/* WORDS_BIGENDIAN */
 
-#define MEMORY_dCopyFromMem(from, to, size)	memcpy(to, MEMORY_mem + (from), size)
-#define MEMORY_dCopyToMem(from, to, size)		memcpy(MEMORY_mem + (to), from, size)
-#define MEMORY_dFillMem(addr1, value, length)	memset(MEMORY_mem + (addr1), value, length)
+/* Raw copies through MEMORY_cpu_map, ignoring MEMORY_attrib. */
+void MEMORY_dCopyFromMem(UWORD from, void *to, int size);
+void MEMORY_dCopyToMem(const void *from, UWORD to, int size);
+void MEMORY_dFillMem(UWORD addr1, UBYTE value, int length);
 
 extern UBYTE MEMORY_mem[65536 + 2];
 
@@ -59,12 +73,12 @@ extern int MEMORY_ram_size;
 extern UBYTE MEMORY_attrib[65536];
 /* Reads a byte from ADDR. Can potentially have side effects, when reading
    from hardware area. */
-#define MEMORY_GetByte(addr)		(MEMORY_attrib[addr] == MEMORY_HARDWARE ? MEMORY_HwGetByte(addr, FALSE) : (MEMORY_attrib[addr] == MEMORY_FLASH ? MEMORY_FlashGetByte(addr) : MEMORY_mem[addr]))
+#define MEMORY_GetByte(addr)		(MEMORY_attrib[addr] == MEMORY_HARDWARE ? MEMORY_HwGetByte(addr, FALSE) : (MEMORY_attrib[addr] == MEMORY_FLASH ? MEMORY_FlashGetByte(addr) : MEMORY_dGetByte(addr)))
 #define MEMORY_GetWord(x)                (MEMORY_GetByte(x) + (MEMORY_GetByte((x) + 1) << 8))
 #define MEMORY_PutWord(x, y)            MEMORY_PutByte(x, (UBYTE) (y)); MEMORY_PutByte((x) + 1, (UBYTE) ((y) >> 8));
 /* Reads a byte from ADDR, but without any side effects. */
-#define MEMORY_SafeGetByte(addr)        (MEMORY_attrib[addr] == MEMORY_HARDWARE ? MEMORY_HwGetByte(addr, TRUE) : (MEMORY_attrib[addr] == MEMORY_FLASH ? MEMORY_FlashGetByte(addr) : MEMORY_mem[addr]))
-#define MEMORY_PutByte(addr, byte)	 do { if (MEMORY_attrib[addr] == MEMORY_RAM) MEMORY_mem[addr] = byte; else if (MEMORY_attrib[addr] == MEMORY_HARDWARE) MEMORY_HwPutByte(addr, byte); else if (MEMORY_attrib[addr] == MEMORY_FLASH) MEMORY_FlashPutByte(addr, byte);} while (0)
+#define MEMORY_SafeGetByte(addr)        (MEMORY_attrib[addr] == MEMORY_HARDWARE ? MEMORY_HwGetByte(addr, TRUE) : (MEMORY_attrib[addr] == MEMORY_FLASH ? MEMORY_FlashGetByte(addr) : MEMORY_dGetByte(addr)))
+#define MEMORY_PutByte(addr, byte)	 do { if (MEMORY_attrib[addr] == MEMORY_RAM) MEMORY_dPutByte(addr, byte); else if (MEMORY_attrib[addr] == MEMORY_HARDWARE) MEMORY_HwPutByte(addr, byte); else if (MEMORY_attrib[addr] == MEMORY_FLASH) MEMORY_FlashPutByte(addr, byte);} while (0)
 #define MEMORY_SetRAM(addr1, addr2) memset(MEMORY_attrib + (addr1), MEMORY_RAM, (addr2) - (addr1) + 1)
 #define MEMORY_SetROM(addr1, addr2) memset(MEMORY_attrib + (addr1), MEMORY_ROM, (addr2) - (addr1) + 1)
 #define MEMORY_SetHARDWARE(addr1, addr2) memset(MEMORY_attrib + (addr1), MEMORY_HARDWARE, (addr2) - (addr1) + 1)
@@ -80,10 +94,10 @@ extern MEMORY_wrfunc MEMORY_writemap[256];
 void MEMORY_ROM_PutByte(UWORD addr, UBYTE byte);
 /* Reads a byte from ADDR. Can potentially have side effects, when reading
    from hardware area. */
-#define MEMORY_GetByte(addr)		(MEMORY_readmap[(addr) >> 8] ? (*MEMORY_readmap[(addr) >> 8])(addr, FALSE) : MEMORY_mem[addr])
+#define MEMORY_GetByte(addr)		(MEMORY_readmap[(addr) >> 8] ? (*MEMORY_readmap[(addr) >> 8])(addr, FALSE) : MEMORY_dGetByte(addr))
 /* Reads a byte from ADDR, but without any side effects. */
-#define MEMORY_SafeGetByte(addr)		(MEMORY_readmap[(addr) >> 8] ? (*MEMORY_readmap[(addr) >> 8])(addr, TRUE) : MEMORY_mem[addr])
-#define MEMORY_PutByte(addr,byte)	(MEMORY_writemap[(addr) >> 8] ? ((*MEMORY_writemap[(addr) >> 8])(addr, byte), 0) : (MEMORY_mem[addr] = byte))
+#define MEMORY_SafeGetByte(addr)		(MEMORY_readmap[(addr) >> 8] ? (*MEMORY_readmap[(addr) >> 8])(addr, TRUE) : MEMORY_dGetByte(addr))
+#define MEMORY_PutByte(addr,byte)	(MEMORY_writemap[(addr) >> 8] ? ((*MEMORY_writemap[(addr) >> 8])(addr, byte), 0) : MEMORY_dPutByte(addr, byte))
 #define MEMORY_SetRAM(addr1, addr2) do { \
 		int i; \
 		for (i = (addr1) >> 8; i <= (addr2) >> 8; i++) { \
@@ -119,11 +133,16 @@ void MEMORY_StateRead(UBYTE SaveVerbose, UBYTE StateVersion);
 void MEMORY_CopyFromMem(UWORD from, UBYTE *to, int size);
 void MEMORY_CopyToMem(const UBYTE *from, UWORD to, int size);
 void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval);
+/* Shows XE bank BANK (0 = base RAM) to the CPU at 0x4000-0x7fff without
+   changing PORTB, for the monitor. ANTIC follows unless the machine has
+   separate ANTIC access. */
+void MEMORY_SelectXEBank(int bank);
 void MEMORY_Cart809fDisable(void);
 void MEMORY_Cart809fEnable(void);
 void MEMORY_CartA0bfDisable(void);
 void MEMORY_CartA0bfEnable(void);
 void MEMORY_AllocXEMemory(void);
+/* Cartridge areas are never remapped, so these go straight to MEMORY_mem. */
 #define MEMORY_CopyFromCart(addr1, addr2, src) memcpy(MEMORY_mem + (addr1), src, (addr2) - (addr1) + 1)
 #define MEMORY_CopyToCart(addr1, addr2, dst) memcpy(dst, MEMORY_mem + (addr1), (addr2) - (addr1) + 1)
 void MEMORY_GetCharset(UBYTE *cs);
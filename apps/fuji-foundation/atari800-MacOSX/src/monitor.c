@@ -30,11 +30,14 @@
 #include "antic.h"
 #include "atari.h"
 #include "cpu.h"
+#include "cputrace.h"
 #include "gtia.h"
 #include "memory.h"
 #include "monitor.h"
 #include "pia.h"
 #include "pokey.h"
+#include "profiler.h"
+#include "symtable.h"
 #include "util.h"
 #ifdef STEREO_SOUND
 #include "pokeysnd.h"
@@ -79,10 +82,6 @@ void monitor_printf(const char *format, ...)
 
 #endif /* __PLUS */
 
-#ifdef MONITOR_TRACE
-FILE *MONITOR_trace_file = NULL;
-#endif
-
 #ifdef MONITOR_HINTS
 
 typedef struct {
@@ -354,34 +353,46 @@ static int symtable_builtin_enable = TRUE;
 static symtable_rec *symtable_user = NULL;
 static int symtable_user_size = 0;
 
-static const char *find_label_name(UWORD addr, int is_write)
+/* Indexes of symtable_user and of the built-in table for the current
+   machine. */
+static SYMTABLE_Index symindex_user;
+static SYMTABLE_Index symindex_builtin;
+static const symtable_rec *symindex_builtin_table = NULL;
+
+/* Returns the built-in table for the current machine, indexed. */
+static const symtable_rec *builtin_labels(void)
 {
-	int i;
-	for (i = 0; i < symtable_user_size; i++) {
-		if (symtable_user[i].addr == addr)
-			return symtable_user[i].name;
+	const symtable_rec *table = Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin;
+	if (table != symindex_builtin_table) {
+		SYMTABLE_IndexBuiltin(&symindex_builtin, table);
+		symindex_builtin_table = table;
 	}
+	return table;
+}
+
+static const char *find_label_name(UWORD addr, int is_write)
+{
+	int i = SYMTABLE_FindAddr(&symindex_user, addr, FALSE);
+	if (i >= 0)
+		return symtable_user[i].name;
 	if (symtable_builtin_enable) {
-		const symtable_rec *p;
-		for (p = (Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin); p->name != NULL; p++) {
-			if (p->addr == addr) {
-				if (is_write && p[1].addr == addr)
-					p++;
-				return p->name;
-			}
-		}
+		const symtable_rec *table = builtin_labels();
+		i = SYMTABLE_FindAddr(&symindex_builtin, addr, is_write);
+		if (i >= 0)
+			return table[i].name;
 	}
 	return NULL;
 }
 
+static const char *profiler_label(UWORD addr)
+{
+	return find_label_name(addr, FALSE);
+}
+
 static symtable_rec *find_user_label(const char *name)
 {
-	int i;
-	for (i = 0; i < symtable_user_size; i++) {
-		if (Util_stricmp(symtable_user[i].name, name) == 0)
-			return &symtable_user[i];
-	}
-	return NULL;
+	int i = SYMTABLE_FindName(&symindex_user, symtable_user, name);
+	return i >= 0 ? &symtable_user[i] : NULL;
 }
 
 static int find_label_value(const char *name)
@@ -390,10 +401,10 @@ static int find_label_value(const char *name)
 	if (p != NULL)
 		return p->addr;
 	if (symtable_builtin_enable) {
-		for (p = (Atari800_machine_type == Atari800_MACHINE_5200 ? symtable_builtin_5200 : symtable_builtin); p->name != NULL; p++) {
-			if (Util_stricmp(p->name, name) == 0)
-				return p->addr;
-		}
+		const symtable_rec *table = builtin_labels();
+		int i = SYMTABLE_FindName(&symindex_builtin, table, name);
+		if (i >= 0)
+			return table[i].addr;
 	}
 	return -1;
 }
@@ -406,6 +417,7 @@ static void free_user_labels(void)
 		free(symtable_user);
 		symtable_user = NULL;
 	}
+	SYMTABLE_Free(&symindex_user);
 }
 
 static void add_user_label(const char *name, UWORD addr)
@@ -421,9 +433,15 @@ static void add_user_label(const char *name, UWORD addr)
 	}
 	symtable_user[symtable_user_size].name = Util_strdup(name);
 	symtable_user[symtable_user_size].addr = addr;
+	SYMTABLE_Add(&symindex_user, symtable_user, symtable_user_size);
 	symtable_user_size++;
 }
 
+static void move_user_label(symtable_rec *p, UWORD addr)
+{
+	SYMTABLE_Move(&symindex_user, symtable_user, (int) (p - symtable_user), addr);
+}
+
 static void load_user_labels(const char *filename)
 {
 	FILE *fp;
@@ -1589,17 +1607,13 @@ int MONITOR_Run(void)
 #ifdef MONITOR_TRACE
 		else if (strcmp(t, "TRACE") == 0) {
 			const char *filename = get_token();
-			if (MONITOR_trace_file != NULL) {
-				fclose(MONITOR_trace_file);
-				printf("Trace file closed\n");
-				MONITOR_trace_file = NULL;
+			if (CPUTRACE_enabled) {
+				if (CPUTRACE_Stop())
+					printf("Trace file closed\n");
 			}
 			if (filename != NULL) {
-				MONITOR_trace_file = fopen(filename, "w");
-				if (MONITOR_trace_file != NULL)
+				if (CPUTRACE_Start(filename))
 					printf("Trace file open\n");
-				else
-					perror(filename);
 			}
 		}
 #endif /* MONITOR_TRACE */
@@ -1625,6 +1639,55 @@ int MONITOR_Run(void)
 			}
 		}
 #endif /* MONITOR_PROFILE */
+		else if (strcmp(t, "PROF") == 0) {
+			unsigned long long insns, cycles;
+			PROFILER_GetTotals(&insns, &cycles);
+			t = get_token();
+			if (t == NULL)
+				printf("Profiler is %s, %llu instructions, %llu cycles\n",
+				       PROFILER_enabled ? "on" : "off", insns, cycles);
+			else if (Util_stricmp(t, "ON") == 0)
+				PROFILER_Start();
+			else if (Util_stricmp(t, "OFF") == 0)
+				PROFILER_Stop();
+			else if (Util_stricmp(t, "CLEAR") == 0)
+				PROFILER_Reset();
+			else if (Util_stricmp(t, "HOT") == 0) {
+				PROFILER_Hot hot[100];
+				int count = 20;
+				int n, i;
+				t = get_token();
+				if (t != NULL)
+					count = Util_sscandec(t);
+				if (count <= 0)
+					count = 20;
+				else if (count > 100)
+					count = 100;
+				n = PROFILER_GetHot(hot, count);
+				printf("Addr Label           Count       Cycles     %%\n");
+				for (i = 0; i < n; i++) {
+					const char *name = NULL;
+#ifdef MONITOR_HINTS
+					name = find_label_name(hot[i].addr, FALSE);
+#endif
+					printf("%04X %-12.12s %10lu %12llu %5.1f\n", hot[i].addr, name != NULL ? name : "",
+					       hot[i].count, hot[i].cycles, cycles != 0 ? hot[i].cycles * 100.0 / cycles : 0.0);
+				}
+			}
+			else if (Util_stricmp(t, "SAVE") == 0) {
+				t = get_token();
+				if (t == NULL)
+					printf("Usage: PROF SAVE filename\n");
+				else
+#ifdef MONITOR_HINTS
+					PROFILER_WriteFolded(t, profiler_label);
+#else
+					PROFILER_WriteFolded(t, NULL);
+#endif
+			}
+			else
+				printf("Usage: PROF [ON|OFF|CLEAR|HOT [count]|SAVE filename]\n");
+		}
 		else if (strcmp(t, "SHOW") == 0)
 			show_state();
 		else if (strcmp(t, "STACK") == 0) {
@@ -1694,8 +1757,12 @@ int MONITOR_Run(void)
 					if (f == NULL)
 						perror(filename);
 					else {
-						if (fread(&MEMORY_mem[addr], 1, nbytes, f) == 0)
+						UBYTE *buffer = (UBYTE *) Util_malloc(nbytes);
+						size_t len = fread(buffer, 1, nbytes, f);
+						if (len == 0)
 							perror(filename);
+						MEMORY_dCopyToMem(buffer, addr, (int) len);
+						free(buffer);
 						fclose(f);
 					}
 				}
@@ -1715,8 +1782,11 @@ int MONITOR_Run(void)
 					perror(filename);
 				else {
 					size_t nbytes = addr2 - addr1 + 1;
-					if (fwrite(&MEMORY_mem[addr1], 1, addr2 - addr1 + 1, f) < nbytes)
+					UBYTE *buffer = (UBYTE *) Util_malloc(nbytes);
+					MEMORY_dCopyFromMem(addr1, buffer, (int) nbytes);
+					if (fwrite(buffer, 1, nbytes, f) < nbytes)
 						perror(filename);
+					free(buffer);
 					fclose(f);
 				}
 			}
@@ -1929,7 +1999,7 @@ int MONITOR_Run(void)
 						if (p != NULL) {
 							if (p->addr != addr) {
 								printf("%s redefined (previous value: %04X)\n", name, p->addr);
-								p->addr = addr;
+								move_user_label(p, addr);
 							}
 						}
 						else
@@ -2029,7 +2099,7 @@ int MONITOR_Run(void)
 				"SUM startaddr endaddr          - Print sum of specified memory range\n");
 #ifdef MONITOR_TRACE
 			printf(
-				"TRACE [filename]               - Output 6502 trace on/off\n");
+				"TRACE [filename]               - 6502 trace on/off (util/tracedump)\n");
 #endif
 #ifdef MONITOR_BREAK
 			printf(
@@ -2065,6 +2135,9 @@ int MONITOR_Run(void)
 #ifdef MONITOR_PROFILE
 				"PROFILE                        - Display profiling statistics\n"
 #endif
+				"PROF [ON|OFF|CLEAR]            - Control the code profiler\n"
+				"PROF HOT [count]               - Show the addresses using most cycles\n"
+				"PROF SAVE filename             - Write call stacks for flame graphs\n"
 #ifdef MONITOR_HINTS
 				"LABELS [command] [filename]    - Configure labels\n"
 #endif
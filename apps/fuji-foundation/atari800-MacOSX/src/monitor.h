@@ -8,10 +8,6 @@
 
 int MONITOR_Run(void);
 
-#ifdef MONITOR_TRACE
-extern FILE *MONITOR_trace_file;
-#endif
-
 typedef struct {
 	char *name;
 	UWORD addr;
@@ -28,7 +24,6 @@ extern int MONITOR_histon;
 extern UBYTE MONITOR_break_active;
 extern UBYTE MONITOR_break_brk_occured;
 extern int MONITOR_break_fired;
-extern int MONITOR_tron;
 extern int check_break_i;
 extern int break_table_on;
 extern const UBYTE MONITOR_optype6502[];
@@ -44,6 +39,7 @@ void load_user_labels(const char *filename);
 void add_user_label(const char *name, UWORD addr);
 void free_user_labels(void);
 symtable_rec *find_user_label(const char *name);
+void move_user_label(symtable_rec *p, UWORD addr);
 int get_val_gui(char *s, UWORD *hexval);
 int get_hex(char *string, UWORD *hexval);
 #endif /* MACOSX */
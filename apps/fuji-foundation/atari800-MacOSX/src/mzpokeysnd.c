@@ -32,8 +32,9 @@
 #include "atari.h"
 #endif
 #include "mzpokeysnd.h"
+#include "perf.h"
+#include "pokeyfilt.h"
 #include "pokeysnd.h"
-#include "remez.h"
 #include "antic.h"
 #include "gtia.h"
 #include "util.h"
@@ -100,6 +101,11 @@ static int pokey_frq; /* Hz - for easier resampling */
 static int filter_size;
 static double filter_data[SND_FILTER_SIZE];
 static int audible_frq;
+/* Parameters of the filter in filter_data, so a reinit at the same rate
+   keeps it. */
+static int filter_rate = 0;
+static int filter_quality;
+static double filter_cutoff;
 
 static const int pokey_frq_ideal =  1789790; /* Hz - True */
 #if 0
@@ -124,6 +130,10 @@ static int poly4tbl[15];
 static int poly5tbl[31];
 static unsigned char poly17tbl[131071];
 static int poly9tbl[511];
+/* The poly4, poly5 and poly9 outputs (bits 0, 1 and 2) at every position
+   of their common period, so one counter replaces three. */
+#define POLY459_SIZE (15 * 31 * 511)
+static unsigned char poly459tbl[POLY459_SIZE];
 
 
 struct stPokeyState;
@@ -143,10 +153,8 @@ typedef struct stPokeyState
 {
     int curtick;
     /* Poly positions */
-    int poly4pos;
-    int poly5pos;
+    int poly459pos;
     int poly17pos;
-    int poly9pos;
 
     /* Change queue */
     qev_t ovola;
@@ -306,6 +314,7 @@ static int tick_pos;
 static double samp_pos;
 static int start_sample;
 static double ticks_per_sample;
+static double base_ticks_per_sample;
 UBYTE *MZPOKEYSND_process_buffer = NULL;
 static void render_to_tick(int last_tick);
 #endif
@@ -316,9 +325,7 @@ static void render_to_tick(int last_tick);
 static void ResetPokeyState(PokeyState* ps)
 {
     /* Poly positions */
-    ps->poly4pos = 0;
-    ps->poly5pos = 0;
-    ps->poly9pos = 0;
+    ps->poly459pos = 0;
     ps->poly17pos = 0;
 
     /* Change queue */
@@ -664,12 +671,23 @@ static void build_poly9(void)
 	}
 }
 
+static void build_poly459(void)
+{
+	int i;
+
+	for(i = 0; i < POLY459_SIZE; i++)
+		poly459tbl[i] = (poly4tbl[i % 15] & 1) | (poly5tbl[i % 31] & 1) << 1 | (poly9tbl[i % 511] & 1) << 2;
+}
+
 static void advance_polies(PokeyState* ps, int tacts)
 {
-    ps->poly4pos = (tacts + ps->poly4pos) % 15;
-    ps->poly5pos = (tacts + ps->poly5pos) % 31;
-    ps->poly17pos = (tacts + ps->poly17pos) % 131071;
-    ps->poly9pos = (tacts + ps->poly9pos) % 511;
+    /* both periods are over 100000 ticks, so the modulo is rarely taken */
+    ps->poly459pos += tacts;
+    if(ps->poly459pos >= POLY459_SIZE)
+        ps->poly459pos %= POLY459_SIZE;
+    ps->poly17pos += tacts;
+    if(ps->poly17pos >= 131071)
+        ps->poly17pos %= 131071;
 }
 
 /***********************************
@@ -999,6 +1017,17 @@ static void advance_ticks(PokeyState* ps, int ticks)
         }
     }
 
+#ifndef NONLINEAR_MIXING
+    if(ps->c0stop && ps->c1stop && ps->c2stop && ps->c3stop)
+    {
+        /* No divider runs, so the output can't change: just move the
+           clocks, the same as one pass of the loop below */
+        advance_polies(ps,ticks);
+        bump_qe_subticks(ps,ticks);
+        return;
+    }
+#endif
+
     while(ticks>0)
     {
         tbe0 = ps->c0divpos;
@@ -1055,10 +1084,11 @@ static void advance_ticks(PokeyState* ps, int ticks)
 
         if(need)
         {
-            p5v = poly5tbl[ps->poly5pos] & 1;
-            p4v = poly4tbl[ps->poly4pos] & 1;
+            int p459 = poly459tbl[ps->poly459pos];
+            p4v = p459 & 1;
+            p5v = (p459 >> 1) & 1;
             if(ps->selpoly9)
-                p917v = poly9tbl[ps->poly9pos] & 1;
+                p917v = (p459 >> 2) & 1;
             else
                 p917v = poly17tbl[ps->poly17pos] & 1;
 
@@ -1182,110 +1212,6 @@ static double generate_sample(PokeyState* ps)
     return read_resam_all(ps);
 }
 
-/******************************************
- filter table generator by Krzysztof Nikiel
- ******************************************/
-
-static int remez_filter_table(double resamp_rate, /* output_rate/input_rate */
-                              double *cutoff, int quality)
-{
-  int i;
-  static const int orders[] = {600, 800, 1000, 1200};
-  static const struct {
-    int stop;		/* stopband ripple */
-    double weight;	/* stopband weight */
-    double twidth[sizeof(orders)/sizeof(orders[0])];
-  } paramtab[] =
-  {
-    {70, 90, {4.9e-3, 3.45e-3, 2.65e-3, 2.2e-3}},
-    {55, 25, {3.4e-3, 2.7e-3, 2.05e-3, 1.7e-3}},
-    {40, 6.0, {2.6e-3, 1.8e-3, 1.5e-3, 1.2e-3}},
-    {-1, 0, {0, 0, 0, 0}}
-  };
-  static const double passtab[] = {0.5, 0.6, 0.7};
-  int ripple = 0, order = 0;
-  int size;
-  double weights[2], desired[2], bands[4];
-  static const int interlevel = 5;
-  double step = 1.0 / interlevel;
-
-  *cutoff = 0.95 * 0.5 * resamp_rate;
-
-  if (quality >= (int) (sizeof(passtab) / sizeof(passtab[0])))
-    quality = (int) (sizeof(passtab) / sizeof(passtab[0])) - 1;
-
-  for (ripple = 0; paramtab[ripple].stop > 0; ripple++)
-  {
-    for (order = 0; order < (int) (sizeof(orders)/sizeof(orders[0])); order++)
-    {
-      if ((*cutoff - paramtab[ripple].twidth[order])
-	  > passtab[quality] * 0.5 * resamp_rate)
-	/* transition width OK */
-	goto found;
-    }
-  }
-
-  /* not found -- use shortest transition */
-  ripple--;
-  order--;
-
-found:
-
-#if 0
-  printf("order: %d, cutoff: %g\tstopband:%d\ttranswidth:%f\n",
-         orders[order],
-	 1789790 * *cutoff,
-	 paramtab[ripple].stop,
-	 1789790 * paramtab[ripple].twidth[order]);
-  exit(1);
-#endif
-
-  size = orders[order] + 1;
-
-  if (size > SND_FILTER_SIZE) /* static table too short */
-    return 0;
-
-  desired[0] = 1;
-  desired[1] = 0;
-
-  weights[0] = 1;
-  weights[1] = paramtab[ripple].weight;
-
-  bands[0] = 0;
-  bands[2] = *cutoff;
-  bands[1] = bands[2] - paramtab[ripple].twidth[order];
-  bands[3] = 0.5;
-
-  bands[1] *= (double)interlevel;
-  bands[2] *= (double)interlevel;
-  REMEZ_CreateFilter(filter_data, (size / interlevel) + 1, 2, bands, desired, weights, REMEZ_BANDPASS);
-  for (i = size - interlevel; i >= 0; i -= interlevel)
-  {
-    int s;
-    double h1 = filter_data[i/interlevel];
-    double h2 = filter_data[i/interlevel+1];
-
-    for (s = 0; s < interlevel; s++)
-    {
-      double d = (double)s * step;
-      filter_data[i+s] = (h1*(1.0 - d) + h2 * d) * step;
-    }
-  }
-
-  /* compute reversed cumulative sum table */
-  for (i = size - 2; i >= 0; i--)
-    filter_data[i] += filter_data[i + 1];
-
-#if 0
-  for (i = 0; i < size; i++)
-    printf("%.15f,\n", filter_data[i]);
-  fflush(stdout);
-  exit(1);
-#endif
-
-  return size;
-}
-
 static void mzpokeysnd_process_8(void* sndbuffer, int sndn);
 static void mzpokeysnd_process_16(void* sndbuffer, int sndn);
 static void Update_pokey_sound_mz(UWORD addr, UBYTE val, UBYTE chip, UBYTE gain);
@@ -1322,8 +1248,6 @@ int MZPOKEYSND_Init(ULONG freq17, int playback_freq, UBYTE num_pokeys,
 #endif
                        )
 {
-    double cutoff;
-
     sample_rate = playback_freq;
     snd_flags = flags;
     snd_quality = quality;
@@ -1422,14 +1346,19 @@ int MZPOKEYSND_Init(ULONG freq17, int playback_freq, UBYTE num_pokeys,
     default:
         pokey_frq = (int)(((double)pokey_frq_ideal/sample_rate) + 0.5)
           * sample_rate;
-	filter_size = remez_filter_table((double)sample_rate/pokey_frq,
-					 &cutoff, quality);
-	audible_frq = (int ) (cutoff * pokey_frq);
+	if (filter_size == 0 || filter_rate != sample_rate || filter_quality != quality) {
+		filter_size = POKEYFILT_Get(filter_data, SND_FILTER_SIZE, sample_rate, pokey_frq,
+		                            quality, &filter_cutoff);
+		filter_rate = sample_rate;
+		filter_quality = quality;
+	}
+	audible_frq = (int ) (filter_cutoff * pokey_frq);
     }
 
     build_poly4();
     build_poly5();
     build_poly9();
+    build_poly459();
     build_poly17();
 
 #ifdef __PLUS
@@ -2536,8 +2465,10 @@ void init_mzpokeysnd_sync(void)
 	else
 		ticks_per_frame = (int)(deltatime / 0.00006375)*114;
 	ticks_per_sample = (double)ticks_per_frame / samples_per_frame;
+	base_ticks_per_sample = ticks_per_sample;
     tick_pos = 0;
-    bytes_per_frame = (int)ceil(num_cur_pokeys*samples_per_frame*((snd_flags & POKEYSND_BIT16) ? 2:1));
+    /* leave room for the extra samples MZPOKEYSND_SetRateRatio() may ask for */
+    bytes_per_frame = (int)ceil(num_cur_pokeys*(samples_per_frame*(1.0 + MZPOKEYSND_MAX_RATE_DEVIATION) + 1)*((snd_flags & POKEYSND_BIT16) ? 2:1));
     free(MZPOKEYSND_process_buffer);
     MZPOKEYSND_process_buffer = (UBYTE *)Util_malloc(bytes_per_frame);
     memset(MZPOKEYSND_process_buffer, 0, bytes_per_frame);
@@ -2546,6 +2477,77 @@ void init_mzpokeysnd_sync(void)
     start_sample = 0;
 }
 
+/* Produce ratio times the nominal number of samples per frame, so the
+   front end can steer its buffer fill without changing emulation speed. */
+void MZPOKEYSND_SetRateRatio(double ratio)
+{
+	if (ratio > 1.0 + MZPOKEYSND_MAX_RATE_DEVIATION)
+		ratio = 1.0 + MZPOKEYSND_MAX_RATE_DEVIATION;
+	else if (ratio < 1.0 - MZPOKEYSND_MAX_RATE_DEVIATION)
+		ratio = 1.0 - MZPOKEYSND_MAX_RATE_DEVIATION;
+	if (base_ticks_per_sample > 0.0)
+		ticks_per_sample = base_ticks_per_sample / ratio;
+}
+
+/* store the filtered output of pokey i at the sample position frac */
+static void store_sample(UBYTE *buffer, int i, double frac)
+{
+    if (snd_flags & POKEYSND_BIT16) ((SWORD *)buffer)[i] = (SWORD)floor((interp_read_resam_all(pokey_states + i, frac) + POKEYSND_sampout)
+																		* (sound_volume * 65535.0 / MAX_SAMPLE / 4 * M_PI * 0.95) + 0.5 );
+    else buffer[i] = (UBYTE)floor((interp_read_resam_all(pokey_states + i, frac) + POKEYSND_sampout)
+								  * (sound_volume * 255.0 / MAX_SAMPLE / 4 * M_PI * 0.95) + 128 + 0.5);
+}
+
+/* TRUE if no pokey output can change before the next register write:
+   all channels are stopped and the change queues have drained, so each
+   sample only depends on where it falls between two ticks */
+static int pokeys_idle(void)
+{
+#ifdef NONLINEAR_MIXING
+    return FALSE;
+#else
+    int i;
+#ifdef VOL_ONLY_SOUND
+    if (POKEYSND_sampbuf_rptr != POKEYSND_sampbuf_ptr)
+        return FALSE;
+#endif
+    for (i = 0; i < num_cur_pokeys; i++)
+    {
+        PokeyState *ps = pokey_states + i;
+        if (!(ps->c0stop && ps->c1stop && ps->c2stop && ps->c3stop) || ps->forcero
+            || ps->qebeg != ps->qeend)
+            return FALSE;
+    }
+    return TRUE;
+#endif
+}
+
+/* render_to_tick() for idle pokeys: produces the samples without
+   advancing the pokeys, then advances them in one step */
+static UBYTE *render_idle_to_tick(UBYTE *buffer, int last_tick)
+{
+    int i;
+    int start_tick = tick_pos;
+    double new_samp_pos;
+    int new_tick_pos;
+
+    do {
+        new_samp_pos = samp_pos + ticks_per_sample;
+        new_tick_pos = floor(new_samp_pos);
+        if (new_tick_pos > last_tick) {
+                break;
+        }
+        for (i = 0; i<num_cur_pokeys; i++)
+            store_sample(buffer, i, new_samp_pos - new_tick_pos);
+        buffer += num_cur_pokeys*((snd_flags & POKEYSND_BIT16) ? 2 : 1 );
+        samp_pos = new_samp_pos;
+        tick_pos = new_tick_pos;
+    } while (1);
+    for (i = 0; i<num_cur_pokeys; i++)
+        advance_ticks(pokey_states + i, tick_pos - start_tick);
+    return buffer;
+}
+
 /* render sound into the buffer up to the specified tick position */
 static void render_to_tick(int last_tick)
 {
@@ -2561,6 +2563,11 @@ static void render_to_tick(int last_tick)
         return ; /* module was not initialized */
 
     do {
+        /* silence and steady volume-only levels: skip the per-tick work */
+        if (pokeys_idle()) {
+            buffer = render_idle_to_tick(buffer, last_tick);
+            break;
+        }
         /* advance to the next sample position */
         new_samp_pos = samp_pos + ticks_per_sample;
         /* the next tick position is the integer part */
@@ -2591,10 +2598,7 @@ static void render_to_tick(int last_tick)
                     }
                 }
 #endif
-            if (snd_flags & POKEYSND_BIT16) ((SWORD *)buffer)[i] = (SWORD)floor((interp_read_resam_all(pokey_states + i, new_samp_pos - new_tick_pos) + POKEYSND_sampout)
-																				* (sound_volume * 65535.0 / MAX_SAMPLE / 4 * M_PI * 0.95) + 0.5 );
-            else buffer[i] = (UBYTE)floor((interp_read_resam_all(pokey_states + i, new_samp_pos - new_tick_pos) + POKEYSND_sampout)
-										  * (sound_volume * 255.0 / MAX_SAMPLE / 4 * M_PI * 0.95) + 128 + 0.5);
+            store_sample(buffer, i, new_samp_pos - new_tick_pos);
         }
         buffer += num_cur_pokeys*((snd_flags & POKEYSND_BIT16) ? 2 : 1 );
         samp_pos = new_samp_pos;
@@ -2607,6 +2611,7 @@ static void render_to_tick(int last_tick)
 int MZPOKEYSND_UpdateProcessBuffer(void)
 {
     int result;
+    PERF_BEGIN(PERF_POKEYSND);
     render_to_tick(ticks_per_frame);
     samp_pos = samp_pos - (double)ticks_per_frame;
     tick_pos = tick_pos - ticks_per_frame;
@@ -2618,6 +2623,7 @@ int MZPOKEYSND_UpdateProcessBuffer(void)
 #if !defined(__PLUS) && !defined(ASAP)
     SndSave_WriteToSoundFile((const unsigned char *)MZPOKEYSND_process_buffer, result);
 #endif
+    PERF_END(PERF_POKEYSND);
     return result;
 }
 #endif /* SYNCHRONIZED_SOUND */
@@ -16,6 +16,10 @@ int MZPOKEYSND_Init(ULONG freq17,
                        );
 
 #ifdef SYNCHRONIZED_SOUND
+/* Largest deviation from 1.0 accepted by MZPOKEYSND_SetRateRatio() */
+#define MZPOKEYSND_MAX_RATE_DEVIATION 0.01
+/* Resamples the output by ratio (more samples per frame if > 1.0). */
+void MZPOKEYSND_SetRateRatio(double ratio);
 #endif /* SYNCHRONIZED_SOUND */
 int MZPOKEYSND_UpdateProcessBuffer(void);
 extern UBYTE *MZPOKEYSND_process_buffer;
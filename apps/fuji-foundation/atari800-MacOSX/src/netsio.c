@@ -5,6 +5,7 @@
 * queues complete packets to emulator
 *
 */
+#include "config.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,7 @@
 #include <time.h>
 #include "netsio.h"
 #include "log.h"
+#include "perf.h"
 #include "pia.h" /* For toggling PROC & INT */
 
 
@@ -28,6 +30,7 @@
 static char *buf_to_hex(const uint8_t *buf, size_t offset, size_t len);
 #endif /* DEBUG */
 static void send_block_to_fujinet(const uint8_t *block, size_t len);
+static void flush_tx_buffer(void);
 
 /* Flag to know when netsio is enabled */
 volatile int netsio_enabled = 0;
@@ -45,6 +48,11 @@ volatile int netsio_next_write_size = 0;
 /* FIFO pipe: fds0: FujiNet->emulator */
 int fds0[2];
 
+/* Outbound data bytes waiting to go out as one DATA_BLOCK.
+   Only touched from the emulator thread. */
+static uint8_t tx_buf[NETSIO_MAX_BLOCK_SIZE];
+static size_t tx_len = 0;
+
 /* UDP socket for NetSIO and return address holder */
 static int sockfd = -1;
 static struct sockaddr_storage fujinet_addr;
@@ -190,9 +198,9 @@ static void send_to_fujinet(const uint8_t *pkt, size_t len) {
 
 /* Send up to 512 bytes as a DATA_BLOCK packet */
 static void send_block_to_fujinet(const uint8_t *block, size_t len) {
-    uint8_t packet[512 + 2];
+    uint8_t packet[NETSIO_MAX_BLOCK_SIZE + 2];
 
-    if (len == 0 || len > 512) return;  /* sanity check */
+    if (len == 0 || len > NETSIO_MAX_BLOCK_SIZE) return;  /* sanity check */
     packet[0] = NETSIO_DATA_BLOCK;
     memcpy(&packet[1], block, len);
     /* Pad the end with a junk byte or FN-PC won't accept the packet */
@@ -200,6 +208,27 @@ static void send_block_to_fujinet(const uint8_t *block, size_t len) {
     send_to_fujinet(packet, len + 2);
 }
 
+/* Send batched data bytes before anything that must follow them on the wire */
+static void flush_tx_buffer(void) {
+    uint8_t pkt[2];
+
+    if (tx_len == 0)
+        return;
+    if (tx_len == 1)
+    {
+        /* a lone byte is cheaper as DATA_BYTE than as a padded block */
+        pkt[0] = NETSIO_DATA_BYTE;
+        pkt[1] = tx_buf[0];
+        send_to_fujinet(pkt, 2);
+    }
+    else
+        send_block_to_fujinet(tx_buf, tx_len);
+#ifdef DEBUG
+    Log_print("netsio: flushed %zu batched bytes", tx_len);
+#endif
+    tx_len = 0;
+}
+
 /* Store configured port for use in response routing */
 static uint16_t netsio_port = 9997;
 
@@ -332,6 +361,7 @@ void netsio_shutdown(void) {
     }
     
     /* Reset state variables */
+    tx_len = 0;
     fujinet_known = 0;
     netsio_sync_wait = 0;
     netsio_cmd_state = 0;
@@ -343,6 +373,7 @@ void netsio_shutdown(void) {
 void netsio_wait_for_sync(void)
 {
     int ticker = 0;
+    PERF_BEGIN(PERF_NETSIO_WAIT);
     while (netsio_sync_wait)
     {
 #ifdef DEBUG
@@ -356,6 +387,7 @@ void netsio_wait_for_sync(void)
         }
         ticker++;
     }
+    PERF_END(PERF_NETSIO_WAIT);
 }
 
 /* Return number of bytes waiting from FujiNet to emulator */
@@ -382,6 +414,7 @@ int netsio_cmd_on(void)
 #ifdef DEBUG
     Log_print("netsio: CMD ON");
 #endif
+    flush_tx_buffer();
     netsio_cmd_state = 1;
     send_to_fujinet(&p, 1);
     return 0;
@@ -395,6 +428,7 @@ int netsio_cmd_off(void)
 #ifdef DEBUG
     Log_print("netsio: CMD OFF");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(&p, 1);
     return 0;
 }
@@ -409,6 +443,7 @@ int netsio_cmd_off_sync(void)
 #ifdef DEBUG
     Log_print("netsio: CMD OFF SYNC");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(p, sizeof(p));
     netsio_sync_wait = 1; /* pause emulation until we hear back or timeout */
     return 0;
@@ -431,6 +466,7 @@ int netsio_motor_on(void)
 #ifdef DEBUG
     Log_print("netsio: MOTOR ON");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(&p, 1);
     return 0;
 }
@@ -443,31 +479,51 @@ int netsio_motor_off(void)
 #ifdef DEBUG
     Log_print("netsio: MOTOR OFF");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(&p, 1);
     return 0;
 }
 
-/* The emulator calls this to send a data byte out to FujiNet */
+/* The emulator calls this to send a data byte out to FujiNet.
+   The byte is batched; it goes out when the block fills, at the next
+   sync point or when the frame ends (netsio_flush). */
 int netsio_send_byte(uint8_t b) {
-    uint8_t pkt[2];
-    pkt[0] = NETSIO_DATA_BYTE;
-    pkt[1] = b;
 #ifdef DEBUG
     Log_print("netsio: send byte: %02X", b);
 #endif
-    send_to_fujinet(pkt, 2);
+    if (tx_len == NETSIO_MAX_BLOCK_SIZE)
+        flush_tx_buffer();
+    tx_buf[tx_len++] = b;
     return 0;
 }
 
 /* The emulator calls this to send a data block out to FujiNet */
 int netsio_send_block(const uint8_t *block, ssize_t len) {
-    send_block_to_fujinet(block, len);
+    size_t chunk;
 #ifdef DEBUG
     Log_print("netsio: send block, %i bytes:\n  %s", len, buf_to_hex(block, 0, len));
 #endif
+    while (len > 0)
+    {
+        if (tx_len == NETSIO_MAX_BLOCK_SIZE)
+            flush_tx_buffer();
+        chunk = NETSIO_MAX_BLOCK_SIZE - tx_len;
+        if (chunk > (size_t)len)
+            chunk = (size_t)len;
+        memcpy(tx_buf + tx_len, block, chunk);
+        tx_len += chunk;
+        block += chunk;
+        len -= chunk;
+    }
     return 0;
 }
 
+/* Called once per frame so batched bytes never wait longer than that */
+void netsio_flush(void)
+{
+    flush_tx_buffer();
+}
+
 /* DATA BYTE with SYNC */
 int netsio_send_byte_sync(uint8_t b)
 {
@@ -479,6 +535,7 @@ int netsio_send_byte_sync(uint8_t b)
 #ifdef DEBUG
     Log_print("netsio: send byte: 0x%02X sync: %d", b, netsio_sync_num);
 #endif
+    flush_tx_buffer();
     send_to_fujinet(p, sizeof(p));
     netsio_sync_wait = 1; /* pause emulation until we hear back or timeout s*/
     return 0;
@@ -509,6 +566,7 @@ int netsio_cold_reset(void) {
 #ifdef DEBUG
     Log_print("netsio: cold reset");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(&pkt, 1);
     return 0;
 }
@@ -519,6 +577,7 @@ int netsio_warm_reset(void) {
 #ifdef DEBUG
     Log_print("netsio: warm reset");
 #endif
+    flush_tx_buffer();
     send_to_fujinet(&pkt, 1);
     return 0;
 }
@@ -528,7 +587,7 @@ void netsio_test_cmd(void)
 {
     uint8_t p[6] = { 0x70, 0xE8, 0x00, 0x00, 0x59 }; /* Send fujidev get adapter config request */
     netsio_cmd_on(); /* Turn on CMD */
-    send_block_to_fujinet(p, sizeof(p));
+    netsio_send_block(p, sizeof(p));
     netsio_cmd_off_sync(); /* Turn off CMD */
 }
 
@@ -35,7 +35,8 @@ extern volatile int netsio_enabled;
 #define NETSIO_WARM_RESET         0xFE
 #define NETSIO_COLD_RESET         0xFF
 
-#define NETSIO_WRITE_CHUNK_SIZE 65
+/* Largest payload FujiNet-PC accepts in one DATA_BLOCK packet */
+#define NETSIO_MAX_BLOCK_SIZE 512
 
 /* FIFO buffer depth */
 #define NETSIO_FIFO_SIZE 4096
@@ -69,10 +70,14 @@ void netsio_wait(void);
 /* Shutdown NetSIO, join the thread, close socket. */
 void netsio_shutdown(void);
 
-/* Enqueue one byte to send to FujiNet-PC. */
-/* Returns 0 on success, -1 if FIFO is full. */
+/* Enqueue one byte to send to FujiNet-PC. Bytes are batched into */
+/* DATA_BLOCK packets until netsio_flush() or the next sync point. */
+/* Returns 0 on success. */
 int netsio_send_byte(uint8_t b);
 
+/* Send any batched outbound bytes now. */
+void netsio_flush(void);
+
 int netsio_send_block(const uint8_t *block, ssize_t len);
 
 int netsio_send_byte_sync(uint8_t b);
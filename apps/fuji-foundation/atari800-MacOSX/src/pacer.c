@@ -0,0 +1,158 @@
+/*
+ * pacer.c - frame pacing with absolute deadlines
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <errno.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#endif
+
+#include "log.h"
+#include "pacer.h"
+
+double PACER_spin_margin = 0.0005;
+
+static double next_deadline = 0.0;
+static PACER_Stats stats;
+static double error_sum = 0.0;
+
+#ifdef __APPLE__
+static mach_timebase_info_data_t timebase;
+
+static void init_timebase(void)
+{
+	if (timebase.denom == 0)
+		mach_timebase_info(&timebase);
+}
+#endif
+
+double PACER_Time(void)
+{
+#if defined(__APPLE__)
+	init_timebase();
+	return (double) mach_absolute_time() * timebase.numer / timebase.denom * 1e-9;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+	struct timeval tp;
+	gettimeofday(&tp, NULL);
+	return tp.tv_sec + 1e-6 * tp.tv_usec;
+#endif
+}
+
+/* Sleeps until the deadline; may return early on signals, never sleeps past
+   it by more than the OS wake-up latency. */
+static void sleep_until(double deadline)
+{
+#if defined(__APPLE__)
+	init_timebase();
+	mach_wait_until((uint64_t) (deadline * 1e9 * timebase.denom / timebase.numer));
+#elif defined(CLOCK_MONOTONIC) && defined(TIMER_ABSTIME)
+	struct timespec ts;
+	ts.tv_sec = (time_t) deadline;
+	ts.tv_nsec = (long) ((deadline - ts.tv_sec) * 1e9);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+#else
+	double s = deadline - PACER_Time();
+	if (s > 0)
+		usleep(s * 1e6);
+#endif
+}
+
+void PACER_WaitUntil(double deadline)
+{
+	if (deadline - PACER_Time() > PACER_spin_margin)
+		sleep_until(deadline - PACER_spin_margin);
+	while (PACER_Time() < deadline)
+		;
+}
+
+void PACER_Sync(double frame_time)
+{
+	double now = PACER_Time();
+	double wait_start;
+	double error;
+
+	if (frame_time <= 0.0) {
+		/* Unpaced; start a new schedule when pacing resumes. */
+		next_deadline = 0.0;
+		return;
+	}
+	if (next_deadline == 0.0)
+		next_deadline = now;
+	next_deadline += frame_time;
+
+	if (next_deadline - now > 1.0) {
+		Log_print("Large positive sleeptime (%f), correcting to 1.0", next_deadline - now);
+		next_deadline = now + 1.0;
+	}
+
+	if (next_deadline + frame_time < now) {
+		/* More than a frame behind - don't try to catch up. */
+		next_deadline = now;
+		stats.late_frames++;
+		stats.frames++;
+		return;
+	}
+
+	PACER_WaitUntil(next_deadline);
+	wait_start = now;
+	now = PACER_Time();
+	error = now - next_deadline;
+	stats.sleep_time += now - wait_start;
+	stats.frames++;
+	error_sum += error;
+	stats.mean_error = error_sum / stats.frames;
+	if (error > stats.max_error)
+		stats.max_error = error;
+}
+
+void PACER_Reset(void)
+{
+	next_deadline = 0.0;
+}
+
+void PACER_GetStats(PACER_Stats *s)
+{
+	*s = stats;
+}
+
+void PACER_ResetStats(void)
+{
+	stats.frames = 0;
+	stats.late_frames = 0;
+	stats.mean_error = 0.0;
+	stats.max_error = 0.0;
+	stats.sleep_time = 0.0;
+	error_sum = 0.0;
+}
@@ -0,0 +1,43 @@
+#ifndef PACER_H_
+#define PACER_H_
+
+/* Frame pacing against a monotonic clock.
+   Each frame gets an absolute deadline; the wait sleeps until just before
+   it (clock_nanosleep TIMER_ABSTIME, or mach_wait_until on Mac OS X) and
+   spins the last PACER_spin_margin seconds, so deadlines don't drift and
+   a wake-up is not late by a scheduler tick. */
+
+typedef struct PACER_Stats_t {
+	unsigned long frames;		/* frames paced since the last reset */
+	unsigned long late_frames;	/* frames that missed their deadline by more than a frame */
+	double mean_error;		/* average wake-up time minus deadline, in seconds */
+	double max_error;		/* worst wake-up time minus deadline, in seconds */
+	double sleep_time;		/* total time spent waiting, in seconds */
+} PACER_Stats;
+
+/* Length of the busy-wait tail of each wait, in seconds. */
+extern double PACER_spin_margin;
+
+/* Returns monotonic time in seconds. */
+double PACER_Time(void);
+
+/* Waits until the given PACER_Time(). */
+void PACER_WaitUntil(double deadline);
+
+/* Waits for the end of the current frame of length frame_time seconds.
+   Deadlines advance by exactly frame_time, so the average rate is
+   1/frame_time; if emulation falls more than a frame behind, the
+   schedule restarts from now instead of running frames back to back.
+   A frame_time of 0 returns at once, for running without a speed limit. */
+void PACER_Sync(double frame_time);
+
+/* Restarts the schedule, e.g. after the emulator was paused. */
+void PACER_Reset(void);
+
+/* Copies the timing statistics collected by PACER_Sync(). */
+void PACER_GetStats(PACER_Stats *stats);
+
+/* Clears the timing statistics. */
+void PACER_ResetStats(void);
+
+#endif /* PACER_H_ */
@@ -10,12 +10,18 @@
 #include "atari.h"
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/dir.h>
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <sys/event.h>
+#define DIR_CACHE_KQUEUE
+#endif
 #include <time.h>
 #include <unistd.h>
 #include "vec.h"
@@ -444,6 +450,251 @@ UBYTE TranslateErrnoToSIOError(ULONG err) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Host directory listing cache
+//
+// fopen, ffirst and wildcard rename/remove/chmod all walk a host directory.
+// Reading it and stat()ing every entry per request makes a wildcard copy
+// out of a large folder quadratic, so the listings of the last few
+// directories are kept, sorted the way the Atari sees them. A kqueue watch
+// drops a listing as soon as an entry is added, removed or renamed. It
+// doesn't see writes to the files themselves, so listings also expire
+// after a few seconds. Changes made through PCLink drop all listings.
+
+#define DIR_CACHE_SLOTS 8
+// Seconds a listing is trusted while kqueue watches its directory
+#define DIR_CACHE_MAX_AGE_WATCHED 10
+// Seconds a listing is trusted otherwise, if the directory's mtime is unchanged
+#define DIR_CACHE_MAX_AGE 1
+
+typedef struct hostDirEntry {
+    char     *NativeName;
+    int      StatErrno;     // set if stat() failed; Mode, HostFlags and DirEnt are then empty
+    mode_t   Mode;
+    u_int    HostFlags;
+    int      NameValid;     // NativeName is a valid Atari file name
+    FileName Name;
+    DirEntry DirEnt;
+} HostDirEntry;
+
+typedef vec_t(HostDirEntry) HostDirEntry_vec_t;
+
+typedef struct dirCache {
+    char     Path[FILENAME_MAX];    // empty if the slot is unused
+    HostDirEntry_vec_t Entries;
+    time_t   Loaded;
+    time_t   DirMTime;
+    int      WatchFd;
+    ULONG    LastUse;
+} DirCache;
+
+static DirCache Dir_Caches[DIR_CACHE_SLOTS];
+static ULONG Dir_Cache_Use_Count = 0;
+// Set by changes made through PCLink; the listings are dropped on the next
+// lookup, so that loops over a listing can safely change the directory.
+static int Dir_Cache_Stale = FALSE;
+#ifdef DIR_CACHE_KQUEUE
+static int Dir_Cache_Kqueue = -1;
+#endif
+
+int Host_Dir_Entry_Compare(const void *vx, const void *vy) {
+    const HostDirEntry *x = (const HostDirEntry *) vx;
+    const HostDirEntry *y = (const HostDirEntry *) vy;
+
+    return Dir_Entry_Compare(&x->DirEnt, &y->DirEnt);
+}
+
+void Dir_Cache_Invalidate(void)
+{
+    Dir_Cache_Stale = TRUE;
+}
+
+void Dir_Cache_Drop(DirCache *cache)
+{
+    if (!cache->Path[0])
+        return;
+
+    for (int i = 0; i < cache->Entries.length; i++)
+        free(cache->Entries.data[i].NativeName);
+    vec_deinit(&cache->Entries);
+    if (cache->WatchFd >= 0)
+        close(cache->WatchFd);
+    cache->WatchFd = -1;
+    cache->Path[0] = 0;
+}
+
+// Returns a descriptor watched for changes to the directory, or -1.
+int Dir_Cache_Watch(const char *path, int slot)
+{
+#ifdef DIR_CACHE_KQUEUE
+    struct kevent change;
+    int fd;
+
+    if (Dir_Cache_Kqueue < 0 && (Dir_Cache_Kqueue = kqueue()) < 0)
+        return -1;
+#ifdef O_EVTONLY
+    fd = open(path, O_EVTONLY);
+#else
+    fd = open(path, O_RDONLY);
+#endif
+    if (fd < 0)
+        return -1;
+
+    EV_SET(&change, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR,
+           NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME | NOTE_REVOKE,
+           0, (void *) (intptr_t) slot);
+    if (kevent(Dir_Cache_Kqueue, &change, 1, NULL, 0, NULL) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+// Drops the listings of directories that kqueue reported as changed.
+void Dir_Cache_Poll(void)
+{
+#ifdef DIR_CACHE_KQUEUE
+    struct kevent events[DIR_CACHE_SLOTS];
+    struct timespec zero = {0, 0};
+    int n;
+
+    if (Dir_Cache_Kqueue < 0)
+        return;
+
+    while ((n = kevent(Dir_Cache_Kqueue, NULL, 0, events, DIR_CACHE_SLOTS, &zero)) > 0) {
+        for (int i = 0; i < n; i++)
+            Dir_Cache_Drop(&Dir_Caches[(intptr_t) events[i].udata]);
+    }
+#endif
+}
+
+// Reads the directory PATH into CACHE. Returns 0 or an errno value.
+int Dir_Cache_Load(DirCache *cache, const char *path, time_t now)
+{
+    char fullPath[FILENAME_MAX];
+    DIR *dirStream;
+    struct dirent *ep;
+    struct stat file_stats;
+    HostDirEntry entry;
+    long long slen;
+
+    // Take the mtime first, so that changes made during the scan show up.
+    if (stat(path, &file_stats) == -1)
+        return errno;
+    cache->DirMTime = file_stats.st_mtime;
+
+    if ((dirStream = opendir(path)) == NULL)
+        return errno;
+
+    strcpy(cache->Path, path);
+    vec_init(&cache->Entries);
+    cache->WatchFd = -1;
+
+    while ((ep = readdir(dirStream))) {
+        if ((strcmp(ep->d_name,".") == 0) ||
+            (strcmp(ep->d_name,"..") == 0))
+            continue;
+
+        memset(&entry, 0, sizeof(HostDirEntry));
+
+        snprintf(fullPath, sizeof(fullPath), "%s/%s", path, ep->d_name);
+        if ((stat(fullPath, &file_stats)) == -1) {
+            entry.StatErrno = errno;
+        } else {
+            entry.Mode = file_stats.st_mode;
+            entry.HostFlags = file_stats.st_flags;
+
+            slen = file_stats.st_size;
+            if (slen > 0xFFFFFF)
+                slen = 0xFFFFFF;
+
+            Dir_Entry_Set_Flags_From_Attributes(&entry.DirEnt,
+                                                file_stats.st_mode, file_stats.st_flags);
+            entry.DirEnt.LengthLo = (UBYTE)slen;
+            entry.DirEnt.LengthMid = (UBYTE)((ULONG)slen >> 8);
+            entry.DirEnt.LengthHi = (UBYTE)((ULONG)slen >> 16);
+            Dir_Entry_Set_Date(&entry.DirEnt, file_stats.st_mtime);
+        }
+
+        entry.NameValid = File_Name_Parse_From_Native(&entry.Name, ep->d_name);
+        if (entry.NameValid)
+            memcpy(entry.DirEnt.Name, entry.Name.Name, sizeof(entry.DirEnt.Name));
+
+        entry.NativeName = strdup(ep->d_name);
+        if (entry.NativeName == NULL || vec_push(&cache->Entries, entry)) {
+            free(entry.NativeName);
+            closedir(dirStream);
+            Dir_Cache_Drop(cache);
+            return ENOMEM;
+        }
+    }
+    closedir(dirStream);
+
+    vec_sort(&cache->Entries, Host_Dir_Entry_Compare);
+    cache->Loaded = now;
+    cache->WatchFd = Dir_Cache_Watch(path, (int) (cache - Dir_Caches));
+    return 0;
+}
+
+// Returns the listing of the directory NATIVEPATH, reading it if it isn't
+// cached or has gone stale. On failure, stores an errno value in *ERR and
+// returns NULL. The listing stays valid until the next call.
+DirCache *Dir_Cache_Get(const char *nativePath, int *err)
+{
+    char path[FILENAME_MAX];
+    struct stat dir_stats;
+    DirCache *cache = NULL;
+    time_t now = time(NULL);
+    size_t len;
+    int i;
+
+    strcpy(path, nativePath);
+    len = strlen(path);
+    while (len > 1 && path[len - 1] == '/')
+        path[--len] = 0;
+
+    if (Dir_Cache_Stale) {
+        for (i = 0; i < DIR_CACHE_SLOTS; i++)
+            Dir_Cache_Drop(&Dir_Caches[i]);
+        Dir_Cache_Stale = FALSE;
+    }
+    Dir_Cache_Poll();
+
+    for (i = 0; i < DIR_CACHE_SLOTS; i++) {
+        if (Dir_Caches[i].Path[0] && strcmp(Dir_Caches[i].Path, path) == 0) {
+            cache = &Dir_Caches[i];
+            break;
+        }
+    }
+
+    if (cache) {
+        if (cache->WatchFd >= 0) {
+            if (now - cache->Loaded > DIR_CACHE_MAX_AGE_WATCHED)
+                Dir_Cache_Drop(cache);
+        } else if (now - cache->Loaded > DIR_CACHE_MAX_AGE ||
+                   stat(path, &dir_stats) == -1 || dir_stats.st_mtime != cache->DirMTime) {
+            Dir_Cache_Drop(cache);
+        }
+    } else {
+        // Reuse the least recently used slot
+        cache = &Dir_Caches[0];
+        for (i = 1; i < DIR_CACHE_SLOTS; i++) {
+            if (Dir_Caches[i].LastUse < cache->LastUse)
+                cache = &Dir_Caches[i];
+        }
+        Dir_Cache_Drop(cache);
+    }
+
+    if (!cache->Path[0] && (*err = Dir_Cache_Load(cache, path, now)) != 0)
+        return NULL;
+
+    cache->LastUse = ++Dir_Cache_Use_Count;
+    return cache;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 typedef struct fileHandle {
@@ -562,6 +813,9 @@ UBYTE File_Handle_Open_File(FileHandle *hndl, const char *nativePath,
     }
 
     if (file) {
+        if (allowWrite)
+            Dir_Cache_Invalidate();
+
         hndl->Open = TRUE;
         hndl->IsDirectory = FALSE;
         hndl->AllowRead = allowRead;
@@ -594,7 +848,7 @@ void File_Handle_Open_As_Directory(FileHandle *hndl,
                                    FileName* pattern, 
                                    UBYTE attrFilter)
 {
-    vec_sort(&hndl->DirEnts, Dir_Entry_Compare);
+    // The entries were added in the sorted order of the directory cache
     hndl->Open = TRUE;
     hndl->IsDirectory = TRUE;
     hndl->Length = 23 * ((ULONG) hndl->DirEnts.length + 1);
@@ -619,6 +873,8 @@ void File_Handle_Close(FileHandle *hndl)
 {
     if (hndl->File)
         fclose(hndl->File);
+    if (hndl->AllowWrite)
+        Dir_Cache_Invalidate();
     File_Handle_Init(hndl);
 }
 
@@ -1011,26 +1267,26 @@ int Link_Device_On_Put(LinkDevice *dev) {
     char resultPath[FILENAME_MAX];
     char dstNativePath[FILENAME_MAX];
     char srcNativePath[FILENAME_MAX];
-    DIR * dirStream;
+    DirCache *cache;
     DirEntry dirEnt;
     FileHandle* fh;
+    HostDirEntry *entry;
     FileName dirName;
     FileName dstpat;
-    FileName entryName;
     FileName fn;
     FileName fn2;
     FileName fname;
     FileName pattern;
     FileName srcpat;
+    int err;
+    int i;
     int openDir;
     int setTimestamp;
     int matched;
     mode_t newmode;
     u_int newflags;
-    long long slen;
     size_t fnlen;
     size_t extlen;
-    struct dirent *ep;
     struct stat file_stats;
     struct timeval fileTime[2];
     struct tm fileExpTime;
@@ -1209,56 +1465,38 @@ int Link_Device_On_Put(LinkDevice *dev) {
 
             openDir = dev->ParBuf.Function == 10 || (dev->ParBuf.Mode & 0x10) != 0;
 
-            if ((dirStream = opendir(nativePath)) == NULL) {
-                return TranslateErrnoToSIOError(errno);
+            if ((cache = Dir_Cache_Get(nativePath, &err)) == NULL) {
+                dev->StatusError = TranslateErrnoToSIOError(err);
+                return TRUE;
             }
 
             matched = FALSE;
-            while((ep = readdir(dirStream))) {
-                if (!File_Name_Parse_From_Native(&fn, ep->d_name))
+            for (i = 0; i < cache->Entries.length; i++) {
+                entry = &cache->Entries.data[i];
+
+                if (!entry->NameValid)
                     continue;
 
                 // We can't filter at this point for a directory, because the byte stream
                 // needs to reflect all files while the FNEXT output shouldn't. Therefore,
                 // we need to cache the pattern with the file handle instead.
-                if (!openDir && !File_Name_Wild_Match(&pattern, &fn))
+                if (!openDir && !File_Name_Wild_Match(&pattern, &entry->Name))
                     continue;
 
-                strcpy(nativeFilePath, nativePath);
-                strcat(nativeFilePath, ep->d_name);
-                if ((stat(nativeFilePath, &file_stats)) == -1) {
-                    return TranslateErrnoToSIOError(errno);
+                if (entry->StatErrno) {
+                    dev->StatusError = TranslateErrnoToSIOError(entry->StatErrno);
+                    return TRUE;
                 }
-                slen = file_stats.st_size;
-
-                if (slen > 0xFFFFFF)
-                    slen = 0xFFFFFF;
-
-                Dir_Entry_Set_Flags_From_Attributes(&dirEnt,
-                                                    file_stats.st_mode, file_stats.st_flags);
 
-                if (ep->d_type == DT_DIR) {
-                    // skip blasted . and .. dirs
-                    if ((strcmp(ep->d_name,".") == 0) ||
-                        (strcmp(ep->d_name,"..") == 0))
-                        continue;
-                }
+                dirEnt = entry->DirEnt;
 
                 if (!Link_Device_Is_Dir_Ent_Included(dev, &dirEnt))
                     continue;
 
-                dirEnt.SectorMapLo = 0;
-                dirEnt.SectorMapHi = 0;
-                dirEnt.LengthLo = (UBYTE)slen;
-                dirEnt.LengthMid = (UBYTE)((ULONG)slen >> 8);
-                dirEnt.LengthHi = (UBYTE)((ULONG)slen >> 16);
-                memcpy(dirEnt.Name, fn.Name, sizeof(dirEnt.Name));
-                Dir_Entry_Set_Date(&dirEnt, file_stats.st_mtime);
-
                 if (!openDir) {
                     matched = TRUE;
                     strcpy(nativeFilePath, nativePath);
-                    strcat(nativeFilePath, ep->d_name);
+                    strcat(nativeFilePath, entry->NativeName);
                     break;
                 }
 
@@ -1381,31 +1619,28 @@ int Link_Device_On_Put(LinkDevice *dev) {
             strcat(path, "/");
             strcat(path, dev->CurDir);
 
-            if ((dirStream = opendir(path)) == NULL) {
-                return TranslateErrnoToSIOError(errno);
+            if ((cache = Dir_Cache_Get(path, &err)) == NULL) {
+                dev->StatusError = TranslateErrnoToSIOError(err);
+                return TRUE;
             }
 
             matched = FALSE;
-            while((ep = readdir(dirStream))) {
-                if ((strcmp(ep->d_name,".") == 0) ||
-                    (strcmp(ep->d_name,"..") == 0))
-                    continue;
+            for (i = 0; i < cache->Entries.length; i++) {
+                entry = &cache->Entries.data[i];
 
-                strcpy(fullPath, path);
-                strcat(fullPath, ep->d_name);
-                
-                if ((stat(fullPath, &file_stats)) == -1) {
-                    return TranslateErrnoToSIOError(errno);
+                if (entry->StatErrno) {
+                    dev->StatusError = TranslateErrnoToSIOError(entry->StatErrno);
+                    return TRUE;
                 }
-                Dir_Entry_Set_Flags_From_Attributes(&dirEnt,
-                                                    file_stats.st_mode, file_stats.st_flags);
 
-                if (!Link_Device_Is_Dir_Ent_Included(dev, &dirEnt))
+                if (!Link_Device_Is_Dir_Ent_Included(dev, &entry->DirEnt))
                     continue;
 
-                if (!File_Name_Parse_From_Native(&fn, ep->d_name))
+                if (!entry->NameValid)
                     continue;
 
+                fn = entry->Name;
+
                 if (!File_Name_Wild_Match(&srcpat, &fn))
                     continue;
 
@@ -1425,6 +1660,7 @@ int Link_Device_On_Put(LinkDevice *dev) {
                     {
                         dev->StatusError = TranslateErrnoToSIOError(errno);
                     }
+                Dir_Cache_Invalidate();
 
                 matched = TRUE;
                 }
@@ -1452,35 +1688,37 @@ int Link_Device_On_Put(LinkDevice *dev) {
             }
 
             if (File_Name_Is_Wild(&fname)) {
-                if ((dirStream = opendir(resultPath)) == NULL) {
-                    return TranslateErrnoToSIOError(errno);
+                if ((cache = Dir_Cache_Get(resultPath, &err)) == NULL) {
+                    dev->StatusError = TranslateErrnoToSIOError(err);
+                    return TRUE;
                 }
 
             matched = FALSE;
-            while((ep = readdir(dirStream))) {
-                strcpy(fullPath, resultPath);
-                strcat(fullPath, "/");
-                strcat(fullPath, ep->d_name);
-                
-                if ((stat(fullPath, &file_stats)) == -1) {
-                    return TranslateErrnoToSIOError(errno);
+            for (i = 0; i < cache->Entries.length; i++) {
+                entry = &cache->Entries.data[i];
+
+                if (entry->StatErrno) {
+                    dev->StatusError = TranslateErrnoToSIOError(entry->StatErrno);
+                    return TRUE;
                 }
 
-                if (S_ISDIR(file_stats.st_mode))
+                if (S_ISDIR(entry->Mode))
                     continue;
 
-                Dir_Entry_Set_Flags_From_Attributes(&dirEnt,
-                                                    file_stats.st_mode, file_stats.st_flags);
-
-                if (!Link_Device_Is_Dir_Ent_Included(dev, &dirEnt))
+                if (!Link_Device_Is_Dir_Ent_Included(dev, &entry->DirEnt))
                     continue;
 
-                if (!File_Name_Parse_From_Native(&entryName, ep->d_name))
+                if (!entry->NameValid)
                     continue;
 
-                if (!File_Name_Wild_Match(&fname, &entryName))
+                if (!File_Name_Wild_Match(&fname, &entry->Name))
                     continue;
 
+                strcpy(fullPath, resultPath);
+                strcat(fullPath, "/");
+                strcat(fullPath, entry->NativeName);
+
+                Dir_Cache_Invalidate();
                 if (remove(fullPath))
                     {
                     dev->StatusError = TranslateErrnoToSIOError(errno);
@@ -1504,6 +1742,7 @@ int Link_Device_On_Put(LinkDevice *dev) {
                 Dir_Entry_Set_Flags_From_Attributes(&dirEnt, file_stats.st_mode, file_stats.st_flags);
 
                 if (Link_Device_Is_Dir_Ent_Included(dev, &dirEnt)) {
+                    Dir_Cache_Invalidate();
                     if (remove(resultPath)) {
                         dev->StatusError = TranslateErrnoToSIOError(errno);
                         return TRUE;
@@ -1534,40 +1773,36 @@ int Link_Device_On_Put(LinkDevice *dev) {
                 return TRUE;
             }
 
-            if ((dirStream = opendir(path)) == NULL) {
-                return TranslateErrnoToSIOError(errno);
+            if ((cache = Dir_Cache_Get(path, &err)) == NULL) {
+                dev->StatusError = TranslateErrnoToSIOError(err);
+                return TRUE;
             }
 
             matched = FALSE;
-            while((ep = readdir(dirStream))) {
-                if ((strcmp(ep->d_name,".") == 0) ||
-                    (strcmp(ep->d_name,"..") == 0))
-                    continue;
+            for (i = 0; i < cache->Entries.length; i++) {
+                entry = &cache->Entries.data[i];
 
-                strcpy(fullPath, path);
-                strcat(fullPath, ep->d_name);
-                
-                if ((stat(fullPath, &file_stats)) == -1) {
-                    return TranslateErrnoToSIOError(errno);
+                if (entry->StatErrno) {
+                    dev->StatusError = TranslateErrnoToSIOError(entry->StatErrno);
+                    return TRUE;
                 }
 
-                Dir_Entry_Set_Flags_From_Attributes(&dirEnt,
-                                                    file_stats.st_mode, file_stats.st_flags);
-
-                if (!Link_Device_Is_Dir_Ent_Included(dev, &dirEnt))
+                if (!Link_Device_Is_Dir_Ent_Included(dev, &entry->DirEnt))
                     continue;
 
-                if (!File_Name_Parse_From_Native(&fn, ep->d_name))
+                if (!entry->NameValid)
                     continue;
 
+                fn = entry->Name;
+
                 if (!File_Name_Wild_Match(&srcpat, &fn))
                     continue;
 
                 strcpy(srcNativePath, path);
                 File_Name_Append_Native(&fn, srcNativePath);
 
-                newmode = file_stats.st_mode;
-                newflags = file_stats.st_flags;
+                newmode = entry->Mode;
+                newflags = entry->HostFlags;
 
                 if (dev->ParBuf.Attr2 & 0x10)
                     newmode |= S_IWUSR;
@@ -1581,6 +1816,8 @@ int Link_Device_On_Put(LinkDevice *dev) {
                 if (dev->ParBuf.Attr2 & 0x20)
                     newflags &= ~UF_HIDDEN;
 
+                Dir_Cache_Invalidate();
+
                 if (chmod(srcNativePath, newmode)) {
                     dev->StatusError = TranslateErrnoToSIOError(errno);
                     return TRUE;
@@ -1624,6 +1861,8 @@ int Link_Device_On_Put(LinkDevice *dev) {
 
             File_Name_Append_Native(&fname, resultPath);
 
+            Dir_Cache_Invalidate();
+
             if (mkdir(resultPath, S_IRWXU)) {
                 dev->StatusError = TranslateErrnoToSIOError(errno);
                 return TRUE;
@@ -1668,6 +1907,8 @@ int Link_Device_On_Put(LinkDevice *dev) {
 
             File_Name_Append_Native(&fname, resultPath);
 
+            Dir_Cache_Invalidate();
+
             if (rmdir(resultPath)) {
                 dev->StatusError = TranslateErrnoToSIOError(errno);
                 return TRUE;
@@ -0,0 +1,204 @@
+/*
+ * perf.c - hot-path profiling counters
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#endif
+
+#include "log.h"
+#include "pacer.h"
+#include "perf.h"
+
+int PERF_dump_interval = 0;
+
+static const char * const section_names[PERF_SECTION_COUNT] = {
+	"CPU", "ANTIC", "GTIA", "POKEYSND", "SIO", "NetSIO", "palette", "sleep"
+};
+
+static PERF_Counters counters;
+static PERF_Counters last_dump;
+static double start_time = -1.0;
+
+#ifdef PERF_COUNTERS
+
+/* Raw clock ticks: mach_absolute_time() is a commpage read on Mac OS X,
+   clock_gettime() a vDSO call on Linux, so both are cheap enough to read
+   on every CPU_GO. */
+#ifdef __APPLE__
+typedef uint64_t ticks_t;
+static mach_timebase_info_data_t timebase;
+
+static ticks_t read_ticks(void)
+{
+	return mach_absolute_time();
+}
+
+static double ticks_to_seconds(ticks_t t)
+{
+	if (timebase.denom == 0)
+		mach_timebase_info(&timebase);
+	return (double) t * timebase.numer / timebase.denom * 1e-9;
+}
+#elif defined(CLOCK_MONOTONIC)
+typedef unsigned long long ticks_t;
+
+static ticks_t read_ticks(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ticks_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static double ticks_to_seconds(ticks_t t)
+{
+	return t * 1e-9;
+}
+#else
+typedef double ticks_t;
+
+static ticks_t read_ticks(void)
+{
+	return PACER_Time();
+}
+
+static double ticks_to_seconds(ticks_t t)
+{
+	return t;
+}
+#endif
+
+#define MAX_DEPTH 8
+
+static ticks_t section_ticks[PERF_SECTION_COUNT];
+static int stack[MAX_DEPTH];
+static int depth = 0;
+static ticks_t segment_start;
+
+void PERF_Begin(int section)
+{
+	ticks_t now = read_ticks();
+	/* Past MAX_DEPTH the outer section is not on the stack; its time so
+	   far goes unaccounted rather than to the wrong section. */
+	if (depth > 0 && depth <= MAX_DEPTH)
+		section_ticks[stack[depth - 1]] += now - segment_start;
+	if (depth < MAX_DEPTH)
+		stack[depth] = section;
+	depth++;
+	counters.calls[section]++;
+	segment_start = now;
+}
+
+void PERF_End(int section)
+{
+	ticks_t now = read_ticks();
+	if (depth == 0)
+		return;
+	depth--;
+	section_ticks[section] += now - segment_start;
+	segment_start = now;
+}
+
+static void collect(void)
+{
+	int i;
+	for (i = 0; i < PERF_SECTION_COUNT; i++)
+		counters.time[i] = ticks_to_seconds(section_ticks[i]);
+}
+
+static void clear(void)
+{
+	memset(section_ticks, 0, sizeof(section_ticks));
+}
+
+#else /* PERF_COUNTERS */
+
+#define collect()
+#define clear()
+
+#endif /* PERF_COUNTERS */
+
+void PERF_Frame(void)
+{
+	double now = PACER_Time();
+	if (start_time < 0.0)
+		start_time = now;
+	counters.frames++;
+	counters.wall_time = now - start_time;
+	if (PERF_dump_interval > 0 && counters.frames - last_dump.frames >= (unsigned long) PERF_dump_interval)
+		PERF_Dump();
+}
+
+void PERF_GetCounters(PERF_Counters *c)
+{
+	collect();
+	*c = counters;
+}
+
+void PERF_Reset(void)
+{
+	clear();
+	memset(&counters, 0, sizeof(counters));
+	memset(&last_dump, 0, sizeof(last_dump));
+	start_time = -1.0;
+	PACER_ResetStats();
+}
+
+const char *PERF_SectionName(int section)
+{
+	if (section < 0 || section >= PERF_SECTION_COUNT)
+		return "?";
+	return section_names[section];
+}
+
+void PERF_Dump(void)
+{
+	char line[256];
+	int len;
+	int i;
+	unsigned long frames;
+	double wall;
+	PACER_Stats pacer;
+
+	collect();
+	frames = counters.frames - last_dump.frames;
+	wall = counters.wall_time - last_dump.wall_time;
+	if (frames == 0 || wall <= 0.0)
+		return;
+	len = snprintf(line, sizeof(line), "perf: %lu frames, %.1f fps, ms/frame:",
+	               frames, frames / wall);
+	for (i = 0; i < PERF_SECTION_COUNT && len < (int) sizeof(line); i++)
+		len += snprintf(line + len, sizeof(line) - len, " %s %.3f",
+		                section_names[i], (counters.time[i] - last_dump.time[i]) * 1000.0 / frames);
+	Log_print("%s", line);
+	last_dump = counters;
+
+	PACER_GetStats(&pacer);
+	if (pacer.frames > 0)
+		Log_print("pacer: %lu late, wake-up error mean %.3f max %.3f ms",
+		          pacer.late_frames, pacer.mean_error * 1000.0, pacer.max_error * 1000.0);
+	PACER_ResetStats();
+}
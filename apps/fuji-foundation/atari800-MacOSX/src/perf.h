@@ -0,0 +1,59 @@
+#ifndef PERF_H_
+#define PERF_H_
+
+/* Hot-path profiling counters.
+   Only compiled in when PERF_COUNTERS is defined; otherwise PERF_BEGIN and
+   PERF_END expand to nothing and the counters stay zero. Times are
+   exclusive: while a section runs inside another (e.g. a partial scanline
+   drawn from a register write during CPU_GO), the outer one is paused.
+   The counters are not thread-safe; only use them on the emulation thread. */
+
+enum {
+	PERF_CPU,		/* CPU_GO */
+	PERF_ANTIC_DRAW,	/* ANTIC scanline drawing */
+	PERF_GTIA_COLLISIONS,	/* PMG scanline and collision updates */
+	PERF_POKEYSND,		/* sound sample generation */
+	PERF_SIO,		/* SIO_Handler patch */
+	PERF_NETSIO_WAIT,	/* waiting for NetSIO sync responses */
+	PERF_PALETTE,		/* indexed colour to RGB conversion */
+	PERF_SYNC_SLEEP,	/* Atari800_Sync waiting for the frame deadline */
+	PERF_SECTION_COUNT
+};
+
+typedef struct PERF_Counters_t {
+	unsigned long frames;			/* frames since the last reset */
+	double wall_time;			/* seconds since the last reset */
+	double time[PERF_SECTION_COUNT];	/* seconds spent in each section */
+	unsigned long calls[PERF_SECTION_COUNT];	/* times each section was entered */
+} PERF_Counters;
+
+/* Frames between dumps of the counters to the log, 0 disables dumping. */
+extern int PERF_dump_interval;
+
+#ifdef PERF_COUNTERS
+void PERF_Begin(int section);
+void PERF_End(int section);
+#define PERF_BEGIN(section) PERF_Begin(section)
+#define PERF_END(section) PERF_End(section)
+#else
+#define PERF_BEGIN(section) do {} while (0)
+#define PERF_END(section) do {} while (0)
+#endif
+
+/* Called once per emulated frame; dumps the counters every PERF_dump_interval frames. */
+void PERF_Frame(void);
+
+/* Copies the counters accumulated since the last PERF_Reset(). */
+void PERF_GetCounters(PERF_Counters *counters);
+
+/* Clears the counters and the PACER statistics. */
+void PERF_Reset(void);
+
+/* Returns a short name of the section, for display. */
+const char *PERF_SectionName(int section);
+
+/* Writes the per-frame averages and the PACER statistics since the
+   previous dump to the log. */
+void PERF_Dump(void);
+
+#endif /* PERF_H_ */
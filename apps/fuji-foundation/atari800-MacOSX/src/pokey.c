@@ -52,6 +52,7 @@
 #include "log.h"
 #include "input.h"
 #include "pbi.h"
+#include "sched.h"
 #ifdef NETSIO
 #include "netsio.h"
 #endif
@@ -93,6 +94,57 @@ UBYTE POKEY_poly9_lookup[511];
 UBYTE POKEY_poly17_lookup[16385];
 static ULONG random_scanline_counter;
 
+/* Timers 1, 2 and 4 run as scheduler events. The stored event cycle is the
+   next underflow; the event is only queued while its IRQ is enabled, so idle
+   timers cost nothing per scanline. */
+#define TIMER_COUNT 3
+#define TIMER_EVENT(t) (SCHED_EVENT_POKEY_TIMER1 + (t))
+static const int timer_chan[TIMER_COUNT] = { POKEY_CHAN1, POKEY_CHAN2, POKEY_CHAN4 };
+static const UBYTE timer_irq_mask[TIMER_COUNT] = { 0x01, 0x02, 0x04 };
+
+static unsigned int timer_period(int t)
+{
+	int period = POKEY_DivNMax[timer_chan[t]];
+	return period > ANTIC_LINE_C ? period : ANTIC_LINE_C;
+}
+
+/* Returns the first underflow after now, counting from the stored cycle */
+static unsigned int timer_next_underflow(int t, unsigned int now)
+{
+	unsigned int next = SCHED_GetCycle(TIMER_EVENT(t));
+	if ((int) (now - next) >= 0) {
+		unsigned int period = timer_period(t);
+		next += ((now - next) / period + 1) * period;
+	}
+	return next;
+}
+
+static void timer_underflow(int event)
+{
+	int t = event - SCHED_EVENT_POKEY_TIMER1;
+	/* Timers don't count while POKEY is in reset mode; keep the phase moving
+	   but don't raise the IRQ. */
+	if ((POKEY_SKCTL & 0x03) != 0 && (POKEY_IRQEN & timer_irq_mask[t])) {
+		POKEY_IRQST &= ~timer_irq_mask[t];
+		CPU_GenerateIRQ();
+	}
+	SCHED_Add(event, timer_next_underflow(t, ANTIC_CPU_CLOCK));
+}
+
+/* Queues the timer events whose IRQ is enabled and drops the others */
+static void update_timer_events(void)
+{
+	int t;
+	for (t = 0; t < TIMER_COUNT; t++) {
+		if (POKEY_IRQEN & timer_irq_mask[t]) {
+			if (!SCHED_IsQueued(TIMER_EVENT(t)))
+				SCHED_Add(TIMER_EVENT(t), timer_next_underflow(t, ANTIC_CPU_CLOCK));
+		}
+		else
+			SCHED_Remove(TIMER_EVENT(t));
+	}
+}
+
 ULONG POKEY_GetRandomCounter(void)
 {
 	return random_scanline_counter;
@@ -255,6 +307,7 @@ void POKEY_PutByte(UWORD addr, UBYTE byte)
 		printf("WR: IRQEN = %x, PC = %x\n", POKEY_IRQEN, PC);
 #endif
 		POKEY_IRQST |= ~byte & 0xf7;	/* Reset disabled IRQs except XMTDONE */
+		update_timer_events();
 		if ((~POKEY_IRQST & POKEY_IRQEN) == 0 && PBI_IRQ == 0 && PIA_IRQ == 0)
 			CPU_IRQ = 0;
 		else
@@ -311,9 +364,11 @@ void POKEY_PutByte(UWORD addr, UBYTE byte)
 #endif
 		break;
 	case POKEY_OFFSET_STIMER:
-		POKEY_DivNIRQ[POKEY_CHAN1] = POKEY_DivNMax[POKEY_CHAN1];
-		POKEY_DivNIRQ[POKEY_CHAN2] = POKEY_DivNMax[POKEY_CHAN2];
-		POKEY_DivNIRQ[POKEY_CHAN4] = POKEY_DivNMax[POKEY_CHAN4];
+		{
+			int t;
+			for (t = 0; t < TIMER_COUNT; t++)
+				SCHED_SetCycle(TIMER_EVENT(t), ANTIC_CPU_CLOCK + POKEY_DivNMax[timer_chan[t]]);
+		}
 		POKEYSND_Update(POKEY_OFFSET_STIMER, byte, 0, SOUND_GAIN);
 #ifdef DEBUG1
 		printf("WR: STIMER = %x\n", byte);
@@ -425,6 +480,12 @@ int POKEY_Initialise(int *argc, char *argv[])
 	for (i = 0; i < 4; i++)
 		POKEY_DivNIRQ[i] = POKEY_DivNMax[i] = 0;
 
+	for (i = 0; i < TIMER_COUNT; i++) {
+		SCHED_Register(TIMER_EVENT(i), timer_underflow);
+		SCHED_Remove(TIMER_EVENT(i));
+		SCHED_SetCycle(TIMER_EVENT(i), ANTIC_CPU_CLOCK);
+	}
+
 	pot_scanline = 0;
 
 	/* initialise poly9_lookup */
@@ -470,6 +531,11 @@ int POKEY_Initialise(int *argc, char *argv[])
 void POKEY_Frame(void)
 {
 	random_scanline_counter %= (POKEY_AUDCTL[0] & POKEY_POLY9) ? POKEY_POLY9_SIZE : POKEY_POLY17_SIZE;
+#ifdef NETSIO
+	/* Outbound serial bytes are batched; don't hold them past the frame */
+	if (netsio_enabled)
+		netsio_flush();
+#endif
 }
 
 /***************************************************************************
@@ -492,6 +558,9 @@ void POKEY_Scanline(void)
 	POKEYSND_UpdateVolOnly();
 #endif
 
+	/* Timer IRQs and any other peripheral events that are due */
+	SCHED_Run();
+
 #ifndef BASIC
 	INPUT_Scanline();	/* Handle Amiga and ST mice. */
 						/* It's not a part of POKEY emulation, */
@@ -587,30 +656,6 @@ void POKEY_Scanline(void)
 				printf("SERIO: XMTDONE Interrupt missed\n");
 #endif
 		}
-
-	if ((POKEY_DivNIRQ[POKEY_CHAN1] -= ANTIC_LINE_C) < 0 ) {
-		POKEY_DivNIRQ[POKEY_CHAN1] += POKEY_DivNMax[POKEY_CHAN1];
-		if (POKEY_IRQEN & 0x01) {
-			POKEY_IRQST &= 0xfe;
-			CPU_GenerateIRQ();
-		}
-	}
-
-	if ((POKEY_DivNIRQ[POKEY_CHAN2] -= ANTIC_LINE_C) < 0 ) {
-		POKEY_DivNIRQ[POKEY_CHAN2] += POKEY_DivNMax[POKEY_CHAN2];
-		if (POKEY_IRQEN & 0x02) {
-			POKEY_IRQST &= 0xfd;
-			CPU_GenerateIRQ();
-		}
-	}
-
-	if ((POKEY_DivNIRQ[POKEY_CHAN4] -= ANTIC_LINE_C) < 0 ) {
-		POKEY_DivNIRQ[POKEY_CHAN4] += POKEY_DivNMax[POKEY_CHAN4];
-		if (POKEY_IRQEN & 0x04) {
-			POKEY_IRQST &= 0xfb;
-			CPU_GenerateIRQ();
-		}
-	}
 }
 
 /*****************************************************************************/
@@ -691,6 +736,12 @@ void POKEY_StateSave(void)
 {
 	int shift_key = 0;
 	int keypressed = 0;
+	int i;
+
+	/* Timer phase is kept as absolute event cycles; save it as the
+	   remaining count like before. */
+	for (i = 0; i < TIMER_COUNT; i++)
+		POKEY_DivNIRQ[timer_chan[i]] = (int) (timer_next_underflow(i, ANTIC_CPU_CLOCK) - ANTIC_CPU_CLOCK);
 
 	STATESAV_TAG(pokey);
 	StateSav_SaveUBYTE(&POKEY_KBCODE, 1);
@@ -742,6 +793,12 @@ void POKEY_StateRead(void)
 	StateSav_ReadINT(&POKEY_DivNIRQ[0], 4);
 	StateSav_ReadINT(&POKEY_DivNMax[0], 4);
 	StateSav_ReadINT(&POKEY_Base_mult[0], 1);
+
+	for (i = 0; i < TIMER_COUNT; i++) {
+		SCHED_Remove(TIMER_EVENT(i));
+		SCHED_SetCycle(TIMER_EVENT(i), ANTIC_CPU_CLOCK + POKEY_DivNIRQ[timer_chan[i]]);
+	}
+	update_timer_events();
 }
 
 #endif
@@ -0,0 +1,262 @@
+/*
+ * pokeyfilt.c - precomputed and cached resampling filters for mzpokeysnd
+ *
+ * Copyright (C) 2002 Krzysztof Nikiel
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pokeyfilt.h"
+#include "remez.h"
+
+/* This file is also linked into util/pokeyfilt_gen.c, so it only uses the
+   C library. */
+
+#ifndef DEFAULT_POKEYFILT_NAME
+#define DEFAULT_POKEYFILT_NAME ".atari800-pokeyfilt"
+#endif
+
+/* First line of the cache file; bump the number when the format changes. */
+#define HEADER "Atari800 POKEY filters 1\n"
+/* Follows the header; rejects files written on a machine with another
+   byte order. */
+#define BYTE_ORDER_MARK 0x01020304
+
+char POKEYFILT_cache_filename[FILENAME_MAX];
+
+/* Each record in the cache file is this header followed by SIZE doubles. */
+typedef struct record_t {
+	int sample_rate;
+	int pokey_frq;
+	int quality;
+	int size;
+	double cutoff;
+} record_t;
+
+/******************************************
+ filter table generator by Krzysztof Nikiel
+ ******************************************/
+
+int POKEYFILT_Design(double *filter, int max_size, int sample_rate, int pokey_frq,
+                     int quality, double *cutoff)
+{
+	double resamp_rate = (double) sample_rate / pokey_frq;
+	int i;
+	static const int orders[] = {600, 800, 1000, 1200};
+	static const struct {
+		int stop;		/* stopband ripple */
+		double weight;	/* stopband weight */
+		double twidth[sizeof(orders)/sizeof(orders[0])];
+	} paramtab[] =
+	{
+		{70, 90, {4.9e-3, 3.45e-3, 2.65e-3, 2.2e-3}},
+		{55, 25, {3.4e-3, 2.7e-3, 2.05e-3, 1.7e-3}},
+		{40, 6.0, {2.6e-3, 1.8e-3, 1.5e-3, 1.2e-3}},
+		{-1, 0, {0, 0, 0, 0}}
+	};
+	static const double passtab[POKEYFILT_MAX_QUALITY + 1] = {0.5, 0.6, 0.7};
+	int ripple = 0, order = 0;
+	int size;
+	double weights[2], desired[2], bands[4];
+	static const int interlevel = 5;
+	double step = 1.0 / interlevel;
+
+	*cutoff = 0.95 * 0.5 * resamp_rate;
+
+	if (quality > POKEYFILT_MAX_QUALITY)
+		quality = POKEYFILT_MAX_QUALITY;
+
+	for (ripple = 0; paramtab[ripple].stop > 0; ripple++) {
+		for (order = 0; order < (int) (sizeof(orders)/sizeof(orders[0])); order++) {
+			if ((*cutoff - paramtab[ripple].twidth[order])
+			    > passtab[quality] * 0.5 * resamp_rate)
+				/* transition width OK */
+				goto found;
+		}
+	}
+
+	/* not found -- use shortest transition */
+	ripple--;
+	order--;
+
+found:
+	size = orders[order] + 1;
+
+	if (size > max_size) /* table too short */
+		return 0;
+
+	desired[0] = 1;
+	desired[1] = 0;
+
+	weights[0] = 1;
+	weights[1] = paramtab[ripple].weight;
+
+	bands[0] = 0;
+	bands[2] = *cutoff;
+	bands[1] = bands[2] - paramtab[ripple].twidth[order];
+	bands[3] = 0.5;
+
+	bands[1] *= (double)interlevel;
+	bands[2] *= (double)interlevel;
+	REMEZ_CreateFilter(filter, (size / interlevel) + 1, 2, bands, desired, weights, REMEZ_BANDPASS);
+	for (i = size - interlevel; i >= 0; i -= interlevel) {
+		int s;
+		double h1 = filter[i/interlevel];
+		double h2 = filter[i/interlevel+1];
+
+		for (s = 0; s < interlevel; s++) {
+			double d = (double)s * step;
+			filter[i+s] = (h1*(1.0 - d) + h2 * d) * step;
+		}
+	}
+
+	/* compute reversed cumulative sum table */
+	for (i = size - 2; i >= 0; i--)
+		filter[i] += filter[i + 1];
+
+	return size;
+}
+
+static void set_default_filename(void)
+{
+	const char *home;
+	if (POKEYFILT_cache_filename[0] != '\0')
+		return;
+	home = getenv("HOME");
+	if (home != NULL)
+		snprintf(POKEYFILT_cache_filename, FILENAME_MAX, "%s/%s", home, DEFAULT_POKEYFILT_NAME);
+	else
+		snprintf(POKEYFILT_cache_filename, FILENAME_MAX, "%s", DEFAULT_POKEYFILT_NAME);
+}
+
+static int find_builtin(double *filter, int max_size, int sample_rate, int pokey_frq,
+                        int quality, double *cutoff)
+{
+	const POKEYFILT_Table *t;
+	for (t = POKEYFILT_builtin; t->sample_rate != 0; t++) {
+		if (t->sample_rate == sample_rate && t->pokey_frq == pokey_frq && t->quality == quality
+		    && t->size <= max_size) {
+			int i;
+			for (i = 0; i < t->size; i++)
+				filter[i] = t->data[i];
+			*cutoff = t->cutoff;
+			return t->size;
+		}
+	}
+	return 0;
+}
+
+static int check_header(FILE *fp)
+{
+	char header[sizeof(HEADER) - 1];
+	int mark;
+	return fread(header, sizeof(header), 1, fp) == 1
+	       && memcmp(header, HEADER, sizeof(header)) == 0
+	       && fread(&mark, sizeof(mark), 1, fp) == 1
+	       && mark == BYTE_ORDER_MARK;
+}
+
+static int find_cached(double *filter, int max_size, int sample_rate, int pokey_frq,
+                       int quality, double *cutoff)
+{
+	FILE *fp;
+	record_t rec;
+	int size = 0;
+
+	fp = fopen(POKEYFILT_cache_filename, "rb");
+	if (fp == NULL)
+		return 0;
+	if (check_header(fp)) {
+		while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+			if (rec.size <= 0)
+				break;
+			if (rec.sample_rate == sample_rate && rec.pokey_frq == pokey_frq && rec.quality == quality
+			    && rec.size <= max_size) {
+				if (fread(filter, sizeof(double), rec.size, fp) == (size_t) rec.size) {
+					*cutoff = rec.cutoff;
+					size = rec.size;
+				}
+				break;
+			}
+			if (fseek(fp, (long) (rec.size * sizeof(double)), SEEK_CUR) != 0)
+				break;
+		}
+	}
+	fclose(fp);
+	return size;
+}
+
+/* Appends a record. The file is only ever appended to, with one fwrite()
+   per record, so a concurrent reader sees either the old or the new end. */
+static void store_cached(const double *filter, int size, int sample_rate, int pokey_frq,
+                         int quality, double cutoff)
+{
+	FILE *fp;
+	record_t rec;
+	unsigned char *buf;
+
+	fp = fopen(POKEYFILT_cache_filename, "ab");
+	if (fp == NULL)
+		return;
+	fseek(fp, 0, SEEK_END);
+	if (ftell(fp) == 0) {
+		int mark = BYTE_ORDER_MARK;
+		fwrite(HEADER, sizeof(HEADER) - 1, 1, fp);
+		fwrite(&mark, sizeof(mark), 1, fp);
+	}
+	memset(&rec, 0, sizeof(rec));
+	rec.sample_rate = sample_rate;
+	rec.pokey_frq = pokey_frq;
+	rec.quality = quality;
+	rec.size = size;
+	rec.cutoff = cutoff;
+	buf = (unsigned char *) malloc(sizeof(rec) + size * sizeof(double));
+	if (buf != NULL) {
+		memcpy(buf, &rec, sizeof(rec));
+		memcpy(buf + sizeof(rec), filter, size * sizeof(double));
+		fwrite(buf, sizeof(rec) + size * sizeof(double), 1, fp);
+		free(buf);
+	}
+	fclose(fp);
+}
+
+int POKEYFILT_Get(double *filter, int max_size, int sample_rate, int pokey_frq,
+                  int quality, double *cutoff)
+{
+	int size;
+
+	if (quality > POKEYFILT_MAX_QUALITY)
+		quality = POKEYFILT_MAX_QUALITY;
+	size = find_builtin(filter, max_size, sample_rate, pokey_frq, quality, cutoff);
+	if (size > 0)
+		return size;
+	set_default_filename();
+	size = find_cached(filter, max_size, sample_rate, pokey_frq, quality, cutoff);
+	if (size > 0)
+		return size;
+	size = POKEYFILT_Design(filter, max_size, sample_rate, pokey_frq, quality, cutoff);
+	if (size > 0)
+		store_cached(filter, size, sample_rate, pokey_frq, quality, *cutoff);
+	return size;
+}
@@ -0,0 +1,44 @@
+#ifndef POKEYFILT_H_
+#define POKEYFILT_H_
+
+#include <stdio.h>
+
+/* Resampling filters for mzpokeysnd.
+   Designing a filter with the Parks-McClellan algorithm takes a noticeable
+   time, so POKEYFILT_Get() looks for it first among the tables built in by
+   util/pokeyfilt_gen.c, then in a cache file, and only designs (and caches)
+   it when neither has it. A filter depends on the playback rate, the POKEY
+   clock it is resampled from and the quality, not on the sample format. */
+
+typedef struct POKEYFILT_Table_t {
+	int sample_rate;	/* Hz; 0 ends POKEYFILT_builtin */
+	int pokey_frq;		/* Hz */
+	int quality;
+	int size;
+	double cutoff;		/* as a fraction of pokey_frq */
+	const float *data;
+} POKEYFILT_Table;
+
+/* Precomputed filters, in pokeyfilt_tables.c. */
+extern const POKEYFILT_Table POKEYFILT_builtin[];
+
+/* Path of the cache file; defaults to ~/.atari800-pokeyfilt when empty. */
+extern char POKEYFILT_cache_filename[FILENAME_MAX];
+
+/* Highest quality level; higher values are treated as this one. */
+#define POKEYFILT_MAX_QUALITY 2
+
+/* Designs the filter for resampling POKEY_FRQ to SAMPLE_RATE at QUALITY
+   into FILTER as a reversed cumulative sum table. Stores the cutoff, as a
+   fraction of POKEY_FRQ, in *CUTOFF. Returns the table size, or 0 if it
+   would exceed MAX_SIZE. */
+int POKEYFILT_Design(double *filter, int max_size, int sample_rate, int pokey_frq,
+                     int quality, double *cutoff);
+
+/* Like POKEYFILT_Design(), but takes the filter from the built-in tables or
+   the cache file when possible, and adds newly designed filters to the
+   cache file. */
+int POKEYFILT_Get(double *filter, int max_size, int sample_rate, int pokey_frq,
+                  int quality, double *cutoff);
+
+#endif /* POKEYFILT_H_ */
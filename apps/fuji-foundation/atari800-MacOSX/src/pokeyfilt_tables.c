@@ -0,0 +1,596 @@
+/* pokeyfilt_tables.c - generated by util/pokeyfilt_gen.c, do not edit */
+
+#include "config.h"
+#include <stdio.h>
+
+#include "pokeyfilt.h"
+
+static const float filter_11025_0[1201] = {
+	0.926801083, 0.920320107, 0.919023912, 0.917956386, 0.91711753, 0.916507344,
+	0.916125827, 0.91597298, 0.915818593, 0.915662664, 0.915505195, 0.915346184,
+	0.915185633, 0.915023619, 0.914860142, 0.914695202, 0.914528799, 0.914360933,
+	0.914191786, 0.914021358, 0.913849649, 0.913676659, 0.913502388, 0.913326942,
+	0.913150322, 0.912972526, 0.912793555, 0.912613409, 0.912432314, 0.912250269,
+	0.912067275, 0.911883331, 0.911698438, 0.911512744, 0.911326249, 0.911138953,
+	0.910950857, 0.91076196, 0.910572519, 0.910382535, 0.910192007, 0.910000935,
+	0.90980932, 0.909617355, 0.90942504, 0.909232375, 0.90903936, 0.908845996,
+	0.90865257, 0.908459083, 0.908265535, 0.908071925, 0.907878254, 0.90768474,
+	0.907491384, 0.907298185, 0.907105144, 0.906912261, 0.906719856, 0.906527929,
+	0.906336481, 0.906145511, 0.90595502, 0.905765243, 0.90557618, 0.905387831,
+	0.905200195, 0.905013274, 0.904827411, 0.904642608, 0.904458864, 0.904276179,
+	0.904094553, 0.903914235, 0.903735225, 0.903557522, 0.903381126, 0.903206039,
+	0.90303262, 0.90286087, 0.90269079, 0.902522379, 0.902355637, 0.902190824,
+	0.902027942, 0.90186699, 0.901707967, 0.901550874, 0.901396095, 0.901243629,
+	0.901093476, 0.900945637, 0.900800111, 0.900657173, 0.900516823, 0.900379061,
+	0.900243887, 0.900111302, 0.899981722, 0.899855147, 0.899731578, 0.899611014,
+	0.899493455, 0.89937919, 0.899268218, 0.899160538, 0.899056152, 0.898955059,
+	0.898857702, 0.898764081, 0.898674196, 0.898588046, 0.898505632, 0.898427234,
+	0.898352852, 0.898282484, 0.898216133, 0.898153796, 0.8980959, 0.898042444,
+	0.897993427, 0.89794885, 0.897908713, 0.897873241, 0.897842432, 0.897816288,
+	0.897794807, 0.897777991, 0.897766215, 0.89775948, 0.897757786, 0.897761132,
+	0.897769518, 0.897783073, 0.897801796, 0.897825688, 0.897854748, 0.897888977,
+	0.897928814, 0.897974259, 0.898025312, 0.898081974, 0.898144244, 0.898212282,
+	0.898286088, 0.898365662, 0.898451004, 0.898542114, 0.898639842, 0.89874419,
+	0.898855156, 0.898972741, 0.899096945, 0.899227421, 0.899364169, 0.899507189,
+	0.899656481, 0.899812046, 0.89997406, 0.900142523, 0.900317437, 0.9004988,
+	0.900686613, 0.900881508, 0.901083485, 0.901292545, 0.901508688, 0.901731912,
+	0.901962043, 0.902199081, 0.902443025, 0.902693875, 0.902951631, 0.90321665,
+	0.903488932, 0.903768477, 0.904055284, 0.904349354, 0.904650662, 0.904959206,
+	0.905274988, 0.905598007, 0.905928263, 0.906265946, 0.906611057, 0.906963593,
+	0.907323557, 0.907690948, 0.908065733, 0.908447913, 0.908837486, 0.909234455,
+	0.909638817, 0.910050653, 0.910469964, 0.910896748, 0.911331006, 0.911772739,
+	0.912221862, 0.912678378, 0.913142284, 0.913613582, 0.914092272, 0.914578343,
+	0.915071796, 0.915572631, 0.916080848, 0.916596446, 0.917119271, 0.917649322,
+	0.918186599, 0.918731103, 0.919282833, 0.919841681, 0.920407648, 0.920980734,
+	0.921560938, 0.92214826, 0.922742463, 0.923343546, 0.923951509, 0.924566352,
+	0.925188076, 0.925816468, 0.926451528, 0.927093257, 0.927741655, 0.928396721,
+	0.929058134, 0.929725895, 0.930400003, 0.931080459, 0.931767262, 0.932460105,
+	0.93315899, 0.933863914, 0.934574879, 0.935291884, 0.936014528, 0.936742809,
+	0.937476729, 0.938216287, 0.938961482, 0.939711922, 0.940467606, 0.941228534,
+	0.941994706, 0.942766122, 0.943542294, 0.944323221, 0.945108904, 0.945899343,
+	0.946694537, 0.947493995, 0.948297716, 0.9491057, 0.949917948, 0.950734459,
+	0.951554649, 0.952378519, 0.953206069, 0.954037299, 0.954872208, 0.955710188,
+	0.95655124, 0.957395362, 0.958242556, 0.959092821, 0.959945484, 0.960800545,
+	0.961658004, 0.962517862, 0.963380117, 0.964244068, 0.965109714, 0.965977056,
+	0.966846093, 0.967716825, 0.968588513, 0.969461158, 0.97033476, 0.971209319,
+	0.972084834, 0.972960571, 0.973836532, 0.974712715, 0.97558912, 0.976465749,
+	0.977341775, 0.9782172, 0.979092023, 0.979966244, 0.980839863, 0.981712038,
+	0.982582768, 0.983452053, 0.984319895, 0.985186291, 0.986050277, 0.986911853,
+	0.987771018, 0.988627772, 0.989482115, 0.990333148, 0.99118087, 0.992025282,
+	0.992866384, 0.993704175, 0.994537852, 0.995367414, 0.996192863, 0.997014197,
+	0.997831418, 0.998643362, 0.99945003, 1.00025142, 1.00104754, 1.00183838,
+	1.00262306, 1.00340158, 1.00417395, 1.00494015, 1.0057002, 1.00645304,
+	1.00719867, 1.00793709, 1.00866831, 1.00939231, 1.01010808, 1.01081561,
+	1.01151491, 1.01220596, 1.01288878, 1.01356233, 1.0142266, 1.0148816,
+	1.01552732, 1.01616376, 1.01678988, 1.01740567, 1.01801112, 1.01860625,
+	1.01919105, 1.01976447, 1.02032652, 1.02087719, 1.02141649, 1.02194442,
+	1.02245991, 1.02296297, 1.0234536, 1.0239318, 1.02439757, 1.02484985,
+	1.02528866, 1.02571398, 1.02612581, 1.02652417, 1.02690799, 1.02727728,
+	1.02763205, 1.02797228, 1.02829798, 1.02860812, 1.02890269, 1.0291817,
+	1.02944515, 1.02969303, 1.02992432, 1.03013903, 1.03033715, 1.03051868,
+	1.03068363, 1.030831, 1.03096079, 1.03107301, 1.03116764, 1.03124471,
+	1.03130322, 1.03134317, 1.03136458, 1.03136744, 1.03135174, 1.03131656,
+	1.03126189, 1.03118774, 1.03109411, 1.03098099, 1.03084748, 1.03069357,
+	1.03051927, 1.03032458, 1.03010949, 1.02987314, 1.02961554, 1.02933667,
+	1.02903655, 1.02871517, 1.02837169, 1.02800611, 1.02761844, 1.02720867,
+	1.02677681, 1.02632207, 1.02584445, 1.02534396, 1.02482059, 1.02427435,
+	1.02370448, 1.02311098, 1.02249385, 1.0218531, 1.02118872, 1.02050005,
+	1.01978708, 1.01904982, 1.01828826, 1.01750242, 1.01669164, 1.01585594,
+	1.01499531, 1.01410975, 1.01319926, 1.01226329, 1.01130186, 1.01031495,
+	1.00930256, 1.0082647, 1.00720087, 1.00611107, 1.00499529, 1.00385354,
+	1.00268582, 1.00149166, 1.00027107, 0.999024047, 0.997750592, 0.996450703,
+	0.995124022, 0.993770548, 0.992390282, 0.990983223, 0.989549371, 0.988088435,
+	0.986600413, 0.985085305, 0.983543113, 0.981973835, 0.980377258, 0.978753381,
+	0.977102204, 0.975423728, 0.973717952, 0.971984757, 0.970224143, 0.96843611,
+	0.966620658, 0.964777786, 0.962907357, 0.961009369, 0.959083823, 0.957130718,
+	0.955150055, 0.953141901, 0.951106254, 0.949043117, 0.946952487, 0.944834367,
+	0.942688837, 0.940515899, 0.938315551, 0.936087795, 0.933832629, 0.931550187,
+	0.929240467, 0.926903471, 0.924539197, 0.922147645, 0.919729114, 0.917283603,
+	0.914811112, 0.91231164, 0.909785189, 0.90723206, 0.904652254, 0.902045771,
+	0.899412611, 0.896752774, 0.894066699, 0.891354385, 0.888615833, 0.885851042,
+	0.883060013, 0.880243219, 0.877400662, 0.87453234, 0.871638254, 0.868718404,
+	0.865773372, 0.862803159, 0.859807764, 0.856787188, 0.85374143, 0.850671131,
+	0.84757629, 0.844456907, 0.841312983, 0.838144518, 0.83495225, 0.83173618,
+	0.828496307, 0.825232632, 0.821945155, 0.81863467, 0.815301176, 0.811944674,
+	0.808565164, 0.805162646, 0.801738012, 0.79829126, 0.794822391, 0.791331406,
+	0.787818304, 0.784284024, 0.780728567, 0.777151931, 0.773554118, 0.769935128,
+	0.766295988, 0.762636699, 0.758957262, 0.755257675, 0.751537939, 0.747799129,
+	0.744041245, 0.740264287, 0.736468255, 0.732653149, 0.72882012, 0.72496917,
+	0.721100297, 0.717213501, 0.713308783, 0.70938734, 0.705449171, 0.701494277,
+	0.697522657, 0.693534312, 0.689530509, 0.685511247, 0.681476528, 0.677426351,
+	0.673360715, 0.669280925, 0.66518698, 0.661078881, 0.656956626, 0.652820217,
+	0.648671024, 0.644509048, 0.640334287, 0.636146743, 0.631946416, 0.627734699,
+	0.623511592, 0.619277096, 0.615031211, 0.610773936, 0.606506713, 0.60222954,
+	0.597942418, 0.593645348, 0.589338328, 0.585022836, 0.58069887, 0.576366431,
+	0.57202552, 0.567676135, 0.563319753, 0.558956376, 0.554586002, 0.550208632,
+	0.545824266, 0.541434468, 0.537039238, 0.532638576, 0.528232482, 0.523820956,
+	0.519405528, 0.514986198, 0.510562966, 0.506135832, 0.501704796, 0.497271402,
+	0.492835652, 0.488397546, 0.483957082, 0.479514261, 0.475070672, 0.470626313,
+	0.466181186, 0.461735289, 0.457288623, 0.452842726, 0.448397598, 0.44395324,
+	0.43950965, 0.43506683, 0.430626366, 0.426188259, 0.421752509, 0.417319116,
+	0.41288808, 0.408460946, 0.404037713, 0.399618383, 0.395202956, 0.39079143,
+	0.386385336, 0.381984674, 0.377589444, 0.373199646, 0.368815279, 0.364437909,
+	0.360067536, 0.355704158, 0.351347777, 0.346998392, 0.34265748, 0.338325042,
+	0.334001076, 0.329685583, 0.325378564, 0.321081493, 0.316794372, 0.312517199,
+	0.308249975, 0.303992701, 0.299746815, 0.295512319, 0.291289213, 0.287077496,
+	0.282877168, 0.278689624, 0.274514864, 0.270352887, 0.266203695, 0.262067285,
+	0.257945031, 0.253836931, 0.249742986, 0.245663196, 0.241597561, 0.237547383,
+	0.233512664, 0.229493403, 0.225489599, 0.221501254, 0.217529634, 0.21357474,
+	0.209636571, 0.205715128, 0.20181041, 0.197923615, 0.194054742, 0.190203791,
+	0.186370763, 0.182555657, 0.178759625, 0.174982667, 0.171224783, 0.167485973,
+	0.163766237, 0.16006665, 0.156387212, 0.152727923, 0.149088784, 0.145469793,
+	0.14187198, 0.138295345, 0.134739888, 0.131205608, 0.127692506, 0.12420152,
+	0.120732652, 0.1172859, 0.113861265, 0.110458747, 0.107079237, 0.103722735,
+	0.100389242, 0.0970787564, 0.0937912792, 0.0905276043, 0.0872877317, 0.0840716615,
+	0.0808793937, 0.0777109282, 0.0745670043, 0.0714476219, 0.068352781, 0.0652824817,
+	0.0622367239, 0.0592161476, 0.0562207528, 0.0532505396, 0.0503055078, 0.0473856576,
+	0.0444915716, 0.0416232498, 0.0387806923, 0.0359638989, 0.0331728697, 0.030408079,
+	0.0276695267, 0.0249572128, 0.0222711373, 0.0196113002, 0.0169781403, 0.0143716574,
+	0.0117918517, 0.00923872303, 0.00671227149, 0.00421280002, 0.00174030864, -0.000705202658,
+	-0.00312373388, -0.00551528501, -0.00787955897, -0.0102165558, -0.0125262754, -0.0148087178,
+	-0.0170638831, -0.0192916395, -0.0214919869, -0.0236649255, -0.0258104551, -0.0279285759,
+	-0.0300192051, -0.0320823428, -0.0341179889, -0.0361261435, -0.0381068066, -0.0400599113,
+	-0.0419854576, -0.0438834454, -0.0457538749, -0.0475967459, -0.049412198, -0.051200231,
+	-0.052960845, -0.05469404, -0.0563998159, -0.0580782923, -0.059729469, -0.061353346,
+	-0.0629499234, -0.0645192012, -0.0660613937, -0.0675765009, -0.0690645229, -0.0705254597,
+	-0.0719593112, -0.0733663701, -0.0747466365, -0.0761001103, -0.0774267916, -0.0787266803,
+	-0.0800001359, -0.0812471583, -0.0824677477, -0.0836619039, -0.084829627, -0.0859713773,
+	-0.0870871547, -0.0881769593, -0.0892407911, -0.09027865, -0.0912910349, -0.0922779457,
+	-0.0932393826, -0.0941753454, -0.0950858342, -0.0959713946, -0.0968320268, -0.0976677306,
+	-0.0984785062, -0.0992643534, -0.100025907, -0.100763167, -0.101476134, -0.102164806,
+	-0.102829186, -0.103469938, -0.104087064, -0.104680563, -0.105250436, -0.105796681,
+	-0.106320051, -0.106820543, -0.107298159, -0.107752898, -0.108184761, -0.108594528,
+	-0.108982199, -0.109347774, -0.109691254, -0.110012637, -0.110312761, -0.110591626,
+	-0.110849231, -0.111085578, -0.111300665, -0.111495358, -0.111669658, -0.111823564,
+	-0.111957076, -0.112070195, -0.112163829, -0.112237979, -0.112292645, -0.112327826,
+	-0.112343523, -0.112340669, -0.112319262, -0.112279304, -0.112220795, -0.112143733,
+	-0.112049095, -0.111936879, -0.111807086, -0.111659716, -0.11149477, -0.111313236,
+	-0.111115115, -0.110900408, -0.110669115, -0.110421234, -0.110157789, -0.10987878,
+	-0.109584207, -0.109274069, -0.108948368, -0.108608136, -0.108253373, -0.107884079,
+	-0.107500255, -0.107101901, -0.106690064, -0.106264744, -0.105825941, -0.105373655,
+	-0.104907887, -0.104429687, -0.103939057, -0.103435996, -0.102920504, -0.102392581,
+	-0.101853283, -0.10130261, -0.100740562, -0.100167139, -0.0995823402, -0.0989872123,
+	-0.0983817547, -0.0977659677, -0.097139851, -0.0965034048, -0.0958576838, -0.095202688,
+	-0.0945384175, -0.0938648721, -0.093182052, -0.0924909948, -0.0917917006, -0.0910841693,
+	-0.0903684009, -0.0896443954, -0.0889131815, -0.0881747593, -0.0874291286, -0.0866762896,
+	-0.0859162422, -0.0851500362, -0.0843776717, -0.0835991486, -0.0828144671, -0.082023627,
+	-0.0812275108, -0.0804261187, -0.0796194504, -0.0788075061, -0.0779902858, -0.0771689513,
+	-0.0763435027, -0.07551394, -0.0746802631, -0.0738424721, -0.0730013706, -0.0721569587,
+	-0.0713092363, -0.0704582034, -0.06960386, -0.068747106, -0.0678879413, -0.0670263659,
+	-0.0661623798, -0.065295983, -0.0644281418, -0.0635588561, -0.0626881259, -0.0618159513,
+	-0.0609423322, -0.0600681113, -0.0591932885, -0.0583178638, -0.0574418372, -0.0565652088,
+	-0.055688803, -0.05481262, -0.0539366596, -0.0530609219, -0.052185407, -0.0513108486,
+	-0.0504372468, -0.0495646016, -0.048692913, -0.0478221809, -0.0469531442, -0.0460858027,
+	-0.0452201566, -0.0443562058, -0.0434939502, -0.0426340928, -0.0417766335, -0.0409215724,
+	-0.0400689093, -0.0392186444, -0.0383714506, -0.037527328, -0.0366862765, -0.0358482961,
+	-0.0350133869, -0.0341821574, -0.0333546075, -0.0325307374, -0.0317105469, -0.0308940361,
+	-0.0300817886, -0.0292738044, -0.0284700834, -0.0276706257, -0.0268754313, -0.0260849926,
+	-0.0252993095, -0.024518382, -0.0237422103, -0.0229707942, -0.0222046221, -0.0214436942,
+	-0.0206880104, -0.0199375706, -0.0191923749, -0.0184528173, -0.0177188978, -0.0169906163,
+	-0.0162679728, -0.0155509674, -0.0148400025, -0.014135078, -0.0134361939, -0.0127433502,
+	-0.012056547, -0.0113760913, -0.0107019831, -0.0100342223, -0.00937280899, -0.00871774316,
+	-0.00806934579, -0.00742761686, -0.00679255639, -0.00616416437, -0.00554244081, -0.00492759744,
+	-0.00431963427, -0.0037185513, -0.00312434853, -0.00253702596, -0.00195682192, -0.0013837364,
+	-0.000817769417, -0.000258920957, 0.000292808975, 0.000837312599, 0.00137458991, 0.00190464092,
+	0.00242746562, 0.00294306401, 0.00345128062, 0.00395211544, 0.00444556848, 0.00493163975,
+	0.00541032922, 0.00588162728, 0.00634553391, 0.00680204912, 0.00725117291, 0.00769290527,
+	0.00812716363, 0.008553948, 0.00897325836, 0.00938509473, 0.0097894571, 0.0101864252,
+	0.0105759989, 0.0109581783, 0.0113329635, 0.0117003543, 0.0120603181, 0.0124128551,
+	0.0127579651, 0.0130956482, 0.0134259044, 0.0137489234, 0.0140647052, 0.0143732499,
+	0.0146745573, 0.0149686276, 0.015255435, 0.0155349797, 0.0158072616, 0.0160722807,
+	0.016330037, 0.0165808871, 0.0168248308, 0.0170618682, 0.0172919992, 0.017515224,
+	0.0177313664, 0.0179404264, 0.0181424039, 0.018337299, 0.0185251117, 0.0187064748,
+	0.0188813882, 0.019049852, 0.019211866, 0.0193674305, 0.0195167227, 0.0196597429,
+	0.019796491, 0.0199269669, 0.0200511707, 0.0201687556, 0.0202797218, 0.0203840693,
+	0.0204817979, 0.0205729077, 0.0206582496, 0.0207378235, 0.0208116295, 0.0208796675,
+	0.0209419376, 0.0209985994, 0.0210496529, 0.0210950981, 0.021134935, 0.0211691636,
+	0.0211982237, 0.0212221155, 0.0212408388, 0.0212543936, 0.0212627801, 0.021266126,
+	0.0212644313, 0.0212576962, 0.0212459205, 0.0212291042, 0.0212076239, 0.0211814794,
+	0.0211506708, 0.0211151981, 0.0210750613, 0.0210304846, 0.020981468, 0.0209280116,
+	0.0208701152, 0.020807779, 0.0207414273, 0.0206710601, 0.0205966774, 0.0205182792,
+	0.0204358654, 0.0203497159, 0.0202598305, 0.0201662093, 0.0200688522, 0.0199677593,
+	0.0198633732, 0.0197556941, 0.0196447217, 0.0195304563, 0.0194128977, 0.0192923338,
+	0.0191687644, 0.0190421897, 0.0189126096, 0.0187800241, 0.0186448505, 0.0185070888,
+	0.0183667389, 0.0182238009, 0.0180782748, 0.0179304354, 0.0177802827, 0.0176278167,
+	0.0174730373, 0.0173159446, 0.0171569221, 0.0169959696, 0.0168330873, 0.016668275,
+	0.0165015329, 0.0163331216, 0.0161630412, 0.0159912917, 0.015817873, 0.0156427852,
+	0.0154663899, 0.015288687, 0.0151096764, 0.0149293583, 0.0147477327, 0.0145650478,
+	0.0143813037, 0.0141965005, 0.014010638, 0.0138237164, 0.0136360809, 0.0134477315,
+	0.0132586683, 0.0130688912, 0.0128784002, 0.0126874307, 0.0124959827, 0.0123040561,
+	0.012111651, 0.0119187673, 0.0117257262, 0.0115325276, 0.0113391714, 0.0111456578,
+	0.0109519867, 0.0107583769, 0.0105648284, 0.0103713413, 0.0101779156, 0.00998455116,
+	0.00979153657, 0.00959887181, 0.00940655689, 0.0092145918, 0.00902297654, 0.0088319049,
+	0.00864137687, 0.00845139247, 0.00826195168, 0.00807305451, 0.00788495811, 0.00769766248,
+	0.00751116761, 0.00732547351, 0.00714058018, 0.00695663639, 0.00677364212, 0.00659159739,
+	0.00641050219, 0.00623035652, 0.00605138579, 0.00587359, 0.00569696914, 0.00552152322,
+	0.00534725225, 0.00517426226, 0.00500255327, 0.00483212527, 0.00466297826, 0.00449511225,
+	0.00432870923, 0.00416376922, 0.00400029222, 0.00383827821, 0.0036777272, 0.00351871701,
+	0.00336124764, 0.00320531908, 0.00305093133, 0.00289808441, 0.00251656781, 0.00190638154,
+	0.00106752561,
+};
+
+static const float filter_22050_0[1001] = {
+	1.03159016, 1.0318248, 1.03187172, 1.03191465, 1.03195358, 1.03198851,
+	1.03201943, 1.03204636, 1.03207472, 1.03210451, 1.03213573, 1.03216838,
+	1.03220246, 1.03223813, 1.03227539, 1.03231424, 1.03235467, 1.03239669,
+	1.03244044, 1.03248591, 1.03253311, 1.03258204, 1.03263269, 1.03268519,
+	1.03273953, 1.03279571, 1.03285375, 1.03291362, 1.03297543, 1.03303917,
+	1.03310484, 1.03317245, 1.03324198, 1.03331351, 1.03338702, 1.03346252,
+	1.03354001, 1.03361948, 1.03370096, 1.03378444, 1.03386991, 1.03395739,
+	1.03404687, 1.03413831, 1.03423172, 1.0343271, 1.03442445, 1.03452376,
+	1.03462496, 1.03472802, 1.03483297, 1.03493979, 1.03504849, 1.03515892,
+	1.03527107, 1.03538495, 1.03550056, 1.0356179, 1.03573675, 1.0358571,
+	1.03597897, 1.03610234, 1.03622723, 1.03635334, 1.03648067, 1.03660923,
+	1.03673901, 1.03687002, 1.03700189, 1.03713463, 1.03726824, 1.03740272,
+	1.03753806, 1.03767384, 1.03781007, 1.03794674, 1.03808385, 1.03822141,
+	1.0383589, 1.03849634, 1.03863371, 1.03877103, 1.03890829, 1.03904492,
+	1.03918092, 1.03931629, 1.03945104, 1.03958515, 1.039718, 1.03984958,
+	1.0399799, 1.04010894, 1.04023672, 1.04036253, 1.04048639, 1.04060829,
+	1.04072822, 1.0408462, 1.04096147, 1.04107404, 1.0411839, 1.04129107,
+	1.04139552, 1.0414965, 1.04159399, 1.041688, 1.04177853, 1.04186558,
+	1.04194832, 1.04202677, 1.04210091, 1.04217074, 1.04223628, 1.04229669,
+	1.04235196, 1.04240211, 1.04244713, 1.04248702, 1.04252095, 1.04254893,
+	1.04257095, 1.04258703, 1.04259715, 1.04260052, 1.04259715, 1.04258704,
+	1.04257018, 1.04254658, 1.04251545, 1.04247679, 1.04243061, 1.0423769,
+	1.04231566, 1.0422462, 1.04216852, 1.04208262, 1.04198849, 1.04188614,
+	1.04177495, 1.04165491, 1.04152602, 1.04138829, 1.04124172, 1.04108577,
+	1.04092044, 1.04074573, 1.04056164, 1.04036818, 1.04016494, 1.03995194,
+	1.03972916, 1.03949661, 1.03925429, 1.03900194, 1.03873954, 1.03846711,
+	1.03818464, 1.03789213, 1.03758949, 1.03727672, 1.03695382, 1.03662078,
+	1.03627761, 1.03592439, 1.03556111, 1.03518777, 1.03480437, 1.03441092,
+	1.03400768, 1.03359466, 1.03317186, 1.03273928, 1.03229692, 1.03184524,
+	1.03138427, 1.03091399, 1.0304344, 1.02994551, 1.02944801, 1.0289419,
+	1.02842718, 1.02790385, 1.02737192, 1.02683229, 1.02628497, 1.02572995,
+	1.02516725, 1.02459685, 1.0240199, 1.0234364, 1.02284634, 1.02224974,
+	1.02164658, 1.02103823, 1.02042469, 1.01980597, 1.01918205, 1.01855293,
+	1.01792021, 1.01728388, 1.01664393, 1.01600037, 1.01535319, 1.01470418,
+	1.01405335, 1.01340067, 1.01274617, 1.01208983, 1.01143363, 1.01077756,
+	1.01012163, 1.00946583, 1.00881016, 1.00815676, 1.00750562, 1.00685675,
+	1.00621013, 1.00556578, 1.00492596, 1.00429067, 1.00365991, 1.00303368,
+	1.00241198, 1.00179719, 1.00118929, 1.00058831, 0.999994222, 0.999407042,
+	0.99882921, 0.998260725, 0.997701589, 0.997151801, 0.996611361, 0.99608274,
+	0.995565937, 0.995060954, 0.994567789, 0.994086443, 0.993619373, 0.99316658,
+	0.992728063, 0.992303822, 0.991893858, 0.991500567, 0.991123949, 0.990764005,
+	0.990420735, 0.990094138, 0.9897865, 0.989497823, 0.989228105, 0.988977348,
+	0.98874555, 0.988534832, 0.988345195, 0.988176638, 0.988029162, 0.987902765,
+	0.987799361, 0.987718948, 0.987661526, 0.987627096, 0.987615658, 0.987628856,
+	0.987666689, 0.987729159, 0.987816265, 0.987928007, 0.988065707, 0.988229366,
+	0.988418984, 0.98863456, 0.988876095, 0.989144552, 0.989439932, 0.989762234,
+	0.990111459, 0.990487606, 0.990891221, 0.991322303, 0.991780854, 0.992266872,
+	0.992780358, 0.993321408, 0.993890023, 0.994486201, 0.995109944, 0.995761251,
+	0.996439725, 0.997145367, 0.997878175, 0.99863815, 0.999425293, 1.00023868,
+	1.00107832, 1.00194421, 1.00283634, 1.00375473, 1.00469789, 1.00566584,
+	1.00665857, 1.00767608, 1.00871838, 1.00978343, 1.01087123, 1.01198178,
+	1.01311509, 1.01427116, 1.01544737, 1.01664374, 1.01786026, 1.01909694,
+	1.02035377, 1.02162757, 1.02291836, 1.02422613, 1.02555087, 1.02689259,
+	1.02824756, 1.02961577, 1.03099722, 1.03239191, 1.03379984, 1.03521673,
+	1.03664258, 1.0380774, 1.03952117, 1.0409739, 1.04243079, 1.04389184,
+	1.04535706, 1.04682644, 1.04829997, 1.0497724, 1.0512437, 1.05271389,
+	1.05418297, 1.05565093, 1.05711206, 1.05856636, 1.06001384, 1.06145449,
+	1.06288831, 1.06430923, 1.06571722, 1.06711231, 1.06849448, 1.06986374,
+	1.07121369, 1.07254433, 1.07385566, 1.07514767, 1.07642038, 1.07766714,
+	1.07888794, 1.0800828, 1.08125172, 1.08239468, 1.08350489, 1.08458236,
+	1.08562708, 1.08663905, 1.08761827, 1.08855787, 1.08945785, 1.09031821,
+	1.09113894, 1.09192005, 1.09265468, 1.09334282, 1.09398448, 1.09457966,
+	1.09512835, 1.09562381, 1.09606602, 1.096455, 1.09679074, 1.09707324,
+	1.09729594, 1.09745885, 1.09756197, 1.0976053, 1.09758883, 1.0975063,
+	1.09735773, 1.09714311, 1.09686243, 1.09651571, 1.09609706, 1.0956065,
+	1.09504402, 1.09440963, 1.09370331, 1.0929197, 1.09205878, 1.09112056,
+	1.09010503, 1.08901221, 1.08783727, 1.08658021, 1.08524104, 1.08381976,
+	1.08231637, 1.0807267, 1.07905075, 1.07728853, 1.07544004, 1.07350527,
+	1.07148081, 1.06936664, 1.06716277, 1.06486919, 1.06248592, 1.06001031,
+	1.05744237, 1.0547821, 1.0520295, 1.04918456, 1.04624552, 1.04321237,
+	1.04008511, 1.03686375, 1.03354828, 1.03013783, 1.02663241, 1.02303201,
+	1.01933663, 1.01554627, 1.01166101, 1.00768084, 1.00360577, 0.999435786,
+	0.995170897, 0.990812138, 0.986359508, 0.981813009, 0.977172638, 0.972438397,
+	0.967612297, 0.962694338, 0.95768452, 0.952582842, 0.947389305, 0.942106895,
+	0.936735612, 0.931275455, 0.925726426, 0.920088523, 0.914365692, 0.908557932,
+	0.902665244, 0.896687628, 0.890625084, 0.884482486, 0.878259834, 0.871957129,
+	0.865574371, 0.859111559, 0.852574457, 0.845963064, 0.839277382, 0.832517409,
+	0.825683146, 0.818781188, 0.811811536, 0.804774189, 0.797669148, 0.790496412,
+	0.783263345, 0.775969946, 0.768616217, 0.761202156, 0.753727764, 0.746201093,
+	0.738622143, 0.730990915, 0.723307408, 0.715571622, 0.70779221, 0.69996917,
+	0.692102504, 0.68419221, 0.67623829, 0.668249901, 0.660227042, 0.652169715,
+	0.644077918, 0.635951652, 0.627800473, 0.619624383, 0.61142338, 0.603197465,
+	0.594946637, 0.586680746, 0.578399791, 0.570103771, 0.561792687, 0.553466539,
+	0.54513535, 0.536799121, 0.52845785, 0.520111538, 0.511760185, 0.503413873,
+	0.495072602, 0.486736373, 0.478405184, 0.470079036, 0.461767952, 0.453471932,
+	0.445190977, 0.436925086, 0.428674258, 0.420448343, 0.41224734, 0.40407125,
+	0.395920071, 0.387793805, 0.379702008, 0.371644681, 0.363621822, 0.355633433,
+	0.347679513, 0.339769219, 0.331902553, 0.324079513, 0.316300101, 0.308564315,
+	0.300880808, 0.29324958, 0.28567063, 0.278143959, 0.270669567, 0.263255506,
+	0.255901777, 0.248608378, 0.241375311, 0.234202575, 0.227097534, 0.220060187,
+	0.213090535, 0.206188577, 0.199354314, 0.192594341, 0.185908659, 0.179297266,
+	0.172760164, 0.166297352, 0.159914594, 0.153611889, 0.147389237, 0.141246639,
+	0.135184095, 0.129206479, 0.123313791, 0.117506031, 0.1117832, 0.106145297,
+	0.100596268, 0.095136111, 0.0897648278, 0.0844824178, 0.079288881, 0.0741872034,
+	0.0691773849, 0.0642594257, 0.0594333257, 0.0546990849, 0.0500587145, 0.0455122145,
+	0.041059585, 0.0367008258, 0.0324359372, 0.0282659553, 0.0241908802, 0.0202107119,
+	0.0163254504, 0.0125350956, 0.00883971769, 0.00523931649, 0.00173389207, -0.0016765556,
+	-0.0049920265, -0.00821339018, -0.0113406466, -0.0143737959, -0.0173128379, -0.0201577727,
+	-0.0229103756, -0.0255706467, -0.0281385858, -0.0306141931, -0.0329974685, -0.035291042,
+	-0.0374949137, -0.0396090836, -0.0416335517, -0.0435683178, -0.04541681, -0.0471790282,
+	-0.0488549724, -0.0504446425, -0.0519480387, -0.0533693209, -0.0547084892, -0.0559655436,
+	-0.0571404841, -0.0582333106, -0.0592488346, -0.060187056, -0.0610479747, -0.0618315909,
+	-0.0625379045, -0.0631723006, -0.0637347792, -0.0642253404, -0.064643984, -0.0649907102,
+	-0.0652713852, -0.0654860089, -0.0656345816, -0.065717103, -0.0657335732, -0.0656902496,
+	-0.065587132, -0.0654242205, -0.0652015152, -0.0649190159, -0.0645832777, -0.0641943006,
+	-0.0637520846, -0.0632566297, -0.0627079359, -0.0621127588, -0.0614710983, -0.0607829545,
+	-0.0600483273, -0.0592672168, -0.0584464837, -0.0575861281, -0.0566861499, -0.0557465491,
+	-0.0547673258, -0.0537553547, -0.0527106359, -0.0516331692, -0.0505229548, -0.0493799927,
+	-0.0482110817, -0.047016222, -0.0457954135, -0.0445486561, -0.04327595, -0.0419839332,
+	-0.0406726058, -0.0393419677, -0.037992019, -0.0366227596, -0.0352405872, -0.0338455018,
+	-0.0324375034, -0.031016592, -0.0295827676, -0.0281421164, -0.0266946384, -0.0252403337,
+	-0.0237792023, -0.022311244, -0.0208421699, -0.0193719798, -0.0179006737, -0.0164282517,
+	-0.0149547137, -0.0134853371, -0.0120201218, -0.0105590678, -0.00910217508, -0.00764944372,
+	-0.00620567216, -0.00477086041, -0.00334500846, -0.0019281163, -0.000520183954, 0.000874506702,
+	0.00225595566, 0.00362416293, 0.0049791285, 0.00632085237, 0.00764559714, 0.00895336279,
+	0.0102441493, 0.0115179568, 0.0127747851, 0.0140114603, 0.0152279825, 0.0164243515,
+	0.0176005675, 0.0187566304, 0.0198899398, 0.0210004955, 0.0220882977, 0.0231533463,
+	0.0241956413, 0.0252131538, 0.0262058839, 0.0271738316, 0.0281169968, 0.0290353795,
+	0.0299275142, 0.0307934008, 0.0316330395, 0.0324464301, 0.0332335726, 0.0339935481,
+	0.0347263565, 0.0354319977, 0.0361104719, 0.0367617789, 0.0373855217, 0.0379817004,
+	0.0385503148, 0.039091365, 0.039604851, 0.0400908693, 0.0405494197, 0.0409805024,
+	0.0413841173, 0.0417602644, 0.0421094891, 0.0424317913, 0.042727171, 0.0429956283,
+	0.043237163, 0.0434527392, 0.0436423568, 0.0438060158, 0.0439437162, 0.0440554581,
+	0.0441425639, 0.0442050336, 0.0442428674, 0.0442560651, 0.0442446268, 0.0442101969,
+	0.0441527754, 0.0440723623, 0.0439689576, 0.0438425613, 0.0436950847, 0.0435265278,
+	0.0433368906, 0.0431261731, 0.0428943753, 0.0426436177, 0.0423739001, 0.0420852227,
+	0.0417775854, 0.0414509883, 0.0411077177, 0.0407477736, 0.0403711561, 0.0399778652,
+	0.0395679009, 0.0391436602, 0.0387051431, 0.0382523498, 0.0377852801, 0.0373039341,
+	0.0368107692, 0.0363057856, 0.0357889831, 0.0352603619, 0.0347199218, 0.0341701337,
+	0.0336109975, 0.0330425132, 0.0324646809, 0.0318775005, 0.0312834163, 0.0306824282,
+	0.0300745363, 0.0294597405, 0.0288380409, 0.028211811, 0.0275810509, 0.0269457606,
+	0.02630594, 0.0256615892, 0.0250149757, 0.0243660994, 0.0237149605, 0.0230615589,
+	0.0224058945, 0.0217500956, 0.0210941621, 0.020438094, 0.0197818913, 0.019125554,
+	0.0184710494, 0.0178183775, 0.0171675383, 0.0165185317, 0.0158713579, 0.0152277966,
+	0.0145878479, 0.0139515117, 0.0133187882, 0.0126896772, 0.0120657572, 0.011447028,
+	0.0108334898, 0.0102251425, 0.0096219862, 0.0090253813, 0.00843532787, 0.00785182588,
+	0.00727487536, 0.00670447628, 0.00614176994, 0.00558675633, 0.00503943545, 0.0044998073,
+	0.00396787188, 0.00344454501, 0.00292982669, 0.00242371691, 0.00192621568, 0.001437323,
+	0.000957735829, 0.000487454169, 2.64780185e-05, -0.000425192622, -0.000867557751, -0.00130014046,
+	-0.00172294074, -0.00213595861, -0.00253919405, -0.00293264707, -0.00331604318, -0.00368938239,
+	-0.0040526647, -0.0044058901, -0.00474905859, -0.00508209482, -0.0054049988, -0.00571777051,
+	-0.00602040996, -0.00631291715, -0.00659538677, -0.00686781882, -0.00713021331, -0.00738257022,
+	-0.00762488957, -0.00785743778, -0.00808021485, -0.0082932208, -0.0084964556, -0.00868991928,
+	-0.00887400518, -0.00904871333, -0.00921404371, -0.00936999632, -0.00951657117, -0.00965430075,
+	-0.00978318508, -0.00990322415, -0.010014418, -0.0101167665, -0.0102108929, -0.0102967972,
+	-0.0103744794, -0.0104439395, -0.0105051775, -0.0105588882, -0.0106050715, -0.0106437275,
+	-0.0106748563, -0.0106984577, -0.0107153151, -0.0107254284, -0.0107287976, -0.0107254229,
+	-0.010715304, -0.0106992316, -0.0106772054, -0.0106492257, -0.0106152923, -0.0105754052,
+	-0.0105303882, -0.0104802414, -0.0104249646, -0.0103645579, -0.0102990213, -0.0102291828,
+	-0.0101550424, -0.0100766002, -0.00999385613, -0.00990681018, -0.00981628169, -0.00972227064,
+	-0.00962477703, -0.00952380088, -0.00941934218, -0.00931218011, -0.00920231469, -0.00908974591,
+	-0.00897447378, -0.00885649828, -0.00873656262, -0.00861466679, -0.0084908108, -0.00836499464,
+	-0.00823721831, -0.00810817383, -0.0079778612, -0.00784628043, -0.0077134315, -0.00757931442,
+	-0.00744456914, -0.00730919567, -0.00717319401, -0.00703656416, -0.00689930611, -0.00676198898,
+	-0.00662461276, -0.00648717746, -0.00634968308, -0.00621212962, -0.00607501826, -0.005938349,
+	-0.00580212185, -0.00566633679, -0.00553099384, -0.00539651801, -0.00526290931, -0.00513016775,
+	-0.0049982933, -0.00486728599, -0.00473750345, -0.00460894569, -0.0044816127, -0.00435550449,
+	-0.00423062105, -0.00410724679, -0.00398538172, -0.00386502583, -0.00374617912, -0.0036288416,
+	-0.00351323176, -0.0033993496, -0.00328719511, -0.00317676831, -0.00306806918, -0.00296124696,
+	-0.00285630166, -0.00275323328, -0.00265204181, -0.00255272725, -0.00245538022, -0.00236000073,
+	-0.00226658877, -0.00217514433, -0.00208566743, -0.00199819071, -0.00191271415, -0.00182923777,
+	-0.00174776157, -0.00166828554, -0.00159079746, -0.00151529735, -0.00144178519, -0.001370261,
+	-0.00130072476, -0.00123312048, -0.00116744813, -0.00110370774, -0.00104189929, -0.000982022782,
+	-0.000923991148, -0.000867804383, -0.000813462487, -0.000760965461, -0.000710313304, -0.000661387351,
+	-0.000614187602, -0.000568714058, -0.000524966717, -0.000482945581, -0.000442512368, -0.000403667078,
+	-0.000366409713, -0.00033074027, -0.000296658751, -0.000264007934, -0.00023278782, -0.000202998408,
+	-0.000174639698, -0.00014771169, -0.000116783716, -8.18557768e-05, -4.29278713e-05,
+};
+
+static const float filter_44100_0[601] = {
+	0.980043363, 0.979855473, 0.979817895, 0.979780181, 0.979742331, 0.979704344,
+	0.979666222, 0.979627963, 0.979586552, 0.979541989, 0.979494274, 0.979443407,
+	0.979389388, 0.979332085, 0.979271501, 0.979207633, 0.979140483, 0.97907005,
+	0.978996573, 0.978920053, 0.97884049, 0.978757882, 0.978672232, 0.978584247,
+	0.978493928, 0.978401275, 0.978306288, 0.978208966, 0.97811056, 0.978011069,
+	0.977910493, 0.977808832, 0.977706086, 0.977604078, 0.977502807, 0.977402273,
+	0.977302476, 0.977203416, 0.977107465, 0.977014621, 0.976924886, 0.976838259,
+	0.97675474, 0.976677169, 0.976605544, 0.976539866, 0.976480135, 0.976426351,
+	0.976381665, 0.976346076, 0.976319584, 0.97630219, 0.976293893, 0.976297931,
+	0.976314304, 0.976343013, 0.976384056, 0.976437434, 0.976506185, 0.97659031,
+	0.976689807, 0.976804677, 0.976934921, 0.977083053, 0.977249074, 0.977432984,
+	0.977634783, 0.977854471, 0.978093696, 0.978352458, 0.978630757, 0.978928594,
+	0.979245968, 0.979583319, 0.979940649, 0.980317956, 0.98071524, 0.981132503,
+	0.98156867, 0.982023743, 0.982497722, 0.982990605, 0.983502394, 0.984030292,
+	0.9845743, 0.985134416, 0.985710642, 0.986302977, 0.986906803, 0.987522121,
+	0.988148931, 0.988787232, 0.989437024, 0.990091904, 0.990751872, 0.991416927,
+	0.992087069, 0.992762298, 0.99343462, 0.994104033, 0.994770537, 0.995434133,
+	0.996094821, 0.996743412, 0.997379909, 0.998004309, 0.998616614, 0.999216823,
+	0.999795095, 1.00035143, 1.00088583, 1.00139829, 1.00188881, 1.00234759,
+	1.00277462, 1.0031699, 1.00353343, 1.00386522, 1.00415631, 1.00440672,
+	1.00461643, 1.00478545, 1.00491377, 1.00499416, 1.00502662, 1.00501113,
+	1.0049477, 1.00483634, 1.00467238, 1.00445582, 1.00418666, 1.00386491,
+	1.00349055, 1.00306228, 1.00258011, 1.00204401, 1.00145401, 1.0008101,
+	1.00011493, 0.999368518, 0.998570857, 0.997721948, 0.99682179, 0.995877406,
+	0.994888796, 0.99385596, 0.992778898, 0.99165761, 0.990503577, 0.9893168,
+	0.988097278, 0.986845011, 0.985559999, 0.984257928, 0.982938796, 0.981602605,
+	0.980249355, 0.978879044, 0.977510945, 0.976145056, 0.974781379, 0.973419913,
+	0.972060658, 0.970725474, 0.969414361, 0.968127319, 0.966864348, 0.965625449,
+	0.964433743, 0.963289231, 0.962191913, 0.961141789, 0.960138859, 0.959205893,
+	0.958342892, 0.957549855, 0.956826782, 0.956173674, 0.955611142, 0.955139186,
+	0.954757806, 0.954467003, 0.954266775, 0.954173688, 0.95418774, 0.954308933,
+	0.954537265, 0.954872737, 0.95532603, 0.955897144, 0.956586079, 0.957392835,
+	0.958317412, 0.959362954, 0.96052946, 0.96181693, 0.963225366, 0.964754765,
+	0.96639941, 0.968159301, 0.970034436, 0.972024818, 0.974130444, 0.976335858,
+	0.97864106, 0.981046049, 0.983550826, 0.986155391, 0.988834228, 0.991587338,
+	0.994414719, 0.997316373, 1.0002923, 1.00330723, 1.00636116, 1.00945409,
+	1.01258603, 1.01575697, 1.01892286, 1.02208372, 1.02523952, 1.02839029,
+	1.031536, 1.03462547, 1.03765868, 1.04063564, 1.04355634, 1.04642079,
+	1.04917283, 1.05181247, 1.05433969, 1.05675451, 1.05905693, 1.06118855,
+	1.06314938, 1.06493942, 1.06655867, 1.06800712, 1.06922724, 1.070219,
+	1.07098242, 1.07151749, 1.07182422, 1.07184911, 1.07159218, 1.07105342,
+	1.07023282, 1.0691304, 1.06769995, 1.06594148, 1.06385499, 1.06144048,
+	1.05869794, 1.05559148, 1.0521211, 1.04828679, 1.04408856, 1.03952641,
+	1.03457731, 1.02924125, 1.02351824, 1.01740828, 1.01091136, 1.0040193,
+	0.996732114, 0.989049787, 0.980972324, 0.972499724, 0.963639879, 0.954392789,
+	0.944758454, 0.934736874, 0.924328049, 0.913556329, 0.902421714, 0.890924204,
+	0.879063799, 0.866840499, 0.854294587, 0.841426063, 0.828234927, 0.814721179,
+	0.80088482, 0.786780654, 0.772408681, 0.757768902, 0.742861316, 0.727685923,
+	0.712309805, 0.696732961, 0.680955392, 0.664977097, 0.648798076, 0.632494731,
+	0.616067061, 0.599515068, 0.58283875, 0.566038108, 0.549195364, 0.532310519,
+	0.515383572, 0.498414523, 0.481403372, 0.464434324, 0.447507376, 0.430622531,
+	0.413779787, 0.396979145, 0.380302827, 0.363750834, 0.347323164, 0.331019819,
+	0.314840798, 0.298862503, 0.283084934, 0.26750809, 0.252131972, 0.236956579,
+	0.222048994, 0.207409214, 0.193037242, 0.178933075, 0.165096716, 0.151582968,
+	0.138391832, 0.125523308, 0.112977396, 0.100754096, 0.0888936907, 0.0773961807,
+	0.0662615657, 0.0554898458, 0.045081021, 0.0350594412, 0.0254251063, 0.0161780163,
+	0.00731817136, -0.00115442869, -0.00923189217, -0.0169142191, -0.0242014095, -0.0310934633,
+	-0.0375903806, -0.0437003446, -0.0494233553, -0.0547594127, -0.0597085168, -0.0642706676,
+	-0.0684688957, -0.072303201, -0.0757735837, -0.0788800435, -0.0816225807, -0.0840370952,
+	-0.086123587, -0.0878820561, -0.0893125025, -0.0904149263, -0.0912355202, -0.0917742842,
+	-0.0920312184, -0.0920063227, -0.091699597, -0.0911645249, -0.0904011064, -0.0894093413,
+	-0.0881892298, -0.0867407717, -0.0851215228, -0.0833314828, -0.081370652, -0.0792390301,
+	-0.0769366174, -0.0745217973, -0.07199457, -0.0693549354, -0.0666028936, -0.0637384445,
+	-0.0608177415, -0.0578407846, -0.0548075737, -0.051718109, -0.0485723903, -0.0454216276,
+	-0.0422658207, -0.0391049698, -0.0359390748, -0.0327681357, -0.0296361991, -0.026543265,
+	-0.0234893336, -0.0204744046, -0.0174984782, -0.0145968242, -0.0117694424, -0.009016333,
+	-0.00633749592, -0.00373293116, -0.00122815408, 0.00117683534, 0.00348203709, 0.00568745117,
+	0.00779307758, 0.00978345865, 0.0116585944, 0.0134184848, 0.0150631298, 0.0165925295,
+	0.0180009647, 0.0192884354, 0.0204549416, 0.0215004832, 0.0224250604, 0.0232318165,
+	0.0239207516, 0.0244918656, 0.0249451585, 0.0252806304, 0.0255089625, 0.0256301547,
+	0.0256442071, 0.0255511197, 0.0253508925, 0.0250600891, 0.0246787094, 0.0242067534,
+	0.0236442213, 0.0229911129, 0.0222680401, 0.0214750031, 0.0206120017, 0.019679036,
+	0.018676106, 0.017625982, 0.0165286641, 0.0153841523, 0.0141924466, 0.0129535469,
+	0.0116905761, 0.0104035343, 0.00909242133, 0.00775723731, 0.00639798221, 0.00503651603,
+	0.00367283877, 0.00230695042, 0.000938850993, -0.000431459518, -0.00178471025, -0.00312090122,
+	-0.00444003241, -0.00574210383, -0.00702711547, -0.0082793824, -0.00949890461, -0.0106856821,
+	-0.0118397149, -0.012961003, -0.014038065, -0.015070901, -0.016059511, -0.0170038949,
+	-0.0179040528, -0.0187529623, -0.0195506233, -0.0202970359, -0.0209922, -0.0216361157,
+	-0.0222261192, -0.0227622105, -0.0232443895, -0.0236726564, -0.0240470111, -0.0243687674,
+	-0.0246379254, -0.0248544851, -0.0250184464, -0.0251298094, -0.0251932342, -0.0252087208,
+	-0.0251762693, -0.0250958796, -0.0249675517, -0.0247985323, -0.0245888213, -0.0243384188,
+	-0.0240473247, -0.023715539, -0.0233520056, -0.0229567244, -0.0225296955, -0.0220709189,
+	-0.0215803945, -0.0210679331, -0.0205335349, -0.0199771997, -0.0193989276, -0.0187987186,
+	-0.0181864138, -0.0175620134, -0.0169255172, -0.0162769254, -0.0156162378, -0.0149526418,
+	-0.0142861374, -0.0136167246, -0.0129444033, -0.0122691736, -0.0115990314, -0.0109339766,
+	-0.0102740092, -0.00961912923, -0.00896933671, -0.00833103571, -0.00770422622, -0.00708890824,
+	-0.00648508178, -0.00589274683, -0.00531652108, -0.00475640452, -0.00421239716, -0.003684499,
+	-0.00317271004, -0.0026798264, -0.00220584809, -0.0017507751, -0.00131460743, -0.000897345088,
+	-0.000500060442, -0.000122753491, 0.000234575765, 0.000571927325, 0.00088930119, 0.00118713784,
+	0.00146543727, 0.00172419949, 0.0019634245, 0.00218311229, 0.00238491118, 0.00256882119,
+	0.0027348423, 0.00288297452, 0.00301321784, 0.00312808816, 0.00322758546, 0.00331170975,
+	0.00338046103, 0.0034338393, 0.00347488254, 0.00350359074, 0.00351996391, 0.00352400204,
+	0.00351570514, 0.00349831086, 0.00347181918, 0.00343623012, 0.00339154367, 0.00333775983,
+	0.00327802902, 0.00321235123, 0.00314072646, 0.00306315471, 0.00297963598, 0.00289300906,
+	0.00280327394, 0.00271043063, 0.00261447912, 0.00251541941, 0.00241562253, 0.00231508847,
+	0.00221381724, 0.00211180883, 0.00200906325, 0.00190740248, 0.00180682651, 0.00170733535,
+	0.00160892899, 0.00151160744, 0.00141662009, 0.00132396694, 0.00123364799, 0.00114566324,
+	0.00106001269, 0.000977405637, 0.00089784208, 0.000821322021, 0.000747845459, 0.000677412394,
+	0.000610262071, 0.000546394488, 0.000485809647, 0.000428507546, 0.000374488186, 0.000323620962,
+	0.000275905873, 0.00023134292, 0.000189932102, 0.000151673419, 0.000113550868, 7.55644474e-05,
+	3.77141582e-05,
+};
+
+static const float filter_48000_0[601] = {
+	1.01986202, 1.02001034, 1.02004, 1.02006681, 1.02009075, 1.02011182,
+	1.02013004, 1.02014539, 1.02016029, 1.02017472, 1.0201887, 1.02020222,
+	1.02021528, 1.02022655, 1.02023604, 1.02024374, 1.02024965, 1.02025378,
+	1.02025436, 1.02025139, 1.02024489, 1.02023483, 1.02022123, 1.02020198,
+	1.02017707, 1.0201465, 1.02011027, 1.02006839, 1.02001854, 1.01996073,
+	1.01989495, 1.0198212, 1.01973949, 1.01964754, 1.01954534, 1.01943291,
+	1.01931023, 1.01917731, 1.01903221, 1.01887492, 1.01870546, 1.01852381,
+	1.01832997, 1.01812269, 1.01790196, 1.01766777, 1.01742013, 1.01715905,
+	1.01688426, 1.01659576, 1.01629357, 1.01597768, 1.01564808, 1.01530585,
+	1.014951, 1.01458351, 1.0142034, 1.01381065, 1.01340789, 1.01299513,
+	1.01257235, 1.01213957, 1.01169678, 1.01124823, 1.01079393, 1.01033388,
+	1.00986807, 1.00939651, 1.00892502, 1.0084536, 1.00798224, 1.00751094,
+	1.00703971, 1.00657565, 1.00611874, 1.00566899, 1.00522641, 1.00479099,
+	1.00437062, 1.0039653, 1.00357503, 1.00319981, 1.00283964, 1.00250254,
+	1.0021885, 1.00189752, 1.0016296, 1.00138475, 1.00117027, 1.00098618,
+	1.00083246, 1.00070912, 1.00061616, 1.0005593, 1.00053854, 1.00055389,
+	1.00060534, 1.0006929, 1.0008198, 1.00098604, 1.00119162, 1.00143655,
+	1.00172081, 1.00204439, 1.00240728, 1.00280947, 1.00325098, 1.00373179,
+	1.00424806, 1.00479977, 1.00538693, 1.00600955, 1.00666761, 1.0073532,
+	1.0080663, 1.00880692, 1.00957505, 1.01037071, 1.01118202, 1.01200899,
+	1.01285161, 1.01370988, 1.01458382, 1.01545819, 1.016333, 1.01720825,
+	1.01808394, 1.01896006, 1.01981912, 1.02066112, 1.02148606, 1.02229393,
+	1.02308473, 1.02384009, 1.02455999, 1.02524444, 1.02589345, 1.026507,
+	1.0270676, 1.02757525, 1.02802994, 1.02843168, 1.02878048, 1.02906163,
+	1.02927513, 1.029421, 1.02949922, 1.02950981, 1.02944277, 1.02929811,
+	1.02907583, 1.02877593, 1.0283984, 1.02793971, 1.02739986, 1.02677885,
+	1.02607667, 1.02529333, 1.024433, 1.02349569, 1.02248139, 1.0213901,
+	1.02022183, 1.01898917, 1.01769213, 1.01633071, 1.0149049, 1.0134147,
+	1.01188108, 1.01030403, 1.00868355, 1.00701964, 1.0053123, 1.00358993,
+	1.00185255, 1.00010014, 0.998332702, 0.996550243, 0.994786827, 0.993042451,
+	0.991317117, 0.989610825, 0.987923574, 0.986292505, 0.98471762, 0.983198918,
+	0.981736399, 0.980330062, 0.979016874, 0.977796834, 0.976669942, 0.975636199,
+	0.974695603, 0.973881273, 0.973193209, 0.972631409, 0.972195875, 0.971886607,
+	0.971729055, 0.971723219, 0.971869099, 0.972166696, 0.972616009, 0.97323122,
+	0.974012329, 0.974959336, 0.97607224, 0.977351043, 0.978795594, 0.980405893,
+	0.982181941, 0.984123737, 0.986231281, 0.988487933, 0.990893691, 0.993448556,
+	0.996152527, 0.999005606, 1.00197365, 1.00505665, 1.00825461, 1.01156753,
+	1.01499541, 1.01848698, 1.02204222, 1.02566115, 1.02934377, 1.03309006,
+	1.03683345, 1.04057392, 1.04431149, 1.04804614, 1.05177789, 1.05542808,
+	1.0589967, 1.06248376, 1.06588926, 1.0692132, 1.07236938, 1.07535781,
+	1.07817847, 1.08083138, 1.08331653, 1.08554571, 1.0875189, 1.08923612,
+	1.09069736, 1.09190262, 1.09276778, 1.09329283, 1.09347777, 1.0933226,
+	1.09282732, 1.09191817, 1.09059514, 1.08885824, 1.08670746, 1.0841428,
+	1.08110679, 1.07759943, 1.07362071, 1.06917064, 1.06424921, 1.05882034,
+	1.05288402, 1.04644025, 1.03948904, 1.03203039, 1.02405339, 1.01555805,
+	1.00654437, 0.997012345, 0.98696198, 0.976409774, 0.965355729, 0.953799844,
+	0.941742119, 0.929182554, 0.916165363, 0.902690548, 0.888758107, 0.874368041,
+	0.85952035, 0.844285353, 0.828663052, 0.812653446, 0.796256534, 0.779472317,
+	0.762393718, 0.745020735, 0.72735337, 0.709391621, 0.69113549, 0.672695362,
+	0.654071237, 0.635263116, 0.616270998, 0.597094884, 0.57785618, 0.558554887,
+	0.539191005, 0.519764533, 0.500275472, 0.480849, 0.461485117, 0.442183824,
+	0.42294512, 0.403769006, 0.384776888, 0.365968767, 0.347344642, 0.328904514,
+	0.310648383, 0.292686634, 0.275019269, 0.257646286, 0.240567687, 0.22378347,
+	0.207386559, 0.191376952, 0.175754651, 0.160519654, 0.145671963, 0.131281897,
+	0.117349456, 0.103874641, 0.0908574505, 0.0782978853, 0.0662401602, 0.054684275,
+	0.0436302299, 0.0330780247, 0.0230276595, 0.0134956362, 0.00448195478, -0.00401338482,
+	-0.0119903826, -0.0194490385, -0.0264002486, -0.0328440131, -0.0387803319, -0.044209205,
+	-0.0491306324, -0.0535807054, -0.0575594241, -0.0610667885, -0.0641027985, -0.0666674542,
+	-0.0688182339, -0.0705551376, -0.0718781653, -0.072787317, -0.0732825927, -0.0734377608,
+	-0.0732528213, -0.0727277742, -0.0718626195, -0.0706573573, -0.0691961172, -0.0674788993,
+	-0.0655057037, -0.0632765303, -0.0607913792, -0.0581384704, -0.055317804, -0.05232938,
+	-0.0491731985, -0.0458492593, -0.0424437585, -0.0389566961, -0.0353880721, -0.0317378864,
+	-0.0280061392, -0.0242714825, -0.0205339163, -0.0167934408, -0.0130500558, -0.00930376144,
+	-0.00562114937, -0.00200221961, 0.00155302784, 0.00504459298, 0.0084724758, 0.0117853978,
+	0.0149833589, 0.0180663591, 0.0210343985, 0.023887477, 0.0265914487, 0.0291463135,
+	0.0315520716, 0.0338087228, 0.0359162672, 0.0378580632, 0.0396341109, 0.0412444103,
+	0.0426889613, 0.0439677639, 0.0450806687, 0.0460276755, 0.0468087844, 0.0474239954,
+	0.0478733085, 0.0481709052, 0.0483167856, 0.0483109497, 0.0481533974, 0.0478441288,
+	0.0474085949, 0.0468467956, 0.046158731, 0.045344401, 0.0444038056, 0.043370062,
+	0.0422431702, 0.0410231303, 0.0397099421, 0.0383036057, 0.0368410864, 0.0353223841,
+	0.0337474989, 0.0321164307, 0.0304291796, 0.028722887, 0.026997553, 0.0252531776,
+	0.0234897608, 0.0217073025, 0.0199398681, 0.0181874574, 0.0164500705, 0.0147277075,
+	0.0130203682, 0.0113564579, 0.00973597661, 0.00815892428, 0.00662530092, 0.00513510654,
+	0.0037092965, 0.00234787079, 0.00105082942, -0.000181827611, -0.00135010031, -0.00244138662,
+	-0.00345568654, -0.00439300008, -0.00525332723, -0.00603666799, -0.00673884537, -0.00735985934,
+	-0.00789970993, -0.00835839712, -0.00873592092, -0.00903582343, -0.00925810466, -0.0094027646,
+	-0.00946980326, -0.00945922063, -0.0093809962, -0.00923512997, -0.00902162194, -0.00874047211,
+	-0.00839168048, -0.00798993678, -0.00753524103, -0.00702759321, -0.00646699333, -0.00585344139,
+	-0.00520443878, -0.00451998548, -0.00380008152, -0.00304472688, -0.00225392156, -0.00144605198,
+	-0.000621118135, 0.000220879969, 0.00107994234, 0.00195606896, 0.00283175681, 0.00370700586,
+	0.00458181614, 0.00545618762, 0.00633012032, 0.00718839743, 0.00803101896, 0.0088579849,
+	0.00966929526, 0.01046495, 0.0112330869, 0.0119737058, 0.0126868068, 0.0133723899,
+	0.0140304551, 0.0146530699, 0.0152402345, 0.0157919487, 0.0163082125, 0.0167890261,
+	0.0172305305, 0.0176327259, 0.0179956123, 0.0183191895, 0.0186034577, 0.0188483832,
+	0.0190539662, 0.0192202065, 0.0193471043, 0.0194346595, 0.0194861114, 0.0195014602,
+	0.0194807058, 0.0194238481, 0.0193308873, 0.0192075476, 0.0190538291, 0.0188697318,
+	0.0186552556, 0.0184104005, 0.0181424834, 0.0178515042, 0.017537463, 0.0172003597,
+	0.0168401943, 0.0164649775, 0.0160747091, 0.0156693892, 0.0152490177, 0.0148135947,
+	0.0143710106, 0.0139212652, 0.0134643586, 0.0130002909, 0.0125290619, 0.0120577673,
+	0.011586407, 0.0111149811, 0.0106434896, 0.0101719325, 0.00970612782, 0.00924607571,
+	0.00879177613, 0.00834322907, 0.00790043453, 0.00746764977, 0.0070448748, 0.0066321096,
+	0.00622935419, 0.00583660856, 0.00545649277, 0.00508900683, 0.00473415073, 0.00439192448,
+	0.00406232808, 0.00374643333, 0.00344424026, 0.00315574884, 0.00288095909, 0.002619871,
+	0.00237223401, 0.00213804813, 0.00191731335, 0.00171002967, 0.0015161971, 0.00133454717,
+	0.00116507988, 0.00100779523, 0.000862693225, 0.00072977386, 0.000607096025, 0.00049465972,
+	0.000392464944, 0.000300511697, 0.00021879998, 0.000145054226, 7.92744357e-05, 2.14606091e-05,
+	-2.83872539e-05, -7.02691533e-05, -0.000106494307, -0.000137062714, -0.000161974376, -0.000181229291,
+	-0.000194827461, -0.000204880846, -0.000211389445, -0.00021435326, -0.000213772289, -0.000209646534,
+	-0.000203733972, -0.000196034603, -0.000186548427, -0.000175275444, -0.000162215655, -0.000148697118,
+	-0.000134719836, -0.000120283806, -0.00010538903, -9.00355068e-05, -7.18198423e-05, -5.07420363e-05,
+	-2.68020889e-05,
+};
+
+const POKEYFILT_Table POKEYFILT_builtin[] = {
+	{11025, 1786050, 0, 1201, 0.0029320987654320985, filter_11025_0},
+	{22050, 1786050, 0, 1001, 0.005864197530864197, filter_22050_0},
+	{44100, 1808100, 0, 601, 0.011585365853658536, filter_44100_0},
+	{48000, 1776000, 0, 601, 0.012837837837837839, filter_48000_0},
+	{0, 0, 0, 0, 0.0, NULL}
+};
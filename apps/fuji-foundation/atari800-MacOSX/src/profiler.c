@@ -0,0 +1,301 @@
+/*
+ * profiler.c - 6502 guest code profiler
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "antic.h"
+#include "log.h"
+#include "profiler.h"
+#include "util.h"
+
+/* Call tree nodes; a path deeper or wider than this is charged to the
+   deepest node that could still be created. */
+#define MAX_NODES 0x10000
+#define HASH_SIZE (2 * MAX_NODES)
+/* The 6502 stack holds at most 128 return addresses. */
+#define MAX_DEPTH 256
+/* Clock differences above one frame mean the clock was rebased (coldstart)
+   or profiling was paused; they are not charged. */
+#define MAX_GAP (ANTIC_LINE_C * 312)
+
+int PROFILER_enabled = FALSE;
+
+typedef struct node_t {
+	UWORD addr;			/* entry address of the routine */
+	int parent;
+	unsigned long long cycles;	/* cycles spent in this path, excluding callees */
+} node_t;
+
+typedef struct frame_t {
+	int node;
+	UBYTE s;			/* stack pointer on entry */
+} frame_t;
+
+static unsigned long long pc_cycles[0x10000];
+static unsigned long pc_count[0x10000];
+
+/* Node 0 is the root: code running below the first recorded call. */
+static node_t *nodes = NULL;
+static int nodes_used;
+/* Maps (parent, addr) to a node index; 0 marks an empty slot. */
+static int *node_hash = NULL;
+
+static frame_t stack[MAX_DEPTH];
+static int depth;
+
+static unsigned long long total_insns;
+static unsigned long long total_cycles;
+
+static int have_last;
+static unsigned int last_clock;
+static UWORD last_pc;
+static int last_node;
+static int call_pending;	/* the last instruction was JSR or BRK */
+static int entry_pending;	/* an interrupt was taken after it */
+
+static unsigned int hash_node(int parent, UWORD addr)
+{
+	return ((unsigned int) parent * 0x9e3779b1u ^ addr * 0x85ebca6bu) & (HASH_SIZE - 1);
+}
+
+static int child_node(int parent, UWORD addr)
+{
+	unsigned int h = hash_node(parent, addr);
+	int n;
+	while ((n = node_hash[h]) != 0) {
+		if (nodes[n].parent == parent && nodes[n].addr == addr)
+			return n;
+		h = (h + 1) & (HASH_SIZE - 1);
+	}
+	if (nodes_used >= MAX_NODES)
+		return parent;
+	n = nodes_used++;
+	nodes[n].addr = addr;
+	nodes[n].parent = parent;
+	nodes[n].cycles = 0;
+	node_hash[h] = n;
+	return n;
+}
+
+static int top_node(void)
+{
+	return depth > 0 ? stack[depth - 1].node : 0;
+}
+
+/* Pops the frames whose return address is no longer on the 6502 stack. */
+static void unwind(UBYTE s)
+{
+	while (depth > 0 && s > stack[depth - 1].s)
+		depth--;
+}
+
+static void push(UWORD addr, UBYTE s)
+{
+	if (depth >= MAX_DEPTH)
+		return;
+	stack[depth].node = child_node(top_node(), addr);
+	stack[depth].s = s;
+	depth++;
+}
+
+/* Returns the cycles since the previous call, or 0 after a gap. */
+static unsigned int elapsed(void)
+{
+	unsigned int now = ANTIC_CPU_CLOCK;
+	unsigned int delta = now - last_clock;
+	last_clock = now;
+	if (!have_last || delta > MAX_GAP)
+		return 0;
+	return delta;
+}
+
+static void charge(UWORD pc, int node, unsigned int cycles)
+{
+	pc_cycles[pc] += cycles;
+	nodes[node].cycles += cycles;
+	total_cycles += cycles;
+}
+
+void PROFILER_Step(UWORD pc, UBYTE s, UBYTE insn)
+{
+	unsigned int cycles = elapsed();
+	unwind(s);
+	if (entry_pending) {
+		/* The 7 cycles of interrupt entry belong to the handler. */
+		push(pc, s);
+		charge(pc, top_node(), cycles);
+		entry_pending = FALSE;
+	}
+	else {
+		if (have_last)
+			charge(last_pc, last_node, cycles);
+		if (call_pending)
+			push(pc, s);
+	}
+	pc_count[pc]++;
+	total_insns++;
+	have_last = TRUE;
+	last_pc = pc;
+	last_node = top_node();
+	call_pending = insn == 0x20 || insn == 0x00;
+}
+
+void PROFILER_Interrupt(UWORD pc, UBYTE s)
+{
+	unsigned int cycles = elapsed();
+	if (have_last)
+		charge(last_pc, last_node, cycles);
+	unwind(s);
+	/* Taken before the first instruction of a subroutine: record the call
+	   so that the handler nests below it. */
+	if (call_pending)
+		push(pc, s);
+	call_pending = FALSE;
+	entry_pending = TRUE;
+}
+
+void PROFILER_Reset(void)
+{
+	memset(pc_cycles, 0, sizeof(pc_cycles));
+	memset(pc_count, 0, sizeof(pc_count));
+	if (node_hash != NULL)
+		memset(node_hash, 0, HASH_SIZE * sizeof(int));
+	if (nodes != NULL) {
+		nodes[0].addr = 0;
+		nodes[0].parent = 0;
+		nodes[0].cycles = 0;
+	}
+	nodes_used = 1;
+	depth = 0;
+	total_insns = 0;
+	total_cycles = 0;
+	have_last = FALSE;
+	call_pending = FALSE;
+	entry_pending = FALSE;
+}
+
+void PROFILER_Start(void)
+{
+	if (nodes == NULL) {
+		nodes = (node_t *) Util_malloc(MAX_NODES * sizeof(node_t));
+		node_hash = (int *) Util_malloc(HASH_SIZE * sizeof(int));
+		PROFILER_Reset();
+	}
+	/* The call stack may have changed while stopped. */
+	depth = 0;
+	have_last = FALSE;
+	call_pending = FALSE;
+	entry_pending = FALSE;
+	PROFILER_enabled = TRUE;
+}
+
+void PROFILER_Stop(void)
+{
+	PROFILER_enabled = FALSE;
+}
+
+void PROFILER_GetTotals(unsigned long long *insns, unsigned long long *cycles)
+{
+	*insns = total_insns;
+	*cycles = total_cycles;
+}
+
+static int compare_hot(const void *a, const void *b)
+{
+	const PROFILER_Hot *x = (const PROFILER_Hot *) a;
+	const PROFILER_Hot *y = (const PROFILER_Hot *) b;
+	if (x->cycles != y->cycles)
+		return x->cycles < y->cycles ? 1 : -1;
+	return (int) x->addr - (int) y->addr;
+}
+
+int PROFILER_GetHot(PROFILER_Hot *hot, int max)
+{
+	PROFILER_Hot *all;
+	int n = 0;
+	int pc;
+
+	all = (PROFILER_Hot *) Util_malloc(0x10000 * sizeof(PROFILER_Hot));
+	for (pc = 0; pc < 0x10000; pc++) {
+		if (pc_count[pc] == 0)
+			continue;
+		all[n].addr = (UWORD) pc;
+		all[n].count = pc_count[pc];
+		all[n].cycles = pc_cycles[pc];
+		n++;
+	}
+	qsort(all, n, sizeof(PROFILER_Hot), compare_hot);
+	if (n > max)
+		n = max;
+	memcpy(hot, all, n * sizeof(PROFILER_Hot));
+	free(all);
+	return n;
+}
+
+/* Writes a frame name that can't break the folded format. */
+static void write_frame(FILE *fp, UWORD addr, PROFILER_LabelFunc label)
+{
+	const char *name = label != NULL ? label(addr) : NULL;
+	if (name == NULL) {
+		fprintf(fp, "$%04X", addr);
+		return;
+	}
+	for (; *name != '\0'; name++)
+		fputc(*name == ';' || *name == ' ' ? '_' : *name, fp);
+}
+
+int PROFILER_WriteFolded(const char *filename, PROFILER_LabelFunc label)
+{
+	FILE *fp;
+	int i;
+
+	fp = fopen(filename, "w");
+	if (fp == NULL) {
+		Log_print("Cannot write profile %s", filename);
+		return FALSE;
+	}
+	if (nodes != NULL && nodes[0].cycles != 0)
+		fprintf(fp, "[top] %llu\n", nodes[0].cycles);
+	for (i = 1; i < nodes_used; i++) {
+		int path[MAX_DEPTH];
+		int len = 0;
+		int n;
+		if (nodes[i].cycles == 0)
+			continue;
+		for (n = i; n != 0 && len < MAX_DEPTH; n = nodes[n].parent)
+			path[len++] = n;
+		while (len > 0) {
+			write_frame(fp, nodes[path[--len]].addr, label);
+			fputc(len > 0 ? ';' : ' ', fp);
+		}
+		fprintf(fp, "%llu\n", nodes[i].cycles);
+	}
+	if (fclose(fp) != 0) {
+		Log_print("Cannot write profile %s", filename);
+		return FALSE;
+	}
+	return TRUE;
+}
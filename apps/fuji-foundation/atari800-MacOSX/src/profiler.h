@@ -0,0 +1,59 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdio.h>
+
+#include "atari.h"
+
+/* 6502 guest code profiler.
+   While enabled, every executed instruction is counted and charged with the
+   machine cycles that pass until the next one starts, so cycles stolen by
+   ANTIC DMA and WSYNC halts are included. A shadow call stack is kept from
+   JSR, BRK and interrupt entries and unwound when the stack pointer rises
+   above a frame (RTS, RTI or discarding the return address), and cycles are
+   also accumulated per call path for flame graphs. */
+
+/* Non-zero while profiling; tested by the CPU core before calling
+   PROFILER_Step(). */
+extern int PROFILER_enabled;
+
+typedef struct PROFILER_Hot_t {
+	UWORD addr;
+	unsigned long count;		/* times the instruction was executed */
+	unsigned long long cycles;	/* machine cycles charged to it */
+} PROFILER_Hot;
+
+/* Returns a label for ADDR, or NULL when it has none. */
+typedef const char *(*PROFILER_LabelFunc)(UWORD addr);
+
+/* Starts or resumes profiling. Collected data is kept until PROFILER_Reset(). */
+void PROFILER_Start(void);
+
+/* Stops profiling. */
+void PROFILER_Stop(void);
+
+/* Clears all collected data. */
+void PROFILER_Reset(void);
+
+/* Called by the CPU core before executing instruction INSN at PC, with the
+   stack pointer S. */
+void PROFILER_Step(UWORD pc, UBYTE s, UBYTE insn);
+
+/* Called by the CPU core when it takes an NMI or IRQ at PC, with the stack
+   pointer S before the return address is pushed. */
+void PROFILER_Interrupt(UWORD pc, UBYTE s);
+
+/* Stores the number of profiled instructions and cycles. */
+void PROFILER_GetTotals(unsigned long long *insns, unsigned long long *cycles);
+
+/* Fills HOT with up to MAX executed addresses, most cycles first, and
+   returns how many were stored. */
+int PROFILER_GetHot(PROFILER_Hot *hot, int max);
+
+/* Writes one "frame;frame;... cycles" line per call path to FILENAME, the
+   folded-stack format read by flamegraph.pl and compatible tools. Frames are
+   named by LABEL where it returns a name, or by "$XXXX" entry addresses.
+   Returns FALSE if the file can't be written. */
+int PROFILER_WriteFolded(const char *filename, PROFILER_LabelFunc label);
+
+#endif /* PROFILER_H_ */
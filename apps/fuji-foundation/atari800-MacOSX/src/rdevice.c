@@ -170,6 +170,9 @@ extern void dc_set_baud(int baud);
 #endif /* R_NETWORK */
 #include <sys/types.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#define R_IO_THREAD
 #endif /* not WIN32 and not DREAMCAST */
 
 #if defined(R_SERIAL) && !defined(DREAMCAST)
@@ -178,6 +181,7 @@ extern void dc_set_baud(int baud);
 
 #include "atari.h"
 #include "rdevice.h"
+#include "antic.h"
 #include "cpu.h"
 #include "devices.h"
 #include "log.h"
@@ -211,14 +215,12 @@ static int retval;
 
 static char MESSAGE[256];
 static char command_buf[256];
-static char bufout[256];
 static int concurrent;
 
 static int command_end = 0;
 static int translation = 1;
 static int trans_cr = 0;
 static int linefeeds = 1;
-static int bufend = 0;
 
 #ifndef R_NETWORK
 int RDevice_serial_enabled = 1;
@@ -227,24 +229,585 @@ int RDevice_serial_enabled = 0;  /* Default to network, if enabled. Use paramete
 #endif
 char RDevice_serial_device[FILENAME_MAX];
 
+/*---------------------------------------------------------------------------
+   Buffered I/O
+
+   Bytes from the line, along with the local echo and the modem messages,
+   wait in rx_ring until the Atari reads them, and bytes the Atari writes
+   wait in tx_ring. io_pump() moves data between the rings and the line and
+   answers telnet negotiation. With R_IO_THREAD it runs on a thread that
+   sleeps in poll() until the line or the emulator has something for it;
+   otherwise it runs from the R: vectors. The thread shares only the rings
+   and hangup_pending; everything else belongs to the emulator thread.
+---------------------------------------------------------------------------*/
+#define RING_SIZE 0x4000  /* must be a power of two */
+
+typedef struct ring_t {
+  UBYTE data[RING_SIZE];
+  unsigned int head;  /* write count */
+  unsigned int tail;  /* read count */
+} ring_t;
+
+static ring_t rx_ring;
+static ring_t tx_ring;
+
+/* Set when the line drops; io_service() handles it on the emulator thread. */
+static volatile int hangup_pending = 0;
+/* TRUE while io_pump() serves the line. */
+static int io_active = 0;
+/* Descriptor of the line served by io_pump(). */
+static int io_fd = -1;
+
+#ifdef R_IO_THREAD
+static pthread_t io_thread_id;
+static pthread_mutex_t io_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int io_running = 0;
+static volatile int io_quit;
+static int wake_pipe[2] = {-1, -1};
+#define IO_LOCK()    pthread_mutex_lock(&io_mutex)
+#define IO_UNLOCK()  pthread_mutex_unlock(&io_mutex)
+#else
+#define io_running   0
+#define IO_LOCK()    ((void) 0)
+#define IO_UNLOCK()  ((void) 0)
+#endif /* R_IO_THREAD */
+
+/* Telnet negotiation state of the received data. */
+#define TELNET_DATA  0
+#define TELNET_IAC   1
+#define TELNET_OPT   2
+#define TELNET_SB    3
+#define TELNET_SB_IAC 4
+static int telnet_state = TELNET_DATA;
+static UBYTE telnet_cmd;
+
+/* Receive pacing: the Atari sees the received bytes no faster than a line
+   running at rx_baud would deliver them, in emulated time. 0 turns pacing
+   off until the program sets a rate with XIO 36. */
+static int rx_baud = 0;
+static int rx_frame_bits = 10;
+static double rx_credit;
+static double rx_last_line;
+/* Bytes at the start of rx_ring released to the Atari. */
+static int rx_released = 0;
+/* Drop a line feed that follows a carriage return. */
+static int rx_skip_lf = 0;
+/* Frame since which tx_ring has stayed full, or -1. */
+static int tx_stall_frame = -1;
+/* Frames the line may take no data before a write fails with a timeout. */
+#define TX_TIMEOUT_FRAMES 500
+
+/* Number of bytes in R. The caller holds the lock. */
+static unsigned int ring_count(const ring_t *r)
+{
+  return r->head - r->tail;
+}
+
+/* Appends up to LEN bytes of BUF to R, returns the number stored. The
+   caller holds the lock. */
+static int ring_put(ring_t *r, const UBYTE *buf, int len)
+{
+  int pos = r->head & (RING_SIZE - 1);
+  int first;
+  if (len > (int) (RING_SIZE - ring_count(r)))
+    len = RING_SIZE - ring_count(r);
+  first = RING_SIZE - pos;
+  if (first > len)
+    first = len;
+  memcpy(r->data + pos, buf, first);
+  memcpy(r->data, buf + first, len - first);
+  r->head += len;
+  return len;
+}
+
+/* Takes up to LEN bytes from R into BUF, returns the number taken. The
+   caller holds the lock. */
+static int ring_get(ring_t *r, UBYTE *buf, int len)
+{
+  int pos = r->tail & (RING_SIZE - 1);
+  int first;
+  if (len > (int) ring_count(r))
+    len = ring_count(r);
+  first = RING_SIZE - pos;
+  if (first > len)
+    first = len;
+  memcpy(buf, r->data + pos, first);
+  memcpy(buf + first, r->data, len - first);
+  r->tail += len;
+  return len;
+}
+
+/* Reads what the line has, up to LEN bytes. Returns 0 if nothing is
+   waiting and -1 if the line was dropped. */
+static int io_read(UBYTE *buf, int len)
+{
+#ifdef DREAMCAST
+  int n = 0;
+  while (n < len && dc_read_serial(buf + n) > 0)
+    n++;
+  return n;
+#else
+  int n = read(io_fd, (char *) buf, len);
+  if (n > 0)
+    return n;
+#ifdef WIN32
+  /* rdevice_win32_read() reports dropped connections. */
+  return 0;
+#else
+  if (n == 0)
+    /* end of file on a socket, no data on a non-blocking tty */
+    return RDevice_serial_enabled ? 0 : -1;
+  if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOTCONN)
+    return 0;
+  return -1;
+#endif /* WIN32 */
+#endif /* DREAMCAST */
+}
+
+/* Writes up to LEN bytes to the line. Returns the number written, or -1 if
+   the line was dropped. */
+static int io_write(const UBYTE *buf, int len)
+{
+#ifdef DREAMCAST
+  int n = 0;
+  while (n < len && dc_write_serial(buf[n]) == 1)
+    n++;
+  return n;
+#else
+  int n = write(io_fd, (char *) buf, len);
+  if (n >= 0)
+    return n;
+#ifdef WIN32
+  return 0;
+#else
+  if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOTCONN)
+    return 0;
+  return -1;
+#endif /* WIN32 */
+#endif /* DREAMCAST */
+}
+
+/* Queues received bytes for the Atari, answering telnet negotiation on a
+   network line. The caller holds the lock. */
+static void io_receive(const UBYTE *buf, int len)
+{
+  UBYTE reply[3];
+  int i;
+
+  if (RDevice_serial_enabled)
+  {
+    ring_put(&rx_ring, buf, len);
+    return;
+  }
+
+  for (i = 0; i < len; i++)
+  {
+    UBYTE c = buf[i];
+    switch (telnet_state)
+    {
+      case TELNET_DATA:
+        if (c == 0xff)
+          telnet_state = TELNET_IAC;
+        else
+          ring_put(&rx_ring, &c, 1);
+        break;
+      case TELNET_IAC:
+        if (c == 0xff)
+        { /* escaped 0xff */
+          ring_put(&rx_ring, &c, 1);
+          telnet_state = TELNET_DATA;
+        }
+        else if (c == 0xfa)
+        { /* subnegotiation */
+          telnet_state = TELNET_SB;
+        }
+        else if (c >= 0xfb)
+        { /* WILL, WONT, DO, DONT */
+          telnet_cmd = c;
+          telnet_state = TELNET_OPT;
+        }
+        else
+        { /* commands without an option */
+          telnet_state = TELNET_DATA;
+        }
+        break;
+      case TELNET_OPT:
+        reply[0] = 0xff;
+        reply[2] = c;
+        if (telnet_cmd == 0xfd)
+        { /*DO*/
+          if ((c == 0x01) || (c == 0x03))
+          { /* WILL ECHO and GO AHEAD (char mode) */
+            reply[1] = 0xfb; /* WILL */
+          }
+          else
+          {
+            reply[1] = 0xfc; /* WONT */
+          }
+        }
+        else if (telnet_cmd == 0xfb)
+        { /*WILL*/
+          reply[1] = 0xfe; /*DONT*/
+        }
+        else if (telnet_cmd == 0xfe)
+        { /*DONT*/
+          reply[1] = 0xfc;
+        }
+        else
+        { /*WONT*/
+          reply[1] = 0xfe;
+        }
+        ring_put(&tx_ring, reply, 3);
+        telnet_state = TELNET_DATA;
+        break;
+      case TELNET_SB:
+        if (c == 0xff)
+          telnet_state = TELNET_SB_IAC;
+        break;
+      case TELNET_SB_IAC:
+        /* wait for end of sub negotiation */
+        telnet_state = (c == 0xf0) ? TELNET_DATA : TELNET_SB;
+        break;
+    }
+  }
+}
+
+/* Moves data between the line and the rings. Returns FALSE if the line
+   was dropped. */
+static int io_pump(void)
+{
+  UBYTE buf[1024];
+  int space;
+  int n;
+
+  IO_LOCK();
+  space = RING_SIZE - ring_count(&rx_ring);
+  IO_UNLOCK();
+  if (space > (int) sizeof(buf))
+    space = sizeof(buf);
+  if (space > 0)
+  {
+    n = io_read(buf, space);
+    if (n < 0)
+      return FALSE;
+    if (n > 0)
+    {
+      IO_LOCK();
+      io_receive(buf, n);
+      IO_UNLOCK();
+    }
+  }
+
+  for (;;)
+  {
+    IO_LOCK();
+    n = ring_count(&tx_ring);
+    if (n > (int) sizeof(buf))
+      n = sizeof(buf);
+    /* Copy without taking, so bytes the line doesn't accept stay queued. */
+    ring_get(&tx_ring, buf, n);
+    tx_ring.tail -= n;
+    IO_UNLOCK();
+    if (n == 0)
+      break;
+    n = io_write(buf, n);
+    if (n < 0)
+      return FALSE;
+    IO_LOCK();
+    tx_ring.tail += n;
+    IO_UNLOCK();
+    if (n < (int) sizeof(buf))
+      break;
+  }
+  return TRUE;
+}
+
+#ifdef R_IO_THREAD
+/* Wakes the I/O thread, to have it look at the rings again. */
+static void io_kick(void)
+{
+  static const char c = 0;
+  if (io_running)
+    write(wake_pipe[1], &c, 1);
+}
+
+static void *io_thread(void *arg)
+{
+  struct pollfd fds[2];
+  int hup = FALSE;
+  char c;
+
+  while (!io_quit)
+  {
+    int rx_full;
+    int tx_waiting;
+
+    IO_LOCK();
+    rx_full = ring_count(&rx_ring) == RING_SIZE;
+    tx_waiting = ring_count(&tx_ring) > 0;
+    IO_UNLOCK();
+
+    /* After a hang-up, poll() keeps reporting it; wait for the Atari to
+       make room for the rest of the data before looking again. */
+    fds[0].fd = (hup && rx_full) ? -1 : io_fd;
+    fds[0].events = (rx_full ? 0 : POLLIN) | (tx_waiting ? POLLOUT : 0);
+    fds[0].revents = 0;
+    fds[1].fd = wake_pipe[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      hangup_pending = TRUE;
+      break;
+    }
+    if (fds[1].revents & POLLIN)
+      while (read(wake_pipe[0], &c, 1) > 0) {};
+    if (fds[0].revents & (POLLERR | POLLNVAL))
+    {
+      hangup_pending = TRUE;
+      break;
+    }
+    if (fds[0].revents & POLLHUP)
+    {
+      /* A serial port has lost carrier; a socket may still hold data. */
+      if (RDevice_serial_enabled)
+      {
+        hangup_pending = TRUE;
+        break;
+      }
+      hup = TRUE;
+    }
+    if (!io_pump())
+    {
+      hangup_pending = TRUE;
+      break;
+    }
+  }
+  return NULL;
+}
+#else
+#define io_kick() ((void) 0)
+#endif /* R_IO_THREAD */
+
+/* Starts serving the line FD. Bytes left unsent to another line are
+   dropped; the modem's messages already received stay. */
+static void io_start(int fd)
+{
+  IO_LOCK();
+  tx_ring.tail = tx_ring.head;
+  IO_UNLOCK();
+  telnet_state = TELNET_DATA;
+  hangup_pending = FALSE;
+  io_fd = fd;
+  io_active = TRUE;
+#ifdef R_IO_THREAD
+  if (wake_pipe[0] < 0)
+  {
+    if (pipe(wake_pipe) < 0)
+      return;
+    fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+  }
+  io_quit = FALSE;
+  /* Without the thread, the R: vectors pump the line. */
+  io_running = pthread_create(&io_thread_id, NULL, io_thread, NULL) == 0;
+#endif /* R_IO_THREAD */
+}
+
+/* Stops serving the line. Unsent bytes are dropped. */
+static void io_stop(void)
+{
+#ifdef R_IO_THREAD
+  if (io_running)
+  {
+    io_quit = TRUE;
+    io_kick();
+    pthread_join(io_thread_id, NULL);
+    io_running = FALSE;
+  }
+#endif /* R_IO_THREAD */
+  io_active = FALSE;
+  io_fd = -1;
+}
+
+/* Pumps the line when there is no I/O thread, and handles a dropped line.
+   Called on entry to the R: vectors. */
+static void io_service(void)
+{
+  if (io_active && !io_running && !io_pump())
+    hangup_pending = TRUE;
+  if (hangup_pending)
+  {
+    DBG_APRINT("R*: Disconnected....");
+    io_stop();
+#ifndef DREAMCAST
+    close(rdev_fd);
+#endif
+    connected = 0;
+    do_once = 0;
+    hangup_pending = FALSE;
+    rx_released = 0;
+    IO_LOCK();
+    rx_ring.tail = rx_ring.head;
+    tx_ring.tail = tx_ring.head;
+    ring_put(&rx_ring, (const UBYTE *) "\r\nNO CARRIER\r\n", 14);
+    IO_UNLOCK();
+  }
+}
+
+/* Queues the modem's own output, such as the local echo, for the Atari. */
+static void rx_put(const char *buf, int len)
+{
+  IO_LOCK();
+  ring_put(&rx_ring, (const UBYTE *) buf, len);
+  IO_UNLOCK();
+}
+
+/* Queues the modem's own output, such as telnet negotiation, for the line. */
+static void tx_put(const char *buf, int len)
+{
+  IO_LOCK();
+  ring_put(&tx_ring, (const UBYTE *) buf, len);
+  IO_UNLOCK();
+  io_kick();
+}
+
+/* Drops the received data. */
+static void rx_clear(void)
+{
+  IO_LOCK();
+  rx_ring.tail = rx_ring.head;
+  IO_UNLOCK();
+  rx_released = 0;
+  io_kick();
+}
+
+/* Position of the emulation in scanlines. */
+static double rx_line_now(void)
+{
+  return (double) Atari800_nframes * Atari800_tv_mode + ANTIC_ypos;
+}
+
+/* Releases the received bytes a line running at rx_baud would have
+   delivered by now, and returns the number of bytes the Atari may read. */
+static int rx_available(void)
+{
+  int count;
+
+  IO_LOCK();
+  count = ring_count(&rx_ring);
+  IO_UNLOCK();
+  if (rx_baud == 0 || RDevice_serial_enabled)
+  {
+    /* A serial line is paced by the port itself. */
+    rx_released = count;
+  }
+  else
+  {
+    double now = rx_line_now();
+    double lines_per_sec = Atari800_tv_mode == Atari800_TV_PAL ?
+                           Atari800_TV_PAL * Atari800_FPS_PAL :
+                           Atari800_TV_NTSC * Atari800_FPS_NTSC;
+    if (now > rx_last_line)
+      rx_credit += (now - rx_last_line) * rx_baud / (rx_frame_bits * lines_per_sec);
+    rx_last_line = now;
+    while (rx_credit >= 1.0 && rx_released < count)
+    {
+      rx_released++;
+      rx_credit -= 1.0;
+    }
+    /* An idle line doesn't save up time for later bytes. */
+    if (rx_released == count && rx_credit > 1.0)
+      rx_credit = 1.0;
+  }
+  return rx_released;
+}
+
+/* Returns the next released byte for the Atari, translated, or -1. */
+static int rx_getc(void)
+{
+  UBYTE c;
+  int was_full;
+
+  for (;;)
+  {
+    if (rx_released == 0)
+      return -1;
+    IO_LOCK();
+    was_full = ring_count(&rx_ring) == RING_SIZE;
+    ring_get(&rx_ring, &c, 1);
+    IO_UNLOCK();
+    rx_released--;
+    if (was_full)
+      io_kick();
+    if (!translation)
+      return c;
+    if (rx_skip_lf)
+    {
+      rx_skip_lf = FALSE;
+      if (c == 0x0a)
+        continue;
+    }
+    if (c == 0x0d)
+    {
+      /* skip over the linefeed after a return */
+      rx_skip_lf = linefeeds;
+      return 0x9b;
+    }
+    return c;
+  }
+}
+
+/* Queues C for the line. Returns FALSE if tx_ring is full. */
+static int tx_putc(UBYTE c)
+{
+  int stored;
+  IO_LOCK();
+  stored = ring_put(&tx_ring, &c, 1);
+  IO_UNLOCK();
+  return stored;
+}
+
+/* Returns TRUE if tx_ring has room for one more byte from the Atari, which
+   translation may turn into a return and a line feed. Never waits on the
+   line: without the I/O thread it is pumped once. */
+static int tx_ready(void)
+{
+  int room;
+
+  IO_LOCK();
+  room = RING_SIZE - ring_count(&tx_ring);
+  IO_UNLOCK();
+  if (room < 2 && !io_running && io_active)
+  {
+    if (!io_pump())
+    {
+      hangup_pending = TRUE;
+      return FALSE;
+    }
+    IO_LOCK();
+    room = RING_SIZE - ring_count(&tx_ring);
+    IO_UNLOCK();
+  }
+  if (room < 2)
+  {
+    io_kick();
+    return FALSE;
+  }
+  tx_stall_frame = -1;
+  return TRUE;
+}
+
 /*---------------------------------------------------------------------------
    Host Support Function - If Disconnect signal is found, then close socket
-   and clean up.
+   and clean up. Only flags it; io_service() does the cleaning up.
 ---------------------------------------------------------------------------*/
 #ifdef R_NETWORK
 static void catch_disconnect(int sig)
 {
-  DBG_APRINT("R*: Disconnected....");
-  close(rdev_fd);
-  connected = 0;
-  do_once = 0;
-  bufout[0] = 0;
-  strcat(bufout, "\r\nNO CARRIER\r\n");
-  bufend = 13;
-#if 0
-  Poke(747,bufend);
-  Poke(748,0);
-#endif
+  hangup_pending = TRUE;
 }
 #endif /* R_NETWORK */
 
@@ -298,6 +861,7 @@ static void xio_34(void)
 
       if(connected != 0)
       {
+        io_stop();
         close ( rdev_fd );
         connected = 0;
         do_once = 0;
@@ -357,6 +921,11 @@ static void xio_34(void)
 ---------------------------------------------------------------------------*/
 static void xio_36(void)
 {
+  /* Same rates as set on a serial port below */
+  static const int baud_rates[16] = {
+    300, 57600, 50, 115200, 75, 110, 134, 150,
+    300, 600, 1200, 115200, 2400, 4800, 9600, 19200
+  };
   int aux1, aux2;
 #if defined(R_SERIAL) && !defined(DREAMCAST)
   struct termios options;
@@ -365,6 +934,12 @@ static void xio_36(void)
   aux1 = MEMORY_dGetByte(Devices_ICAX1Z);
   aux2 = MEMORY_dGetByte(Devices_ICAX2Z);
 
+  /* Pace the received data to the new rate: start bit, word and stop bits */
+  rx_baud = (aux1 & 0x40) ? 230400 : baud_rates[aux1 & 0x0f];
+  rx_frame_bits = 1 + (8 - ((aux1 >> 4) & 0x03)) + ((aux1 & 0x80) ? 2 : 1);
+  rx_credit = 0.0;
+  rx_last_line = rx_line_now();
+
 #ifdef R_SERIAL
   if(RDevice_serial_enabled)
   {
@@ -750,6 +1325,7 @@ static void open_connection(char * address, int port)
 #endif /* WIN32 */
   if((address != NULL) && (strlen(address) > 0))
   {
+    io_stop();
     close(rdev_fd);
     close(sock);
     do_once = 1;
@@ -808,9 +1384,10 @@ static void open_connection(char * address, int port)
     fcntl(rdev_fd, F_SETFL, O_NONBLOCK);
 #endif /* WIN32 */
 
-    /* Telnet negotiation */
+    /* Telnet negotiation, sent once the connection is up */
+    io_start(rdev_fd);
     sprintf(MESSAGE, "%c%c%c%c%c%c%c%c%c", 0xff, 0xfb, 0x01, 0xff, 0xfb, 0x03, 0xff, 0xfd, 0x0f3);
-    write(rdev_fd, MESSAGE, 9);
+    tx_put(MESSAGE, 9);
     DBG_APRINT("R*: Negotiating Terminal Options...");
   }
 }
@@ -840,12 +1417,16 @@ static void open_connection_serial(int port)
 #ifdef DREAMCAST
   dc_init_serial();
   connected = 1;
+  io_start(-1);
 #else /* above DREAMCAST, below not */
   char dev_name[FILENAME_MAX]; /* reinitialize each time */
   struct termios options;
 
   if(connected)
+  {
+    io_stop();
     close(rdev_fd);
+  }
   do_once = 1;
 
   if (*RDevice_serial_device)  /* got a device name from command line */
@@ -898,6 +1479,7 @@ static void open_connection_serial(int port)
     cfsetispeed(&options, B115200);
     cfsetospeed(&options, B115200);
     tcsetattr(rdev_fd, TCSANOW, &options);
+    io_start(rdev_fd);
   }
 #endif /* not DREAMCAST */
 }
@@ -948,7 +1530,8 @@ void RDevice_OPEN(void)
   CPU_regY = 1;
   CPU_ClrN;
 
-  bufend = 0;
+  io_service();
+  rx_clear();
 
   port = Peek(Devices_ICAX2Z);
   direction = Peek(Devices_ICAX1Z);
@@ -996,9 +1579,13 @@ void RDevice_CLOS(void)
   CPU_regY = 1;
   CPU_ClrN;
   concurrent = 0;
-  bufend = 0;
+  io_service();
+  rx_clear();
   if(RDevice_serial_enabled)
+  {
+    io_stop();
     close(rdev_fd);
+  }
 }
 
 /*---------------------------------------------------------------------------
@@ -1006,43 +1593,48 @@ void RDevice_CLOS(void)
 ---------------------------------------------------------------------------*/
 void RDevice_READ(void)
 {
-  int j;
-
-  /*bufend = Peek(747);*/
-  /*printf("Bufend = %d.\n", bufend);*/
-
-/*  if(bufend >= 0) */
-/*  { */
-    if(translation)
+  static UBYTE const block_cmds[] = { 0x05, 0x07, 0 }; /* GET RECORD, GET CHARACTERS */
+  int ch;
+  int left;
+
+  io_service();
+  rx_available();
+  ch = rx_getc();
+
+  /* Inside a block GET, store all but the last byte of the received data
+     (or of the record) directly and return that one to CIO, which then
+     finishes the transfer as if it had made every call. */
+  left = (ch < 0 || (CPU_regX & 0x8f) != 0) ? 0 : Devices_BlockLeft(CPU_regX >> 4, block_cmds);
+  if(left > 1)
+  {
+    int record = MEMORY_dGetByte(Devices_ICCOMZ) == 0x05;
+    UWORD bufadr = MEMORY_dGetWordAligned(Devices_ICBALZ);
+    UBYTE buf[0x400];
+    int n = 0;
+    int stored = 0;
+    int next;
+
+    while((stored + n < left - 1) && !(record && ch == 0x9b) && ((next = rx_getc()) >= 0))
     {
-      if(bufout[0] == 0x0d)
+      buf[n++] = (UBYTE) ch;
+      ch = next;
+      if(n == (int) sizeof(buf))
       {
-        CPU_regA = 0x9b;
+        MEMORY_CopyToMem(buf, (UWORD) (bufadr + stored), n);
+        stored += n;
+        n = 0;
       }
     }
-    else
-    {
-      CPU_regA = bufout[0];
-    }
-
-    bufend--;
-
-    for(j = 0; j <= bufend; j++)
+    if(n > 0)
     {
-      bufout[j] = bufout[j+1];
+      MEMORY_CopyToMem(buf, (UWORD) (bufadr + stored), n);
+      stored += n;
     }
+    Devices_BlockAdvance(stored);
+  }
 
-    /*Cycle the buffer again to skip over linefeed....*/
-    if(translation && linefeeds && (bufout[0] == 0x0a))
-    {
-      for(j = 0; j <= bufend; j++)
-      {
-        bufout[j] = bufout[j+1];
-      }
-    }
-    /*return; ???*/
-/*  } */
-
+  /* Nothing received yet gives a zero, as the 850 handler's empty buffer */
+  CPU_regA = (ch < 0) ? 0 : (UBYTE) ch;
   CPU_regY = 1;
   CPU_ClrN;
 }
@@ -1050,56 +1642,43 @@ void RDevice_READ(void)
 
 
 /*---------------------------------------------------------------------------
-   R Device WRITE vector - called from Atari OS Device Handler Address Table
+   Host Support Function - Output one character - Called from RDevice_WRIT
+   Returns FALSE, with the error in CPU_regY, if the line doesn't take it.
 ---------------------------------------------------------------------------*/
-void RDevice_WRIT(void)
+static int write_char(UBYTE c)
 {
   unsigned char out_char;
 #ifdef R_NETWORK
   int port;
 #endif
 
-  CPU_regY = 1;
-  CPU_ClrN;
-
-  /*bufend = Peek(747);*/
+  out_char = c;
 
   /* Translation mode */
   if(translation)
   {
-    if(CPU_regA == 0x9b)
+    if(c == 0x9b)
     {
       out_char = 0x0d;
       if(linefeeds)
       {
         if((RDevice_serial_enabled == 0) && (connected == 0))
         { /* local echo */
-          bufend++;
-          bufout[bufend-1] = out_char;
-          bufout[bufend] = 0;
+          rx_put((char *)&out_char, 1);
 
           command_end = 0;
           command_buf[command_end] = 0;
-          strcat(bufout, "OK\r\n");
-          bufend += 4;
+          rx_put("OK\r\n", 4);
 
         }
         else
         {
-#ifndef DREAMCAST
-          write(rdev_fd, (char *)&out_char, 1); /* Write return */
-#else
-          dc_write_serial(out_char);
-#endif
+          tx_putc(out_char); /* Write return */
         }
         out_char = 0x0a;  /*set char for line feed to be output later....*/
       }
     }
   }
-  else
-  {
-    out_char = CPU_regA;
-  }
 
   /* Translate the CR to a LF for telnet, ftp, etc */
   if(connected && trans_cr && (out_char == 0x0d))
@@ -1107,19 +1686,10 @@ void RDevice_WRIT(void)
     out_char = 0x0a;
   }
 
-  /*if((RDevice_serial_enabled == 0) && (out_char == 255))*/
-  /*{*/
-  /*  DBG_APRINT("R: Writing IAC..."); */
-  /*  retval = write(rdev_fd, &out_char, 1);*/ /* IAC escape sequence */ 
-  /*}*/
-  /*if(retval == -1)*/
-
 #ifdef R_NETWORK
   if((RDevice_serial_enabled == 0) && (connected == 0))
   { /* Local echo - only do if in socket mode */
-    bufend++;
-    bufout[bufend-1] = out_char;
-    bufout[bufend] = 0;
+    rx_put((char *)&out_char, 1);
 
     /* Grab Command */
     if((out_char == 0x9b) || (out_char == 0x0d))
@@ -1144,8 +1714,7 @@ void RDevice_WRIT(void)
           open_connection((char *)(strchr(command_buf, ' ')+1), port); /*send string after first space in line*/
         }
         command_buf[command_end] = 0;
-        strcat(bufout, "OK\r\n");
-        bufend += 4;
+        rx_put("OK\r\n", 4);
       /*Change translation command 'ATDL'*/
       }
       else if((command_buf[0] == 'A') && (command_buf[1] == 'T') && (command_buf[2] == 'D') && (command_buf[3] == 'L'))
@@ -1153,8 +1722,7 @@ void RDevice_WRIT(void)
         trans_cr = (trans_cr + 1) % 2;
 
         command_buf[command_end] = 0;
-        strcat(bufout, "OK\r\n");
-        bufend += 4;
+        rx_put("OK\r\n", 4);
       }
     }
     else
@@ -1164,36 +1732,116 @@ void RDevice_WRIT(void)
         command_end--; /* backspace */
         command_buf[command_end] = 0;
       }
-      else
+      else if(command_end < (int) sizeof(command_buf) - 1)
       {
         command_buf[command_end] = out_char;
         command_buf[command_end+1] = 0;
-        command_end = (command_end + 1) % 256;
+        command_end++;
       }
     }
   }
   else
 #endif /* R_NETWORK */
-#ifndef DREAMCAST
-    if((connected) && (write(rdev_fd, (char *)&out_char, 1) < 1))
-    { /* returns -1 if disconnected or 0 if could not send */
-      perror("write");
-      DBG_APRINT("R*: ERROR on write.");
-      CPU_SetN;
-      CPU_regY = 135;
-      /*bufend = 13;*/ /* To catch NO CARRIER message */
-    }
-#else
-  if (connected)
+  if((connected) && !tx_putc(out_char))
+  { /* tx_ready() makes room first, so this is not expected */
+    DBG_APRINT("R*: ERROR on write.");
+    CPU_SetN;
+    CPU_regY = 135;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Called when tx_ready() refused the byte in A. Inside a block PUT, CIO's
+   buffer pointer is stepped back so that CIO offers the byte again on its
+   next call, and the emulation runs on while the line drains. A direct
+   PUT, or a line that takes nothing for TX_TIMEOUT_FRAMES, fails with a
+   timeout; a dropped line fails at once. */
+static void tx_full(int left)
+{
+  if (hangup_pending)
   {
-    if (dc_write_serial(out_char) != 1)
+    DBG_APRINT("R*: ERROR on write.");
+    CPU_SetN;
+    CPU_regY = 135;
+    return;
+  }
+  if (tx_stall_frame < 0)
+    tx_stall_frame = Atari800_nframes;
+  if ((left > 0) && (Atari800_nframes - tx_stall_frame < TX_TIMEOUT_FRAMES))
+  {
+    Devices_BlockAdvance(-1);
+    return;
+  }
+  DBG_APRINT("R*: Timeout on write.");
+  tx_stall_frame = -1;
+  CPU_SetN;
+  CPU_regY = 138;
+}
+
+/*---------------------------------------------------------------------------
+   R Device WRITE vector - called from Atari OS Device Handler Address Table
+---------------------------------------------------------------------------*/
+void RDevice_WRIT(void)
+{
+  static UBYTE const block_cmds[] = { 0x0b, 0 }; /* PUT CHARACTERS */
+  int left;
+
+  CPU_regY = 1;
+  CPU_ClrN;
+
+  io_service();
+
+  /* Inside a block PUT, queue as much of the block as tx_ring takes now;
+     CIO's own step past the last byte queued ends the transfer or calls
+     again for the rest. If the line is dropped, CIO sees the error on the
+     first byte not sent. */
+  left = ((CPU_regX & 0x8f) != 0) ? 0 : Devices_BlockLeft(CPU_regX >> 4, block_cmds);
+  if(connected && !tx_ready())
+  {
+    tx_full(left);
+  }
+  else if((left > 1) && (MEMORY_dGetByte(MEMORY_dGetWordAligned(Devices_ICBALZ)) == CPU_regA))
+  {
+    UWORD bufadr = MEMORY_dGetWordAligned(Devices_ICBALZ);
+    UBYTE buf[0x400];
+    int done = 0;
+    int failed = FALSE;
+
+    while(done < left)
     {
-      Log_print("R*: ERROR on write.");
-      CPU_SetN;
-      CPU_regY = 135;
+      int n = left - done;
+      int i;
+      if(n > (int) sizeof(buf))
+        n = sizeof(buf);
+      MEMORY_CopyFromMem((UWORD) (bufadr + done), buf, n);
+      for(i = 0; i < n; i++)
+      {
+        if((i > 0 || done > 0) && connected && !tx_ready())
+        {
+          failed = hangup_pending;
+          if(failed)
+            tx_full(0);
+          break;
+        }
+        if(!write_char(buf[i]))
+        {
+          failed = TRUE;
+          break;
+        }
+      }
+      done += i;
+      if(i < n)
+        break;
     }
+    Devices_BlockAdvance(failed ? done : done - 1);
   }
-#endif
+  else
+  {
+    write_char(CPU_regA);
+  }
+  io_kick();
 
   CPU_regA = 1;
 }
@@ -1210,14 +1858,12 @@ void RDevice_STAT(void)
   unsigned int len;
 #endif
 #endif
-  int bytesread;
-  unsigned char one;
   int devnum;
   int on;
-  unsigned char telnet_command[2];
-  /*static char IACctr = 0;*/
   on = 1;
 
+  io_service();
+
   if(Peek(764) == 1)
   { /* Hack for Ice-T Terminal program to work! */
     Poke(764, 255);
@@ -1291,8 +1937,9 @@ void RDevice_STAT(void)
 #endif /* WIN32 */
 
         /* Telnet negotiation */
+        io_start(rdev_fd);
         sprintf(MESSAGE, "%c%c%c%c%c%c%c%c%c", 0xff, 0xfb, 0x01, 0xff, 0xfb, 0x03, 0xff, 0xfd, 0x0f3);
-        write(rdev_fd, MESSAGE, 9);
+        tx_put(MESSAGE, 9);
         DBG_APRINT("R*: Negotiating Terminal Options...");
 
         connected = 1;
@@ -1302,83 +1949,12 @@ void RDevice_STAT(void)
         retval = write(rdev_fd, &IACdontLinemode, 3);
         retval = write(rdev_fd, &IACwontLinemode, 3);
   */
-        bufout[0] = 0;
-        strcat(bufout, CONNECT_STRING);
-        bufend = strlen(CONNECT_STRING);
+        rx_put(CONNECT_STRING, strlen(CONNECT_STRING));
         close(sock);
       }
     }
   }
-  else
 #endif /* R_NETWORK */
-  {
-    /* Actually reading and setting the Atari input buffer here */
-    if(concurrent)
-    {
-#ifndef DREAMCAST
-      bytesread = read(rdev_fd, (char *)&one, 1);
-#else
-      bytesread = dc_read_serial(&one);
-#endif
-      if(bytesread > 0)
-      {
-        if((RDevice_serial_enabled == 0) && (one == 0xff))
-        {
-          /* Start Telnet escape seq processing... */
-          while(read(rdev_fd, (char *)telnet_command,2) != 2) {};
-
-          /*sprintf(MESSAGE, "Telnet Command = 0x%x 0x%x", telnet_command[0], telnet_command[1]);*/
-          /*DBG_APRINT(MESSAGE);*/
-          if(telnet_command[0] ==  0xfd)
-          { /*DO*/
-            if((telnet_command[1] == 0x01) || (telnet_command[1] == 0x03))
-            { /* WILL ECHO and GO AHEAD (char mode) */
-              telnet_command[0] = 0xfb; /* WILL */
-            }
-            else
-            {
-              telnet_command[0] = 0xfc; /* WONT */
-            }
-          }
-          else if(telnet_command[0] == 0xfb)
-          { /*WILL*/
-            /*telnet_command[0] = 0xfd;*/ /*DO*/
-            telnet_command[0] = 0xfe; /*DONT*/
-          }
-          else if(telnet_command[0] == 0xfe)
-          { /*DONT*/
-            telnet_command[0] = 0xfc;
-          }
-          else if(telnet_command[0] == 0xfc)
-          { /*WONT*/
-            telnet_command[0] = 0xfe;
-          }
-
-          if(telnet_command[0] == 0xfa)
-          { /* subnegotiation */
-            while(read(rdev_fd, (char *)&one, 1) != 1) {};
-
-            while(one != 0xf0)
-            { /* wait for end of sub negotiation */
-              while(read(rdev_fd, (char *)&one, 1) != 1) {};
-            }
-          }
-          else
-          {
-            write(rdev_fd, (char *)&one, 1);
-            write(rdev_fd, (char *)telnet_command, 2);
-          }
-        }
-        else
-        {
-          bufend++;
-          bufout[bufend-1] = one;
-          bufout[bufend] = 0;
-          /*return;*/
-        }
-      }
-    }
-  }
 
   /* Set all values at all memory locations we modify on exit */
   Poke(746,0);
@@ -1390,7 +1966,9 @@ void RDevice_STAT(void)
 
   if(concurrent)
   {
-    Poke(747,bufend);
+    /* Bytes received so far, paced to the baud rate */
+    int avail = rx_available();
+    Poke(747, avail > 255 ? 255 : avail);
   }
   else
   {
@@ -1458,6 +2036,7 @@ void RDevice_INIT(void)
 
 void RDevice_Exit(void)
 {
+  io_stop();
 #ifdef WIN32
   WSACleanup();
 #endif /* WIN32 */
@@ -0,0 +1,233 @@
+/*
+ * romcache.c - persistent cache of ROM image CRCs
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
+#include "log.h"
+#include "romcache.h"
+#include "util.h"
+
+#ifndef DEFAULT_ROMCACHE_NAME
+#define DEFAULT_ROMCACHE_NAME ".atari800-romcache"
+#endif
+
+/* First line of the cache file; bump the number when the format changes. */
+#define HEADER "Atari800 ROM cache 2"
+
+#define HASH_SIZE 512
+
+char ROMCACHE_filename[FILENAME_MAX];
+
+typedef struct entry_t {
+	struct entry_t *next;
+	long long size;
+	long long mtime;
+	unsigned long long inode;
+	ULONG crc;
+	int altirra;
+	char path[1];
+} entry_t;
+
+static entry_t *table[HASH_SIZE];
+static int loaded = FALSE;
+static int dirty = FALSE;
+
+/* File identity used to validate an entry. Returns FALSE if FILENAME is not
+   a regular file or can't be examined. */
+static int get_identity(char const *filename, long long *size, long long *mtime, unsigned long long *inode)
+{
+#ifdef HAVE_STAT
+	struct stat st;
+	if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode))
+		return FALSE;
+	*size = (long long) st.st_size;
+	*mtime = (long long) st.st_mtime;
+	*inode = (unsigned long long) st.st_ino;
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+static unsigned int hash_path(char const *path)
+{
+	unsigned int h = 2166136261u;
+	while (*path != '\0')
+		h = (h ^ (unsigned char) *path++) * 16777619u;
+	return h % HASH_SIZE;
+}
+
+static entry_t *find(char const *path)
+{
+	entry_t *e;
+	for (e = table[hash_path(path)]; e != NULL; e = e->next)
+		if (strcmp(e->path, path) == 0)
+			return e;
+	return NULL;
+}
+
+static entry_t *insert(char const *path)
+{
+	entry_t *e = find(path);
+	if (e == NULL) {
+		unsigned int h = hash_path(path);
+		e = (entry_t *) Util_malloc(sizeof(entry_t) + strlen(path));
+		strcpy(e->path, path);
+		e->next = table[h];
+		table[h] = e;
+	}
+	return e;
+}
+
+static void set_default_filename(void)
+{
+	char *home;
+	if (ROMCACHE_filename[0] != '\0')
+		return;
+	home = getenv("HOME");
+	if (home != NULL)
+		Util_catpath(ROMCACHE_filename, home, DEFAULT_ROMCACHE_NAME);
+	else
+		Util_strlcpy(ROMCACHE_filename, DEFAULT_ROMCACHE_NAME, FILENAME_MAX);
+}
+
+/* Reads the cache file. Malformed lines are skipped; a missing file or one
+   with another header just leaves the cache empty. */
+static void load(void)
+{
+	FILE *fp;
+	char line[FILENAME_MAX + 128];
+
+	loaded = TRUE;
+	set_default_filename();
+	fp = fopen(ROMCACHE_filename, "r");
+	if (fp == NULL)
+		return;
+	if (fgets(line, sizeof(line), fp) == NULL || strncmp(line, HEADER, strlen(HEADER)) != 0) {
+		fclose(fp);
+		return;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		unsigned int crc;
+		int altirra;
+		long long mtime;
+		unsigned long long inode;
+		long long size;
+		int path_pos;
+		entry_t *e;
+
+		Util_chomp(line);
+		if (sscanf(line, "%8x %d %lld %llu %lld %n", &crc, &altirra, &mtime, &inode, &size, &path_pos) != 5
+		    || line[path_pos] == '\0')
+			continue;
+		e = insert(line + path_pos);
+		e->crc = crc;
+		e->altirra = altirra;
+		e->mtime = mtime;
+		e->inode = inode;
+		e->size = size;
+	}
+	fclose(fp);
+}
+
+int ROMCACHE_Lookup(char const *filename, int *len, ULONG *crc, int *altirra)
+{
+	long long size, mtime;
+	unsigned long long inode;
+	entry_t *e;
+
+	*len = -1;
+	if (!get_identity(filename, &size, &mtime, &inode))
+		return FALSE;
+	*len = (int) size;
+	if (!loaded)
+		load();
+	e = find(filename);
+	if (e == NULL || e->size != size || e->mtime != mtime || e->inode != inode)
+		return FALSE;
+	*crc = e->crc;
+	*altirra = e->altirra;
+	return TRUE;
+}
+
+void ROMCACHE_Store(char const *filename, ULONG crc, int altirra)
+{
+	long long size, mtime;
+	unsigned long long inode;
+	entry_t *e;
+
+	/* The cache file is line-based. */
+	if (strchr(filename, '\n') != NULL || !get_identity(filename, &size, &mtime, &inode))
+		return;
+	if (!loaded)
+		load();
+	e = insert(filename);
+	e->crc = crc;
+	e->altirra = altirra;
+	e->size = size;
+	e->mtime = mtime;
+	e->inode = inode;
+	dirty = TRUE;
+}
+
+void ROMCACHE_Save(void)
+{
+	char tmp_filename[FILENAME_MAX + 4];
+	FILE *fp;
+	int i;
+
+	if (!dirty)
+		return;
+	dirty = FALSE;
+	snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", ROMCACHE_filename);
+	fp = fopen(tmp_filename, "w");
+	if (fp == NULL) {
+		Log_print("Cannot write ROM cache %s", tmp_filename);
+		return;
+	}
+	fprintf(fp, "%s\n", HEADER);
+	for (i = 0; i < HASH_SIZE; i++) {
+		entry_t *e;
+		for (e = table[i]; e != NULL; e = e->next) {
+			long long size, mtime;
+			unsigned long long inode;
+			/* Drop entries for files that have gone away. */
+			if (!get_identity(e->path, &size, &mtime, &inode))
+				continue;
+			fprintf(fp, "%08X %d %lld %llu %lld %s\n", (unsigned int) e->crc, e->altirra,
+			        e->mtime, e->inode, e->size, e->path);
+		}
+	}
+	if (fclose(fp) != 0 || rename(tmp_filename, ROMCACHE_filename) != 0) {
+		Log_print("Cannot write ROM cache %s", ROMCACHE_filename);
+#ifdef HAVE_UTIL_UNLINK
+		Util_unlink(tmp_filename);
+#endif
+	}
+}
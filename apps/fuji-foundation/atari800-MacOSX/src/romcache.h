@@ -0,0 +1,35 @@
+#ifndef ROMCACHE_H_
+#define ROMCACHE_H_
+
+#include <stdio.h>
+
+#include "atari.h"
+
+/* Persistent cache of ROM image identification.
+   Each entry maps a file path, together with the file's size, modification
+   time and inode, to its CRC32 and whether the image carries the Altirra OS
+   signature. ROM IDs are not stored, so a changed ROM table never meets stale
+   entries. An entry is only used while all three still match, so a replaced
+   or edited file is re-read. The cache file is loaded on first use and written back by
+   ROMCACHE_Save(). */
+
+/* Altirra flag of files that were not searched for the signature. */
+#define ROMCACHE_ALTIRRA_UNKNOWN (-1)
+
+/* Path of the cache file; defaults to ~/.atari800-romcache when empty. */
+extern char ROMCACHE_filename[FILENAME_MAX];
+
+/* Looks up FILENAME. If it is cached and unchanged, stores its length, CRC32
+   and Altirra flag in *LEN, *CRC and *ALTIRRA and returns TRUE. Otherwise returns FALSE;
+   *LEN then holds the file's length if it is a regular file, or -1. */
+int ROMCACHE_Lookup(char const *filename, int *len, ULONG *crc, int *altirra);
+
+/* Records CRC and the Altirra flag (TRUE, FALSE or ROMCACHE_ALTIRRA_UNKNOWN)
+   for FILENAME as it is now on disk. */
+void ROMCACHE_Store(char const *filename, ULONG crc, int altirra);
+
+/* Writes the cache file if entries were stored since it was last written.
+   Callers store a whole batch of lookups first and save once at the end. */
+void ROMCACHE_Save(void);
+
+#endif /* ROMCACHE_H_ */
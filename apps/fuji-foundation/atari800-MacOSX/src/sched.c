@@ -0,0 +1,154 @@
+/*
+ * sched.c - cycle-keyed peripheral event queue
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <stdlib.h>	/* for NULL */
+
+#include "atari.h"
+#include "sched.h"
+
+unsigned int SCHED_next_cycle = 0;
+int SCHED_queued = 0;
+
+static SCHED_HandlerType handlers[SCHED_EVENT_COUNT];
+static unsigned int event_cycle[SCHED_EVENT_COUNT];
+/* Position of each event in heap[] plus one, 0 if not queued. */
+static int heap_pos[SCHED_EVENT_COUNT];
+static int heap[SCHED_EVENT_COUNT];
+
+/* TRUE if event a is due before event b */
+#define EARLIER(a, b) ((int) (event_cycle[a] - event_cycle[b]) < 0)
+
+static void heap_set(int pos, int event)
+{
+	heap[pos] = event;
+	heap_pos[event] = pos + 1;
+}
+
+static void sift_up(int pos)
+{
+	int event = heap[pos];
+	while (pos > 0) {
+		int parent = (pos - 1) >> 1;
+		if (!EARLIER(event, heap[parent]))
+			break;
+		heap_set(pos, heap[parent]);
+		pos = parent;
+	}
+	heap_set(pos, event);
+}
+
+static void sift_down(int pos)
+{
+	int event = heap[pos];
+	for (;;) {
+		int child = 2 * pos + 1;
+		if (child >= SCHED_queued)
+			break;
+		if (child + 1 < SCHED_queued && EARLIER(heap[child + 1], heap[child]))
+			child++;
+		if (!EARLIER(heap[child], event))
+			break;
+		heap_set(pos, heap[child]);
+		pos = child;
+	}
+	heap_set(pos, event);
+}
+
+static void update_next(void)
+{
+	if (SCHED_queued > 0)
+		SCHED_next_cycle = event_cycle[heap[0]];
+}
+
+void SCHED_Register(int event, SCHED_HandlerType handler)
+{
+	handlers[event] = handler;
+}
+
+void SCHED_Add(int event, unsigned int cycle)
+{
+	event_cycle[event] = cycle;
+	if (heap_pos[event] == 0) {
+		heap_set(SCHED_queued, event);
+		sift_up(SCHED_queued++);
+	}
+	else {
+		sift_up(heap_pos[event] - 1);
+		sift_down(heap_pos[event] - 1);
+	}
+	update_next();
+}
+
+void SCHED_Remove(int event)
+{
+	int pos = heap_pos[event] - 1;
+	if (pos < 0)
+		return;
+	heap_pos[event] = 0;
+	if (--SCHED_queued > pos) {
+		/* move the last entry into the hole and restore heap order */
+		int last = heap[SCHED_queued];
+		heap_set(pos, last);
+		sift_up(pos);
+		sift_down(heap_pos[last] - 1);
+	}
+	update_next();
+}
+
+void SCHED_SetCycle(int event, unsigned int cycle)
+{
+	if (heap_pos[event] != 0)
+		SCHED_Add(event, cycle);
+	else
+		event_cycle[event] = cycle;
+}
+
+unsigned int SCHED_GetCycle(int event)
+{
+	return event_cycle[event];
+}
+
+int SCHED_IsQueued(int event)
+{
+	return heap_pos[event] != 0;
+}
+
+void SCHED_Rebase(unsigned int origin)
+{
+	int i;
+	/* Every cycle moves by the same amount, so heap order is unchanged. */
+	for (i = 0; i < SCHED_EVENT_COUNT; i++)
+		event_cycle[i] -= origin;
+	update_next();
+}
+
+void SCHED_Dispatch(unsigned int now)
+{
+	while (SCHED_queued > 0 && (int) (now - event_cycle[heap[0]]) >= 0) {
+		int event = heap[0];
+		SCHED_Remove(event);
+		if (handlers[event] != NULL)
+			handlers[event](event);
+	}
+}
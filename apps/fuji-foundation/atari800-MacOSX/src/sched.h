@@ -0,0 +1,61 @@
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include "atari.h"
+#include "antic.h"
+
+/* Peripheral event scheduler.
+   Events are keyed on the absolute CPU cycle (ANTIC_CPU_CLOCK) and kept in
+   a binary min-heap, so a peripheral that has nothing due costs nothing:
+   the per-scanline check is one compare against SCHED_next_cycle. */
+
+/* Event slots. Each slot is owned by one peripheral. */
+enum SCHED_Event_t {
+	SCHED_EVENT_POKEY_TIMER1,
+	SCHED_EVENT_POKEY_TIMER2,
+	SCHED_EVENT_POKEY_TIMER4,
+	SCHED_EVENT_COUNT
+};
+
+/* Called when an event becomes due. The event is already dequeued;
+   a periodic event re-queues itself with SCHED_Add(). */
+typedef void (*SCHED_HandlerType)(int event);
+
+/* Cycle of the earliest queued event. Only valid if SCHED_queued > 0. */
+extern unsigned int SCHED_next_cycle;
+/* Number of queued events. */
+extern int SCHED_queued;
+
+/* Registers the handler for an event slot. */
+void SCHED_Register(int event, SCHED_HandlerType handler);
+
+/* Sets the due cycle of an event and queues it (re-queues if already queued). */
+void SCHED_Add(int event, unsigned int cycle);
+
+/* Removes an event from the queue. Its cycle is retained. */
+void SCHED_Remove(int event);
+
+/* Changes the stored cycle of an event. A queued event moves to its new
+   place in the queue; an event that is not queued stays off the queue. */
+void SCHED_SetCycle(int event, unsigned int cycle);
+
+/* Returns the stored cycle of an event, queued or not. */
+unsigned int SCHED_GetCycle(int event);
+
+/* Returns TRUE if the event is queued. */
+int SCHED_IsQueued(int event);
+
+/* Shifts every stored cycle by -origin. Call when ANTIC_screenline_cpu_clock
+   is moved back to 0 so pending events keep their distance from "now". */
+void SCHED_Rebase(unsigned int origin);
+
+/* Runs every event due at or before the given cycle. */
+void SCHED_Dispatch(unsigned int now);
+
+/* Runs due events. Cycles wrap, so compare by signed difference. */
+#define SCHED_Run() do { \
+		if (SCHED_queued > 0 && (int) (ANTIC_CPU_CLOCK - SCHED_next_cycle) >= 0) \
+			SCHED_Dispatch(ANTIC_CPU_CLOCK); \
+	} while (0)
+
+#endif /* SCHED_H_ */
@@ -22,6 +22,8 @@ static int CartSizeMask;
 static FlashEmu *flash;
 static FlashEmu *flash2;
 static int CartBank;
+static int MappedBank;
+static int MapStale = TRUE;
 static int CartBankMask;
 
 static void SetCartBank(int bank);
@@ -37,7 +39,7 @@ static int SIC_Is_Dirty(void);
 static void  SIC_Cold_Reset(void);
 static UBYTE SIC_Read_Byte(UWORD address);
 static void  SIC_Write_Byte(UWORD address, UBYTE value);
-static void SIC_Map_Cart(void);
+static void SIC_Map_Cart(int force);
 
 static CARTRIDGE_funcs_type funcs = {
     SIC_Shutdown,
@@ -76,6 +78,10 @@ void SIC_Init(CARTRIDGE_image_t *cart)
             flash2 = Flash_Init(Cart->image + 0x80000, Flash_TypeAm29F040B);
             break;
     }
+
+    Flash_Track_Dirty(flash, CARTRIDGE_DirtyBlocks(Cart), 0);
+    if (flash2 != NULL)
+        Flash_Track_Dirty(flash2, CARTRIDGE_DirtyBlocks(Cart), 0x80000);
 }
 
 static void SIC_Shutdown(void)
@@ -136,8 +142,13 @@ static void SetCartBank(int bank) {
     CartBank = bank;
 }
 
-static void SIC_Map_Cart(void)
+static void SIC_Map_Cart(int force)
 {
+    if (!force && !MapStale && CartBank == MappedBank)
+        return;
+    MappedBank = CartBank;
+    MapStale = FALSE;
+
     if (Cart->type == CARTRIDGE_SICPLUS_1024)
         Map_Cart_SicPlus();
     else
@@ -206,6 +217,7 @@ static void SIC_Flash_Write(UWORD addr, UBYTE value) {
         
         if (Flash_Write_Byte(flash, fullAddr, value)) {
             Cart->dirty = TRUE;
+            MapStale = TRUE;
         }
     }
 }
@@ -232,5 +244,6 @@ static void SICPLUS_Flash_Write(UWORD addr, UBYTE value) {
     
     if (Flash_Write_Byte(flashEmu, fullAddr & 0x7FFFF, value)) {
         Cart->dirty = TRUE;
+        MapStale = TRUE;
     }
 }
@@ -58,6 +58,9 @@ static IDEEmu *ide;
 static void *rtc;
 static FlashEmu *flash;
 static int CartDirty = FALSE;
+/* Flash blocks of side2_rom changed since it matched Rom_Dirty_File. */
+static UBYTE Rom_Dirty_Blocks[UTIL_DIRTY_MAP_SIZE(0x80000)];
+static char Rom_Dirty_File[FILENAME_MAX];
 
 static void LoadNVRAM();
 static void Reset_Cart_Bank(void);
@@ -66,6 +69,7 @@ static void Set_SDX_Bank(int bank, int topEnable);
 static void Set_Top_Bank(int bank, int topLeftEnable, int topRightEnable);
 static void Update_IDE_Reset(void);
 static void Update_Memory_Layers_Cart(void);
+static void Rom_Matches_File(const char *filename);
 
 #ifdef ATARI800MACX
 void init_side2(void)
@@ -76,11 +80,13 @@ static void init_side2(void)
     Log_print("Side2 enabled");
     if (!Atari800_LoadImage(side2_rom_filename, side2_rom, 0x80000)) {
         SIDE2_have_rom = FALSE;
+        Rom_Matches_File("");
         Log_print("Couldn't load Side2 ROM image");
         return;
     }
     else {
         SIDE2_have_rom = TRUE;
+        Rom_Matches_File(side2_rom_filename);
         Log_print("loaded Side2 rom image");
     }
     
@@ -100,7 +106,7 @@ static void init_side2(void)
         flash = Flash_Init(side2_rom, Flash_TypeAm29F040B);
     else
         flash = Flash_Init(side2_rom, Flash_TypeSST39SF040);
-
+    Flash_Track_Dirty(flash, Rom_Dirty_Blocks, 0);
 }
 
 void SIDE2_Remove_Block_Device(void)
@@ -146,8 +152,10 @@ int SIDE2_Change_Rom(char *filename, int new) {
     if (!romLoaded) {
         SIDE2_have_rom = FALSE;
         side2_compact_flash_filename[0] = 0;
+        Rom_Matches_File("");
     } else {
         SIDE2_have_rom = TRUE;
+        Rom_Matches_File(filename);
         if (new)
             strcpy(side2_rom_filename, filename);
         strcpy(side2_nvram_filename, side2_rom_filename);
@@ -159,20 +167,33 @@ int SIDE2_Change_Rom(char *filename, int new) {
                 flash = Flash_Init(side2_rom, Flash_TypeAm29F040B);
             else
                 flash = Flash_Init(side2_rom, Flash_TypeSST39SF040);
+            Flash_Track_Dirty(flash, Rom_Dirty_Blocks, 0);
         }
     }
     
     return romLoaded;
 }
 
+static void Rom_Matches_File(const char *filename)
+{
+    strcpy(Rom_Dirty_File, filename);
+    memset(Rom_Dirty_Blocks, 0, sizeof(Rom_Dirty_Blocks));
+}
+
 int SIDE2_Save_Rom(char *filename)
 {
     FILE *f;
 
+    /* Over the image's own file only the flash blocks that changed are written. */
+    if (strcmp(filename, Rom_Dirty_File) == 0
+        && Util_writeback(filename, 0, side2_rom, 0x80000, Rom_Dirty_Blocks) >= 0)
+        return 0;
+
     f = fopen(filename, "wb");
     if (f != NULL) {
         fwrite(side2_rom, 1, 0x80000, f);
         fclose(f);
+        Rom_Matches_File(filename);
         return 0;
     } else {
         return -1;
@@ -37,6 +37,7 @@
 #include "esc.h"
 #include "log.h"
 #include "memory.h"
+#include "perf.h"
 #include "platform.h"
 #include "pokey.h"
 #include "pokeysnd.h"
@@ -265,6 +266,15 @@ int SIO_Mount(int diskno, const char *filename, int b_open_readonly)
 	case 0xfa:
 		/* DCM */
 		{
+#ifdef COMPFILE_STREAMS
+			FILE *f2;
+			Util_rewind(f);
+			f2 = CompFile_OpenDCM(f);
+			if (f2 == NULL) {
+				fclose(f);
+				return FALSE;
+			}
+#else
 			FILE *f2 = Util_tmpopen(sio_tmpbuf[diskno - 1]);
 			if (f2 == NULL)
 				return FALSE;
@@ -275,6 +285,7 @@ int SIO_Mount(int diskno, const char *filename, int b_open_readonly)
 				return FALSE;
 			}
 			fclose(f);
+#endif
 			f = f2;
 		}
 		Util_rewind(f);
@@ -289,6 +300,11 @@ int SIO_Mount(int diskno, const char *filename, int b_open_readonly)
 		if (header.magic2 == 0x8b) {
 			/* ATZ/ATR.GZ, XFZ/XFD.GZ */
 			fclose(f);
+#ifdef COMPFILE_STREAMS
+			f = CompFile_OpenGZ(filename);
+			if (f == NULL)
+				return FALSE;
+#else
 			f = Util_tmpopen(sio_tmpbuf[diskno - 1]);
 			if (f == NULL)
 				return FALSE;
@@ -296,6 +312,7 @@ int SIO_Mount(int diskno, const char *filename, int b_open_readonly)
 				Util_fclose(f, sio_tmpbuf[diskno - 1]);
 				return FALSE;
 			}
+#endif
 			Util_rewind(f);
 			if (fread(&header, 1, sizeof(struct AFILE_ATR_Header), f) != sizeof(struct AFILE_ATR_Header)) {
 				Util_fclose(f, sio_tmpbuf[diskno - 1]);
@@ -1215,7 +1232,7 @@ static int last_ypos = 0;
 #endif
 
 /* SIO patch emulation routine */
-void SIO_Handler(void)
+static void sio_handler(void)
 {
 	int sector = MEMORY_dGetWordAligned(0x30a);
 	UBYTE unit = MEMORY_dGetByte(0x300) + MEMORY_dGetByte(0x301) + 0xff;
@@ -1424,6 +1441,13 @@ void SIO_Handler(void)
 	POKEY_PutByte(POKEY_OFFSET_AUDC4, 0);
 }
 
+void SIO_Handler(void)
+{
+	PERF_BEGIN(PERF_SIO);
+	sio_handler();
+	PERF_END(PERF_SIO);
+}
+
 UBYTE SIO_ChkSum(const UBYTE *buffer, int length)
 {
 #if 0
@@ -1705,14 +1729,10 @@ void NetSIO_PutByte(int byte)
 		/* Transmitting Data Frame (SIO Write command) */
 		if (DataIndex < ExpectedBytes)
 		{
-			/* TODO: bleh grh sending multiple data blocks - make it better */
 			DataBuffer[DataIndex++] = byte;  /* Collect data bytes into buffer */
 			if (DataIndex == ExpectedBytes)
 			{
-				if ((DataIndex-1) % NETSIO_WRITE_CHUNK_SIZE > 0)
-					 /* Send data buffer */
-					netsio_send_block(DataBuffer + NETSIO_WRITE_CHUNK_SIZE * ((DataIndex-1) / NETSIO_WRITE_CHUNK_SIZE), (DataIndex-1) % NETSIO_WRITE_CHUNK_SIZE);
-				 /* send checksum byte + sync */
+				/* send checksum byte + sync; this flushes the batched data bytes first */
 				netsio_send_byte_sync(DataBuffer[DataIndex-1]);
 				netsio_wait_for_sync() ; /* Wait for sync response (ACK/NAK/NONE) */
 				POKEY_DELAYED_SERIN_IRQ = SIO_SERIN_INTERVAL * 8;
@@ -1721,10 +1741,8 @@ void NetSIO_PutByte(int byte)
 			}
 			else
 			{
-				if (DataIndex % NETSIO_WRITE_CHUNK_SIZE == 0)
-				{
-					netsio_send_block(DataBuffer + NETSIO_WRITE_CHUNK_SIZE * ((DataIndex-1) / NETSIO_WRITE_CHUNK_SIZE), NETSIO_WRITE_CHUNK_SIZE); /* Send data buffer */
-				}
+				/* Batched by netsio into DATA_BLOCK packets */
+				netsio_send_byte(byte);
 			}
 		}
 		else
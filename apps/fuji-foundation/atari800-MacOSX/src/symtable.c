@@ -0,0 +1,144 @@
+/*
+ * symtable.c - address and name indexes of the monitor's label tables
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "config.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "symtable.h"
+#include "util.h"
+
+#define NAMES_INITIAL_SIZE 256
+
+static int *new_map(int size)
+{
+	int *map = (int *) Util_malloc(size * sizeof(int));
+	memset(map, 0, size * sizeof(int));
+	return map;
+}
+
+/* FNV-1a, folding case the way Util_stricmp() does. */
+static unsigned int hash_name(const char *name)
+{
+	unsigned int h = 2166136261U;
+	while (*name != '\0')
+		h = (h ^ (unsigned int) tolower(*name++)) * 16777619U;
+	return h;
+}
+
+static void insert_name(SYMTABLE_Index *index, const symtable_rec *table, int i)
+{
+	int mask = index->names_size - 1;
+	int j;
+	for (j = hash_name(table[i].name) & mask; index->names[j] != 0; j = (j + 1) & mask) {
+		if (Util_stricmp(table[index->names[j] - 1].name, table[i].name) == 0)
+			return; /* an earlier label has this name */
+	}
+	index->names[j] = i + 1;
+}
+
+void SYMTABLE_Add(SYMTABLE_Index *index, const symtable_rec *table, int i)
+{
+	UWORD addr = table[i].addr;
+	if (index->read == NULL)
+		index->read = new_map(0x10000);
+	if (index->read[addr] == 0)
+		index->read[addr] = i + 1;
+	index->count = i + 1;
+	/* keep the hash table at most half full */
+	if (2 * index->count > index->names_size) {
+		int j;
+		free(index->names);
+		index->names_size = index->names_size == 0 ? NAMES_INITIAL_SIZE : 2 * index->names_size;
+		index->names = new_map(index->names_size);
+		for (j = 0; j < index->count; j++)
+			insert_name(index, table, j);
+	}
+	else
+		insert_name(index, table, i);
+}
+
+void SYMTABLE_IndexBuiltin(SYMTABLE_Index *index, const symtable_rec *table)
+{
+	int i;
+	SYMTABLE_Free(index);
+	for (i = 0; table[i].name != NULL; i++)
+		SYMTABLE_Add(index, table, i);
+	index->write = new_map(0x10000);
+	for (i = 1; i < index->count; i++) {
+		UWORD addr = table[i].addr;
+		if (table[i - 1].addr == addr && index->read[addr] == i)
+			index->write[addr] = i + 1;
+	}
+}
+
+void SYMTABLE_Move(SYMTABLE_Index *index, symtable_rec *table, int i, UWORD addr)
+{
+	UWORD old_addr = table[i].addr;
+	table[i].addr = addr;
+	if (index->read == NULL)
+		return;
+	if (index->read[old_addr] == i + 1) {
+		int j;
+		index->read[old_addr] = 0;
+		for (j = i + 1; j < index->count; j++) {
+			if (table[j].addr == old_addr) {
+				index->read[old_addr] = j + 1;
+				break;
+			}
+		}
+	}
+	if (index->read[addr] == 0 || index->read[addr] > i + 1)
+		index->read[addr] = i + 1;
+}
+
+int SYMTABLE_FindAddr(const SYMTABLE_Index *index, UWORD addr, int is_write)
+{
+	if (index->read == NULL)
+		return -1;
+	if (is_write && index->write != NULL && index->write[addr] != 0)
+		return index->write[addr] - 1;
+	return index->read[addr] - 1;
+}
+
+int SYMTABLE_FindName(const SYMTABLE_Index *index, const symtable_rec *table, const char *name)
+{
+	int mask = index->names_size - 1;
+	int j;
+	if (index->names == NULL)
+		return -1;
+	for (j = hash_name(name) & mask; index->names[j] != 0; j = (j + 1) & mask) {
+		if (Util_stricmp(table[index->names[j] - 1].name, name) == 0)
+			return index->names[j] - 1;
+	}
+	return -1;
+}
+
+void SYMTABLE_Free(SYMTABLE_Index *index)
+{
+	free(index->read);
+	free(index->write);
+	free(index->names);
+	memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,45 @@
+#ifndef SYMTABLE_H_
+#define SYMTABLE_H_
+
+#include "atari.h"
+#include "monitor.h"
+
+/* Indexes of the monitor's label tables, so that the disassembler can name
+   every operand and expressions can use labels without scanning tables of
+   tens of thousands of labels loaded from MADS or ATasm listings.
+   An index refers to the labels by their position in the table, so a table
+   may be reallocated as it grows. Each address maps to the first label
+   with that address, and each name, compared without regard to case, to
+   the first label with that name. A zeroed SYMTABLE_Index is empty. */
+
+typedef struct SYMTABLE_Index_t {
+	int *read;		/* 65536 label positions + 1, 0 where there is none */
+	int *write;		/* like read, for labels of hardware registers written to */
+	int *names;		/* hash table of label positions + 1 */
+	int names_size;	/* power of two */
+	int count;		/* labels indexed */
+} SYMTABLE_Index;
+
+/* Adds label I of TABLE, after labels 0 to I-1 have been added. */
+void SYMTABLE_Add(SYMTABLE_Index *index, const symtable_rec *table, int i);
+
+/* Rebuilds INDEX for a built-in table terminated by a NULL name, in which
+   a register with different names for reading and writing has its read
+   name directly before its write name. */
+void SYMTABLE_IndexBuiltin(SYMTABLE_Index *index, const symtable_rec *table);
+
+/* Sets the address of label I of TABLE to ADDR, in an index built by
+   SYMTABLE_Add(). */
+void SYMTABLE_Move(SYMTABLE_Index *index, symtable_rec *table, int i, UWORD addr);
+
+/* Returns the position of the label for ADDR, or -1. IS_WRITE selects the
+   write name of a register. */
+int SYMTABLE_FindAddr(const SYMTABLE_Index *index, UWORD addr, int is_write);
+
+/* Returns the position of the label called NAME, or -1. */
+int SYMTABLE_FindName(const SYMTABLE_Index *index, const symtable_rec *table, const char *name);
+
+/* Empties INDEX and frees its memory. */
+void SYMTABLE_Free(SYMTABLE_Index *index);
+
+#endif /* SYMTABLE_H_ */
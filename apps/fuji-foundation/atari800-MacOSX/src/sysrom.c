@@ -39,6 +39,7 @@
 #include "crc32.h"
 #include "log.h"
 #include "memory.h"
+#include "romcache.h"
 #include "util.h"
 
 #if EMUOS_ALTIRRA
@@ -217,6 +218,46 @@ static char const * const cfg_strings_rev[SYSROM_SIZE+1] = {
 };
 #endif
 
+/* Checks if LEN is a correct ROM length. */
+static int IsLengthAllowed(int len)
+{
+    return len == 0x2800 || len == 0x4000 || len == 0x0800 || len == 0x2000;
+}
+
+/* Gets length and CRC32 of FILENAME, taking them from the ROM cache when the
+   file hasn't changed since it was last checked. *ALTIRRA receives the cached
+   Altirra flag, or ROMCACHE_ALTIRRA_UNKNOWN if the file was read now.
+   Returns SYSROM_OK, SYSROM_ERROR if the file can't be read, or SYSROM_BADSIZE
+   if no ROM has its length. */
+static int GetFileCRC(char const *filename, int *len, ULONG *crc, int *altirra)
+{
+    FILE *f;
+
+    if (ROMCACHE_Lookup(filename, len, crc, altirra))
+        return SYSROM_OK;
+    /* Known length (regular file): reject without opening it. */
+    if (*len >= 0 && !IsLengthAllowed(*len))
+        return SYSROM_BADSIZE;
+
+    if ((f = fopen(filename, "rb")) == NULL)
+        return SYSROM_ERROR;
+    *len = Util_flen(f);
+    /* Don't proceed to CRC computation if the file has invalid size. */
+    if (!IsLengthAllowed(*len)) {
+        fclose(f);
+        return SYSROM_BADSIZE;
+    }
+    Util_rewind(f);
+    if (!CRC32_FromFile(f, crc)) {
+        fclose(f);
+        return SYSROM_ERROR;
+    }
+    fclose(f);
+    *altirra = ROMCACHE_ALTIRRA_UNKNOWN;
+    ROMCACHE_Store(filename, *crc, *altirra);
+    return SYSROM_OK;
+}
+
 #ifdef ATARI800MACX
 
 char *memstr(char *buffer, char *str, int size)
@@ -232,72 +273,77 @@ char *memstr(char *buffer, char *str, int size)
     return NULL;
 }
 
-int SYSROM_FindType(int defaultType, char const *filename, char *romTypeName)
+/* Returns TRUE if the LEN-byte image in FILENAME contains the Altirra OS
+   signature. */
+static int HasAltirraSignature(char const *filename, int len)
 {
     FILE *file;
-    int len;
-    int id;
-    ULONG crc;
-
-    strcpy(romTypeName, "");
+    char *image;
+    int found = FALSE;
 
-    if ((file = fopen(filename, "rb")) == NULL) {
-        /* Ignore non-readable files (e.g. directories). */
-        return(-1);
-    }
-    
-    len = Util_flen(file);
-    /* Don't proceed to CRC computation if the file has invalid size. */
-    if (len != 0x2800 && len != 0x4000 && len != 0x0800 && len != 0x2000){
-        fclose(file);
-        return(-1);
+    if ((file = fopen(filename, "rb")) == NULL)
+        return FALSE;
+    image = Util_malloc(len);
+    if (image != NULL) {
+        size_t rlen = fread(image, 1, len, file);
+        // Check for Altirra specific string
+        found = memstr((char *)image, "!ltirra", rlen) != NULL;
+        free(image);
     }
-    Util_rewind(file);
+    fclose(file);
+    return found;
+}
 
-    if (!CRC32_FromFile(file, &crc)) {
-        fclose(file);
-        return(-1);
-    }
+/* Identifies the ROM in FILENAME by CRC, or failing that by the Altirra
+   signature. ALTIRRA is the cached signature flag; the file is only searched
+   when it is ROMCACHE_ALTIRRA_UNKNOWN. Returns the ROM ID or -1. */
+static int IdentifyFile(char const *filename, int len, ULONG crc, int altirra)
+{
+    int id;
 
     /* Match ROM image by CRC. */
     for (id = 0; id < SYSROM_LOADABLE_SIZE; ++id) {
         if (SYSROM_roms[id].size == len
-            && SYSROM_roms[id].crc32 != CRC_NULL && SYSROM_roms[id].crc32 == crc) {
-            strcpy(romTypeName, readable_strings[id]);
-            fclose(file);
+            && SYSROM_roms[id].crc32 != CRC_NULL && SYSROM_roms[id].crc32 == crc)
             return id;
-        }
     }
-        
-    Util_rewind(file);
-    char *image;
-    
-    if (len == 0x2800) {
-        image = Util_malloc(len);
-        if (image != NULL) {
-            size_t rlen = fread(image, 1, 0x2800, file);
-            // Check for Altirra specific string
-            if (memstr((char *)image, "!ltirra", rlen)) {
-                strcpy(romTypeName, "Altirra 400/800 OS");
-                free(image);
-                return SYSROM_ALTIRRA_800;
-            }
-            free(image);
-        }
+
+    if (len != 0x2800 && len != 0x4000)
+        return -1;
+    if (altirra == ROMCACHE_ALTIRRA_UNKNOWN) {
+        altirra = HasAltirraSignature(filename, len);
+        ROMCACHE_Store(filename, crc, altirra);
     }
+    if (!altirra)
+        return -1;
+    return (len == 0x2800) ? SYSROM_ALTIRRA_800 : SYSROM_ALTIRRA_XL;
+}
 
-    if (len == 0x4000) {
-        image = Util_malloc(len);
-        if (image != NULL) {
-            size_t rlen = fread(image, 1, 0x4000, file);
-            // Check for Altirra specific string
-            if (memstr((char *)image, "!ltirra", rlen)) {
-                strcpy(romTypeName, "Altirra XL/XE OS");
-                free(image);
-                return SYSROM_ALTIRRA_XL;
-            }
-            free(image);
-        }
+int SYSROM_FindType(int defaultType, char const *filename, char *romTypeName)
+{
+    int len;
+    int id;
+    int altirra;
+    ULONG crc;
+
+    strcpy(romTypeName, "");
+
+    if (GetFileCRC(filename, &len, &crc, &altirra) != SYSROM_OK)
+        /* Ignore non-readable files (e.g. directories). */
+        return(-1);
+    id = IdentifyFile(filename, len, crc, altirra);
+
+    if (id == SYSROM_ALTIRRA_800) {
+        strcpy(romTypeName, "Altirra 400/800 OS");
+        return id;
+    }
+    if (id == SYSROM_ALTIRRA_XL) {
+        strcpy(romTypeName, "Altirra XL/XE OS");
+        return id;
+    }
+    if (id >= 0 && id < SYSROM_LOADABLE_SIZE) {
+        strcpy(romTypeName, readable_strings[id]);
+        return id;
     }
 
     if (defaultType >= 0 && defaultType <= SYSROM_LOADABLE_SIZE) {
@@ -361,12 +407,6 @@ int SYSROM_FindImageType(const unsigned char *image)
 /* Number of ROM paths not set during initialisation. */
 static int num_unset_roms = SYSROM_LOADABLE_SIZE;
 
-/* Checks if LEN is a correct ROM length. */
-static int IsLengthAllowed(int len)
-{
-    return len == 0x2800 || len == 0x4000 || len == 0x0800 || len == 0x2000;
-}
-
 /* Clears the unset flag for a given ROM ID. */
 static void ClearUnsetFlag(int id)
 {
@@ -380,25 +420,12 @@ int SYSROM_SetPath(char const *filename, int num, ...)
 {
     va_list ap;
     int len;
+    int altirra;
     ULONG crc;
-    int retval = SYSROM_OK;
-    FILE *f = fopen(filename, "rb");
+    int retval = GetFileCRC(filename, &len, &crc, &altirra);
 
-    if (f == NULL)
-        return SYSROM_ERROR;
-
-    len = Util_flen(f);
-    /* Don't proceed to CRC computation if the file has invalid size. */
-    if (!IsLengthAllowed(len)) {
-        fclose(f);
-        return SYSROM_BADSIZE;
-    }
-    Util_rewind(f);
-    if (!CRC32_FromFile(f, &crc)) {
-        fclose(f);
-        return SYSROM_ERROR;
-    }
-    fclose(f);
+    if (retval != SYSROM_OK)
+        return retval;
 
     va_start(ap, num);
     while (num > 0) {
@@ -473,30 +500,17 @@ int SYSROM_FindInDir(char const *directory, int only_if_not_set)
 
     while ((entry = readdir(dir)) != NULL) {
         char full_filename[FILENAME_MAX];
-        FILE *file;
         int len;
         int id;
+        int altirra;
         ULONG crc;
         int matched_crc = FALSE;
         Util_catpath(full_filename, directory, entry->d_name);
-        if ((file = fopen(full_filename, "rb")) == NULL)
-            /* Ignore non-readable files (e.g. directories). */
+        /* Ignore non-readable files (e.g. directories) and files of
+           invalid size. */
+        if (GetFileCRC(full_filename, &len, &crc, &altirra) != SYSROM_OK)
             continue;
 
-        len = Util_flen(file);
-        /* Don't proceed to CRC computation if the file has invalid size. */
-        if (!IsLengthAllowed(len)){
-            fclose(file);
-            continue;
-        }
-        Util_rewind(file);
-
-        if (!CRC32_FromFile(file, &crc)) {
-            fclose(file);
-            continue;
-        }
-        fclose(file);
-
         /* Match ROM image by CRC. */
         for (id = 0; id < SYSROM_LOADABLE_SIZE; ++id) {
             if ((!only_if_not_set || SYSROM_roms[id].unset)
@@ -526,6 +540,7 @@ int SYSROM_FindInDir(char const *directory, int only_if_not_set)
     }
 
     closedir(dir);
+    ROMCACHE_Save();
     return TRUE;
 }
 
@@ -895,6 +910,8 @@ int SYSROM_Initialise(int *argc, char *argv[])
     }
     *argc = j;
 
+    /* Paths set from the config file and the command line. */
+    ROMCACHE_Save();
     return TRUE;
 }
 #endif
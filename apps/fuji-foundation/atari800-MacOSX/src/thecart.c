@@ -26,6 +26,11 @@ static int   TheCartConfigLock;
 static UBYTE TheCartRegs[9];
 static int   CartBank;
 static int   CartBank2;
+static int   MappedBank;
+static int   MappedBank2;
+static UBYTE MappedReg7;
+static int   MappedBankMode;
+static int   MapStale = TRUE;
 static UBYTE CARTRAM[524288];
 static int CartSize;
 static int CartSizeMask;
@@ -52,7 +57,7 @@ static int THECART_Is_Dirty(void);
 static void  THECART_Cold_Reset(void);
 static UBYTE THECART_Read_Byte(UWORD address);
 static void  THECART_Write_Byte(UWORD address, UBYTE value);
-static void THECART_Map_Cart(void);
+static void THECART_Map_Cart(int force);
 static UWORD Read_Unaligned_LEU16(const void *p) { return *(UWORD *)p; }
 static void  Write_Unaligned_LEU16(void *p, UWORD v) { *(UWORD *)p = v; }
 
@@ -94,6 +99,7 @@ void THECART_Init(CARTRIDGE_image_t *cart) {
             flash = Flash_Init(Cart->image, Flash_TypeS29GL01P);
             break;
     }
+    Flash_Track_Dirty(flash, CARTRIDGE_DirtyBlocks(Cart), 0);
 
     EEPROM_Init();
 }
@@ -630,8 +636,17 @@ static void Set_Cart_Banks(int bank, int bank2) {
     //THECART_Map_Cart();
 }
 
-static void THECART_Map_Cart()
+static void THECART_Map_Cart(int force)
 {
+    if (!force && !MapStale && CartBank == MappedBank && CartBank2 == MappedBank2
+        && TheCartRegs[7] == MappedReg7 && TheCartBankMode == MappedBankMode)
+        return;
+    MappedBank = CartBank;
+    MappedBank2 = CartBank2;
+    MappedReg7 = TheCartRegs[7];
+    MappedBankMode = TheCartBankMode;
+    MapStale = FALSE;
+
     if (CartBank < 0) {
         Bank1_Base = 0;
         Bank1_End = 0;
@@ -773,6 +788,7 @@ static void THECART_Flash_Write(UWORD addr, UBYTE value) {
     if (writeEnable) {
         if (Flash_Write_Byte(flash, fullAddr, value)) {
             Cart->dirty = TRUE;
+            MapStale = TRUE;
         }
     }
 }
@@ -63,6 +63,9 @@ static UBYTE pbi_ram[0x1000];
 static void *rtc;
 static FlashEmu *flash;
 static int rom_dirty = FALSE;
+/* Flash blocks of ultimate_rom changed since it matched rom_dirty_file. */
+static UBYTE rom_dirty_blocks[UTIL_DIRTY_MAP_SIZE(0x80000)];
+static char rom_dirty_file[FILENAME_MAX];
 
 void CreateWindowCaption(void);
 static void Select_PBI_Device(int enable);
@@ -76,6 +79,7 @@ static void Update_Kernel_Bank(void);
 static void LoadNVRAM();
 static void SaveNVRAM();
 static void Update_Cart_Layers();
+static void rom_matches_file(const char *filename);
 
 #ifdef ATARI800MACX
 void init_ultimate(void)
@@ -88,16 +92,19 @@ static void init_ultimate(void)
         ULTIMATE_enabled = FALSE;
         Log_print("Couldn't load Ultimate1MB ROM image");
         ULTIMATE_have_rom = FALSE;
+        rom_matches_file("");
         return;
     }
     else {
         Log_print("loaded Ultimate1MB rom image");
         ULTIMATE_have_rom = TRUE;
+        rom_matches_file(ultimate_rom_filename);
     }
     if (ULTIMATE_Flash_Type == 0)
         flash = Flash_Init(ultimate_rom, Flash_TypeAm29F040B);
     else
         flash = Flash_Init(ultimate_rom, Flash_TypeSST39SF040);
+    Flash_Track_Dirty(flash, rom_dirty_blocks, 0);
 }
 
 int ULTIMATE_Initialise(int *argc, char *argv[])
@@ -369,8 +376,10 @@ int ULTIMATE_Change_Rom(char *filename, int new) {
     romLoaded = Atari800_LoadImage(filename, ultimate_rom, 0x80000);
     if (!romLoaded) {
         ULTIMATE_have_rom = FALSE;
+        rom_matches_file("");
     } else {
         ULTIMATE_have_rom = TRUE;
+        rom_matches_file(filename);
         if (new)
             strcpy(ultimate_rom_filename, filename);
         strcpy(ultimate_nvram_filename, ultimate_rom_filename);
@@ -382,20 +391,33 @@ int ULTIMATE_Change_Rom(char *filename, int new) {
                 flash = Flash_Init(ultimate_rom, Flash_TypeAm29F040B);
             else
                 flash = Flash_Init(ultimate_rom, Flash_TypeSST39SF040);
+            Flash_Track_Dirty(flash, rom_dirty_blocks, 0);
         }
     }
 
     return romLoaded;
 }
 
+static void rom_matches_file(const char *filename)
+{
+    strcpy(rom_dirty_file, filename);
+    memset(rom_dirty_blocks, 0, sizeof(rom_dirty_blocks));
+}
+
 int ULTIMATE_Save_Rom(char *filename)
 {
     FILE *f;
 
+    /* Over the image's own file only the flash blocks that changed are written. */
+    if (strcmp(filename, rom_dirty_file) == 0
+        && Util_writeback(filename, 0, ultimate_rom, 0x80000, rom_dirty_blocks) >= 0)
+        return 0;
+
     f = fopen(filename, "wb");
     if (f != NULL) {
         fwrite(ultimate_rom, 1, 0x80000, f);
         fclose(f);
+        rom_matches_file(filename);
         return 0;
     } else {
         return -1;
@@ -479,7 +501,7 @@ static void Update_Kernel_Bank(void)
     memcpy(MEMORY_os, ultimate_rom + kernelbase, 0x4000);
     memcpy(MEMORY_mem + 0xc000, ultimate_rom + kernelbase, 0x4000);
     if (MEMORY_selftest_enabled)
-        memcpy(MEMORY_mem + 0x5000, ultimate_rom + kernelbase + 0x1000, 0x800);
+        memcpy(MEMORY_cpu_map[0x50], ultimate_rom + kernelbase + 0x1000, 0x800);
     memcpy(MEMORY_basic, ultimate_rom + basicbase, 0x2000);
 
     memcpy(MEMORY_xegame, ultimate_rom + gamebase, 0x2000);
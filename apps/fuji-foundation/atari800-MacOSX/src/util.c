@@ -37,6 +37,11 @@
 #ifdef HAVE_SYS_STAT_H
 #include <sys/stat.h>
 #endif
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #ifdef HAVE_WINDOWS_H
 #include <windows.h>
 #endif
@@ -422,6 +427,87 @@ int Util_flen(FILE *fp)
 	return (int) ftell(fp);
 }
 
+#ifdef HAVE_MMAP
+
+void *Util_mapfile(const char *filename, size_t offset, size_t size)
+{
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	size_t skip = offset % page;
+	struct stat st;
+	void *ptr;
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	/* Touching a page past the end of the file raises SIGBUS. */
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < offset + size) {
+		close(fd);
+		return NULL;
+	}
+	ptr = mmap(NULL, skip + size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset - skip);
+	close(fd);
+	if (ptr == MAP_FAILED)
+		return NULL;
+	return (char *) ptr + skip;
+}
+
+void Util_unmapfile(void *ptr, size_t offset, size_t size)
+{
+	size_t skip = offset % (size_t) sysconf(_SC_PAGESIZE);
+	munmap((char *) ptr - skip, skip + size);
+}
+
+#else
+
+void *Util_mapfile(const char *filename, size_t offset, size_t size)
+{
+	return NULL;
+}
+
+void Util_unmapfile(void *ptr, size_t offset, size_t size)
+{
+}
+
+#endif /* HAVE_MMAP */
+
+void Util_markdirty(UBYTE *dirty, size_t offset, size_t size)
+{
+	size_t block;
+	if (size == 0)
+		return;
+	for (block = offset / UTIL_DIRTY_BLOCK; block <= (offset + size - 1) / UTIL_DIRTY_BLOCK; block++)
+		dirty[block >> 3] |= 1 << (block & 7);
+}
+
+int Util_writeback(const char *filename, size_t offset, const void *data, size_t size, UBYTE *dirty)
+{
+	const UBYTE *p = (const UBYTE *) data;
+	size_t block;
+	int written = 0;
+	FILE *fp = fopen(filename, "r+b");
+	if (fp == NULL)
+		return -1;
+	if ((size_t) Util_flen(fp) != offset + size) {
+		fclose(fp);
+		return -1;
+	}
+	for (block = 0; block * UTIL_DIRTY_BLOCK < size; block++) {
+		size_t pos = block * UTIL_DIRTY_BLOCK;
+		size_t len = size - pos < UTIL_DIRTY_BLOCK ? size - pos : UTIL_DIRTY_BLOCK;
+		if (!UTIL_DIRTY_BLOCK_SET(dirty, block))
+			continue;
+		if (fseek(fp, (long) (offset + pos), SEEK_SET) != 0 || fwrite(p + pos, 1, len, fp) != len) {
+			fclose(fp);
+			return -1;
+		}
+		written++;
+	}
+	/* Only forget the changes once they are known to be on disk. */
+	if (fclose(fp) != 0)
+		return -1;
+	memset(dirty, 0, UTIL_DIRTY_MAP_SIZE(size));
+	return written;
+}
+
 /* Creates a file that does not exist and fills in filename with its name.
    filename must point to FILENAME_MAX characters buffer which doesn't need
    to be initialized. */
@@ -158,6 +158,33 @@ int Util_direxists(const char *filename);
    May change the current position. */
 int Util_flen(FILE *fp);
 
+/* Maps SIZE bytes of FILENAME starting at OFFSET as private copy-on-write
+   memory, so pages are read in on first access and only pages that are
+   written to take up anonymous memory. Returns NULL if the file is too short
+   or mapping is unavailable; the caller should then fall back to fread(). */
+void *Util_mapfile(const char *filename, size_t offset, size_t size);
+
+/* Releases a mapping returned by Util_mapfile() with the same OFFSET and SIZE. */
+void Util_unmapfile(void *ptr, size_t offset, size_t size);
+
+/* Dirty block maps record which 4 KB blocks of an in-memory image changed
+   since it last matched its file, one bit per block. */
+#define UTIL_DIRTY_BLOCK 4096
+/* Bytes needed for the dirty block map of a SIZE-byte image. */
+#define UTIL_DIRTY_MAP_SIZE(size) (((size) + UTIL_DIRTY_BLOCK * 8 - 1) / (UTIL_DIRTY_BLOCK * 8))
+#define UTIL_DIRTY_BLOCK_SET(dirty, block) ((dirty)[(block) >> 3] & (1 << ((block) & 7)))
+
+/* Marks the blocks covering SIZE bytes at OFFSET of the image as changed. */
+void Util_markdirty(UBYTE *dirty, size_t offset, size_t size);
+
+/* Updates SIZE bytes at OFFSET of the existing file FILENAME in place,
+   writing only the blocks of DATA marked in DIRTY and then clearing DIRTY.
+   DIRTY must record every change since DATA last matched this file.
+   Returns the number of blocks written, or -1 if the file does not exist,
+   is not exactly OFFSET + SIZE bytes long or could not be written; the
+   caller should then write the file in full. */
+int Util_writeback(const char *filename, size_t offset, const void *data, size_t size, UBYTE *dirty);
+
 /* Deletes a file, returns 0 on success, -1 on failure. */
 #ifdef HAVE_WINDOWS_H
 int Util_unlink(const char *filename);
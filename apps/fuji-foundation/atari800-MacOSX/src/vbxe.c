@@ -120,6 +120,38 @@ static uint32_t vbxe_palette[VBXE_PALETTE_SIZE];
 /* Overlay framebuffer — BGRA8 pixels (same format as MetalFrameBuffer). */
 static uint32_t vbxe_overlay[VBXE_MAX_WIDTH * VBXE_MAX_HEIGHT];
 
+/*
+ * Incremental rendering state.
+ *
+ * VRAM writes (MEMAC and blitter) set a bit per 256-byte page.  Each overlay
+ * line remembers the XDL mode and bitmap pointer it was last rendered from;
+ * VBXE_RenderFrame() only redraws a line when that entry changed, one of its
+ * source pages was written, or the palette changed.  The dirty bits are
+ * cleared once per frame.
+ */
+#define VBXE_DIRTY_PAGE_SHIFT  8
+#define VBXE_DIRTY_PAGES       (VBXE_VRAM_SIZE >> VBXE_DIRTY_PAGE_SHIFT)
+#define VBXE_MARK_DIRTY(off) \
+    (vbxe_vram_dirty[(off) >> (VBXE_DIRTY_PAGE_SHIFT + 5)] |= 1u << (((off) >> VBXE_DIRTY_PAGE_SHIFT) & 31))
+
+static uint32_t vbxe_vram_dirty[VBXE_DIRTY_PAGES / 32];
+
+typedef struct {
+    uint32_t bmap_ptr;  /* VRAM address of the line's bitmap data */
+    uint8_t  mode;      /* bmap_ctl the line was rendered with */
+    uint8_t  valid;     /* 0 forces a redraw */
+    uint8_t  opaque;    /* line has at least one non-transparent pixel */
+} vbxe_line_t;
+
+static vbxe_line_t vbxe_lines[VBXE_MAX_HEIGHT];
+
+/* Register palette or palette base changed since the last rebuild. */
+static int      vbxe_palette_dirty = 1;
+
+/* Compositor dst x → overlay x, rebuilt when the screen width changes. */
+static uint16_t vbxe_xmap[VBXE_MAX_WIDTH];
+static int      vbxe_xmap_width = 0;
+
 /* Snapshot of GTIA color registers (indices 0x12–0x1A into this array). */
 static uint8_t  vbxe_gtia_colors[32];
 
@@ -162,6 +194,34 @@ static inline uint8_t expand7to8(uint8_t v7) {
     return (uint8_t)((v7 << 1) | (v7 >> 6));
 }
 
+/* =========================================================================
+ * Helpers: VRAM page dirty bits
+ * ====================================================================== */
+static void vbxe_mark_vram_dirty(uint32_t addr, uint32_t len) {
+    uint32_t page, last;
+    if (len == 0 || addr >= VBXE_VRAM_SIZE) return;
+    if (len > VBXE_VRAM_SIZE - addr) len = VBXE_VRAM_SIZE - addr;
+    last = (addr + len - 1) >> VBXE_DIRTY_PAGE_SHIFT;
+    for (page = addr >> VBXE_DIRTY_PAGE_SHIFT; page <= last; page++)
+        vbxe_vram_dirty[page >> 5] |= 1u << (page & 31);
+}
+
+static int vbxe_vram_range_dirty(uint32_t addr, uint32_t len) {
+    uint32_t page, last;
+    if (len == 0 || addr >= VBXE_VRAM_SIZE) return 0;
+    if (len > VBXE_VRAM_SIZE - addr) len = VBXE_VRAM_SIZE - addr;
+    last = (addr + len - 1) >> VBXE_DIRTY_PAGE_SHIFT;
+    for (page = addr >> VBXE_DIRTY_PAGE_SHIFT; page <= last; page++)
+        if (vbxe_vram_dirty[page >> 5] & (1u << (page & 31)))
+            return 1;
+    return 0;
+}
+
+/* Forget every rendered line; the overlay buffer itself must be transparent. */
+static void vbxe_reset_lines(void) {
+    memset(vbxe_lines, 0, sizeof(vbxe_lines));
+}
+
 /* =========================================================================
  * Helper: convert 7-bit R/G/B components to a BGRA8Unorm uint32_t
  * (Metal BGRA8Unorm: stored in memory as B,G,R,A — as uint32_t little-endian
@@ -228,7 +288,105 @@ static void vbxe_build_palette(void) {
  *  5 = MOVE  : dst[i] = src_a[i]  (like copy but overlapping-safe direction)
  *  6 = STENCIL: if(src_b[i] != 0) dst[i] = src_a[i]
  *  7 = ADD   : dst[i] = saturating_add(src_a[i], src_b[i])
+ *
+ * Each op (and its Z-enable variant, which leaves dst untouched where the
+ * result is 0) has its own row kernel.  The kernels are plain loops with no
+ * per-byte branching on op or bounds, so the compiler vectorises them; rows
+ * are clipped to VRAM before the kernel runs.
  */
+
+typedef void (*vbxe_row_fn)(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill);
+
+/* Source bytes past the end of VRAM read as 0. */
+static const uint8_t vbxe_zero_row[0x1000];
+
+static void blt_copy(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    /* The blitter copies upwards byte by byte, so a destination just above
+     * its source repeats the source pattern; memmove would not. */
+    if ((uintptr_t)d > (uintptr_t)s && (uintptr_t)d < (uintptr_t)s + n) {
+        for (i = 0; i < n; i++)
+            d[i] = s[i];
+    } else {
+        memmove(d, s, n);
+    }
+}
+
+static void blt_fill(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    (void)s;
+    memset(d, fill, n);
+}
+
+static void blt_fill_z(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    (void)s;
+    if (fill != 0)
+        memset(d, fill, n);
+}
+
+static void blt_or(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++)
+        d[i] |= s[i];
+}
+
+static void blt_and(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++)
+        d[i] &= s[i];
+}
+
+static void blt_and_z(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++) {
+        uint8_t r = d[i] & s[i];
+        d[i] = r ? r : d[i];
+    }
+}
+
+static void blt_xor(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++)
+        d[i] ^= s[i];
+}
+
+static void blt_xor_z(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++) {
+        uint8_t r = d[i] ^ s[i];
+        d[i] = r ? r : d[i];
+    }
+}
+
+/* Also COPY/MOVE with Z-enable: only non-zero source bytes are written. */
+static void blt_stencil(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++)
+        d[i] = s[i] ? s[i] : d[i];
+}
+
+static void blt_add(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t fill) {
+    uint32_t i;
+    (void)fill;
+    for (i = 0; i < n; i++) {
+        unsigned sum = (unsigned)d[i] + s[i];
+        d[i] = (uint8_t)(sum > 255 ? 255 : sum);
+    }
+}
+
+/* [z_enable][op]. With Z-enable, OR, STENCIL and ADD only give 0 where dst
+ * was already 0, so they share the plain kernels. */
+static const vbxe_row_fn vbxe_row_kernels[2][8] = {
+    { blt_copy,    blt_fill,   blt_or, blt_and,   blt_xor,   blt_copy,    blt_stencil, blt_add },
+    { blt_stencil, blt_fill_z, blt_or, blt_and_z, blt_xor_z, blt_stencil, blt_stencil, blt_add }
+};
+
 static void vbxe_do_blit(void) {
     uint32_t src_a  = ((uint32_t)(vbxe_regs[0x22] & 0x07) << 16)
                     | ((uint32_t) vbxe_regs[0x21]          << 8)
@@ -297,35 +455,35 @@ static void vbxe_do_blit(void) {
     if (src_a >= VBXE_VRAM_SIZE && op != 1 /* FILL */) return;
     if (dst   >= VBXE_VRAM_SIZE) return;
 
+    vbxe_row_fn kernel = vbxe_row_kernels[z_enable][op];
     uint32_t src_row  = src_a;
     uint32_t dst_row  = dst;
     uint16_t y;
 
     for (y = 0; y < height; y++) {
-        uint32_t sp = src_row;
-        uint32_t dp = dst_row;
-        uint16_t x;
-        for (x = 0; x < width; x++) {
-            if (dp >= VBXE_VRAM_SIZE) break;
-            uint8_t sv = (sp < VBXE_VRAM_SIZE) ? vbxe_vram[sp] : 0;
-            uint8_t dv = vbxe_vram[dp];
-            uint8_t result;
-            switch (op) {
-                default:
-                case 0: /* COPY    */ result = sv;                               break;
-                case 1: /* FILL    */ result = fill_byte;                        break;
-                case 2: /* OR      */ result = sv | dv;                          break;
-                case 3: /* AND     */ result = sv & dv;                          break;
-                case 4: /* XOR     */ result = sv ^ dv;                          break;
-                case 5: /* MOVE    */ result = sv;                               break;
-                case 6: /* STENCIL */ result = (sv != 0) ? sv : dv;             break;
-                case 7: /* ADD     */ result = (uint8_t)((sv + dv > 255) ? 255
-                                                : (uint8_t)(sv + dv));           break;
+        if (dst_row < VBXE_VRAM_SIZE) {
+            /* Clip the row to VRAM and split it where the source leaves
+             * VRAM (reads as zeros) or wraps back to address 0. */
+            uint32_t n = width;
+            uint32_t done = 0;
+            uint32_t sp = src_row;
+            if (n > VBXE_VRAM_SIZE - dst_row)
+                n = VBXE_VRAM_SIZE - dst_row;
+            while (done < n) {
+                uint32_t len = n - done;
+                if (sp < VBXE_VRAM_SIZE) {
+                    if (len > VBXE_VRAM_SIZE - sp)
+                        len = VBXE_VRAM_SIZE - sp;
+                    kernel(vbxe_vram + dst_row + done, vbxe_vram + sp, len, fill_byte);
+                } else {
+                    if (len > 0u - sp)
+                        len = 0u - sp;
+                    kernel(vbxe_vram + dst_row + done, vbxe_zero_row, len, fill_byte);
+                }
+                done += len;
+                sp += len;
             }
-            if (!z_enable || result != 0)
-                vbxe_vram[dp] = result;
-            sp++;
-            dp++;
+            vbxe_mark_vram_dirty(dst_row, n);
         }
         /* Advance rows */
         src_row = (uint32_t)((int32_t)src_row + src_step);
@@ -380,11 +538,18 @@ void VBXE_RegisterPutByte(UWORD addr, UBYTE value) {
             /* bit7 = XDL enable; other bits reserved in FX 1.26 */
             break;
 
+        /* --- XDL base ($0D-$0F): also the VRAM palette base --- */
+        case 0x0D:
+        case 0x0E:
+        case 0x0F:
+            vbxe_palette_dirty = 1;
+            break;
+
         /* --- Palette ($40-$BF): 3 bytes per entry, entries 0-127 --- */
-        /* Any write in that range triggers a palette rebuild */
+        /* Rebuilt once by the next VBXE_RenderFrame() */
         default:
             if (reg >= 0x40 && reg <= 0xBF) {
-                vbxe_build_palette();
+                vbxe_palette_dirty = 1;
             }
             break;
 
@@ -449,14 +614,16 @@ void VBXE_MEMACPutByte(UWORD addr, UBYTE value) {
         uint32_t offset = memac_a_vram_base + (uint32_t)(addr - ((uint16_t)memac_a_page_hi << 8));
         if (offset < VBXE_VRAM_SIZE) {
             vbxe_vram[offset] = value;
-            /* If the write falls in the palette range, rebuild palette */
-            /* (Programs write palette VRAM directly — future: hook palette range) */
+            VBXE_MARK_DIRTY(offset);
         }
         return;
     }
     if (memac_b_installed && page >= memac_b_page_hi && page < (uint8_t)(memac_b_page_hi + 16)) {
         uint32_t offset = memac_b_vram_base + (uint32_t)(addr - ((uint16_t)memac_b_page_hi << 8));
-        if (offset < VBXE_VRAM_SIZE) vbxe_vram[offset] = value;
+        if (offset < VBXE_VRAM_SIZE) {
+            vbxe_vram[offset] = value;
+            VBXE_MARK_DIRTY(offset);
+        }
         return;
     }
 }
@@ -574,115 +741,159 @@ void VBXE_SetGTIAColor(int reg_offset, UBYTE value) {
 /* Transparent pixel sentinel: alpha = 0 means "show GTIA pixel" */
 #define VBXE_TRANSPARENT   0x00000000u
 
+/* Render one overlay line from its XDL entry, unless the cached copy is
+ * still current. */
+static void vbxe_render_line(int line, uint8_t mode, uint32_t bmap_ptr) {
+    vbxe_line_t *lc      = &vbxe_lines[line];
+    uint32_t    *row_ptr = vbxe_overlay + (uint32_t)line * VBXE_MAX_WIDTH;
+    uint32_t     bytes   = (mode == 0) ? 0 : (mode == 1) ? 160 : 320;
+    uint32_t     opaque  = 0;
+    int          x, out  = 0;
+
+    if (mode == 0)
+        bmap_ptr = 0;
+    if (lc->valid && lc->mode == mode && lc->bmap_ptr == bmap_ptr
+        && !vbxe_vram_range_dirty(bmap_ptr, bytes))
+        return;
+
+    if (bmap_ptr + bytes > VBXE_VRAM_SIZE)
+        bytes = VBXE_VRAM_SIZE - bmap_ptr;
+
+    /* Index 0 is always transparent */
+    switch (mode) {
+        case 0:
+            /* Transparent line */
+            break;
+
+        case 1:
+            /* LR: 160 pixels wide, 1 byte per pixel, each pixel 4 wide. */
+            for (x = 0; x < (int)bytes; x++) {
+                uint8_t  idx = vbxe_vram[bmap_ptr + (uint32_t)x];
+                uint32_t pix = (idx == 0) ? VBXE_TRANSPARENT : vbxe_palette[idx];
+                opaque |= idx;
+                row_ptr[out + 0] = pix;
+                row_ptr[out + 1] = pix;
+                row_ptr[out + 2] = pix;
+                row_ptr[out + 3] = pix;
+                out += 4;
+            }
+            break;
+
+        case 2:
+            /* SR: 320 pixels wide, 1 byte per pixel, each pixel doubled. */
+            for (x = 0; x < (int)bytes; x++) {
+                uint8_t  idx = vbxe_vram[bmap_ptr + (uint32_t)x];
+                uint32_t pix = (idx == 0) ? VBXE_TRANSPARENT : vbxe_palette[idx];
+                opaque |= idx;
+                row_ptr[out + 0] = pix;
+                row_ptr[out + 1] = pix;
+                out += 2;
+            }
+            break;
+
+        case 3:
+            /* HR: 640 pixels wide, 4 bits per pixel (high nibble first),
+             * using the lower 16 palette entries. */
+            for (x = 0; x < (int)bytes; x++) {
+                uint8_t byte = vbxe_vram[bmap_ptr + (uint32_t)x];
+                uint8_t hi   = (byte >> 4) & 0x0F;
+                uint8_t lo   =  byte       & 0x0F;
+                opaque |= byte;
+                row_ptr[out + 0] = (hi == 0) ? VBXE_TRANSPARENT : vbxe_palette[hi];
+                row_ptr[out + 1] = (lo == 0) ? VBXE_TRANSPARENT : vbxe_palette[lo];
+                out += 2;
+            }
+            break;
+    }
+    /* Past the bitmap (or past the end of VRAM) the line is transparent.
+     * A line that was transparent before needs no clearing. */
+    if (lc->opaque || !lc->valid)
+        for (x = out; x < VBXE_MAX_WIDTH; x++) row_ptr[x] = VBXE_TRANSPARENT;
+
+    lc->bmap_ptr = bmap_ptr;
+    lc->mode     = mode;
+    lc->valid    = 1;
+    lc->opaque   = opaque != 0;
+}
+
+/* Rebuild the palette if its registers or VRAM copy changed; returns
+ * non-zero if any entry differs from before. */
+static int vbxe_refresh_palette(void) {
+    uint32_t pal_vram = ((uint32_t)(vbxe_regs[0x0F] & 0x07) << 16)
+                      | ((uint32_t) vbxe_regs[0x0E]          << 8)
+                      | ((uint32_t) vbxe_regs[0x0D]);
+    uint32_t old[VBXE_PALETTE_SIZE];
+
+    if (!vbxe_palette_dirty && !vbxe_vram_range_dirty(pal_vram, 128 * 3))
+        return 0;
+    vbxe_palette_dirty = 0;
+    memcpy(old, vbxe_palette, sizeof(old));
+    vbxe_build_palette();
+    return memcmp(old, vbxe_palette, sizeof(old)) != 0;
+}
+
 void VBXE_RenderFrame(void) {
     /* XDL base address (19-bit VRAM offset) */
     uint32_t xdl_addr = ((uint32_t)(vbxe_regs[0x0F] & 0x07) << 16)
                       | ((uint32_t) vbxe_regs[0x0E]          <<  8)
                       | ((uint32_t) vbxe_regs[0x0D]);
+    int line;
 
     /* XDLC: bit 7 = enable, bits 2:0 = VRAM 64KB segment for bitmap data */
     uint8_t xdlc = vbxe_regs[0x08];
     if (!(xdlc & 0x80)) {
-        /* XDL disabled — fill overlay with transparent */
-        int total = VBXE_MAX_WIDTH * VBXE_MAX_HEIGHT;
-        for (int i = 0; i < total; i++) vbxe_overlay[i] = VBXE_TRANSPARENT;
+        /* XDL disabled — clear whatever the overlay still shows */
+        for (line = 0; line < VBXE_MAX_HEIGHT; line++) {
+            if (vbxe_lines[line].opaque) {
+                uint32_t *rp = vbxe_overlay + (uint32_t)line * VBXE_MAX_WIDTH;
+                for (int x = 0; x < VBXE_MAX_WIDTH; x++) rp[x] = VBXE_TRANSPARENT;
+            }
+        }
+        vbxe_reset_lines();
+        memset(vbxe_vram_dirty, 0, sizeof(vbxe_vram_dirty));
         return;
     }
     uint32_t bmap_seg = (uint32_t)(xdlc & 0x07) << 16;  /* 64 KB segment base */
 
-    /* Rebuild palette from VRAM in case software loaded it via MEMAC */
-    vbxe_build_palette();
+    /* Pick up palette changes made through registers or MEMAC writes */
+    if (vbxe_refresh_palette()) {
+        for (line = 0; line < VBXE_MAX_HEIGHT; line++)
+            vbxe_lines[line].valid = 0;
+    }
 
-    int line;
     int max_lines = Screen_HEIGHT;   /* typically 240 */
     if (max_lines > VBXE_MAX_HEIGHT) max_lines = VBXE_MAX_HEIGHT;
 
+    /* The XDL itself is only 3 bytes per line, so it is re-read every frame
+     * and compared against each line's cached entry. */
+    int ended = 0;
     for (line = 0; line < max_lines; line++) {
-        uint32_t *row_ptr = vbxe_overlay + (uint32_t)line * VBXE_MAX_WIDTH;
-
-        /* Read 3-byte XDL entry */
-        if (xdl_addr + 2 >= VBXE_VRAM_SIZE) {
-            /* End of VRAM — fill rest transparent */
-            for (; line < max_lines; line++) {
-                uint32_t *rp = vbxe_overlay + (uint32_t)line * VBXE_MAX_WIDTH;
-                for (int x = 0; x < VBXE_MAX_WIDTH; x++) rp[x] = VBXE_TRANSPARENT;
+        uint8_t  mode     = 0;
+        uint32_t bmap_ptr = 0;
+
+        /* End of VRAM ends the list like an end-of-frame marker */
+        if (!ended && xdl_addr + 2 >= VBXE_VRAM_SIZE)
+            ended = 1;
+        if (!ended) {
+            uint8_t ctl   = vbxe_vram[xdl_addr + 0];
+            uint8_t ptr_l = vbxe_vram[xdl_addr + 1];
+            uint8_t ptr_h = vbxe_vram[xdl_addr + 2];
+            xdl_addr += 3;
+
+            if (ctl & 0x80) {
+                /* End-of-frame marker: remaining lines are transparent */
+                ended = 1;
+            } else {
+                mode = ctl & 0x03;
+                /* pri_ctl stored per-line but we handle it in VBXE_Composite() globally */
+                /* Bitmap VRAM pointer (16-bit within 64KB segment) */
+                bmap_ptr = bmap_seg | ((uint32_t)ptr_h << 8) | (uint32_t)ptr_l;
             }
-            break;
-        }
-
-        uint8_t ctl   = vbxe_vram[xdl_addr + 0];
-        uint8_t ptr_l = vbxe_vram[xdl_addr + 1];
-        uint8_t ptr_h = vbxe_vram[xdl_addr + 2];
-        xdl_addr += 3;
-
-        /* End-of-frame marker */
-        if (ctl & 0x80) {
-            /* Fill remaining lines transparent */
-            for (; line < max_lines; line++) {
-                uint32_t *rp = vbxe_overlay + (uint32_t)line * VBXE_MAX_WIDTH;
-                for (int x = 0; x < VBXE_MAX_WIDTH; x++) rp[x] = VBXE_TRANSPARENT;
-            }
-            break;
-        }
-
-        uint8_t bmap_ctl = ctl & 0x03;
-        /* pri_ctl stored per-line but we handle it in VBXE_Composite() globally */
-
-        /* Bitmap VRAM pointer (16-bit within 64KB segment) */
-        uint32_t bmap_ptr = bmap_seg | ((uint32_t)ptr_h << 8) | (uint32_t)ptr_l;
-
-        /* Render the line according to mode */
-        switch (bmap_ctl) {
-            case 0:
-                /* Transparent line */
-                for (int x = 0; x < VBXE_MAX_WIDTH; x++) row_ptr[x] = VBXE_TRANSPARENT;
-                break;
-
-            case 1:
-                /* LR: 160 pixels wide, 1 byte per pixel (palette index 0-255).
-                 * Each pixel is doubled horizontally to fill 320px of the 640px row,
-                 * then the remaining 320px are transparent. */
-                for (int x = 0; x < 160 && bmap_ptr + (uint32_t)x < VBXE_VRAM_SIZE; x++) {
-                    uint8_t  idx  = vbxe_vram[bmap_ptr + (uint32_t)x];
-                    uint32_t pix  = vbxe_palette[idx];
-                    /* Mark transparent if index is 0 and alpha is full — use palette alpha=0
-                     * convention: index 0 is always transparent in LR/SR mode */
-                    if (idx == 0) pix = VBXE_TRANSPARENT;
-                    row_ptr[x * 4 + 0] = pix;
-                    row_ptr[x * 4 + 1] = pix;
-                    row_ptr[x * 4 + 2] = pix;
-                    row_ptr[x * 4 + 3] = pix;
-                }
-                /* Fill right side transparent */
-                for (int x = 640; x < VBXE_MAX_WIDTH; x++) row_ptr[x] = VBXE_TRANSPARENT;
-                break;
-
-            case 2:
-                /* SR: 320 pixels wide, 1 byte per pixel.
-                 * Each pixel is doubled to fill 640px. */
-                for (int x = 0; x < 320 && bmap_ptr + (uint32_t)x < VBXE_VRAM_SIZE; x++) {
-                    uint8_t  idx  = vbxe_vram[bmap_ptr + (uint32_t)x];
-                    uint32_t pix  = (idx == 0) ? VBXE_TRANSPARENT : vbxe_palette[idx];
-                    row_ptr[x * 2 + 0] = pix;
-                    row_ptr[x * 2 + 1] = pix;
-                }
-                for (int x = 640; x < VBXE_MAX_WIDTH; x++) row_ptr[x] = VBXE_TRANSPARENT;
-                break;
-
-            case 3:
-                /* HR: 640 pixels wide, 4 bits per pixel (2 pixels per byte, high nibble first).
-                 * 320 bytes per line → 640 pixels. Uses the lower 16 palette entries. */
-                for (int x = 0; x < 320 && bmap_ptr + (uint32_t)x < VBXE_VRAM_SIZE; x++) {
-                    uint8_t  byte = vbxe_vram[bmap_ptr + (uint32_t)x];
-                    uint8_t  hi   = (byte >> 4) & 0x0F;
-                    uint8_t  lo   =  byte       & 0x0F;
-                    row_ptr[x * 2 + 0] = (hi == 0) ? VBXE_TRANSPARENT : vbxe_palette[hi];
-                    row_ptr[x * 2 + 1] = (lo == 0) ? VBXE_TRANSPARENT : vbxe_palette[lo];
-                }
-                for (int x = 640; x < VBXE_MAX_WIDTH; x++) row_ptr[x] = VBXE_TRANSPARENT;
-                break;
         }
+        vbxe_render_line(line, mode, bmap_ptr);
     }
+
+    memset(vbxe_vram_dirty, 0, sizeof(vbxe_vram_dirty));
 }
 
 /* =========================================================================
@@ -697,11 +908,12 @@ void VBXE_RenderFrame(void) {
  *   3 — OR blend: pixel = vbxe_pixel | gtia_pixel (per-byte)
  *
  * In all modes an overlay pixel with alpha == 0 (VBXE_TRANSPARENT) passes
- * through to the GTIA pixel.
+ * through to the GTIA pixel, so fully transparent lines are skipped.
  *
  * The overlay is rendered at VBXE_MAX_WIDTH (640) but the dst buffer is
  * screen_width pixels wide (typically 384 in standard mode).  We scale the
- * overlay horizontally by mapping overlay x-position proportionally.
+ * overlay horizontally through vbxe_xmap[], which maps each dst x to its
+ * proportional overlay x.
  * ====================================================================== */
 
 void VBXE_Composite(uint32_t *dst, int screen_width, int screen_height) {
@@ -712,43 +924,35 @@ void VBXE_Composite(uint32_t *dst, int screen_width, int screen_height) {
 
     if (screen_height > VBXE_MAX_HEIGHT) screen_height = VBXE_MAX_HEIGHT;
     if (screen_width  > VBXE_MAX_WIDTH)  screen_width  = VBXE_MAX_WIDTH;
+    if (screen_width <= 0) return;
+
+    if (screen_width != vbxe_xmap_width) {
+        for (int x = 0; x < screen_width; x++)
+            vbxe_xmap[x] = (uint16_t)((x * VBXE_MAX_WIDTH) / screen_width);
+        vbxe_xmap_width = screen_width;
+    }
 
     int y;
     for (y = 0; y < screen_height; y++) {
+        if (!vbxe_lines[y].opaque)
+            continue;
+
         const uint32_t *ov_row  = vbxe_overlay + (uint32_t)y * VBXE_MAX_WIDTH;
         uint32_t       *dst_row = dst + (uint32_t)y * (uint32_t)screen_width;
         int x;
-        for (x = 0; x < screen_width; x++) {
-            /* Map dst x → overlay x (scale from screen_width to VBXE_MAX_WIDTH) */
-            int ov_x = (x * VBXE_MAX_WIDTH) / screen_width;
-            if (ov_x >= VBXE_MAX_WIDTH) ov_x = VBXE_MAX_WIDTH - 1;
-
-            uint32_t ov_pix   = ov_row[ov_x];
-            uint32_t gtia_pix = dst_row[x];
-
-            if (ov_pix == VBXE_TRANSPARENT) {
-                /* Always pass GTIA through on transparent overlay pixel */
-                continue;
+        if (prio == 3) {
+            /* OR blend (per-channel) */
+            for (x = 0; x < screen_width; x++) {
+                uint32_t ov_pix = ov_row[vbxe_xmap[x]];
+                if (ov_pix != VBXE_TRANSPARENT)
+                    dst_row[x] = 0xFF000000u | ((ov_pix | dst_row[x]) & 0x00FFFFFFu);
             }
-
-            switch (prio) {
-                default:
-                case 1:
-                    /* VBXE pixel wins when opaque */
-                    dst_row[x] = ov_pix;
-                    break;
-                case 2:
-                    /* VBXE always wins */
+        } else {
+            /* 1 and 2: VBXE pixel wins when opaque */
+            for (x = 0; x < screen_width; x++) {
+                uint32_t ov_pix = ov_row[vbxe_xmap[x]];
+                if (ov_pix != VBXE_TRANSPARENT)
                     dst_row[x] = ov_pix;
-                    break;
-                case 3: {
-                    /* OR blend (per-channel) */
-                    uint32_t r = ((ov_pix >> 16) & 0xFF) | ((gtia_pix >> 16) & 0xFF);
-                    uint32_t g = ((ov_pix >>  8) & 0xFF) | ((gtia_pix >>  8) & 0xFF);
-                    uint32_t b = ( ov_pix        & 0xFF) | ( gtia_pix        & 0xFF);
-                    dst_row[x] = 0xFF000000u | (r << 16) | (g << 8) | b;
-                    break;
-                }
             }
         }
     }
@@ -764,6 +968,8 @@ void VBXE_Initialise(void) {
     memset(vbxe_palette,     0, sizeof(vbxe_palette));
     memset(vbxe_overlay,     0, sizeof(vbxe_overlay));
     memset(vbxe_gtia_colors, 0, sizeof(vbxe_gtia_colors));
+    memset(vbxe_vram_dirty,  0, sizeof(vbxe_vram_dirty));
+    vbxe_reset_lines();
 
     /* Default MEMAC windows: A at $4000, B at $6000 */
     memac_a_page_hi   = 0x40;
@@ -791,6 +997,7 @@ void VBXE_Exit(void) {
 void VBXE_ColdStart(void) {
     /* Cold reset: clear VRAM and all state */
     memset(vbxe_vram, 0, sizeof(vbxe_vram));
+    vbxe_mark_vram_dirty(0, VBXE_VRAM_SIZE);
     VBXE_WarmStart();
 }
 
@@ -821,7 +1028,9 @@ void VBXE_WarmStart(void) {
     }
 
     memset(vbxe_overlay, 0, sizeof(vbxe_overlay));
+    vbxe_reset_lines();
     vbxe_build_palette();
+    vbxe_palette_dirty = 0;
 }
 
 /* =========================================================================
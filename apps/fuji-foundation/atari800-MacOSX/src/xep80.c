@@ -25,6 +25,7 @@
 #ifdef XEP80_EMULATION
 #include "xep80.h"
 #include "xep80_fonts.h"
+#include "col80.h"
 #include "statesav.h"
 #include "atari.h"
 #include "antic.h"
@@ -102,8 +103,6 @@ int XEP80_enabled = FALSE;
 int XEP80_last_sent_count = 0;
 int XEP80_sent_count = 0;
 int XEP80_port = 0;
-int XEP80_first_row = XEP80_SCRN_HEIGHT - 1;
-int XEP80_last_row = 0;
 
 /* Local procedures */
 static void XEP80_InputWord(int word);
@@ -154,6 +153,7 @@ static void XEP80_ScrollUp(int y_start, int y_end);
 static void XEP80_FindEndLogicalLine(int *x, int *y);
 static void XEP80_FindStartLogicalLine(int *x, int *y);
 static void XEP80_BlitChar(int x, int y, int cur);
+static void XEP80_MarkCells(int screen_col, int y, int count);
 static void XEP80_BlitScreen(void);
 static void XEP80_BlitRows(int y_start, int y_end);
 static void XEP80_BlitGraphChar(int x, int y);
@@ -1578,11 +1578,6 @@ static void XEP80_BlitChar(int x, int y, int cur)
 		}
 	}
 
-	if (y*XEP80_CHAR_HEIGHT < XEP80_first_row)
-		XEP80_first_row = y*XEP80_CHAR_HEIGHT;
-	if (y*XEP80_CHAR_HEIGHT + XEP80_CHAR_HEIGHT - 1 > XEP80_last_row)
-		XEP80_last_row = y*XEP80_CHAR_HEIGHT + XEP80_CHAR_HEIGHT - 1;
-
     if (inverse_mode) {
         on = XEP80_FONTS_offcolor;
         off = XEP80_FONTS_oncolor;
@@ -1837,6 +1832,26 @@ static void XEP80_BlitChar(int x, int y, int cur)
 			}
 		}
     }
+
+	/* Double width characters cover the next cell too */
+	XEP80_MarkCells(screen_col, y, (font_double && (font_blank || !cur)) ? 2 : 1);
+}
+
+/* Marks cells just drawn for the display, noting those that differ between
+   the two blink phase screens. */
+static void XEP80_MarkCells(int screen_col, int y, int count)
+{
+	for (; count > 0 && screen_col < XEP80_LINE_LEN; count--, screen_col++) {
+		int offset = XEP80_SCRN_WIDTH * XEP80_CHAR_HEIGHT * y + screen_col * XEP80_CHAR_WIDTH;
+		int blinks = FALSE;
+		int font_row;
+
+		for (font_row = 0; font_row < XEP80_CHAR_HEIGHT && !blinks; font_row++) {
+			blinks = memcmp(&XEP80_screen_1[offset], &XEP80_screen_2[offset], XEP80_CHAR_WIDTH) != 0;
+			offset += XEP80_SCRN_WIDTH;
+		}
+		COL80_MarkCell(y, screen_col, blinks);
+	}
 }
 
 static void XEP80_BlitScreen(void)
@@ -1869,6 +1884,8 @@ static void XEP80_BlitGraphChar(int x, int y)
     UBYTE *to1,*to2;
     UBYTE ch;
     UBYTE on, off;
+	int pixel_x = x * 8 + XEP80_GRAPH_X_OFFSET;
+	int cell_y = (y + XEP80_GRAPH_Y_OFFSET) / XEP80_CHAR_HEIGHT;
 
     if (inverse_mode) {
         on = XEP80_FONTS_offcolor;
@@ -1879,10 +1896,9 @@ static void XEP80_BlitGraphChar(int x, int y)
         off = XEP80_FONTS_offcolor;
     }
 	
-	if (y + XEP80_GRAPH_Y_OFFSET < XEP80_first_row)
-		XEP80_first_row = y + XEP80_GRAPH_Y_OFFSET;
-	if (y + XEP80_GRAPH_Y_OFFSET > XEP80_last_row)
-		XEP80_last_row = y + XEP80_GRAPH_Y_OFFSET;
+	/* The 8 pixels span two text cells */
+	COL80_MarkCell(cell_y, pixel_x / XEP80_CHAR_WIDTH, FALSE);
+	COL80_MarkCell(cell_y, (pixel_x + 7) / XEP80_CHAR_WIDTH, FALSE);
 
     ch = xep80_graph_data[y][x];
 
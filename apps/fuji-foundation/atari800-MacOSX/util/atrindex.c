@@ -0,0 +1,562 @@
+/*
+ * atrindex.c - indexes the files on a library of Atari disk images
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* Walks directories of ATR, XFD, DCM and gzipped (ATZ, XFZ, .gz) disk
+   images, reads each one with the disk editor library of the Mac front end
+   and writes an index of every file on them. Linux only. Build and run from
+   this directory (-iquote keeps src/sched.h from hiding the system one):
+
+     cc -O2 -pthread -iquote ../src -iquote ../src/Atari800MacX -o atrindex atrindex.c \
+        ../src/Atari800MacX/atrMount.c ../src/Atari800MacX/atrUtil.c \
+        ../src/Atari800MacX/atrDos2.c ../src/Atari800MacX/atrDos3.c \
+        ../src/Atari800MacX/atrDos4.c ../src/Atari800MacX/atrMyDos.c \
+        ../src/Atari800MacX/atrSparta.c ../src/Atari800MacX/atrXE.c \
+        ../src/compfile.c ../src/crc32.c -lz
+     ./atrindex [-j threads] [-o index.txt] directory-or-image...
+
+   Images are mounted read-only and spread over a thread per CPU (or -j).
+   The index is plain text, one tab-separated line per entry, sorted by
+   image path so that it can be searched with grep and compared between
+   runs:
+
+     image  DOS  path  bytes  CRC32
+
+   Subdirectories are listed with a path ending in "/" and "-" for bytes
+   and CRC32. A file that can't be read has "-" for bytes and the reason
+   in brackets instead of the CRC32. An image without a recognised DOS has
+   a single line with an empty path, and one that can't be read at all has
+   "-" for the DOS and the reason in brackets as the path. */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "atari.h"
+#include "atrUtil.h"
+#include "atrMount.h"
+#include "atrErr.h"
+#include "afile.h"
+#include "compfile.h"
+#include "crc32.h"
+
+/* More than the entries of the largest directory any of the DOSes can
+   hold: a SpartaDOS directory of 1024 512-byte sectors. */
+#define MAX_DIR_ENTRIES 32768
+/* Subdirectories nested deeper than this are taken as a corrupted disk
+   pointing back at itself. */
+#define MAX_DIR_DEPTH 16
+
+/* compfile.c needs these from the emulator. */
+void *Util_malloc(size_t size)
+{
+	void *ptr = malloc(size);
+	if (ptr == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	return ptr;
+}
+
+void *Util_realloc(void *ptr, size_t size)
+{
+	ptr = realloc(ptr, size);
+	if (ptr == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	return ptr;
+}
+
+/* Its complaints about broken images are reported in the index instead. */
+void Log_print(char *format, ...)
+{
+}
+
+static char **images = NULL;
+static int image_count = 0;
+static int image_alloc = 0;
+
+/* Index text of each image, printed in order as soon as the images before
+   it are done, so memory holds only the images finished out of order. */
+static char **results;
+static int next_image = 0;
+static int next_output = 0;
+static FILE *output;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+	const char *image;
+	const char *dos;
+	AtrDiskInfo *info;
+	FILE *out;
+	/* Per-thread scratch file the library exports each file into */
+	FILE *export_file;
+	char export_path[64];
+	ADosFileEntry *dirs[MAX_DIR_DEPTH];
+} Job;
+
+static int has_extension(const char *name, const char *ext)
+{
+	size_t n = strlen(name);
+	size_t e = strlen(ext);
+	return n > e && strcasecmp(name + n - e, ext) == 0;
+}
+
+static int add_image(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+	if (type != FTW_F)
+		return 0;
+	if (!has_extension(path, ".atr") && !has_extension(path, ".xfd")
+	    && !has_extension(path, ".dcm") && !has_extension(path, ".atz")
+	    && !has_extension(path, ".xfz") && !has_extension(path, ".gz"))
+		return 0;
+	if (image_count == image_alloc) {
+		image_alloc = image_alloc ? image_alloc * 2 : 1024;
+		images = realloc(images, image_alloc * sizeof(char *));
+		if (images == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+	images[image_count++] = strdup(path);
+	return 0;
+}
+
+static int compare_paths(const void *a, const void *b)
+{
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+static const char *dos_name(int dosType)
+{
+	switch (dosType) {
+	case DOS_ATARI1:
+		return "Atari DOS 1";
+	case DOS_ATARI:
+		return "Atari DOS 2";
+	case DOS_ATARI3:
+		return "Atari DOS 3";
+	case DOS_ATARI4:
+		return "Atari DOS 4";
+	case DOS_ATARIXE:
+		return "Atari DOS XE";
+	case DOS_MYDOS:
+		return "MyDOS";
+	case DOS_SPARTA2:
+		return "SpartaDOS";
+	case DOS_TOP:
+		return "TopDOS";
+	case DOS_BIBO:
+		return "BiboDOS";
+	}
+	return "unknown";
+}
+
+static const char *error_text(int status)
+{
+	switch (status) {
+	case ADOS_NOT_A_ATR_IMAGE:
+		return "not a disk image";
+	case ADOS_UNKNOWN_FORMAT:
+		return "unknown format";
+	case ADOS_DISK_READ_ERR:
+		return "disk read error";
+	case ADOS_DIR_READ_ERR:
+		return "directory read error";
+	case ADOS_FILE_CORRUPTED:
+		return "file corrupted";
+	case ADOS_FILE_READ_ERR:
+		return "file read error";
+	case ADOS_FILE_NOT_FOUND:
+		return "file not found";
+	case ADOS_NOT_A_DIRECTORY:
+		return "not a directory";
+	case ADOS_MEM_ERR:
+		return "out of memory";
+	case ADOS_HOST_CREATE_ERR:
+	case ADOS_HOST_WRITE_ERR:
+		return "scratch file error";
+	}
+	return "error";
+}
+
+/* Prints a path from the image, which may hold any byte, without breaking
+   the line and column structure of the index. */
+static void put_field(FILE *fp, const char *s)
+{
+	for (; *s != '\0'; s++)
+		fputc(isprint((unsigned char) *s) ? *s : '?', fp);
+}
+
+/* Name as the DOS expects it in the export and change directory calls. */
+static void entry_name(const ADosFileEntry *entry, char *name)
+{
+	int i;
+	for (i = 0; i < 8 && entry->aname[i] != ' '; i++)
+		*name++ = entry->aname[i];
+	if (entry->aname[8] != ' ') {
+		*name++ = '.';
+		for (i = 8; i < 11 && entry->aname[i] != ' '; i++)
+			*name++ = entry->aname[i];
+	}
+	*name = '\0';
+}
+
+static void put_line(Job *job, const char *dir, const char *name)
+{
+	put_field(job->out, job->image);
+	fprintf(job->out, "\t%s\t", job->dos);
+	put_field(job->out, dir);
+	put_field(job->out, name);
+}
+
+static void index_file(Job *job, const char *dir, char *name)
+{
+	UBYTE data[0x4000];
+	ULONG crc = 0xffffffff;
+	long bytes = 0;
+	int fd = fileno(job->export_file);
+	int status;
+	int n;
+
+	put_line(job, dir, name);
+	status = AtrExportFile(job->info, name, job->export_path, FALSE, FALSE);
+	if (status) {
+		fprintf(job->out, "\t-\t[%s]\n", error_text(status));
+		return;
+	}
+	while ((n = pread(fd, data, sizeof(data), bytes)) > 0) {
+		crc = CRC32_Update(crc, data, n);
+		bytes += n;
+	}
+	fprintf(job->out, "\t%ld\t%08x\n", bytes, (unsigned) (crc ^ 0xffffffff));
+}
+
+static void index_dir(Job *job, const char *dir, int depth)
+{
+	ADosFileEntry *files;
+	UWORD fileCount;
+	ULONG freeBytes;
+	char name[13];
+	char *subdir;
+	int status;
+	int i;
+
+	if (depth >= MAX_DIR_DEPTH) {
+		put_line(job, dir, "");
+		fprintf(job->out, "\t-\t[directories nested too deep]\n");
+		return;
+	}
+	if (job->dirs[depth] == NULL) {
+		job->dirs[depth] = malloc(MAX_DIR_ENTRIES * sizeof(ADosFileEntry));
+		if (job->dirs[depth] == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+	files = job->dirs[depth];
+	status = AtrGetDir(job->info, &fileCount, files, &freeBytes);
+	if (status) {
+		put_line(job, dir, "");
+		fprintf(job->out, "\t-\t[%s]\n", error_text(status));
+		return;
+	}
+	for (i = 0; i < fileCount; i++) {
+		entry_name(&files[i], name);
+		if ((files[i].flags & DIRE_SUBDIR) && (job->info->atr_dostype == DOS_MYDOS
+		    || job->info->atr_dostype == DOS_SPARTA2 || job->info->atr_dostype == DOS_ATARIXE)) {
+			put_line(job, dir, name);
+			fprintf(job->out, "/\t-\t-\n");
+			subdir = malloc(strlen(dir) + strlen(name) + 2);
+			if (subdir == NULL) {
+				fprintf(stderr, "Out of memory\n");
+				exit(1);
+			}
+			/* before the library upper-cases NAME and cuts it at the dot */
+			sprintf(subdir, "%s%s/", dir, name);
+			if (AtrChangeDir(job->info, CD_NAME, name) == 0) {
+				index_dir(job, subdir, depth + 1);
+				AtrChangeDir(job->info, CD_UP, NULL);
+			}
+			free(subdir);
+		}
+		else
+			index_file(job, dir, name);
+	}
+}
+
+/* Writes an ATR header for a headerless XFD image of LENGTH bytes to OUT,
+   followed by the image, sized the way sio.c mounts XFDs. */
+static int xfd_to_atr(FILE *in, long length, FILE *out)
+{
+	struct AFILE_ATR_Header header;
+	ULONG paragraphs = length >> 4;
+	char buf[0x4000];
+	size_t n;
+
+	memset(&header, 0, sizeof(header));
+	header.magic1 = AFILE_ATR_MAGIC1;
+	header.magic2 = AFILE_ATR_MAGIC2;
+	header.secsizelo = length <= 1040 * 128 ? 128 : 0;
+	header.secsizehi = length <= 1040 * 128 ? 0 : 1;
+	header.seccountlo = paragraphs & 0xff;
+	header.seccounthi = (paragraphs >> 8) & 0xff;
+	header.hiseccountlo = (paragraphs >> 16) & 0xff;
+	header.hiseccounthi = (paragraphs >> 24) & 0xff;
+	if (fwrite(&header, 1, sizeof(header), out) != sizeof(header))
+		return FALSE;
+	while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+		if (fwrite(buf, 1, n, out) != n)
+			return FALSE;
+	return fflush(out) == 0;
+}
+
+/* Opens IMAGE as an ATR image, converting it into a scratch file if it is
+   in another format. Returns the path to mount, or NULL. */
+static const char *open_atr(const char *image, FILE **scratch, char *path)
+{
+	FILE *in;
+	FILE *tmp;
+	struct stat st;
+	int c;
+
+	*scratch = NULL;
+	in = fopen(image, "rb");
+	if (in == NULL)
+		return NULL;
+	c = fgetc(in);
+	if (c == AFILE_ATR_MAGIC1 && fgetc(in) == AFILE_ATR_MAGIC2) {
+		fclose(in);
+		return image;
+	}
+	rewind(in);
+	tmp = tmpfile();
+	if (tmp == NULL) {
+		fclose(in);
+		return NULL;
+	}
+	if (c == 0xf9 || c == 0xfa) {
+		if (!CompFile_DCMtoATR(in, tmp))
+			goto error;
+	}
+	else if (c == 0x1f) {
+		/* Gzipped ATR or XFD */
+		FILE *unzipped = tmpfile();
+		if (unzipped == NULL || !CompFile_ExtractGZ(image, unzipped)) {
+			if (unzipped != NULL)
+				fclose(unzipped);
+			goto error;
+		}
+		fclose(in);
+		in = unzipped;
+		rewind(in);
+		c = fgetc(in);
+		if (c == AFILE_ATR_MAGIC1 && fgetc(in) == AFILE_ATR_MAGIC2) {
+			fclose(tmp);
+			tmp = in;
+			in = NULL;
+		}
+		else {
+			fstat(fileno(in), &st);
+			rewind(in);
+			if (!xfd_to_atr(in, st.st_size, tmp))
+				goto error;
+		}
+	}
+	else {
+		fstat(fileno(in), &st);
+		if (!xfd_to_atr(in, st.st_size, tmp))
+			goto error;
+	}
+	if (in != NULL)
+		fclose(in);
+	fflush(tmp);
+	*scratch = tmp;
+	sprintf(path, "/proc/self/fd/%d", fileno(tmp));
+	return path;
+
+error:
+	fclose(in);
+	fclose(tmp);
+	return NULL;
+}
+
+static void index_image(Job *job, const char *image)
+{
+	char path[64];
+	const char *atr;
+	FILE *scratch;
+	int dosType;
+	int writeProtect;
+	int status;
+
+	job->image = image;
+	job->dos = "-";
+	atr = open_atr(image, &scratch, path);
+	if (atr == NULL) {
+		put_line(job, "", "");
+		fprintf(job->out, "[can't read image]\t-\t-\n");
+		return;
+	}
+	status = AtrMountReadOnly(atr, &dosType, &writeProtect, &job->info);
+	job->dos = dos_name(dosType);
+	if (status == ADOS_UNKNOWN_FORMAT) {
+		put_line(job, "", "");
+		fprintf(job->out, "\t-\t-\n");
+	}
+	else if (status) {
+		job->dos = "-";
+		put_line(job, "", "");
+		fprintf(job->out, "[%s]\t-\t-\n", error_text(status));
+	}
+	else
+		index_dir(job, "", 0);
+	if (job->info != NULL)
+		AtrUnmount(job->info);
+	job->info = NULL;
+	if (scratch != NULL)
+		fclose(scratch);
+}
+
+static void *worker(void *arg)
+{
+	Job job;
+	char *text;
+	size_t size;
+	int i;
+
+	memset(&job, 0, sizeof(job));
+	job.export_file = tmpfile();
+	if (job.export_file == NULL) {
+		perror("tmpfile");
+		exit(1);
+	}
+	sprintf(job.export_path, "/proc/self/fd/%d", fileno(job.export_file));
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		i = next_image++;
+		pthread_mutex_unlock(&lock);
+		if (i >= image_count)
+			break;
+
+		job.out = open_memstream(&text, &size);
+		if (job.out == NULL) {
+			perror("open_memstream");
+			exit(1);
+		}
+		index_image(&job, images[i]);
+		fclose(job.out);
+
+		pthread_mutex_lock(&lock);
+		results[i] = text;
+		while (next_output < image_count && results[next_output] != NULL) {
+			fputs(results[next_output], output);
+			free(results[next_output]);
+			results[next_output++] = NULL;
+		}
+		pthread_mutex_unlock(&lock);
+	}
+
+	for (i = 0; i < MAX_DIR_DEPTH; i++)
+		free(job.dirs[i]);
+	fclose(job.export_file);
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t *threads;
+	int thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+	const char *output_name = NULL;
+	int first;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			thread_count = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			output_name = argv[++i];
+		else
+			break;
+	}
+	if (i == argc || thread_count < 1) {
+		fprintf(stderr, "Usage: %s [-j threads] [-o index.txt] directory-or-image...\n", argv[0]);
+		return 1;
+	}
+	first = i;
+
+	for (i = first; i < argc; i++) {
+		if (nftw(argv[i], add_image, 64, FTW_PHYS) != 0) {
+			perror(argv[i]);
+			return 1;
+		}
+	}
+	qsort(images, image_count, sizeof(char *), compare_paths);
+
+	output = stdout;
+	if (output_name != NULL) {
+		output = fopen(output_name, "w");
+		if (output == NULL) {
+			perror(output_name);
+			return 1;
+		}
+	}
+	results = calloc(image_count + 1, sizeof(char *));
+	threads = malloc(thread_count * sizeof(pthread_t));
+	if (results == NULL || threads == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	/* crc32.c builds its tables on first use; do it before the threads. */
+	CRC32_Update(0, (const UBYTE *) "", 0);
+
+	for (i = 0; i < thread_count; i++) {
+		if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+			perror("pthread_create");
+			return 1;
+		}
+	}
+	for (i = 0; i < thread_count; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	free(results);
+	for (i = 0; i < image_count; i++)
+		free(images[i]);
+	free(images);
+
+	if (fclose(output) != 0) {
+		perror(output_name != NULL ? output_name : "stdout");
+		return 1;
+	}
+	fprintf(stderr, "%d images indexed\n", image_count);
+	return 0;
+}
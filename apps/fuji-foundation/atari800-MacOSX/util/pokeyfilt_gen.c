@@ -0,0 +1,131 @@
+/*
+ * pokeyfilt_gen.c - generates src/pokeyfilt_tables.c
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* Designs the mzpokeysnd resampling filters for common playback rates and
+   writes them as float tables that POKEYFILT_Get() finds without running
+   the Parks-McClellan design. Build and run from this directory:
+
+     cc -I../src -I../src/Atari800MacX -o pokeyfilt_gen pokeyfilt_gen.c \
+        ../src/pokeyfilt.c ../src/remez.c -lm
+     ./pokeyfilt_gen ../src/pokeyfilt_tables.c [rate[:quality]...]
+
+   Without rates, the tables are made for 11025, 22050, 44100 and
+   48000 Hz at quality 0, the only quality the SDL and Mac ports use. */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "log.h"
+#include "pokeyfilt.h"
+#include "util.h"
+
+/* Must match pokey_frq_ideal in mzpokeysnd.c. */
+#define POKEY_FRQ_IDEAL 1789790
+
+#define MAX_SIZE 2048
+
+/* remez.c needs these two from the emulator. */
+void *Util_malloc(size_t size)
+{
+	void *ptr = malloc(size);
+	if (ptr == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	return ptr;
+}
+
+void Log_print(char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+/* The tables don't exist yet while they are being generated. */
+const POKEYFILT_Table POKEYFILT_builtin[] = {
+	{0, 0, 0, 0, 0.0, NULL}
+};
+
+static const char * const default_rates[] = {
+	"11025", "22050", "44100", "48000", NULL
+};
+
+#define MAX_TABLES 64
+
+int main(int argc, char **argv)
+{
+	static double filter[MAX_SIZE];
+	static POKEYFILT_Table tables[MAX_TABLES];
+	const char * const *rates;
+	FILE *fp;
+	int n, i;
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s output.c [rate[:quality]...]\n", argv[0]);
+		return 1;
+	}
+	rates = argc > 2 ? (const char * const *) argv + 2 : default_rates;
+	fp = fopen(argv[1], "w");
+	if (fp == NULL) {
+		perror(argv[1]);
+		return 1;
+	}
+	fprintf(fp, "/* pokeyfilt_tables.c - generated by util/pokeyfilt_gen.c, do not edit */\n\n"
+	            "#include \"config.h\"\n"
+	            "#include <stdio.h>\n\n"
+	            "#include \"pokeyfilt.h\"\n");
+	for (n = 0; rates[n] != NULL && n < MAX_TABLES; n++) {
+		POKEYFILT_Table *t = &tables[n];
+		if (sscanf(rates[n], "%d:%d", &t->sample_rate, &t->quality) < 1 || t->sample_rate <= 0
+		    || t->quality < 0 || t->quality > POKEYFILT_MAX_QUALITY) {
+			fprintf(stderr, "%s: bad rate\n", rates[n]);
+			return 1;
+		}
+		t->pokey_frq = (int) ((double) POKEY_FRQ_IDEAL / t->sample_rate + 0.5) * t->sample_rate;
+		t->size = POKEYFILT_Design(filter, MAX_SIZE, t->sample_rate, t->pokey_frq, t->quality, &t->cutoff);
+		if (t->size == 0) {
+			fprintf(stderr, "%s: filter too long\n", rates[n]);
+			return 1;
+		}
+		fprintf(fp, "\nstatic const float filter_%d_%d[%d] = {", t->sample_rate, t->quality, t->size);
+		for (i = 0; i < t->size; i++)
+			fprintf(fp, "%s%.9g,", i % 6 == 0 ? "\n\t" : " ", filter[i]);
+		fprintf(fp, "\n};\n");
+	}
+	fprintf(fp, "\nconst POKEYFILT_Table POKEYFILT_builtin[] = {\n");
+	for (i = 0; i < n; i++) {
+		const POKEYFILT_Table *t = &tables[i];
+		fprintf(fp, "\t{%d, %d, %d, %d, %.17g, filter_%d_%d},\n", t->sample_rate, t->pokey_frq,
+		        t->quality, t->size, t->cutoff, t->sample_rate, t->quality);
+	}
+	fprintf(fp, "\t{0, 0, 0, 0, 0.0, NULL}\n};\n");
+	if (fclose(fp) != 0) {
+		perror(argv[1]);
+		return 1;
+	}
+	return 0;
+}
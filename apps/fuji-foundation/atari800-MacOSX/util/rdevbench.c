@@ -0,0 +1,264 @@
+/*
+ * rdevbench.c - loopback line and benchmark for the R: device
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* The other end of an R: network line, for trying terminal and BBS
+   software without a real host. Build and run from this directory:
+
+     cc -o rdevbench rdevbench.c
+     ./rdevbench [-p port] [-c host:port] [-n bytes] [-b baud]
+
+   By default it waits for a call on port 2323; dial it from the Atari with
+   "ATDI localhost 2323". With -c it calls the emulator instead, which
+   answers on port 9000 once a program has the R: device open in
+   concurrent mode.
+
+   Without -n it echoes everything back and, when the call ends, prints
+   how many bytes went each way and how fast. With -n it sends that many
+   bytes of numbered text lines, then waits for the Atari to send any byte
+   back (for example from the terminal's keyboard once the text has
+   scrolled by) and reports the rate the Atari took the text at, compared
+   with the line rate given by -b. */
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static double now(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static int listen_for_call(int port)
+{
+	struct sockaddr_in addr;
+	int on = 1;
+	int sock;
+	int fd;
+
+	sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock < 0) {
+		perror("socket");
+		return -1;
+	}
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (void *) &on, sizeof(on));
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(sock, 1) < 0) {
+		perror("bind");
+		close(sock);
+		return -1;
+	}
+	printf("Waiting for a call on port %d...\n", port);
+	fd = accept(sock, NULL, NULL);
+	if (fd < 0)
+		perror("accept");
+	close(sock);
+	return fd;
+}
+
+static int call(const char *address)
+{
+	char host[256];
+	const char *port;
+	struct addrinfo hints;
+	struct addrinfo *res;
+	int fd;
+
+	port = strrchr(address, ':');
+	if (port == NULL || port - address >= (int) sizeof(host)) {
+		fprintf(stderr, "%s: expected host:port\n", address);
+		return -1;
+	}
+	memcpy(host, address, port - address);
+	host[port - address] = '\0';
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(host, port + 1, &hints, &res) != 0) {
+		fprintf(stderr, "%s: unknown host\n", host);
+		return -1;
+	}
+	fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+		perror("connect");
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	return fd;
+}
+
+/* Reads from FD, skipping telnet commands (the R: device negotiates
+   options). Returns the number of data bytes stored in BUF, 0 at the end
+   of the call or -1 on error. */
+static int read_data(int fd, unsigned char *buf, int len)
+{
+	static int iac = 0;
+	unsigned char raw[4096];
+	int n;
+	int i;
+	int out = 0;
+
+	if (len > (int) sizeof(raw))
+		len = sizeof(raw);
+	do {
+		n = read(fd, raw, len);
+		if (n <= 0)
+			return n;
+		for (i = 0; i < n; i++) {
+			if (iac > 0) {
+				/* IAC IAC is a data byte; WILL, WONT, DO and DONT take an option */
+				if (iac == 1 && raw[i] == 0xff)
+					buf[out++] = 0xff;
+				else if (iac == 1 && raw[i] >= 0xfb) {
+					iac = 2;
+					continue;
+				}
+				iac = 0;
+			}
+			else if (raw[i] == 0xff)
+				iac = 1;
+			else
+				buf[out++] = raw[i];
+		}
+	} while (out == 0);
+	return out;
+}
+
+static int write_all(int fd, const unsigned char *buf, int len)
+{
+	while (len > 0) {
+		int n = write(fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf += n;
+		len -= n;
+	}
+	return 0;
+}
+
+static void print_rate(const char *what, long bytes, double seconds, int baud)
+{
+	printf("%s %ld bytes in %.2f s, %.0f bytes/s", what, bytes, seconds,
+	       seconds > 0 ? bytes / seconds : 0.0);
+	if (baud > 0)
+		printf(" (line rate %d bytes/s)", baud / 10);
+	printf("\n");
+}
+
+static int echo(int fd, int baud)
+{
+	unsigned char buf[4096];
+	long total = 0;
+	double start = 0.0;
+	int n;
+
+	printf("Echoing; hang up to end.\n");
+	while ((n = read_data(fd, buf, sizeof(buf))) > 0) {
+		if (total == 0)
+			start = now();
+		total += n;
+		if (write_all(fd, buf, n) < 0)
+			break;
+	}
+	print_rate("Echoed", total, total > 0 ? now() - start : 0.0, baud);
+	return 0;
+}
+
+static int send_text(int fd, long bytes, int baud)
+{
+	unsigned char buf[4096];
+	unsigned char reply;
+	long sent = 0;
+	long line = 1;
+	double start;
+
+	start = now();
+	while (sent < bytes) {
+		int n = 0;
+		while (n < (int) sizeof(buf) - 80 && sent + n < bytes) {
+			n += sprintf((char *) buf + n, "%06ld THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG\r\n", line++);
+		}
+		if (sent + n > bytes)
+			n = bytes - sent;
+		if (write_all(fd, buf, n) < 0) {
+			perror("write");
+			return 1;
+		}
+		sent += n;
+	}
+	printf("Sent %ld bytes; press a key on the Atari once they are all shown.\n", sent);
+	if (read_data(fd, &reply, 1) <= 0) {
+		printf("Call ended before the Atari answered.\n");
+		return 1;
+	}
+	print_rate("Atari took", sent, now() - start, baud);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *address = NULL;
+	long bytes = 0;
+	int port = 2323;
+	int baud = 0;
+	int fd;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+			port = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+			address = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			bytes = atol(argv[++i]);
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			baud = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "Usage: %s [-p port] [-c host:port] [-n bytes] [-b baud]\n", argv[0]);
+			return 1;
+		}
+	}
+	signal(SIGPIPE, SIG_IGN);
+	fd = address != NULL ? call(address) : listen_for_call(port);
+	if (fd < 0)
+		return 1;
+	printf("Connected.\n");
+	i = bytes > 0 ? send_text(fd, bytes, baud) : echo(fd, baud);
+	close(fd);
+	return i;
+}
@@ -0,0 +1,219 @@
+/*
+ * tracedump.c - prints a CPU trace recorded by the monitor
+ *
+ * Copyright (C) 2026 Atari800 development team (see DOC/CREDITS)
+ *
+ * This file is part of the Atari800 emulator project which emulates
+ * the Atari 400, 800, 800XL, 130XE, and 5200 8-bit computers.
+ *
+ * Atari800 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Atari800 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Atari800; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/* Turns a trace written by the monitor's TRON (TRACE in the console
+   monitor) into a disassembly listing. Build and run from this directory:
+
+     cc -o tracedump tracedump.c -lz
+     ./tracedump [-s skip] [-n count] [-p addr] trace.gz
+
+   Each line holds the machine cycle counted from the start of the trace,
+   the scanline and the cycle in it, the address and bytes of the
+   instruction, its disassembly and the registers before it executed. -s
+   skips the first records, -n stops after printing that many and -p only
+   prints instructions at one address (for example to see the registers
+   each time a routine is entered). The record format is described in
+   src/cputrace.h; uncompressed traces are read too. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* See src/cputrace.h */
+#define CPUTRACE_MAGIC "A8TRACE"
+#define CPUTRACE_VERSION 1
+#define CPUTRACE_HEADER_SIZE 16
+#define CPUTRACE_RECORD_SIZE 16
+#define CPUTRACE_CYCLES_UNKNOWN 0xffff
+
+/* Operands: 0 relative, 1 byte, 2 word; from src/Atari800MacX/mac_monitor.c */
+static const char instr6502[256][10] = {
+	"BRK", "ORA (1,X)", "CIM", "ASO (1,X)", "NOP 1", "ORA 1", "ASL 1", "ASO 1",
+	"PHP", "ORA #1", "ASL", "ANC #1", "NOP 2", "ORA 2", "ASL 2", "ASO 2",
+
+	"BPL 0", "ORA (1),Y", "CIM", "ASO (1),Y", "NOP 1,X", "ORA 1,X", "ASL 1,X", "ASO 1,X",
+	"CLC", "ORA 2,Y", "NOP !", "ASO 2,Y", "NOP 2,X", "ORA 2,X", "ASL 2,X", "ASO 2,X",
+
+	"JSR 2", "AND (1,X)", "CIM", "RLA (1,X)", "BIT 1", "AND 1", "ROL 1", "RLA 1",
+	"PLP", "AND #1", "ROL", "ANC #1", "BIT 2", "AND 2", "ROL 2", "RLA 2",
+
+	"BMI 0", "AND (1),Y", "CIM", "RLA (1),Y", "NOP 1,X", "AND 1,X", "ROL 1,X", "RLA 1,X",
+	"SEC", "AND 2,Y", "NOP !", "RLA 2,Y", "NOP 2,X", "AND 2,X", "ROL 2,X", "RLA 2,X",
+
+
+	"RTI", "EOR (1,X)", "CIM", "LSE (1,X)", "NOP 1", "EOR 1", "LSR 1", "LSE 1",
+	"PHA", "EOR #1", "LSR", "ALR #1", "JMP 2", "EOR 2", "LSR 2", "LSE 2",
+
+	"BVC 0", "EOR (1),Y", "CIM", "LSE (1),Y", "NOP 1,X", "EOR 1,X", "LSR 1,X", "LSE 1,X",
+	"CLI", "EOR 2,Y", "NOP !", "LSE 2,Y", "NOP 2,X", "EOR 2,X", "LSR 2,X", "LSE 2,X",
+
+	"RTS", "ADC (1,X)", "CIM", "RRA (1,X)", "NOP 1", "ADC 1", "ROR 1", "RRA 1",
+	"PLA", "ADC #1", "ROR", "ARR #1", "JMP (2)", "ADC 2", "ROR 2", "RRA 2",
+
+	"BVS 0", "ADC (1),Y", "CIM", "RRA (1),Y", "NOP 1,X", "ADC 1,X", "ROR 1,X", "RRA 1,X",
+	"SEI", "ADC 2,Y", "NOP !", "RRA 2,Y", "NOP 2,X", "ADC 2,X", "ROR 2,X", "RRA 2,X",
+
+
+	"NOP #1", "STA (1,X)", "NOP #1", "SAX (1,X)", "STY 1", "STA 1", "STX 1", "SAX 1",
+	"DEY", "NOP #1", "TXA", "ANE #1", "STY 2", "STA 2", "STX 2", "SAX 2",
+
+	"BCC 0", "STA (1),Y", "CIM", "SHA (1),Y", "STY 1,X", "STA 1,X", "STX 1,Y", "SAX 1,Y",
+	"TYA", "STA 2,Y", "TXS", "SHS 2,Y", "SHY 2,X", "STA 2,X", "SHX 2,Y", "SHA 2,Y",
+
+	"LDY #1", "LDA (1,X)", "LDX #1", "LAX (1,X)", "LDY 1", "LDA 1", "LDX 1", "LAX 1",
+	"TAY", "LDA #1", "TAX", "ANX #1", "LDY 2", "LDA 2", "LDX 2", "LAX 2",
+
+	"BCS 0", "LDA (1),Y", "CIM", "LAX (1),Y", "LDY 1,X", "LDA 1,X", "LDX 1,Y", "LAX 1,X",
+	"CLV", "LDA 2,Y", "TSX", "LAS 2,Y", "LDY 2,X", "LDA 2,X", "LDX 2,Y", "LAX 2,Y",
+
+
+	"CPY #1", "CMP (1,X)", "NOP #1", "DCM (1,X)", "CPY 1", "CMP 1", "DEC 1", "DCM 1",
+	"INY", "CMP #1", "DEX", "SBX #1", "CPY 2", "CMP 2", "DEC 2", "DCM 2",
+
+	"BNE 0", "CMP (1),Y", "ESCRTS #1", "DCM (1),Y", "NOP 1,X", "CMP 1,X", "DEC 1,X", "DCM 1,X",
+	"CLD", "CMP 2,Y", "NOP !", "DCM 2,Y", "NOP 2,X", "CMP 2,X", "DEC 2,X", "DCM 2,X",
+
+
+	"CPX #1", "SBC (1,X)", "NOP #1", "INS (1,X)", "CPX 1", "SBC 1", "INC 1", "INS 1",
+	"INX", "SBC #1", "NOP", "SBC #1 !", "CPX 2", "SBC 2", "INC 2", "INS 2",
+
+	"BEQ 0", "SBC (1),Y", "ESCAPE #1", "INS (1),Y", "NOP 1,X", "SBC 1,X", "INC 1,X", "INS 1,X",
+	"SED", "SBC 2,Y", "NOP !", "INS 2,Y", "NOP 2,X", "SBC 2,X", "INC 2,X", "INS 2,X"
+};
+
+static int insn_length(const char *mnemonic)
+{
+	if (strchr(mnemonic, '2') != NULL)
+		return 3;
+	if (strchr(mnemonic, '1') != NULL || strchr(mnemonic, '0') != NULL)
+		return 2;
+	return 1;
+}
+
+static void disassemble(char *buf, unsigned int pc, const unsigned char *bytes)
+{
+	const char *p;
+	for (p = instr6502[bytes[0]]; *p != '\0'; p++) {
+		switch (*p) {
+		case '0':
+			buf += sprintf(buf, "$%04X", (pc + 2 + (signed char) bytes[1]) & 0xffff);
+			break;
+		case '1':
+			buf += sprintf(buf, "$%02X", bytes[1]);
+			break;
+		case '2':
+			buf += sprintf(buf, "$%04X", bytes[1] + (bytes[2] << 8));
+			break;
+		default:
+			*buf++ = *p;
+			break;
+		}
+	}
+	*buf = '\0';
+}
+
+static void print_record(unsigned long long clock, const unsigned char *r)
+{
+	static const char flag_names[] = "NV*BDIZC";
+	unsigned int pc = r[0] + (r[1] << 8);
+	int len = insn_length(instr6502[r[2]]);
+	char text[32];
+	char flags[9];
+	int i;
+
+	disassemble(text, pc, r + 2);
+	for (i = 0; i < 8; i++)
+		flags[i] = (r[9] & (0x80 >> i)) ? flag_names[i] : '-';
+	flags[8] = '\0';
+	printf("%12llu %3d %3d %04X ", clock, r[10] + (r[11] << 8), r[12], pc);
+	for (i = 0; i < 3; i++) {
+		if (i < len)
+			printf("%02X ", r[2 + i]);
+		else
+			printf("   ");
+	}
+	printf("%-14s A=%02X X=%02X Y=%02X S=%02X P=%s\n", text, r[5], r[6], r[7], r[8], flags);
+}
+
+int main(int argc, char **argv)
+{
+	const char *filename = NULL;
+	unsigned long long skip = 0;
+	unsigned long long count = 0;
+	unsigned long long index = 0;
+	unsigned long long clock = 0;
+	long addr = -1;
+	unsigned char header[CPUTRACE_HEADER_SIZE];
+	unsigned char r[CPUTRACE_RECORD_SIZE];
+	gzFile in;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			skip = strtoull(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			count = strtoull(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+			addr = strtol(argv[++i], NULL, 16);
+		else if (filename == NULL && argv[i][0] != '-')
+			filename = argv[i];
+		else
+			break;
+	}
+	if (filename == NULL || i < argc) {
+		fprintf(stderr, "Usage: %s [-s skip] [-n count] [-p addr] trace.gz\n", argv[0]);
+		return 1;
+	}
+	in = gzopen(filename, "rb");
+	if (in == NULL) {
+		perror(filename);
+		return 1;
+	}
+	if (gzread(in, header, sizeof(header)) != sizeof(header)
+	 || memcmp(header, CPUTRACE_MAGIC, sizeof(CPUTRACE_MAGIC)) != 0) {
+		fprintf(stderr, "%s: not a CPU trace\n", filename);
+		gzclose(in);
+		return 1;
+	}
+	if (header[8] != CPUTRACE_VERSION || header[9] != CPUTRACE_RECORD_SIZE) {
+		fprintf(stderr, "%s: unsupported trace version %d\n", filename, header[8]);
+		gzclose(in);
+		return 1;
+	}
+	while (gzread(in, r, sizeof(r)) == sizeof(r)) {
+		unsigned int delta = r[14] + (r[15] << 8);
+		/* Unknown gaps are not counted. */
+		if (delta != CPUTRACE_CYCLES_UNKNOWN)
+			clock += delta;
+		if (index++ < skip)
+			continue;
+		if (addr >= 0 && r[0] + (r[1] << 8) != addr)
+			continue;
+		print_record(clock, r);
+		if (count != 0 && --count == 0)
+			break;
+	}
+	gzclose(in);
+	return 0;
+}
@@ -39,6 +39,8 @@
 #include "colours.h"
 #include "log.h"
 #include "monitor.h"
+#include "pacer.h"
+#include "perf.h"
 #include "platform.h"
 #include "ui.h"
 #include "Atari800Core.h"
@@ -269,10 +271,15 @@ double PLATFORM_AdjustSpeed(void)
     /* Estimate audio buffer gap to throttle emulation speed.
      * If the ring buffer is getting too full, slow down.
      * If it's getting too empty, speed up slightly. */
-    int available = Vision_Sound_Available();
+    int available;
     int target = VISION_SOUND_BUFFER_SIZE / 4;  /* target 25% fill */
     int spread = VISION_SOUND_BUFFER_SIZE / 8;
 
+    /* Speed limit off: a zero frame time makes Atari800_Sync() not wait. */
+    if (!speed_limit)
+        return 0.0;
+    available = Vision_Sound_Available();
+
     if (available > target + spread)
         return 0.95;   /* slow down — buffer too full */
     else if (available < target - spread)
@@ -336,7 +343,9 @@ void Sound_Update(void)
     if (nbytes > sizeof(tempbuf))
         nbytes = sizeof(tempbuf);
 
+    PERF_BEGIN(PERF_POKEYSND);
     POKEYSND_Process(tempbuf, sndbufsize);
+    PERF_END(PERF_POKEYSND);
 
     /* Apply volume scaling */
     if (sound_volume < 1.0 && sound_bits == 16) {
@@ -376,17 +385,14 @@ static void *emulation_thread_func(void *arg)
         return NULL;
     }
 
-    /* Main emulation loop */
+    /* Main emulation loop.  Atari800_Frame() paces itself to the exact
+       PAL/NTSC rate through Atari800_Sync(), so no extra sleep is needed. */
     while (atomic_load(&s_emu_running)) {
         if (!pauseEmulator) {
             Atari800Core_RunFrame();
         } else {
-            usleep(16000);  /* ~60Hz idle when paused */
-        }
-
-        /* Basic frame timing when speed_limit is on */
-        if (speed_limit) {
-            usleep(16000);  /* ~60fps — refined by PLATFORM_AdjustSpeed in sync sound */
+            PACER_WaitUntil(PACER_Time() + 1.0 / Atari800_FPS_NTSC);  /* idle when paused */
+            PACER_Reset();  /* don't race to catch up after resuming */
         }
     }
 
@@ -64,6 +64,8 @@ static inline int vision_system_stub(const char *cmd) { (void)cmd; return -1; }
 #define HAVE_MKDIR 1
 #define HAVE_RMDIR 1
 #define HAVE_FSTAT 1
+#define HAVE_MMAP 1
+#define HAVE_FUNOPEN 1
 #define HAVE_STAT 1
 #define HAVE_CHMOD 1
 /* HAVE_SYSTEM intentionally omitted — system() unavailable on visionOS */
@@ -126,6 +128,7 @@ static inline int vision_system_stub(const char *cmd) { (void)cmd; return -1; }
 
 /* ── Misc ──────────────────────────────────────────────────────────────── */
 #define DONT_USE_RTCONFIGUPDATE
+/* #define PERF_COUNTERS */   /* hot-path timers, see perf.h */
 #define monitor Atari_monitor
 
 #endif /* CONFIG_H_FUJIVISION */